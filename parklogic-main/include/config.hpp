@@ -21,6 +21,7 @@ constexpr float PPM = static_cast<float>(PIXELS_PER_ART_PIXEL * ART_PIXELS_PER_M
 
 constexpr int LANE_OFFSET_UP = 61;   ///< Up lane offset from top of road (art pixels)
 constexpr int LANE_OFFSET_DOWN = 94; ///< Down lane offset from top of road (art pixels)
+constexpr int ENTRANCE_LANE_OFFSET = 18; ///< Entry/exit lanes' distance from an entrance's center line (art pixels)
 
 // Physical Window Start Size
 constexpr int INITIAL_WINDOW_WIDTH = 1280; ///< Initial window width
@@ -32,6 +33,11 @@ constexpr double FIXED_DELTA_TIME = 1.0 / static_cast<double>(TICK_RATE); ///< T
 constexpr int TARGET_FPS = 60;       ///< Target frames per second
 constexpr bool VSYNC_ENABLED = true; ///< Vertical sync flag
 
+constexpr float MIN_ZOOM = 0.1f; ///< Camera zoom limits
+constexpr float MAX_ZOOM = 5.0f;
+
+constexpr int FRAME_ARENA_INITIAL_BYTES = 64 * 1024; ///< Initial per-tick scratch arena size (grows on demand)
+
 namespace CarAI {
 /**
  * @struct AIPhase
@@ -60,10 +66,37 @@ constexpr float LARGE_CHARGING = 12.0f;
 constexpr float GENERIC = 5.0f;
 } // namespace GateDepth
 
+constexpr float MAX_SPEED = 15.0f;             // Cruise speed (m/s, ~54 km/h)
+constexpr float ALIGN_ROTATION_SPEED = 120.0f; // In-spot alignment turn rate (degrees per second)
+constexpr float ALIGN_DISTANCE = 8.0f;         // Alignment point's distance straight behind a spot (m)
+
 // Turn Logic
 constexpr float TURN_SLOWDOWN_DIST = 30.0f;    // Start slowing down X meters before a sharp turn
 constexpr float TURN_SLOWDOWN_ANGLE = 0.2f;    // Angle (radians) to consider "sharp" (~11 degrees)
 constexpr float TURN_MIN_SPEED_FACTOR = 0.20f; // Slow down to at least this factor during turns
+
+namespace Flow {
+// Facility interiors are steered by per-template flow fields (see FlowField)
+constexpr float CELL_SIZE = 1.0f;        // Grid resolution (m)
+constexpr float STALL_LENGTH = 5.0f;     // Blocked footprint of a parking spot along its orientation (m)
+constexpr float STALL_WIDTH = 3.0f;      // ... and across it (m)
+constexpr float SLOW_RADIUS = 6.0f;      // Closer than this to a stall or the goal, speed ramps down to MANEUVER
+constexpr float EXIT_GOAL_RADIUS = 1.5f; // Cells this close to the exit gate waypoint end the exit field
+} // namespace Flow
+
+namespace Avoidance {
+constexpr float LOOK_AHEAD = 5.0f;           // Look-ahead at standstill (m) ...
+constexpr float LOOK_AHEAD_PER_SPEED = 1.5f; // ... plus this many seconds of travel
+constexpr float LANE_HALF_WIDTH = 2.2f;      // Frontal corridor half width (m)
+constexpr float BRAKING_GAIN = 45.0f;        // Braking at zero distance; falls off with the square of the gap
+constexpr float HEAD_ON_ALIGNMENT = -0.3f;   // Heading dot product below which an oncoming car triggers a side-step
+constexpr float CRAWL_SPEED = 0.5f;          // Below this speed (m/s) any car ahead triggers a side-step
+constexpr float SIDE_STEP_FORCE = 25.0f;     // Sideways push away from the car in the way
+constexpr float MATCH_GAIN = 12.0f;          // Braking per m/s faster than the car ahead
+constexpr float REPULSION_RADIUS = 1.8f;     // Cars closer than this push apart (m)
+constexpr float REPULSION_FORCE = 30.0f;     // ... with up to this force
+constexpr int NEIGHBOR_BATCH = 64;           // Gathered neighbors evaluated per kernel call
+} // namespace Avoidance
 } // namespace CarAI
 
 // Battery Constants
@@ -86,5 +119,127 @@ namespace Spawner {
 // Level 4: Fast
 // Level 5: Very Fast
 constexpr float SPAWN_RATES[] = {0.0f, 5.0f, 4.0f, 3.0f, 2.0f, 1.0f};
+
+constexpr float LANE_CLEARANCE = 7.0f;      // Free road (m) needed ahead of a spawn point before the next car enters
+constexpr float LANE_HALF_WIDTH = 1.5f;     // Lateral distance (m) within which a car blocks the spawn lane
+constexpr double PRESAMPLE_HORIZON = 10.0;  // Arrivals are sampled this far (sim seconds) ahead of the clock
+constexpr int MAX_DEFERRED_PER_LANE = 5000; // Waiting arrivals beyond this give up (balk)
 } // namespace Spawner
+
+namespace Demand {
+constexpr float DAY_START_HOUR = 6.0f;          // Time of day when a scene starts
+constexpr float ELECTRIC_SHARE = 0.5f;          // Fraction of arrivals that are EVs
+constexpr float DISTANCE_PRIORITY_SHARE = 0.5f; // Fraction of arrivals that prefer distance over price
+
+// Relative arrival intensity per hour of day (0-23), peaks for the morning and evening commute
+constexpr float COMMUTER_CURVE[24] = {0.05f, 0.03f, 0.02f, 0.02f, 0.05f, 0.15f, 0.45f, 0.85f,
+                                      1.00f, 0.70f, 0.50f, 0.55f, 0.65f, 0.55f, 0.50f, 0.55f,
+                                      0.75f, 0.95f, 0.80f, 0.55f, 0.40f, 0.30f, 0.20f, 0.10f};
+constexpr float COMMUTER_PEAK_RATE = 0.5f; // Arrivals per second at curve 1.0, per auto-spawn level
+constexpr float STRESS_RATE = 40.0f;       // Arrivals per second per auto-spawn level (load testing)
+} // namespace Demand
+
+namespace Congestion {
+constexpr float CELL_SIZE = 4.0f;        // Side of a heatmap cell (m)
+constexpr int LOCAL_RECORDS = 4096;      // Per-thread records buffered between merges; a full buffer folds early
+constexpr unsigned char MAX_ALPHA = 170; // Overlay opacity of the hottest cell
+} // namespace Congestion
+
+namespace Scheduler {
+constexpr int MAX_WORKERS = 3;    // Job pool threads at most (the ticking thread runs jobs as well)
+constexpr int MAX_SYSTEMS = 32;   // Systems per scheduler (dependency sets are 32-bit masks)
+constexpr int SPAWN_RATE = 10;    // Arrival admissions per second (Hz)
+constexpr int PARKED_RATE = 5;    // Charging and departure checks of parked cars (Hz)
+constexpr int DASHBOARD_RATE = 4; // Dashboard occupancy aggregates (Hz)
+constexpr int FORECAST_RATE = 1;  // Live state captures offered to the forecaster (Hz)
+constexpr int WATCHDOG_RATE = 1;  // Stuck-vehicle sweeps (Hz)
+} // namespace Scheduler
+
+namespace Governor {
+constexpr int WINDOW_TICKS = 60;           // Ticks per load measurement (one simulated second)
+constexpr double HIGH_LOAD = 0.8;          // Share of the wall-clock budget spent ticking that escalates a stage ...
+constexpr int ESCALATE_WINDOWS = 2;        // ... when exceeded this many windows in a row (one-off stalls pass)
+constexpr double LOW_LOAD = 0.35;          // Below this for RELAX_WINDOWS windows in a row, relax a stage
+constexpr int RELAX_WINDOWS = 5;
+constexpr double MIN_SPEED_FACTOR = 0.125; // Slowest the governor makes the requested speed
+constexpr float DEMOTE_MARGIN = 20.0f;     // Cars this close to the view keep the full update (m)
+} // namespace Governor
+
+namespace Watchdog {
+constexpr float PROGRESS_DISTANCE = 2.0f; // Driving this far, reaching a waypoint or a new path counts as progress (m)
+constexpr float STALL_SECONDS = 30.0f;    // Driving or exiting cars without progress this long are stalled
+constexpr float CLUSTER_RADIUS = 10.0f;   // Stalled cars this close block each other (one cluster)
+constexpr float RIGHT_OF_WAY = 5.0f;      // Seconds a cluster's longest-stalled car drives on without avoidance
+constexpr float DESPAWN_SECONDS = 120.0f; // A cluster's longest-stalled car is removed after this long
+} // namespace Watchdog
+
+namespace Trips {
+constexpr int EVENT_RING = 4096;         // Milestone events buffered between drains (power of two)
+constexpr float RESOLUTION = 0.01f;      // Smallest duration the trip histograms tell apart (s)
+constexpr float MAX_DURATION = 86400.0f; // Longer trips are counted at this value (s)
+} // namespace Trips
+
+namespace Forecast {
+constexpr double HORIZON = 1800.0;       // Look-ahead of the occupancy forecast (s)
+constexpr double SAMPLE_INTERVAL = 60.0; // Spacing of the forecast curve samples (s)
+constexpr int REPLICATIONS = 8;          // DES runs averaged per forecast
+constexpr double MIN_PERIOD = 0.5;       // Wall seconds between forecasts, so fast-forwarded runs stay cheap
+} // namespace Forecast
+
+namespace History {
+constexpr int SAMPLE_RATE = 4;         // Occupancy history samples per simulated second (Hz)
+constexpr int CAPACITY = 256;          // Buckets per resolution: ~4 min of 1 s, ~4 h of 1 min, ~64 h of 15 min
+constexpr int SPARKLINE_BUCKETS = 120; // Buckets shown by the dashboard sparklines
+} // namespace History
+
+namespace Trajectory {
+constexpr unsigned int TICKS_PER_CHUNK = 600; // Ticks per keyframe chunk (10 s at 60 Hz); bounds the cost of a seek
+constexpr double SEEK_STEP = 10.0;             // Seconds skipped by the playback arrow keys
+constexpr float PLAYBACK_SPEEDS[] = {0.25f, 0.5f, 1.0f, 2.0f, 4.0f, 8.0f, 16.0f, 32.0f};
+constexpr int DEFAULT_SPEED_INDEX = 2;         // 1x
+} // namespace Trajectory
+
+namespace Control {
+constexpr int MAX_CLIENTS = 16;              // Concurrent control connections; further ones are refused
+constexpr int MAX_LINE = 256;                // Longest accepted command line (bytes)
+constexpr int SNAPSHOT_FACILITIES = 64;      // Facilities reported by the occupancy and map queries
+constexpr int SNAPSHOT_ENTRANCES = 64;       // Entrance roads reported by the map query
+constexpr double MIN_SPEED = 0.1;            // Speed multiplier range accepted by the speed command
+constexpr double MAX_SPEED = 64.0;
+constexpr int HISTORY_BUCKETS = 30;          // Newest buckets returned by the history query
+} // namespace Control
+
+namespace Shard {
+constexpr int MAX_SHARDS = 64;               // Upper bound for --shards
+constexpr float GHOST_MARGIN = 30.0f;        // Mirror cars this close to a seam (exceeds the avoidance look-ahead)
+constexpr int MIGRATION_RING = 256;          // Hand-over slots per seam and direction (power of two)
+constexpr int GHOST_RING = 2048;             // Ghost slots per seam and direction; holds two ticks of seam traffic
+constexpr double REPORT_INTERVAL = 5.0;      // Seconds between coordinator progress lines (wall clock)
+} // namespace Shard
+
+namespace Planner {
+constexpr int MAX_PER_TYPE = 4;            // Facilities of each kind the search tries (0 to this)
+constexpr int ETA = 3;                     // Each rung keeps 1/ETA of its candidates and runs ETA times longer
+constexpr double MIN_RUNG_HOURS = 4.0;     // Shortest rung; shorter runs barely get past the empty-map start
+constexpr int FINALISTS = 12;              // Rungs never cut below this many candidates
+constexpr double PARKING_SPOT_COST = 1.0;  // Cost of a parking spot (arbitrary units)
+constexpr double CHARGING_SPOT_COST = 4.0; // ... and of a charging spot, charger included
+} // namespace Planner
+
+namespace Render {
+constexpr int SPRITES_PER_JOB = 512;    // Cars or modules whose quads one draw-list job builds
+constexpr double CAR_CULL_MARGIN = 3.0; // Cars centered this far outside the view still reach into it (m)
+} // namespace Render
+
+namespace RenderBench {
+constexpr double WARMUP_SECONDS = 900.0;     // Simulated time that populates the map before the first frame
+constexpr int SEGMENT_FRAMES = 300;          // Frames per camera segment of the script
+} // namespace RenderBench
+
+namespace World {
+constexpr float CHUNK_SIZE = 256.0f;         // Side of a coordinate chunk (m); floats inside resolve ~15 um
+constexpr int PAGED_MIN_CHUNKS = 8;          // Maps at least this many chunks wide page their geometry (WorldChunkStore)
+constexpr int CACHED_CHUNKS = 8;             // Unpinned chunks kept resident before the least recent is evicted
+constexpr unsigned int SWEEP_INTERVAL = 600; // Ticks between re-releasing evicted chunks touched outside the pins
+} // namespace World
 } // namespace Config
@@ -2,6 +2,7 @@
 #include "core/EventBus.hpp"
 #include "core/EventLogger.hpp"
 #include "core/GameLoop.hpp"
+#include "core/LaunchOptions.hpp"
 #include "core/Window.hpp"
 #include "input/InputSystem.hpp"
 #include "scenes/SceneManager.hpp"
@@ -20,15 +21,18 @@ class Application {
 public:
   /**
    * @brief Constructs the Application and initializes core systems.
+   *
+   * @param options Parsed command line (only the interactive settings are used).
    */
-  Application();
+  explicit Application(const LaunchOptions &options = {});
 
   /**
    * @brief Destructor.
    *
    * Cleans up resources. The Subscription token automatically unsubscribes on destruction.
+   * Logs allocation totals when allocation tracking is compiled in.
    */
-  ~Application() = default;
+  ~Application();
 
   /**
    * @brief Starts the main game loop.
@@ -39,6 +39,13 @@ public:
    */
   Texture2D GetTexture(const std::string &name);
 
+  /**
+   * @brief Retrieves a cached texture without logging a miss. Safe to call from several threads
+   * while no texture is loaded or unloaded (the draw-list jobs do).
+   * @return nullptr if not found.
+   */
+  const Texture2D *FindTexture(const std::string &name) const;
+
   /**
    * @brief Unloads a specific texture from GPU memory.
    * @param name The unique identifier.
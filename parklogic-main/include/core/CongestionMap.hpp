@@ -0,0 +1,118 @@
+#pragma once
+#include "core/WorldCoord.hpp"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @file CongestionMap.hpp
+ * @brief World-aligned statistics of where cars slow down, brake and side-step.
+ */
+
+/**
+ * @class CongestionMap
+ * @brief Accumulates per-cell traffic statistics over a scene.
+ *
+ * Every moving car reports once per tick through Record(), which appends one record to a fixed
+ * buffer owned by the calling thread: a cell index and a handful of adds, no locks and no
+ * allocation. The owner folds every thread's buffer into the grid with mergeTick() once the car
+ * updates of a tick are done.
+ *
+ * Per cell (Config::Congestion::CELL_SIZE, cell (0, 0) at the world origin):
+ * - dwell: car-seconds spent in the cell,
+ * - distance: meters driven (mean speed = distance / dwell),
+ * - braking: avoidance braking force integrated over time (mean force = braking / dwell),
+ * - sideSteps: ticks on which the deadlock breaker nudged a car sideways.
+ *
+ * The grid is drawn as a color overlay, one metric at a time, and can be dumped to a binary file:
+ * a DumpHeader followed by cols * rows Cells, row-major, little-endian.
+ */
+class CongestionMap {
+public:
+  enum class Metric { Off, Dwell, Speed, Braking, SideSteps, Count };
+
+  struct Cell {
+    float dwell;
+    float distance;
+    float braking;
+    uint32_t sideSteps;
+  };
+  static_assert(sizeof(Cell) == 16, "Congestion dump layout changed");
+
+  struct DumpHeader {
+    char magic[8]; ///< "PLHEAT01"
+    uint32_t cols;
+    uint32_t rows;
+    float cellSize; ///< Meters.
+    uint32_t reserved;
+    double seconds; ///< Simulated time the statistics cover.
+  };
+  static_assert(sizeof(DumpHeader) == 32, "Congestion dump layout changed");
+
+  CongestionMap() = default;
+  ~CongestionMap();
+
+  CongestionMap(const CongestionMap &) = delete;
+  CongestionMap &operator=(const CongestionMap &) = delete;
+
+  /**
+   * @brief Sizes an empty grid to the world and makes this the map Record() feeds.
+   */
+  void attach(float worldWidth, float worldHeight);
+
+  /**
+   * @brief Stops feeding this map; Record() is a no-op until the next attach.
+   */
+  void detach();
+
+  /**
+   * @brief Reports one car for one tick; a no-op while no map is attached.
+   * @param braking Braking force the avoidance corridor applied this tick.
+   * @param sideStep Whether the deadlock breaker fired this tick.
+   */
+  static void Record(const WorldCoord &position, float dt, float speed, float braking, bool sideStep);
+
+  /**
+   * @brief Folds every thread's pending records into the grid. Call between ticks.
+   * @param dt Simulated time the tick covered.
+   */
+  void mergeTick(double dt);
+
+  /**
+   * @brief Advances the overlay to the next metric (Off after the last).
+   */
+  Metric cycleMetric();
+  Metric getMetric() const { return metric; }
+  static const char *MetricName(Metric metric);
+
+  /**
+   * @brief Draws the current metric over the cells in [viewMin, viewMax] (inside a camera).
+   */
+  void draw(const WorldCoord &viewMin, const WorldCoord &viewMax) const;
+
+  /**
+   * @brief Writes the grid to a file.
+   * @return false if the file could not be written (logged).
+   */
+  bool dump(const std::string &path) const;
+
+  int getColumns() const { return cols; }
+  int getRows() const { return rows; }
+  const Cell &cellAt(int col, int row) const { return cells[(size_t)row * cols + col]; }
+
+  struct LocalBuffer;
+
+private:
+  void fold(LocalBuffer &buffer);
+
+  std::vector<Cell> cells;
+  int cols = 0;
+  int rows = 0;
+  double seconds = 0.0;
+  Metric metric = Metric::Off;
+  std::mutex foldMutex; ///< Serializes folds of buffers that overflowed mid-tick.
+
+  static inline std::atomic<CongestionMap *> active{nullptr};
+};
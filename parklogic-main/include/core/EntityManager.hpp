@@ -1,17 +1,26 @@
 #pragma once
+#include "core/CongestionMap.hpp"
 #include "core/EventBus.hpp"
+#include "core/SpriteBatch.hpp"
+#include "core/TripTelemetry.hpp"
 #include "entities/Car.hpp"
 #include "entities/map/Modules.hpp"
 #include "entities/map/World.hpp"
 #include <memory>
+#include <span>
 #include <vector>
 
+class SystemScheduler;
+
 /**
  * @class EntityManager
  * @brief Manages the lifecycle and storage of all game entities.
  *
  * Stores the World, Modules, and Cars.
  * Subscribes to events to trigger spawning, generation, and updates.
+ * Large maps keep their background in a WorldChunkStore; the manager pins the camera view each tick.
+ * Cars report to the scene's CongestionMap, which the manager merges after every tick, and stamp
+ * their trip milestones into its TripTelemetry, drained after every tick as well.
  */
 class EntityManager {
 public:
@@ -28,20 +37,53 @@ public:
    */
   void update(double dt);
 
+  /**
+   * @brief Registers the car update (Simulation stage) and chunk residency (reads the camera view).
+   */
+  void schedule(SystemScheduler &scheduler);
+
   /**
    * @brief Draws all managed entities in the correct order (World -> Modules -> Cars -> Overlay).
+   *
+   * Module and car quads are built on the draw pool (see SpriteBatch), then submitted here.
    */
   void draw();
 
+  /**
+   * @brief Workers that build the draw lists; nullptr (the default) builds them on the drawing thread.
+   * The pool must stay alive while it is set and may not be running a batch when draw() is called.
+   */
+  void setDrawPool(JobPool *pool) { drawPool = pool; }
+
   // Entity Management
   void setWorld(std::unique_ptr<World> world);
   void addModule(std::unique_ptr<Module> module);
-  void addCar(std::unique_ptr<Car> car);
+
+  /**
+   * @brief Takes a module out of the map and hands it back (nullptr if it is not part of it).
+   *
+   * The caller decides when it is destroyed, so whatever still points at it can let go first.
+   */
+  std::unique_ptr<Module> removeModule(const Module *module);
+  void addCar(std::unique_ptr<Car> car); ///< Assigns the next id unless the car already has one.
+
+  /**
+   * @brief Makes new car ids first, first + stride, ... (disjoint id ranges per shard process).
+   */
+  void setCarIdSequence(uint32_t first, uint32_t stride);
+
+  /**
+   * @brief Cars of other shards that local cars avoid; the caller keeps them alive and current.
+   */
+  void setGhosts(std::span<const std::unique_ptr<Car>> ghostCars) { ghosts = ghostCars; }
 
   // Accessors
   World *getWorld() const { return world.get(); }
   const std::vector<std::unique_ptr<Module>> &getModules() const { return modules; }
   const std::vector<std::unique_ptr<Car>> &getCars() const { return cars; }
+  const CongestionMap &getCongestionMap() const { return congestion; }
+  const TripTelemetry &getTripTelemetry() const { return trips; }
+  int getDemotedCount() const { return demotedCars; } ///< Cars on the cheap update path last tick.
 
   /**
    * @brief Clears all entities and resets the world.
@@ -55,12 +97,35 @@ public:
   void removeCar(Car *car);
 
 private:
+  void updateCars(double dt);
+  bool isDistant(const WorldCoord &position) const;
+  bool isOutsideView(const WorldCoord &position, double margin) const; ///< Requires viewKnown.
+  void updateChunks();
+
   std::shared_ptr<EventBus> eventBus;
   std::vector<Subscription> eventTokens;
 
+  std::unique_ptr<class WorldChunkStore> chunkStore; ///< Pages the background tiles (large maps only).
   std::unique_ptr<World> world;
   std::vector<std::unique_ptr<Module>> modules;
   std::vector<std::unique_ptr<Car>> cars;
-  
+  uint32_t nextCarId = 1; ///< Car ids are never reused within a scene.
+  uint32_t carIdStride = 1;
+  int nextFacilityId = 0; ///< Facility ids are never reused within a scene.
+  std::span<const std::unique_ptr<Car>> ghosts;
+  CongestionMap congestion;
+  TripTelemetry trips;
+
+  bool viewKnown = false; ///< Set once a CameraViewEvent arrives (never when headless).
+  WorldCoord viewMin;
+  WorldCoord viewMax;
+
+  bool demoteDistant = false; ///< LoadGovernor stage Demote or above.
+  int demotedCars = 0;
+
   bool dashboardVisible = false;
+
+  JobPool *drawPool = nullptr;
+  SpriteBatch moduleSprites;
+  SpriteBatch carSprites;
 };
@@ -1,9 +1,13 @@
 #pragma once
 
+#include "core/MemoryStats.hpp"
 #include "events/EventTypes.hpp"
 #include <algorithm>
+#include <array>
+#include <cstddef>
 #include <functional>
 #include <memory>
+#include <memory_resource>
 #include <mutex>
 #include <shared_mutex>
 #include <typeindex>
@@ -142,13 +146,21 @@ public:
    * This ensures that if a callback takes a long time or modifies the subscription list
    * (e.g., unsubscribes itself), it does not block other threads or invalidate the loop.
    *
+   * The snapshot lives in a small stack buffer (SNAPSHOT_INLINE_BYTES), so publishing to a
+   * typical number of listeners does not touch the heap. publish() may run on any thread and
+   * may recurse, which is why it does not use the per-tick FrameArena.
+   *
    * @tparam T The type of the event object.
    * @param event The event data instance.
    */
   template <EventType T> void publish(const T &event) {
-    std::vector<std::shared_ptr<IEventWrapper>> listenersSnapshot;
+    std::array<std::byte, SNAPSHOT_INLINE_BYTES> snapshotBuffer;
+    std::pmr::monotonic_buffer_resource snapshotArena(snapshotBuffer.data(), snapshotBuffer.size());
+    std::pmr::vector<std::shared_ptr<IEventWrapper>> listenersSnapshot(&snapshotArena);
 
     {
+      ProfileZoneScope zone(ProfileZone::EventDispatch);
+
       // Shared Lock: Allows concurrent calls to publish() from multiple threads.
       std::shared_lock<std::shared_mutex> lock(mutex_);
 
@@ -162,7 +174,7 @@ public:
       // Create a local copy (increments ref counts).
       // This keeps the handlers alive for the duration of this function call
       // even if they are removed from the main 'subscribers' map.
-      listenersSnapshot = it->second;
+      listenersSnapshot.assign(it->second.begin(), it->second.end());
     } // Mutex releases here
 
     // Execute callbacks outside the lock to prevent deadlocks if a callback
@@ -196,6 +208,9 @@ public:
   }
 
 private:
+  /// Stack space for the publish() snapshot (16 listeners); larger lists spill to the heap.
+  static constexpr size_t SNAPSHOT_INLINE_BYTES = 16 * sizeof(std::shared_ptr<void>);
+
   /**
    * @brief Type Erasure Base Interface.
    * Allows storing templated EventWrappers in a generic container.
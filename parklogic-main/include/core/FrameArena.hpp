@@ -0,0 +1,81 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+
+/**
+ * @file FrameArena.hpp
+ * @brief Per-tick monotonic arena for transient simulation allocations.
+ */
+
+/**
+ * @class FrameArena
+ * @brief A bump allocator that is wiped at the end of every simulation tick.
+ *
+ * Systems draw short-lived scratch storage (removal lists, candidate lists, generated paths)
+ * from it through the std::pmr interface:
+ * @code
+ * std::pmr::vector<Car *> carsToRemove(FrameArena::Get().resource());
+ * @endcode
+ *
+ * - Deallocation is a no-op; reset() releases everything in O(1).
+ * - If a tick outgrows the buffer, the overflow is served by the upstream heap and the buffer
+ *   is grown at the next reset(), so steady-state ticks never touch the global heap.
+ * - Each thread owns its own arena (Get() is thread_local), so no locking is required.
+ *
+ * Memory obtained from the arena must not outlive the tick it was allocated in.
+ */
+class FrameArena : public std::pmr::memory_resource {
+public:
+  /**
+   * @brief Retrieves the arena of the calling thread.
+   * @return Reference to the thread's FrameArena.
+   */
+  static FrameArena &Get() {
+    thread_local FrameArena instance;
+    return instance;
+  }
+
+  FrameArena(const FrameArena &) = delete;
+  FrameArena &operator=(const FrameArena &) = delete;
+  ~FrameArena() override;
+
+  /**
+   * @brief Memory resource to hand to std::pmr containers.
+   */
+  std::pmr::memory_resource *resource() { return this; }
+
+  /**
+   * @brief Releases every allocation made since the last reset.
+   *
+   * Called once at the end of each tick. Grows the buffer if the tick overflowed it.
+   */
+  void reset();
+
+  size_t getCapacity() const { return capacity; }       ///< Size of the inline buffer in bytes.
+  size_t getBytesUsed() const { return offset; }        ///< Bytes handed out this tick (inline buffer).
+  size_t getHighWaterMark() const { return highWater; } ///< Largest per-tick demand seen so far.
+
+private:
+  FrameArena();
+
+  void *do_allocate(size_t bytes, size_t alignment) override;
+  void do_deallocate(void *, size_t, size_t) override {} // Monotonic: freed by reset()
+  bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+
+  /**
+   * @brief Header prepended to blocks served by the upstream heap once the buffer is full.
+   */
+  struct OverflowBlock {
+    OverflowBlock *next;
+    size_t size;
+    size_t alignment;
+  };
+
+  std::unique_ptr<std::byte[]> buffer;
+  size_t capacity = 0;
+  size_t offset = 0;
+  size_t overflowBytes = 0;
+  size_t highWater = 0;
+  OverflowBlock *overflowHead = nullptr;
+};
@@ -24,6 +24,12 @@ public:
    */
   void setSpeedMultiplier(double speed) { speedMultiplier = speed; }
 
+  /**
+   * @brief Scales the speed multiplier down while the LoadGovernor sheds load (1 = unchanged).
+   */
+  void setSpeedFactor(double factor) { speedFactor = factor; }
+
 private:
   double speedMultiplier = 1.0;
+  double speedFactor = 1.0;
 };
@@ -0,0 +1,68 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @file JobPool.hpp
+ * @brief Fixed set of worker threads running batches of indexed jobs.
+ */
+
+/**
+ * @class JobPool
+ * @brief Runs job(0) .. job(count - 1) across its workers and the calling thread.
+ *
+ * run() blocks until the whole batch is done, so a batch may reference the caller's stack. Jobs
+ * are claimed one index at a time from a shared counter; dispatching a batch takes one lock and
+ * one notify, and nothing is allocated. A worker resets its own FrameArena after every job, so
+ * arena scratch must not outlive the job that drew it.
+ */
+class JobPool {
+public:
+  /**
+   * @param workers Threads to start; 0 runs every batch on the calling thread.
+   */
+  explicit JobPool(int workers);
+  ~JobPool();
+
+  JobPool(const JobPool &) = delete;
+  JobPool &operator=(const JobPool &) = delete;
+
+  int getWorkerCount() const { return (int)threads.size(); }
+
+  /**
+   * @brief Calls job(i) for every i in [0, count) and returns once all calls have returned.
+   * @param job Callable taking an int; it must outlive the call (it does, run() blocks).
+   */
+  template <typename Job> void run(int count, Job &job) {
+    dispatch(count, [](void *context, int index) { (*static_cast<Job *>(context))(index); }, &job);
+  }
+
+private:
+  using Trampoline = void (*)(void *context, int index);
+
+  void dispatch(int count, Trampoline call, void *context);
+  void workerLoop();
+
+  /// Claims and runs jobs of the current batch until none are left.
+  void claimJobs(Trampoline call, void *context, int count, bool resetArena);
+
+  std::vector<std::thread> threads;
+  std::mutex mutex;
+  std::condition_variable wake; ///< A batch was dispatched, or the pool stops.
+  std::condition_variable idle; ///< The last job of a batch finished, or a worker left it.
+
+  // Current batch, written under mutex while no worker is inside a batch
+  uint64_t generation = 0;
+  Trampoline batchCall = nullptr;
+  void *batchContext = nullptr;
+  int batchCount = 0;
+  int busyWorkers = 0; ///< Workers between joining a batch and running out of jobs.
+  bool stopping = false;
+
+  std::atomic<int> nextJob{0};
+  std::atomic<int> remainingJobs{0};
+};
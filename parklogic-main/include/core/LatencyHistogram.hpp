@@ -0,0 +1,81 @@
+#pragma once
+#include "config.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+
+/**
+ * @file LatencyHistogram.hpp
+ * @brief Fixed-size streaming histogram of durations with bounded relative error.
+ */
+
+/**
+ * @class LatencyHistogram
+ * @brief HDR-style log-linear histogram: constant memory, O(1) record, percentiles to ~3%.
+ *
+ * A value is counted in units of Config::Trips::RESOLUTION. Below 2 * HALF units every unit has its
+ * own bucket; above, each power of two is split into HALF linear sub-buckets, so a bucket is never
+ * wider than 1/HALF of the values it holds. Values above Config::Trips::MAX_DURATION are counted as
+ * that value. 640 buckets, 5 KB.
+ */
+class LatencyHistogram {
+  static constexpr float RESOLUTION = Config::Trips::RESOLUTION;
+  static constexpr uint64_t HALF = 32;
+  static constexpr uint64_t MAX_UNITS = (uint64_t)(Config::Trips::MAX_DURATION / RESOLUTION);
+  static constexpr int MAGNITUDES = std::bit_width(MAX_UNITS) - std::bit_width(2 * HALF - 1);
+  static constexpr size_t BUCKETS = 2 * HALF + (size_t)std::max(MAGNITUDES, 0) * HALF;
+
+public:
+  void record(float seconds) {
+    uint64_t units = (uint64_t)std::clamp(seconds / RESOLUTION, 0.0f, (float)MAX_UNITS);
+    counts[bucketOf(units)]++;
+    total++;
+    sum += seconds;
+    largest = std::max(largest, seconds);
+  }
+
+  /**
+   * @brief Value at or below which p percent of the recorded values lie (0 if none).
+   * @return The midpoint of the bucket holding that rank, never above the largest recorded value.
+   */
+  float percentile(double p) const {
+    if (total == 0)
+      return 0.0f;
+    uint64_t rank = std::max<uint64_t>(1, (uint64_t)std::ceil(std::clamp(p, 0.0, 100.0) / 100.0 * (double)total));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKETS; ++i) {
+      seen += counts[i];
+      if (seen >= rank)
+        return std::min(largest, (float)(midpointOf(i) * RESOLUTION));
+    }
+    return largest;
+  }
+
+  uint64_t count() const { return total; }
+  float mean() const { return total ? (float)(sum / (double)total) : 0.0f; }
+  float max() const { return largest; }
+
+private:
+  static size_t bucketOf(uint64_t units) {
+    if (units < 2 * HALF)
+      return (size_t)units;
+    int magnitude = std::bit_width(units) - std::bit_width(2 * HALF - 1); // >= 1
+    uint64_t sub = units >> magnitude;                                   // In [HALF, 2 * HALF)
+    return (size_t)(2 * HALF + (magnitude - 1) * HALF + (sub - HALF));
+  }
+
+  static double midpointOf(size_t bucket) {
+    if (bucket < 2 * HALF)
+      return (double)bucket + 0.5;
+    int magnitude = (int)((bucket - 2 * HALF) / HALF) + 1;
+    uint64_t sub = HALF + (bucket - 2 * HALF) % HALF;
+    return ((double)(sub << magnitude) + (double)((sub + 1) << magnitude)) / 2.0;
+  }
+
+  std::array<uint64_t, BUCKETS> counts{};
+  uint64_t total = 0;
+  double sum = 0.0;
+  float largest = 0.0f;
+};
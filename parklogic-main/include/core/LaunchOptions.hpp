@@ -0,0 +1,69 @@
+#pragma once
+#include "events/GameEvents.hpp"
+#include "systems/DemandScheduler.hpp"
+#include <cstdint>
+#include <string>
+
+/**
+ * @file LaunchOptions.hpp
+ * @brief Command line options.
+ */
+
+/**
+ * @enum LaunchMode
+ * @brief What the executable does after parsing its arguments.
+ */
+enum class LaunchMode {
+  Interactive, ///< Normal windowed game (default).
+  DES,         ///< Batch capacity study with the discrete-event simulator, no window.
+  ConvertTrace, ///< Convert a CSV gate log to the binary trace format and exit.
+  Playback,     ///< Open the trajectory viewer instead of the main menu.
+  Headless,     ///< Run the game simulation without a window (controlled via --control).
+  RenderBench,  ///< Render a seeded scene along a scripted camera path offscreen and report frame costs.
+  Plan          ///< Search the facility mixes for the cheapest ones that serve the demand (CapacityPlanner).
+};
+
+/**
+ * @struct LaunchOptions
+ * @brief Parsed command line.
+ *
+ * Usage: parklogic [--des] [--hours H] [--spawn-level L] [--demand P] [--seed S] [--map-seed S]
+ *                  [--small-parking N] [--large-parking N] [--small-charging N] [--large-charging N]
+ *                  [--trace FILE] [--convert-trace IN OUT] [--record FILE] [--playback FILE]
+ *                  [--telemetry NAME] [--headless] [--control SOCKET] [--shards N] [--heatmap FILE]
+ *                  [--no-governor] [--render-bench] [--plan] [--max-pass-through PCT]
+ */
+struct LaunchOptions {
+  LaunchMode mode = LaunchMode::Interactive;
+  MapConfig map;                ///< Layout for batch modes (the game uses the MapConfig scene instead).
+  int spawnLevel = 3;           ///< Auto-spawn level (1-5) for batch modes and the render benchmark.
+  std::string demand = "fixed"; ///< Demand profile: fixed, commuter or stress.
+  double hours = 24.0 * 7;      ///< Simulated horizon for batch modes.
+  uint64_t seed = 1;            ///< Seed for batch modes (also used as map seed unless overridden).
+  std::string trace;            ///< Gate log to replay (game and DES), or the conversion input.
+  std::string traceOutput;      ///< Conversion output (ConvertTrace mode).
+  std::string record;           ///< Trajectory file every game session writes (empty = off).
+  std::string playback;         ///< Trajectory file to view (Playback mode).
+  std::string telemetry;        ///< Shared memory name the game publishes live state to (empty = off).
+  std::string control;          ///< Unix socket path for runtime commands and queries (empty = off).
+  int shards = 0;               ///< Headless: split the map across this many processes (0 = single process).
+  std::string heatmap;          ///< CongestionMap dump written when the game scene ends (empty = off).
+  bool governor = true;         ///< Game: let the LoadGovernor shed work when ticks fall behind.
+  double maxPassThrough = 5.0;  ///< Planner: share of arrivals allowed to find no spot (%).
+
+  /**
+   * @brief Parses argv.
+   * @throws std::invalid_argument on unknown flags or malformed values.
+   */
+  static LaunchOptions Parse(int argc, char **argv);
+
+  /**
+   * @brief The arrival profile selected by --demand, scaled by --spawn-level.
+   */
+  DemandProfile demandProfile() const;
+
+  /**
+   * @brief Prints the usage text.
+   */
+  static void PrintUsage();
+};
@@ -1,4 +1,5 @@
 #pragma once
+#include <atomic>
 #include <format>
 #include <iostream>
 #include <mutex>
@@ -18,6 +19,13 @@ public:
    */
   enum class Level { Info, Warning, Error };
 
+  /**
+   * @brief Drops messages below the given level, e.g. while a batch mode builds hundreds of maps.
+   *
+   * @param level The lowest level still logged (Info logs everything, the default).
+   */
+  static void SetMinimumLevel(Level level) { minimumLevel.store(level, std::memory_order_relaxed); }
+
   /**
    * @brief Logs a raw message with a specific severity level.
    *
@@ -25,6 +33,8 @@ public:
    * @param message The message string.
    */
   static void Log(Level level, const std::string &message) {
+    if (level < minimumLevel.load(std::memory_order_relaxed))
+      return;
     std::scoped_lock lock(mutex);
     switch (level) {
     case Level::Info:
@@ -74,5 +84,6 @@ public:
   }
 
 private:
-  static inline std::mutex mutex; ///< Mutex for thread safety.
+  static inline std::mutex mutex;                             ///< Mutex for thread safety.
+  static inline std::atomic<Level> minimumLevel{Level::Info}; ///< See SetMinimumLevel.
 };
@@ -0,0 +1,72 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+/**
+ * @file MappedFile.hpp
+ * @brief Read-only memory mapping of a whole file.
+ */
+
+/**
+ * @class MappedFile
+ * @brief RAII wrapper around a read-only file mapping.
+ *
+ * The whole file is mapped at once (address space is cheap on 64-bit), and the page cache does the
+ * I/O. Long streaming readers call releaseBefore() with their read position so the pages behind
+ * them are dropped and the resident set stays constant no matter how large the file is. Random
+ * access users (e.g. the WorldChunkStore) drop and prefetch ranges with release() and prefetch().
+ */
+class MappedFile {
+public:
+  enum class Access { Sequential, Random };
+
+  /**
+   * @brief Maps a file.
+   * @param path File to open.
+   * @param access Expected access pattern (read-ahead hint).
+   * @throws std::runtime_error if the file cannot be opened or mapped.
+   */
+  explicit MappedFile(const std::string &path, Access access = Access::Sequential);
+  ~MappedFile();
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  const char *data() const { return base; }
+  size_t size() const { return length; }
+
+  /**
+   * @brief Hints that bytes before offset will not be read again.
+   *
+   * Drops the whole pages in [released, offset) from the process' resident set. A no-op where
+   * the platform has no such hint (the OS then trims clean file pages on its own).
+   */
+  void releaseBefore(size_t offset);
+
+  /**
+   * @brief Drops the whole pages inside [offset, offset + bytes) from the resident set.
+   *
+   * They are read back from the file on the next access. A no-op where the platform has no hint.
+   */
+  void release(size_t offset, size_t bytes);
+
+  /**
+   * @brief Starts reading [offset, offset + bytes) in ahead of use. A no-op where unsupported.
+   */
+  void prefetch(size_t offset, size_t bytes);
+
+  /// Granularity of release() and prefetch().
+  static size_t PageSize();
+
+private:
+  const char *base = nullptr;
+  size_t length = 0;
+  size_t released = 0; ///< Everything before this offset has been released already.
+
+#ifdef _WIN32
+  void *fileHandle = nullptr;
+  void *mappingHandle = nullptr;
+#else
+  int fd = -1;
+#endif
+};
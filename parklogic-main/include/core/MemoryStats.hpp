@@ -0,0 +1,130 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @file MemoryStats.hpp
+ * @brief Opt-in heap allocation accounting.
+ *
+ * Build with -DPARKLOGIC_TRACK_ALLOCATIONS=ON to replace the global operator new/delete with
+ * counting versions. Every allocation is attributed to the ProfileZone active on the calling
+ * thread. With tracking off, all of this compiles down to nothing.
+ *
+ * -DPARKLOGIC_ALLOC_STRICT=ON additionally turns the build into an allocation regression test:
+ * any steady-state tick (one without spawns, despawns, exits or scene changes) that allocates
+ * aborts the program with a per-zone breakdown.
+ *
+ * A tick window only counts the threads that run the tick: the one calling beginTick() and those
+ * that called joinTicks() (the JobPool workers). Allocations of other threads, such as the control
+ * socket's I/O thread or the forecaster, show up in the process totals only.
+ */
+
+/**
+ * @enum ProfileZone
+ * @brief Coarse attribution buckets for allocations.
+ */
+enum class ProfileZone : uint8_t { Other, CarUpdate, TrafficHandler, PathPlanning, EventDispatch, Rendering, Count };
+
+class MemoryStats {
+public:
+#ifdef PARKLOGIC_TRACK_ALLOCATIONS
+  static constexpr bool Enabled = true;
+#else
+  static constexpr bool Enabled = false;
+#endif
+
+  static constexpr size_t ZoneCount = static_cast<size_t>(ProfileZone::Count);
+
+  struct ZoneCounters {
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+  };
+
+  /**
+   * @struct Report
+   * @brief Allocation activity over one tick or one frame, or a sum of them.
+   */
+  struct Report {
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+    std::array<ZoneCounters, ZoneCount> zones{};
+
+    void add(const Report &other);
+  };
+
+  // --- Tick / Frame windows ---
+  static void beginTick(); ///< Also makes the calling thread count towards tick windows.
+  static void endTick();
+  static void beginFrame();
+  static void endFrame();
+
+  /**
+   * @brief Exempts the current tick from the strict steady-state check.
+   *
+   * Called by code that legitimately allocates (spawning, despawning, path assignment, scene changes).
+   */
+  static void markTickEventful();
+
+  /**
+   * @brief Counts the calling thread's allocations towards the tick windows from now on.
+   *
+   * For threads that run parts of a tick on behalf of the ticking thread.
+   */
+  static void joinTicks() { tickThread = true; }
+
+  static const Report &getLastTick();
+  static const Report &getLastFrame();
+  static const Report &getTickTotals(); ///< All tick windows so far, summed.
+
+  // --- Process Totals ---
+  static uint64_t getTotalAllocations();
+  static int64_t getLiveBytes();
+  static int64_t getPeakLiveBytes();
+  static Report getTotals(); ///< Everything allocated so far, by any thread.
+  static Report Since(const Report &totals); ///< getTotals() minus an earlier getTotals().
+
+  static const char *ZoneName(ProfileZone zone);
+
+  /**
+   * @brief One-line summary of a report, used by logs and benchmark output.
+   */
+  static std::string FormatReport(const Report &report);
+
+  // --- Hooks (called from the replacement operator new/delete) ---
+  static void recordAllocation(size_t bytes);
+  static void recordDeallocation(size_t bytes);
+
+  static ProfileZone getCurrentZone() { return currentZone; }
+  static void setCurrentZone(ProfileZone zone) { currentZone = zone; }
+
+private:
+  static inline thread_local ProfileZone currentZone = ProfileZone::Other;
+  static inline thread_local bool tickThread = false; ///< See joinTicks().
+};
+
+/**
+ * @class ProfileZoneScope
+ * @brief RAII guard that attributes allocations in its scope to a zone.
+ */
+class ProfileZoneScope {
+public:
+  explicit ProfileZoneScope(ProfileZone zone) {
+    if constexpr (MemoryStats::Enabled) {
+      previous = MemoryStats::getCurrentZone();
+      MemoryStats::setCurrentZone(zone);
+    }
+  }
+  ~ProfileZoneScope() {
+    if constexpr (MemoryStats::Enabled) {
+      MemoryStats::setCurrentZone(previous);
+    }
+  }
+
+  ProfileZoneScope(const ProfileZoneScope &) = delete;
+  ProfileZoneScope &operator=(const ProfileZoneScope &) = delete;
+
+private:
+  ProfileZone previous = ProfileZone::Other;
+};
@@ -0,0 +1,92 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @file RenderStats.hpp
+ * @brief Opt-in per-pass frame cost accounting for the render benchmark.
+ *
+ * Off unless RenderStats::Enable() was called, which only the render benchmark does. Then every
+ * RenderPassScope flushes raylib's batch on entry and exit, so the draw calls the batch issues
+ * land in the pass that queued their geometry, and the scope's wall time includes that
+ * submission. Draw calls and texture binds are counted where rlgl hands them to GL.
+ */
+
+/**
+ * @enum RenderPass
+ * @brief What a frame spends its time on. Other collects everything outside the passes below
+ * (camera mode switches, the blit of the logical render target, the buffer swap).
+ */
+enum class RenderPass : uint8_t { Other, WorldTiles, Modules, Cars, Overlay, HUD, Count };
+
+class RenderStats {
+public:
+  static constexpr size_t PassCount = static_cast<size_t>(RenderPass::Count);
+
+  struct PassCounters {
+    double millis = 0.0;
+    uint32_t drawCalls = 0;    ///< glDrawArrays / glDrawElements calls.
+    uint32_t textureBinds = 0; ///< glBindTexture calls that changed the bound texture.
+  };
+
+  /**
+   * @struct Frame
+   * @brief Cost of one frame; the pass times add up to millis.
+   */
+  struct Frame {
+    double millis = 0.0;
+    std::array<PassCounters, PassCount> passes{};
+
+    uint32_t drawCalls() const;
+    uint32_t textureBinds() const;
+  };
+
+  /**
+   * @brief Starts counting: wraps rlgl's GL draw and bind entry points.
+   *
+   * Needs a live GL context (after InitWindow). Relies on raylib's desktop OpenGL backend, which
+   * calls GL through glad's function pointers.
+   */
+  static void Enable();
+  static bool IsEnabled() { return enabled; }
+
+  static void beginFrame();
+  static const Frame &endFrame();
+
+  static const char *PassName(RenderPass pass);
+
+  // --- Hooks (called from the GL wrappers) ---
+  static void countDraw() { frame.passes[(size_t)currentPass].drawCalls++; }
+  static void countBind() { frame.passes[(size_t)currentPass].textureBinds++; }
+
+private:
+  friend class RenderPassScope;
+
+  static bool enabled;
+  static RenderPass currentPass;
+  static Frame frame;
+  static std::chrono::steady_clock::time_point frameStart;
+};
+
+/**
+ * @class RenderPassScope
+ * @brief RAII guard that attributes the frame time and GL calls in its scope to a pass.
+ *
+ * Costs one branch while RenderStats is off. Scopes of the same pass may repeat within a frame
+ * (their costs add up); they should not nest.
+ */
+class RenderPassScope {
+public:
+  explicit RenderPassScope(RenderPass pass);
+  ~RenderPassScope();
+
+  RenderPassScope(const RenderPassScope &) = delete;
+  RenderPassScope &operator=(const RenderPassScope &) = delete;
+
+private:
+  bool active = false;
+  RenderPass previous = RenderPass::Other;
+  std::chrono::steady_clock::time_point start{};
+};
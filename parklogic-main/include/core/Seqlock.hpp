@@ -0,0 +1,49 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * @file Seqlock.hpp
+ * @brief Single-writer snapshot cell whose writer never waits.
+ */
+
+/**
+ * @class Seqlock
+ * @brief Publishes a small trivially copyable value from one thread to any number of readers.
+ *
+ * store() is wait-free: it bumps the sequence to odd, copies the value and bumps it to even.
+ * load() retries until it copied the value without a store() in between, so readers pay for
+ * contention and the writer (the simulation tick) never does. Same protocol as the shared memory
+ * slots in TelemetryLayout.hpp.
+ */
+template <typename T> class Seqlock {
+  static_assert(std::is_trivially_copyable_v<T>, "Seqlock values are copied bytewise");
+
+public:
+  void store(const T &value) {
+    uint64_t s = sequence.load(std::memory_order_relaxed);
+    sequence.store(s + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(&data, &value, sizeof(T));
+    sequence.store(s + 2, std::memory_order_release);
+  }
+
+  T load() const {
+    T copy;
+    while (true) {
+      uint64_t before = sequence.load(std::memory_order_acquire);
+      if (before & 1)
+        continue;
+      std::memcpy(&copy, &data, sizeof(T));
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (sequence.load(std::memory_order_relaxed) == before)
+        return copy;
+    }
+  }
+
+private:
+  alignas(64) std::atomic<uint64_t> sequence{0};
+  T data{};
+};
@@ -0,0 +1,43 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+/**
+ * @file SharedMemory.hpp
+ * @brief Named, writable shared memory region.
+ */
+
+/**
+ * @class SharedMemory
+ * @brief RAII owner of a named shared memory segment (POSIX shm_open / Win32 named mapping).
+ *
+ * The creating process owns the name: the segment is zero-filled on creation and the name is
+ * removed again on destruction (readers that are still attached keep their mapping).
+ */
+class SharedMemory {
+public:
+  /**
+   * @brief Creates (or takes over a stale) segment and maps it read/write.
+   * @param name Segment name, e.g. "/parklogic" (the leading slash is added if missing).
+   * @param size Size in bytes.
+   * @throws std::runtime_error if the segment cannot be created or mapped.
+   */
+  SharedMemory(std::string name, size_t size);
+  ~SharedMemory();
+
+  SharedMemory(const SharedMemory &) = delete;
+  SharedMemory &operator=(const SharedMemory &) = delete;
+
+  void *data() const { return base; }
+  size_t size() const { return length; }
+  const std::string &getName() const { return name; }
+
+private:
+  std::string name;
+  void *base = nullptr;
+  size_t length = 0;
+
+#ifdef _WIN32
+  void *mappingHandle = nullptr;
+#endif
+};
@@ -0,0 +1,77 @@
+#pragma once
+#include "config.hpp"
+#include "core/JobPool.hpp"
+#include "raylib.h"
+#include <algorithm>
+#include <vector>
+
+/**
+ * @file SpriteBatch.hpp
+ * @brief Sprite quads built in parallel and submitted to raylib's batch in one pass.
+ */
+
+/**
+ * @struct SpriteQuad
+ * @brief One textured quad in render coordinates, ready to submit. Covers its whole texture.
+ */
+struct SpriteQuad {
+  unsigned int texture = 0; ///< GL texture id; 0 skips the quad (culled, or no texture).
+  Vector2 topLeft;
+  Vector2 bottomLeft;
+  Vector2 bottomRight;
+  Vector2 topRight;
+};
+
+/**
+ * @class SpriteBatch
+ * @brief Replaces one DrawTexturePro per sprite with a parallel build and a serial submission.
+ *
+ * build() sizes the quad list for one slot per sprite and has the JobPool fill it in chunks of
+ * Config::Render::SPRITES_PER_JOB: culling, the rotation's sine and cosine and the four corners.
+ * Each job writes only its own slots, so nothing is shared or merged and the draw order stays the
+ * order of the source list. submit() then streams the corners into rlgl on the calling thread,
+ * switching texture only where consecutive quads differ. The list keeps its capacity, so frames
+ * after the largest one so far do not allocate.
+ */
+class SpriteBatch {
+public:
+  /**
+   * @brief Rebuilds the batch with count quads.
+   * @param pool Runs the chunks; nullptr builds on the calling thread.
+   * @param quad Callable (int index, SpriteQuad &out) filling the quad of sprite index. Jobs of one
+   *        build run concurrently, so it may only read shared state.
+   */
+  template <typename Build> void build(JobPool *pool, int count, Build &&quad) {
+    quads.resize((size_t)count);
+    const int chunks = (count + SPRITES_PER_JOB - 1) / SPRITES_PER_JOB;
+    auto job = [&](int chunk) {
+      int end = std::min(count, (chunk + 1) * SPRITES_PER_JOB);
+      for (int i = chunk * SPRITES_PER_JOB; i < end; ++i) {
+        quads[i] = SpriteQuad{};
+        quad(i, quads[i]);
+      }
+    };
+    if (pool)
+      pool->run(chunks, job);
+    else
+      for (int chunk = 0; chunk < chunks; ++chunk)
+        job(chunk);
+  }
+
+  /**
+   * @brief Queues the built quads with raylib, in build order. Call on the thread owning the GL context.
+   */
+  void submit() const;
+
+  /**
+   * @brief The quad DrawTexturePro would draw for the whole of a texture, without drawing it.
+   * @param dest Position and size in render coordinates; rotation turns it about dest.x/y + origin.
+   * @param rotation Degrees, clockwise on screen.
+   */
+  static SpriteQuad Quad(const Texture2D &texture, Rectangle dest, Vector2 origin, float rotation);
+
+private:
+  static constexpr int SPRITES_PER_JOB = Config::Render::SPRITES_PER_JOB;
+
+  std::vector<SpriteQuad> quads;
+};
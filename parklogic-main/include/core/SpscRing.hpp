@@ -0,0 +1,62 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * @file SpscRing.hpp
+ * @brief Bounded lock-free queue between exactly one producer and one consumer.
+ */
+
+/**
+ * @class SpscRing
+ * @brief Fixed-capacity ring of trivially copyable items, usable across processes.
+ *
+ * The object holds no pointers, so it can be placement-constructed in shared memory and used by
+ * two processes mapping it. The producer only writes tail, the consumer only writes head; each
+ * sits on its own cache line. Neither side ever blocks: tryPush reports a full ring, front
+ * reports an empty one.
+ *
+ * @tparam T Item type (copied bytewise).
+ * @tparam Capacity Number of slots, a power of two.
+ */
+template <typename T, size_t Capacity> class SpscRing {
+  static_assert(std::is_trivially_copyable_v<T>, "SpscRing items are copied bytewise");
+  static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "SpscRing capacity must be a power of two");
+  static_assert(std::atomic<uint64_t>::is_always_lock_free, "Cross-process rings need address-free atomics");
+
+public:
+  /**
+   * @brief Appends an item (producer).
+   * @return false if the ring is full.
+   */
+  bool tryPush(const T &item) {
+    uint64_t t = tail.load(std::memory_order_relaxed);
+    if (t - head.load(std::memory_order_acquire) == Capacity)
+      return false;
+    items[t & (Capacity - 1)] = item;
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Oldest item without removing it (consumer), or nullptr if the ring is empty.
+   */
+  const T *front() const {
+    uint64_t h = head.load(std::memory_order_relaxed);
+    if (h == tail.load(std::memory_order_acquire))
+      return nullptr;
+    return &items[h & (Capacity - 1)];
+  }
+
+  /**
+   * @brief Removes the item returned by front() (consumer).
+   */
+  void pop() { head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+private:
+  alignas(64) std::atomic<uint64_t> head{0}; ///< Next slot to read (consumer).
+  alignas(64) std::atomic<uint64_t> tail{0}; ///< Next slot to write (producer).
+  alignas(64) T items[Capacity];
+};
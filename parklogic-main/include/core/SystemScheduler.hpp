@@ -0,0 +1,121 @@
+#pragma once
+#include "config.hpp"
+#include "core/JobPool.hpp"
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+/**
+ * @file SystemScheduler.hpp
+ * @brief Explicit per-tick ordering, rates and parallelism of the simulation systems.
+ */
+
+/**
+ * @class SystemScheduler
+ * @brief Runs the systems of a scene once per tick in a dependency graph built from what they declare.
+ *
+ * Each system declares a Stage, the shared state it reads and writes (Resource bits) and how often
+ * it runs. A system depends on every system of an earlier stage, or of the same stage and added
+ * before it, whose accesses conflict with its own (one writes what the other reads or writes).
+ * Systems that do not conflict run concurrently on the JobPool, whatever their stage.
+ *
+ * A system with a rate below Config::TICK_RATE runs every TICK_RATE / rate ticks. Systems sharing
+ * a period get different tick offsets, so low-rate work does not pile up on one tick. Its update
+ * receives the simulated time since it last ran, not the tick length.
+ *
+ * Every run is timed. report() logs the mean and worst wall time per stage and per system.
+ */
+class SystemScheduler {
+public:
+  enum class Stage : uint8_t {
+    Input,       ///< Camera and other per-frame controls.
+    Simulation,  ///< Car motion and what follows it directly (chunk residency, statistics).
+    Traffic,     ///< Spawning, spot assignment, parking and exits.
+    Bookkeeping, ///< Aggregates read by the HUD and reports.
+    Count
+  };
+
+  /// Shared state a system may touch, as bits of a read or write set.
+  enum Resource : uint32_t {
+    CARS = 1u << 0,       ///< The car list and every car's state.
+    FACILITIES = 1u << 1, ///< Spot states, prices and the modules list.
+    DEMAND = 1u << 2,     ///< Arrival queues and the spawn level.
+    VIEW = 1u << 3,       ///< Camera target and the visible area.
+    CHUNKS = 1u << 4,     ///< Background chunk residency.
+    HUD = 1u << 5,        ///< Cached dashboard figures.
+  };
+
+  struct System {
+    const char *name;
+    Stage stage;
+    uint32_t reads;
+    uint32_t writes;
+    int rate = Config::TICK_RATE; ///< Runs per simulated second; Config::TICK_RATE = every tick.
+    std::function<void(double dt)> update;
+  };
+
+  /**
+   * @param workers Threads of the job pool; 0 runs everything on the ticking thread.
+   */
+  explicit SystemScheduler(int workers = DefaultWorkers());
+
+  SystemScheduler(const SystemScheduler &) = delete;
+  SystemScheduler &operator=(const SystemScheduler &) = delete;
+
+  /**
+   * @brief Threads worth starting on this machine (Config::Scheduler::MAX_WORKERS at most).
+   */
+  static int DefaultWorkers();
+
+  /**
+   * @brief Registers a system; call before the first tick.
+   * @throws std::length_error beyond Config::Scheduler::MAX_SYSTEMS systems.
+   */
+  void add(System system);
+
+  /**
+   * @brief Runs every system due this tick, wave by wave, and returns when all are done.
+   * @param dt Simulated time of one tick.
+   */
+  void tick(double dt);
+
+  /**
+   * @brief Logs the timings gathered since construction.
+   */
+  void report() const;
+
+  static const char *StageName(Stage stage);
+
+  /// The workers that run the systems; idle between ticks, so others may run batches there too.
+  JobPool &getPool() { return pool; }
+
+private:
+  struct Timing {
+    uint64_t runs = 0;
+    double totalMicros = 0.0;
+    double worstMicros = 0.0;
+
+    void add(double micros);
+  };
+
+  struct Entry {
+    System system;
+    uint32_t dependencies = 0; ///< Bit i: system i must finish first when both run.
+    int period = 1;            ///< Ticks between runs.
+    int phase = 0;             ///< Tick offset within the period.
+    double elapsed = 0.0;      ///< Simulated time since the last run.
+    double lastMicros = 0.0;   ///< Wall time of the latest run.
+    Timing timing;
+  };
+
+  void run(Entry &entry);
+
+  std::vector<Entry> entries;
+  std::array<Timing, (size_t)Stage::Count> stageTimings{};
+  std::array<int, Config::Scheduler::MAX_SYSTEMS> wave{};
+  uint64_t ticks = 0;
+  int lowRateSystems = 0;
+  JobPool pool;
+};
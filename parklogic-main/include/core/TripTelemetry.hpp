@@ -0,0 +1,120 @@
+#pragma once
+#include "config.hpp"
+#include "core/LatencyHistogram.hpp"
+#include "core/SpscRing.hpp"
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @file TripTelemetry.hpp
+ * @brief Per-trip milestone timestamps and streaming latency percentiles.
+ */
+
+/// Points in a car's trip, in the order a parking trip passes them.
+enum class TripMilestone : uint8_t {
+  Spawn,
+  PathAssigned, ///< A spot was reserved and a path to it planned.
+  PassThrough,  ///< No spot was found; the car drives on to the map edge.
+  GateEntry,    ///< Passed the facility gate on the way in.
+  SpotArrival,  ///< Reached its spot and started ALIGNING.
+  Parked,
+  ExitStart,
+  Despawn,
+  Removed, ///< Taken off the map by the StuckWatchdog instead of despawning.
+  Count
+};
+
+/**
+ * @class TripTelemetry
+ * @brief Turns trip milestones into live p50/p90/p99 of trip phase durations.
+ *
+ * Each car keeps its own Stamps (trip clock and the clock at every milestone reached, inline in
+ * the Car, so no per-car allocation). Record() stamps a milestone and pushes a copy of the stamps
+ * into a fixed SpscRing: the simulation thread is the only producer, and the owner drains the
+ * ring into one LatencyHistogram per metric between ticks (drain()). A full ring drops the event
+ * and counts it.
+ *
+ * Metrics, each closed by one milestone:
+ * - TimeToPark: Spawn to Parked.
+ * - Search: Spawn to GateEntry (finding a spot and driving to its facility).
+ * - Maneuver: GateEntry to Parked (aisle, alignment and rotation into the stall).
+ * - Exit: ExitStart to Despawn.
+ * - PassThrough: Spawn to Despawn of cars that found no spot.
+ *
+ * Every trip ends in Despawn or Removed; a removed car's stall closes no metric.
+ */
+class TripTelemetry {
+public:
+  enum class Metric { TimeToPark, Search, Maneuver, Exit, PassThrough, Count };
+
+  static constexpr int MILESTONES = (int)TripMilestone::Count;
+  static constexpr int METRICS = (int)Metric::Count;
+
+  /**
+   * @struct Stamps
+   * @brief A car's trip so far; held by the Car and carried across shard hand-overs.
+   */
+  struct Stamps {
+    float clock = 0.0f;                  ///< Seconds since Spawn, advanced by the car every tick.
+    std::array<float, MILESTONES> at{};  ///< clock when each milestone was reached, -1 = not yet.
+
+    Stamps() { at.fill(-1.0f); }
+    bool reached(TripMilestone m) const { return at[(int)m] >= 0.0f; }
+    float since(TripMilestone from, TripMilestone to) const { return at[(int)to] - at[(int)from]; }
+  };
+
+  struct Event {
+    uint32_t carId;
+    TripMilestone milestone;
+    Stamps stamps; ///< As of this milestone.
+  };
+
+  TripTelemetry() = default;
+  ~TripTelemetry();
+
+  TripTelemetry(const TripTelemetry &) = delete;
+  TripTelemetry &operator=(const TripTelemetry &) = delete;
+
+  /**
+   * @brief Starts a fresh set of statistics and makes this the telemetry Record() feeds.
+   */
+  void attach();
+
+  /**
+   * @brief Stops feeding this telemetry; Record() only stamps until the next attach.
+   */
+  void detach();
+
+  /**
+   * @brief Stamps a milestone on a car's trip and queues the event. Simulation thread only.
+   *
+   * A milestone already reached keeps its first stamp and is not reported again.
+   */
+  static void Record(uint32_t carId, Stamps &stamps, TripMilestone milestone);
+
+  /**
+   * @brief Feeds every queued event into the histograms (the ring's consumer).
+   */
+  void drain();
+
+  const LatencyHistogram &histogram(Metric metric) const { return histograms[(int)metric]; }
+  uint64_t getCount(TripMilestone milestone) const { return counts[(int)milestone]; }
+  uint64_t getDropped() const { return dropped.load(std::memory_order_relaxed); }
+  static const char *MetricName(Metric metric);
+
+  /**
+   * @brief Logs one p50/p90/p99 line per metric and the milestone totals.
+   */
+  void report() const;
+
+private:
+  void record(Metric metric, float seconds) { histograms[(int)metric].record(seconds); }
+
+  SpscRing<Event, Config::Trips::EVENT_RING> ring;
+  std::array<LatencyHistogram, METRICS> histograms{};
+  std::array<uint64_t, MILESTONES> counts{};
+  std::atomic<uint64_t> dropped{0};
+
+  static inline std::atomic<TripTelemetry *> active{nullptr};
+};
@@ -16,8 +16,10 @@ public:
    * @brief Constructs the Window.
    *
    * @param bus Shared pointer to the EventBus for publishing window events.
+   * @param offscreen Hidden, fixed-size window without vsync or frame cap (render benchmark).
+   *        Prefers a software GL driver unless LIBGL_ALWAYS_SOFTWARE is already set.
    */
-  explicit Window(std::shared_ptr<EventBus> bus);
+  explicit Window(std::shared_ptr<EventBus> bus, bool offscreen = false);
 
   /**
    * @brief Destructor.
@@ -65,8 +67,9 @@ public:
 private:
   /**
    * @brief Initializes the Raylib window with configuration settings.
+   * @param offscreen See the constructor.
    */
-  void initRaylib();
+  void initRaylib(bool offscreen);
 
   /**
    * @brief Updates the window dimensions and scale based on current window size.
@@ -0,0 +1,121 @@
+#pragma once
+#include "config.hpp"
+#include "raylib.h"
+#include <cmath>
+#include <cstdint>
+
+/**
+ * @file WorldCoord.hpp
+ * @brief World positions with the same precision everywhere on the map.
+ */
+
+/**
+ * @struct WorldCoord
+ * @brief A position as an integer chunk plus a float offset (meters) inside that chunk.
+ *
+ * A float holding meters from the map corner resolves about 1 mm at 10 km and 2 mm at 30 km, and
+ * integrating a 0.25 m step every tick rounds by that much each time, so the error grows with
+ * the map until it rivals the 0.2 m spot tolerance. Here the float part never leaves
+ * [0, CHUNK_SIZE), so it resolves the same ~15 um anywhere.
+ *
+ * Positions are not added to each other. The difference of two positions is a plain float
+ * Vector2, and a position moves by adding a float Vector2; steering, avoidance and path geometry
+ * therefore keep their float math and only renormalize the chunk when a position is updated.
+ *
+ * Rendering works the same way: draw code converts with toRender(), i.e. relative to a floating
+ * origin the camera keeps near what is on screen, so the float vertices stay small too.
+ */
+struct WorldCoord {
+  static constexpr float CHUNK_SIZE = Config::World::CHUNK_SIZE;
+
+  int32_t chunkX = 0;
+  int32_t chunkY = 0;
+  Vector2 local = {0, 0}; ///< Meters inside the chunk, each component in [0, CHUNK_SIZE).
+
+  /**
+   * @brief Position from meters measured from the world's top-left corner.
+   */
+  static WorldCoord FromMeters(double x, double y) {
+    WorldCoord c;
+    double cx = std::floor(x / CHUNK_SIZE);
+    double cy = std::floor(y / CHUNK_SIZE);
+    c.chunkX = (int32_t)cx;
+    c.chunkY = (int32_t)cy;
+    c.local = {(float)(x - cx * CHUNK_SIZE), (float)(y - cy * CHUNK_SIZE)};
+    c.normalize(); // Rounding to float may land exactly on CHUNK_SIZE
+    return c;
+  }
+
+  /// Meters from the world's top-left corner. For bounds, seams and reports; not for geometry.
+  double x() const { return (double)chunkX * CHUNK_SIZE + local.x; }
+  double y() const { return (double)chunkY * CHUNK_SIZE + local.y; }
+
+  WorldCoord &operator+=(Vector2 offset) {
+    local.x += offset.x;
+    local.y += offset.y;
+    normalize();
+    return *this;
+  }
+
+  friend WorldCoord operator+(WorldCoord c, Vector2 offset) { return c += offset; }
+
+  /**
+   * @brief Offset from b to a. Exact chunk arithmetic first, so nearby points keep full precision.
+   */
+  friend Vector2 operator-(const WorldCoord &a, const WorldCoord &b) {
+    return {(float)(a.chunkX - b.chunkX) * CHUNK_SIZE + (a.local.x - b.local.x),
+            (float)(a.chunkY - b.chunkY) * CHUNK_SIZE + (a.local.y - b.local.y)};
+  }
+
+  static float Distance(const WorldCoord &a, const WorldCoord &b) {
+    Vector2 d = a - b;
+    return std::sqrt(d.x * d.x + d.y * d.y);
+  }
+
+  static WorldCoord Lerp(const WorldCoord &a, const WorldCoord &b, float t) {
+    Vector2 d = b - a;
+    return a + Vector2{d.x * t, d.y * t};
+  }
+
+  // --- Floating render origin ---
+
+  /**
+   * @brief Moves the render origin to the corner of the chunk holding focus (the camera target).
+   */
+  static void SetRenderOrigin(const WorldCoord &focus) {
+    renderOrigin = WorldCoord{focus.chunkX, focus.chunkY, {0, 0}};
+  }
+  static const WorldCoord &RenderOrigin() { return renderOrigin; }
+
+  /// Render-space position (meters from the render origin) for raylib draw calls.
+  Vector2 toRender() const { return *this - renderOrigin; }
+
+  /// Inverse of toRender, e.g. for a mouse position unprojected by GetScreenToWorld2D.
+  static WorldCoord FromRender(Vector2 p) { return renderOrigin + p; }
+
+private:
+  void normalize() {
+    if (local.x < 0.0f || local.x >= CHUNK_SIZE) {
+      float shift = std::floor(local.x / CHUNK_SIZE);
+      chunkX += (int32_t)shift;
+      local.x -= shift * CHUNK_SIZE;
+      if (local.x >= CHUNK_SIZE) { // -tiny + CHUNK_SIZE rounds up to CHUNK_SIZE
+        local.x -= CHUNK_SIZE;
+        chunkX++;
+      }
+    }
+    if (local.y < 0.0f || local.y >= CHUNK_SIZE) {
+      float shift = std::floor(local.y / CHUNK_SIZE);
+      chunkY += (int32_t)shift;
+      local.y -= shift * CHUNK_SIZE;
+      if (local.y >= CHUNK_SIZE) {
+        local.y -= CHUNK_SIZE;
+        chunkY++;
+      }
+    }
+  }
+
+  static WorldCoord renderOrigin;
+};
+
+inline WorldCoord WorldCoord::renderOrigin{};
@@ -0,0 +1,87 @@
+#pragma once
+#include "config.hpp"
+#include "raylib.h"
+
+/**
+ * @file AvoidanceKernel.hpp
+ * @brief Batched collision-avoidance forces of one car against its neighbors.
+ */
+
+/**
+ * @class AvoidanceKernel
+ * @brief Evaluates the avoidance force terms over a batch of gathered neighbors.
+ *
+ * Car::updateWithNeighbors gathers the moving cars within its look-ahead into a NeighborBatch
+ * (structure of arrays: offset from the car, speed, heading) and hands it over whenever it fills
+ * up. Per neighbor, in gather order (see Config::CarAI::Avoidance):
+ * - Frontal corridor: ahead, closer than the look-ahead, within LANE_HALF_WIDTH of the heading line.
+ *   There: braking that grows with the square of the closing gap; a side-step away from a car
+ *   coming the other way (or from any car while crawling); braking to match a slower car's speed.
+ * - Repulsion: closer than REPULSION_RADIUS in any direction, push apart.
+ *
+ * With PARKLOGIC_SIMD on x86-64 (GCC or Clang), CPUs with AVX2 evaluate 8 neighbors per step; the
+ * rest use the scalar path. Both use only correctly rounded operations (no FMA contraction, no
+ * reciprocal estimates), so every term comes out the same. By default the AVX2 path sums per
+ * lane and reduces at the end, which can differ from the scalar sum in the last bits. Built with
+ * PARKLOGIC_DETERMINISTIC it adds the lanes' terms in neighbor order instead, and the accumulated
+ * forces match the scalar path bit for bit.
+ */
+class AvoidanceKernel {
+public:
+  /**
+   * @struct Self
+   * @brief The car doing the avoiding.
+   */
+  struct Self {
+    Vector2 heading;
+    Vector2 side; ///< Heading turned 90 degrees clockwise on screen.
+    float speed;
+    float lookAhead;
+  };
+
+  /**
+   * @struct NeighborBatch
+   * @brief Gathered neighbors, one array per component. Lives on the stack; never allocates.
+   */
+  struct NeighborBatch {
+    static constexpr int CAPACITY = Config::CarAI::Avoidance::NEIGHBOR_BATCH;
+    static_assert(CAPACITY % 8 == 0, "the AVX2 path reads whole groups of 8");
+
+    alignas(32) float offsetX[CAPACITY]; ///< Neighbor position minus the car's (m).
+    alignas(32) float offsetY[CAPACITY];
+    alignas(32) float speed[CAPACITY];
+    alignas(32) float headingX[CAPACITY];
+    alignas(32) float headingY[CAPACITY];
+    int count = 0;
+
+    bool full() const { return count == CAPACITY; }
+    void push(Vector2 offset, float neighborSpeed, Vector2 neighborHeading) {
+      offsetX[count] = offset.x;
+      offsetY[count] = offset.y;
+      speed[count] = neighborSpeed;
+      headingX[count] = neighborHeading.x;
+      headingY[count] = neighborHeading.y;
+      count++;
+    }
+  };
+
+  /**
+   * @struct Totals
+   * @brief What the neighbors add up to; carried across batches.
+   */
+  struct Totals {
+    Vector2 acceleration;      ///< The car's acceleration; the forces are added to it.
+    float braking = 0.0f;      ///< Braking and speed matching, for the CongestionMap.
+    bool sideStepped = false;
+  };
+
+  /**
+   * @brief Adds the batch's forces to totals and empties the batch.
+   */
+  static void Accumulate(const Self &self, NeighborBatch &batch, Totals &totals);
+
+  /**
+   * @brief The path Accumulate takes on this CPU and build, for the logs.
+   */
+  static const char *Name();
+};
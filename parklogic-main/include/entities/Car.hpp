@@ -1,8 +1,11 @@
 #pragma once
+#include "core/TripTelemetry.hpp"
 #include "entities/Entity.hpp"
 #include "raylib.h"
+#include <cstdint>
 #include <deque>
 #include <memory>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -29,7 +32,7 @@ public:
    * @param world Pointer to the game world for bounds checking.
    * @param type The type of car (Combustion or Electric).
    */
-  Car(Vector2 startPos, const class World *world, Vector2 initialVelocity, CarType type);
+  Car(WorldCoord startPos, const class World *world, Vector2 initialVelocity, CarType type);
 
   /**
    * @brief Updates the car's physics and logic.
@@ -43,8 +46,10 @@ public:
    *
    * @param dt Delta time in seconds.
    * @param cars Pointer to the list of other cars for collision avoidance.
+   * @param ghosts Read-only copies of cars simulated by a neighbouring shard (avoided, not updated).
    */
-  void updateWithNeighbors(double dt, const std::vector<std::unique_ptr<Car>> *cars = nullptr);
+  void updateWithNeighbors(double dt, const std::vector<std::unique_ptr<Car>> *cars = nullptr,
+                           std::span<const std::unique_ptr<Car>> ghosts = {});
 
   /**
    * @brief Draws the car and its debug info (waypoints, velocity).
@@ -53,6 +58,33 @@ public:
   void draw(bool showPath);
   void draw() override { draw(false); }
 
+  /**
+   * @brief Draws the waypoints still ahead, as draw(true) does below the sprite.
+   */
+  void drawPath() const;
+
+  /**
+   * @brief Draws a car sprite without a Car instance (shared with the trajectory playback).
+   * @param textureName Asset name of the car sprite.
+   * @param position Center in render space (see WorldCoord::toRender).
+   * @param rotation Degrees, 0 = facing up.
+   */
+  static void DrawSprite(const std::string &textureName, Vector2 position, float rotation);
+
+  /**
+   * @brief The quad DrawSprite draws, for a SpriteBatch; an empty quad if the texture is missing. Thread-safe.
+   */
+  static struct SpriteQuad SpriteQuadAt(const std::string &textureName, Vector2 position, float rotation);
+
+  /**
+   * @brief Stable identifier assigned by the EntityManager (0 = unassigned).
+   */
+  uint32_t getId() const { return id; }
+  void setId(uint32_t newId) { id = newId; }
+
+  float getRotation() const { return currentRotation; }
+  const std::string &getTextureName() const { return textureName; }
+
   // --- State Management ---
   enum class CarState { DRIVING, ALIGNING, PARKED, EXITING };
 
@@ -72,23 +104,51 @@ public:
   /**
    * @brief Sets the entire path of waypoints.
    *
-   * @param path Vector of waypoints.
+   * The waypoints are copied, so the source may be transient (e.g. a PathPlanner result).
+   *
+   * @param path Ordered waypoints.
    */
-  void setPath(const std::vector<Waypoint> &path);
+  void setPath(std::span<const Waypoint> path);
 
   /**
    * @brief Clears all waypoints.
    */
   void clearWaypoints();
 
-  Vector2 getPosition() const { return position; }
+  const WorldCoord &getPosition() const { return position; }
   Vector2 getVelocity() const { return velocity; }
   void setVelocity(Vector2 v) { velocity = v; }
 
+  /**
+   * @brief Overwrites the kinematic state (ghost copies of cars owned by another shard).
+   */
+  void setPose(const WorldCoord &newPosition, Vector2 newVelocity, float rotation);
+
   bool isReadyToLeave() const { return state == CarState::PARKED && parkingTimer <= 0.0f; }
+  float getParkingTimer() const { return parkingTimer; } ///< Seconds left PARKED (unused while charging).
 
   bool hasArrived() const { return waypoints.empty(); }
 
+  /**
+   * @brief Seconds since the car last reached a waypoint, got a new path or covered
+   *        Config::Watchdog::PROGRESS_DISTANCE (see StuckWatchdog).
+   */
+  float getStalledSeconds() const { return trip.clock - progressAt; }
+
+  /**
+   * @brief Lets the car drive on without braking or steering for other cars for a while.
+   *
+   * Others still avoid it, so of two cars blocking each other one goes first.
+   */
+  void grantRightOfWay(float seconds) { rightOfWay = seconds; }
+  bool hasRightOfWay() const { return rightOfWay > 0.0f; }
+
+  /**
+   * @brief Reports a trip milestone reached outside the car's own update (spawn, path, exit, despawn).
+   */
+  void stampTrip(TripMilestone milestone) { TripTelemetry::Record(id, trip, milestone); }
+  const TripTelemetry::Stamps &getTrip() const { return trip; }
+
   // Context for Parking
   // Used to generate the exit path.
   void setParkingContext(const Module *fac, const Spot &spot, int spotIndex);
@@ -96,13 +156,70 @@ public:
   const Spot &getParkedSpot() const { return parkedSpot; }
   int getParkedSpotIndex() const { return parkedSpotIndex; }
 
+  // --- Shard Hand-over ---
+  static constexpr int MAX_MIGRATION_WAYPOINTS = 96; ///< Longer paths lose middle points (PathPlanner emits < 64).
+
+  /**
+   * @struct MigrationState
+   * @brief Everything a car needs to continue in another process, as a fixed-size POD record.
+   *
+   * The facility is referred to by its index in EntityManager::getModules(), which is identical
+   * in every shard because all of them generate the same map.
+   */
+  struct MigrationState {
+    uint32_t id;
+    uint8_t type;
+    uint8_t priority;
+    uint8_t state;
+    bool enteredFromLeft;
+    WorldCoord position;
+    Vector2 velocity;
+    float currentRotation;
+    float targetRotation;
+    float parkingTimer;
+    float parkingDuration;
+    float batteryLevel;
+    int32_t facilityIndex; ///< -1 = no parking context.
+    int32_t spotIndex;
+    Spot spot;
+    TripTelemetry::Stamps trip;
+    char textureName[12];
+    uint32_t waypointCount;
+    struct {
+      WorldCoord position;
+      float tolerance;
+      int32_t id;
+      float entryAngle;
+      float speedLimitFactor;
+      bool stopAtEnd;
+      int32_t flowGoal;
+    } waypoints[MAX_MIGRATION_WAYPOINTS];
+  };
+
+  /**
+   * @brief Captures the car for a hand-over.
+   * @param facilityIndex Module index of getParkedFacility() (-1 if none), resolved by the caller.
+   */
+  MigrationState saveMigrationState(int32_t facilityIndex) const;
+
+  /**
+   * @brief Recreates a car captured by saveMigrationState.
+   * @param facility The module at state.facilityIndex in this process, or nullptr.
+   */
+  static std::unique_ptr<Car> FromMigrationState(const MigrationState &state, const Module *facility);
+
 private:
-  Vector2 position;
+  WorldCoord position;
   Vector2 velocity;
   Vector2 acceleration;
 
   CarState state = CarState::DRIVING;
   float parkingTimer = 0.0f;
+  TripTelemetry::Stamps trip;
+  float progressAt = 0.0f;  ///< trip.clock at the last progress (see getStalledSeconds).
+  WorldCoord progressFrom;  ///< Position then.
+  float rightOfWay = 0.0f; ///< Seconds left without avoidance.
+  uint32_t id = 0;
   float targetRotation = 0.0f;
   float currentRotation = 0.0f; // degrees, for smooth rendering
 
@@ -122,6 +239,8 @@ private:
    */
   void applyForce(Vector2 force);
 
+  void markProgress();
+
   /**
    * @brief Calculates and applies a steering force towards a target.
    *
@@ -133,6 +252,12 @@ private:
    * @param wp The target waypoint.
    */
   void seek(const Waypoint &wp);
+
+  /**
+   * @brief Steers by the parked facility's FlowField on a field-steered segment (Waypoint::flowGoal).
+   * @return false if the waypoint is to be sought directly (no field, or already in the goal region).
+   */
+  bool followFlow(const Waypoint &wp);
   std::string textureName;
 
   // New Members for Traffic Overhaul
@@ -152,14 +277,19 @@ public:
 
   void charge(float amount);
   float getBatteryLevel() const { return batteryLevel; }
+  void setBatteryLevel(float level) { batteryLevel = level; }
 
+  /**
+   * @brief Fixes how long the car stays PARKED (e.g. a replayed dwell). Negative draws it at random.
+   */
   void setParkingDuration(float duration) { parkingDuration = duration; }
+  bool hasParkingDuration() const { return parkingDuration >= 0.0f; }
 
 private:
   CarType type;
   Priority priority = Priority::PRIORITY_DISTANCE; // Default
   bool enteredFromLeft = true;                     // Default
   float batteryLevel = 100.0f;                     // 0-100%
-  float parkingDuration = 0.0f;                    // Assigned when parking starts
+  float parkingDuration = -1.0f;                   // Fixed PARKED time, negative = random
   bool selected = false;
 };
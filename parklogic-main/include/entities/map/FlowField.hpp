@@ -0,0 +1,75 @@
+#pragma once
+#include "raylib.h"
+#include <cstdint>
+#include <vector>
+
+struct ModuleTemplate;
+
+/**
+ * @file FlowField.hpp
+ * @brief Precomputed interior navigation shared by all facilities of a template.
+ */
+
+/**
+ * @class FlowField
+ * @brief Coarse grid of travel directions and speed limits over a facility's interior.
+ *
+ * One field is built per ModuleTemplate (FlowField::For), when the first facility of that template
+ * is created, and every facility of the template shares it. It has one layer per goal:
+ * - EXIT: the gate's exit lane (ModuleTemplate::gatePosition).
+ * - One per spot row (the spots sharing an orientation): the aisle line through the row's
+ *   alignment points, Config::CarAI::ALIGN_DISTANCE behind each spot.
+ *
+ * A layer is a Dijkstra distance field over Config::CarAI::Flow::CELL_SIZE cells, with the
+ * footprint of a car parked in every stall blocked, reduced to a direction (down the distance
+ * gradient) and a speed limit per cell. The limit is the MANEUVER phase speed next to stalls, walls
+ * and the goal and rises to the ACCESS phase speed in open aisle.
+ *
+ * A car on a field-steered leg (Waypoint::flowGoal) does one lookup per tick instead of chasing a
+ * chain of correction waypoints, and only seeks its own waypoint once inside the goal region.
+ */
+class FlowField {
+public:
+  static constexpr int EXIT = 0; ///< Goal layer leading to the gate's exit lane.
+
+  struct Sample {
+    Vector2 direction; ///< Unit vector (facility-local axes are world axes).
+    float speedFactor; ///< Multiplier of Config::CarAI::MAX_SPEED.
+  };
+
+  /**
+   * @brief The shared field of a facility template, built on first use.
+   */
+  static const FlowField &For(const ModuleTemplate &layout);
+
+  explicit FlowField(const ModuleTemplate &layout);
+
+  /**
+   * @brief Goal layer of the aisle in front of a spot's row.
+   */
+  int rowGoal(int spotIndex) const { return spotGoals[spotIndex]; }
+
+  int getGoalCount() const { return goalCount; }
+  int getColumns() const { return cols; }
+  int getRows() const { return rows; }
+
+  /**
+   * @brief Looks up the steering toward a goal at a facility-local position (meters).
+   * @return false inside the goal region, outside the grid or where the goal is unreachable; the
+   *         caller then seeks its waypoint directly.
+   */
+  bool sample(int goal, Vector2 local, Sample &out) const;
+
+private:
+  struct Cell {
+    int8_t dx; ///< Direction, scaled by 127.
+    int8_t dy;
+    uint8_t speed; ///< Speed factor, scaled by 255; 0 = no steering (goal, stall or unreachable).
+  };
+
+  int cols = 0;
+  int rows = 0;
+  int goalCount = 0;
+  std::vector<Cell> cells;       ///< goalCount layers of cols * rows, row-major.
+  std::vector<uint8_t> spotGoals; ///< Goal layer per spot index.
+};
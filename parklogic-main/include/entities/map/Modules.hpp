@@ -4,8 +4,14 @@
  * @file Modules.hpp
  * @brief Defines the building blocks of the game map (Roads, Parking, Charging).
  */
+#include "config.hpp"
+#include "core/WorldCoord.hpp"
 #include "entities/map/Waypoint.hpp"
 #include "raylib.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <span>
 #include <vector>
 
 /**
@@ -39,25 +45,64 @@ struct Spot {
   float price = 0.0f; ///< Dynamic price for using this spot.
 };
 
+/**
+ * @struct SpotLayout
+ * @brief The immutable part of a spot, shared by every facility of a type and orientation.
+ */
+struct SpotLayout {
+  Vector2 localPosition; ///< Position relative to facility top-left.
+  float orientation;     ///< Heading angle (radians) for the car when parked.
+};
+
+/**
+ * @struct ModuleTemplate
+ * @brief Geometry and art shared by every module of one type and orientation.
+ *
+ * Built at compile time from the art-pixel measurements in Modules.cpp. Modules only point at
+ * their template; what varies per instance (position, prices, spot states) lives in the Module.
+ */
+struct ModuleTemplate {
+  ModuleType type;
+  bool isTop;          ///< Facility sits above the road.
+  const char *texture; ///< AssetManager texture name.
+  float width;         ///< Meters.
+  float height;        ///< Meters.
+  std::span<const AttachmentPoint> attachmentPoints;
+  std::span<const LocalWaypoint> waypoints;
+  std::span<const SpotLayout> spots;
+  float basePrice;       ///< Spot price at a price multiplier of 1.
+  float priceVariance;   ///< Random +/- spread of spot prices.
+  float multiplierBoost; ///< Scales the random facility price multiplier (premium facility types).
+  float gateDepth = Config::CarAI::GateDepth::GENERIC; ///< Meters driven in past the entrance edge before the gate.
+
+  /**
+   * @brief The gate: where a car has driven through the entrance, on one of its two lanes.
+   * @param rightLane Lane right of the entrance's center line (entry of top facilities, exit of bottom ones).
+   * @return Position relative to the module's top-left corner.
+   */
+  Vector2 gatePosition(bool rightLane) const;
+};
+
+class FlowField;
+
 /**
  * @class Module
  * @brief Base class for all buildable map units (Roads, Facilities).
  *
  * A Module has:
- * - Dimensions (Width/Height)
- * - Attachment Points for connecting to other modules.
- * - Local Waypoints for AI navigation.
- * - Spots (iff it's a facility).
+ * - A template (dimensions, attachment points, local waypoints and spot layout, all shared).
+ * - A world position, parent and price multiplier.
+ * - Per-spot prices and states (iff it's a facility), the only per-instance arrays.
  * - A hierarchy (Roads are parents to Facilities).
  */
 class Module {
 public:
-  Module(float w, float h);
+  explicit Module(const ModuleTemplate &layout);
   virtual ~Module() = default;
 
   // --- Dimensions ---
-  float getWidth() const { return width; }
-  float getHeight() const { return height; }
+  float getWidth() const { return layout->width; }
+  float getHeight() const { return layout->height; }
 
   // --- Economics ---
   /**
@@ -75,27 +120,34 @@ public:
   void assignRandomPricesToSpots(float baseSpotPrice, float variance);
 
   // --- Attachments ---
-  const std::vector<AttachmentPoint> &getAttachmentPoints() const { return attachmentPoints; }
+  std::span<const AttachmentPoint> getAttachmentPoints() const { return layout->attachmentPoints; }
 
   // --- Rendering ---
-  Vector2 worldPosition = {0, 0}; ///< Top-left position in the World (Meters).
+  WorldCoord worldPosition; ///< Top-left position in the World.
 
   /**
-   * @brief Draws the module using specific logic per type.
+   * @brief Draws the template's texture over the module's footprint.
    */
   virtual void draw() const;
 
-  // --- Pathfinding & Waypoints ---
   /**
-   * @brief Adds a local waypoint (relative to module).
+   * @brief The quad draw() draws, for the EntityManager's SpriteBatch. Thread-safe.
    */
-  void addWaypoint(Vector2 localPos, float tolerance = 1.0f, int id = -1, float angle = 0.0f, bool stop = false);
+  struct SpriteQuad spriteQuad() const;
 
+  // --- Pathfinding & Waypoints ---
   /**
    * @brief Returns global waypoints by applying worldPosition to local ones.
    */
   std::vector<Waypoint> getGlobalWaypoints() const;
 
+  // --- Identity ---
+  /**
+   * @brief Facility number, assigned by the EntityManager and kept through map edits (-1 for roads).
+   */
+  int getFacilityId() const { return facilityId; }
+  void setFacilityId(int id) { facilityId = id; }
+
   // --- Hierarchy ---
   void setParent(Module *p) { parent = p; }
   Module *getParent() const { return parent; }
@@ -107,8 +159,22 @@ public:
   // --- Spot Management ---
   int getRandomSpotIndex() const;
   Spot getSpot(int index) const;
+  float getSpotPrice(int index) const; ///< Cheaper than getSpot(index).price.
   void setSpotState(int index, SpotState state);
 
+  /**
+   * @brief Reserves a spot only if it is still FREE (compare-and-swap).
+   * @return false if another thread or process reserved it since it was picked.
+   */
+  bool tryReserveSpot(int index);
+
+  /**
+   * @brief Moves the spot states into external storage, one byte per spot (e.g. shared memory
+   * seen by all shard processes). The current states are copied in; the storage must outlive
+   * the module.
+   */
+  void bindSpotStates(std::atomic<uint8_t> *states);
+
   struct SpotCounts {
     int free;
     int reserved;
@@ -116,21 +182,40 @@ public:
   };
   SpotCounts getSpotCounts() const;
   float getOccupancyPercentage() const;
-  size_t getSpotCount() const { return spots.size(); }
+  size_t getSpotCount() const { return layout->spots.size(); }
+
+  /**
+   * @brief A closed facility takes no new cars; cars already holding a spot there play out as usual.
+   */
+  bool isClosed() const { return closed.load(std::memory_order_relaxed); }
+  void setClosed(bool c) { closed.store(c, std::memory_order_relaxed); }
 
   // --- Type Info ---
-  virtual bool isUp() const { return false; }
-  const std::vector<Waypoint> &getLocalWaypoints() const { return localWaypoints; }
-  virtual ModuleType getType() const { return ModuleType::GENERIC; }
+  bool isUp() const { return layout->isTop; }
+  std::span<const LocalWaypoint> getLocalWaypoints() const { return layout->waypoints; }
+  ModuleType getType() const { return layout->type; }
+  const ModuleTemplate &getTemplate() const { return *layout; }
+
+  /**
+   * @brief Interior flow field shared by every facility of this template (nullptr for roads).
+   */
+  const FlowField *getFlowField() const { return flowField; }
 
 protected:
-  float width;
-  float height;
+  const ModuleTemplate *layout;
+  const FlowField *flowField = nullptr;
   float priceMultiplier = 1.0f;
-  std::vector<AttachmentPoint> attachmentPoints;
-  std::vector<Waypoint> localWaypoints;
-  std::vector<Spot> spots;
+  std::unique_ptr<float[]> spotPrices;
+  std::unique_ptr<std::atomic<uint8_t>[]> ownStates; ///< Spot states until bindSpotStates moves them.
+  std::atomic<uint8_t> *spotStates = nullptr;        ///< ownStates or the bound external storage.
   Module *parent = nullptr;
+  std::atomic<bool> closed{false}; ///< Atomic: the forecaster reads it while building its model.
+  int facilityId = -1;
+
+  SpotState stateAt(int index) const { return (SpotState)spotStates[index].load(std::memory_order_acquire); }
+
+  /// Destination rectangle of the module sprite, relative to the render origin.
+  Rectangle renderRect() const;
 };
 
 // --- Roads ---
@@ -138,25 +223,21 @@ protected:
 class NormalRoad : public Module {
 public:
   NormalRoad();
-  void draw() const override;
 };
 
 class UpEntranceRoad : public Module {
 public:
   UpEntranceRoad();
-  void draw() const override;
 };
 
 class DownEntranceRoad : public Module {
 public:
   DownEntranceRoad();
-  void draw() const override;
 };
 
 class DoubleEntranceRoad : public Module {
 public:
   DoubleEntranceRoad();
-  void draw() const override;
 };
 
 // --- Facilities ---
@@ -164,43 +245,19 @@ public:
 class SmallParking : public Module {
 public:
   SmallParking(bool isTop);
-  void draw() const override;
-  bool isUp() const override { return isTop; }
-  ModuleType getType() const override { return ModuleType::SMALL_PARKING; }
-
-private:
-  bool isTop;
 };
 
 class LargeParking : public Module {
 public:
   LargeParking(bool isTop);
-  void draw() const override;
-  bool isUp() const override { return isTop; }
-  ModuleType getType() const override { return ModuleType::LARGE_PARKING; }
-
-private:
-  bool isTop;
 };
 
 class SmallChargingStation : public Module {
 public:
   SmallChargingStation(bool isTop);
-  void draw() const override;
-  bool isUp() const override { return isTop; }
-  ModuleType getType() const override { return ModuleType::SMALL_CHARGING; }
-
-private:
-  bool isTop;
 };
 
 class LargeChargingStation : public Module {
 public:
   LargeChargingStation(bool isTop);
-  void draw() const override;
-  bool isUp() const override { return isTop; }
-  ModuleType getType() const override { return ModuleType::LARGE_CHARGING; }
-
-private:
-  bool isTop;
 };
@@ -1,4 +1,5 @@
 #pragma once
+#include "core/WorldCoord.hpp"
 #include "raylib.h"
 
 /**
@@ -6,13 +7,29 @@
  * @brief A navigation node in the world.
  */
 struct Waypoint {
-  Vector2 position;       ///< Global position in meters.
+  static constexpr int GATE_ID = -2; ///< id of the facility gate on an entry path (the car reports passing it).
+
+  WorldCoord position;    ///< Global position.
   float tolerance;        ///< Radius in meters to consider "reached".
   int id;                 ///< Optional ID for debugging or logic.
   float entryAngle;       ///< Required orientation (radians) at this point.
   bool stopAtEnd;         ///< Whether the car should come to a full stop here.
   float speedLimitFactor; ///< Limit max speed for the segment ending at this waypoint (0.0 to 1.0).
+  int flowGoal = -1;      ///< FlowField goal layer steering the segment (-1: seek the waypoint directly).
 
-  Waypoint(Vector2 pos, float tol = 1.0f, int _id = -1, float angle = 0.0f, bool stop = false, float speedFactor = 1.0f)
+  Waypoint(WorldCoord pos, float tol = 1.0f, int _id = -1, float angle = 0.0f, bool stop = false,
+           float speedFactor = 1.0f)
       : position(pos), tolerance(tol), id(_id), entryAngle(angle), stopAtEnd(stop), speedLimitFactor(speedFactor) {}
 };
+
+/**
+ * @struct LocalWaypoint
+ * @brief A waypoint relative to its module's top-left corner, as authored by the module.
+ */
+struct LocalWaypoint {
+  Vector2 position; ///< Meters from the module's top-left corner.
+  float tolerance;
+  int id;
+  float entryAngle;
+  bool stopAtEnd;
+};
@@ -1,8 +1,12 @@
 #pragma once
+#include "core/WorldCoord.hpp"
 #include "entities/Entity.hpp"
+#include <cstdint>
 #include <string>
 #include <vector>
 
+class WorldChunkStore;
+
 /**
  * @class World
  * @brief Represents the game world boundaries and grid.
@@ -13,12 +17,25 @@
 
 class World : public Entity {
 public:
+  /**
+   * @brief Loads the world, module and car textures into the AssetManager.
+   *
+   * Requires a graphics context. Kept out of the constructor so maps can be generated
+   * without a window (e.g. for the discrete-event simulator).
+   */
+  static void LoadAssets();
+
   World(float width, float height);
 
   void update(double dt) override;
   void draw() override;
   void drawOverlay(); // Draws grid and borders on top of entities
 
+  /**
+   * @brief Draws only the background tiles overlapping [min, max] (e.g. the camera view).
+   */
+  void drawArea(const WorldCoord &min, const WorldCoord &max);
+
   void setGridEnabled(bool enabled) { showGrid = enabled; }
   bool isGridEnabled() const { return showGrid; }
   void toggleGrid() { showGrid = !showGrid; }
@@ -28,14 +45,30 @@ public:
   float getWidth() const { return width; }
   float getHeight() const { return height; }
 
+  // --- Background Tiles ---
+  int getTileColumns() const { return tileCols; }
+  int getTileRows() const { return tileRows; }
+  float getTileSize() const { return tileWidthMeter; }
+
+  /// Texture indices of one tile column, top to bottom (getTileRows() entries).
+  const uint8_t *tileColumn(int col) const;
+
+  /**
+   * @brief Reads tile columns from the store from now on and frees the resident grid.
+   */
+  void attachTileStore(const WorldChunkStore *store);
+
 private:
   float width;
   float height;
   bool showGrid;
 
   // Background
-  std::vector<std::vector<int>> backgroundTiles; // Stores index of texture to use
-  std::vector<std::string> tileTextures;         // Texture names
+  std::vector<uint8_t> backgroundTiles;  // Texture index per tile, column-major (until paged out)
+  const WorldChunkStore *tileStore = nullptr;
+  int tileCols = 0;
+  int tileRows = 0;
+  std::vector<std::string> tileTextures; // Texture names
   float tileWidthMeter;
   float tileHeightMeter;
 };
@@ -0,0 +1,95 @@
+#pragma once
+#include "core/MappedFile.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class World;
+
+/**
+ * @file WorldChunkStore.hpp
+ * @brief Out-of-core storage for the background of large maps.
+ */
+
+/**
+ * @class WorldChunkStore
+ * @brief Pages a map's background tiles in and out of a memory-mapped backing file.
+ *
+ * The map is cut into strips of Config::World::CHUNK_SIZE along X (the WorldCoord chunks). Each
+ * strip's background tile columns are written to one page-aligned section of a temporary file,
+ * which is then mapped read-only; the World reads through the mapping (World::attachTileStore)
+ * and frees its own grid. Module geometry needs no paging: it lives in shared ModuleTemplates.
+ *
+ * Every tick the EntityManager pins the chunks in the camera view. endTick() then drops unpinned
+ * chunks beyond a small LRU cache from the resident set. Eviction is free: the pages are clean,
+ * so the kernel simply re-reads them from the file on the next access.
+ *
+ * What stays resident: the modules (their per-instance state is a few bytes per spot) and one
+ * chunk table entry per strip.
+ */
+class WorldChunkStore {
+public:
+  /**
+   * @brief Writes the world's background tiles to a backing file and points the world at it.
+   * @param path Backing file to create; it is removed again when the store is destroyed.
+   * @throws std::runtime_error if the file cannot be written or mapped.
+   */
+  WorldChunkStore(World &world, const std::string &path);
+  ~WorldChunkStore();
+
+  WorldChunkStore(const WorldChunkStore &) = delete;
+  WorldChunkStore &operator=(const WorldChunkStore &) = delete;
+
+  /**
+   * @brief Whether the world spans enough chunks (Config::World::PAGED_MIN_CHUNKS) to page it.
+   */
+  static bool IsWorthwhile(const World &world);
+
+  /**
+   * @brief A fresh backing file name in the system's temporary directory.
+   */
+  static std::string DefaultPath();
+
+  /**
+   * @brief Keeps the chunks overlapping [fromX, toX] (meters) resident this tick, paging in
+   *        any that were evicted.
+   */
+  void pin(double fromX, double toX);
+
+  /**
+   * @brief Ends the tick: evicts unpinned chunks beyond Config::World::CACHED_CHUNKS, oldest first.
+   */
+  void endTick();
+
+  /// Tile column col of the World (see World::tileColumn).
+  const uint8_t *tileColumn(int col) const;
+
+  int getChunkCount() const { return (int)chunks.size(); }
+  int getResidentCount() const { return (int)residentChunks.size(); }
+  uint64_t getPageIns() const { return pageIns; }
+  uint64_t getEvictions() const { return evictions; }
+
+private:
+  struct Chunk {
+    size_t offset = 0; ///< Page-aligned start of the section in the file.
+    size_t bytes = 0;
+    int firstColumn = 0; ///< First tile column stored in this section.
+    uint64_t lastPinned = 0;
+    bool resident = false;
+  };
+
+  void pinChunk(int chunk);
+  void evict(int chunk);
+
+  std::string path;
+  std::unique_ptr<MappedFile> file;
+  std::vector<Chunk> chunks;
+  std::vector<int> residentChunks; ///< Chunks currently paged in (reserved up front, no per-tick allocation).
+
+  int columnsPerChunk = 1;
+  int tileRows = 0;
+  uint64_t tick = 1;
+  uint64_t pageIns = 0;
+  uint64_t evictions = 0;
+};
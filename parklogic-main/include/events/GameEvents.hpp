@@ -1,6 +1,9 @@
 #pragma once
 #include "entities/map/Waypoint.hpp"
 #include "raylib.h"
+#include <cstdint>
+#include <memory_resource>
+#include <string>
 #include <vector>
 
 struct MapConfig {
@@ -8,9 +11,10 @@ struct MapConfig {
   int largeParkingCount = 1;
   int smallChargingCount = 1;
   int largeChargingCount = 0;
+  unsigned int seed = 0; ///< Layout and price seed (0 = random)
 };
 
-enum class SceneType { MainMenu, MapConfig, Game };
+enum class SceneType { MainMenu, MapConfig, Game, Playback };
 struct SceneChangeEvent {
   SceneType newScene;
   MapConfig config;
@@ -25,6 +29,12 @@ struct WorldBoundsEvent {
   float height;
 };
 
+struct CameraViewEvent {
+  WorldCoord min; // Top-left corner of the visible area
+  WorldCoord max; // Bottom-right corner
+};
+
+// Published after the SystemScheduler ran a tick, for observers; systems are not driven by it
 struct GameUpdateEvent {
   double dt;
 };
@@ -37,6 +47,7 @@ struct GamePausedEvent {};
 struct GameResumedEvent {};
 
 struct ToggleDashboardEvent {};
+struct CycleCongestionOverlayEvent {}; ///< Off -> dwell -> slowdown -> braking -> side-steps -> off.
 
 struct CameraZoomEvent {
   float zoomDelta;
@@ -46,21 +57,41 @@ struct CameraMoveEvent {
   Vector2 delta;
 };
 
+// Places the camera outright (render benchmark script); zoom is clamped to the camera's limits
+struct SetCameraViewEvent {
+  WorldCoord target;
+  float zoom;
+};
+
 struct SpawnCarEvent {};
 
 struct CycleAutoSpawnLevelEvent {};
+struct SetAutoSpawnLevelEvent {
+  int level; // 0 (off) to 5
+};
 struct AutoSpawnLevelChangedEvent {
   int newLevel;
 };
 
 struct SpawnCarRequestEvent {};
 
+struct LoadDemandTraceEvent {
+  std::string path; // Gate log to replay (CSV or binary, see TraceReader)
+};
+
+struct CycleDemandProfileEvent {};
+struct DemandProfileChangedEvent {
+  const char *name; // Static string ("Fixed", "Commuter", "Stress")
+};
+
 struct CreateCarEvent {
-  Vector2 position;
+  WorldCoord position;
   Vector2 velocity; // Initial velocity (sets heading)
   int carType;      // 0: Combustion, 1: Electric
   int priority;     // 0: Price, 1: Distance
   bool enteredFromLeft;
+  float battery = -1.0f; // Initial state of charge, negative = random
+  float dwell = -1.0f;   // Fixed parking time, negative = random
 };
 
 struct CarSpawnedEvent {
@@ -69,7 +100,7 @@ struct CarSpawnedEvent {
 
 struct AssignPathEvent {
   class Car *car;
-  std::vector<struct Waypoint> path;
+  std::pmr::vector<struct Waypoint> path; // Transient (FrameArena); copied by Car::setPath
 };
 
 struct CarFinishedParkingEvent {
@@ -84,6 +115,58 @@ struct SimulationSpeedChangedEvent {
   double speedMultiplier;
 };
 
+enum class GovernorStage : uint8_t {
+  Normal,      ///< Every car on the full update.
+  Demote,      ///< Cars outside the view skip collision avoidance.
+  Slow,        ///< ... and the effective speed multiplier is reduced.
+  Backpressure ///< ... and arrivals wait while the car count is at its cap.
+};
+
+// LoadGovernor verdict, once per measurement window
+struct LoadGovernorEvent {
+  GovernorStage stage;
+  double speedFactor; ///< Applied to the requested speed multiplier (1 = unchanged).
+  double load;        ///< Tick wall time / wall time the effective pace allowed, last window.
+};
+
+// StuckWatchdog intervened; running totals of the scene
+struct StuckVehiclesEvent {
+  uint64_t rightOfWays; ///< Right-of-way grants to stalled cars.
+  uint64_t removed;     ///< Stalled cars removed.
+};
+
+enum class MapEdit { Insert, Remove, Convert, Close, Reopen };
+
+// Runtime map edit request (control socket), applied by the MapEditor
+struct EditMapEvent {
+  MapEdit edit;
+  int target;      ///< Facility id (Module::getFacilityId); entrance road number for Insert.
+  bool top = true; ///< Insert: side of the entrance road.
+  int type = 0;    ///< Insert and Convert: ModuleType of the facility to build.
+};
+
+// A map edit took effect. replaced is out of the module list but alive until the scene ends.
+struct MapEditedEvent {
+  MapEdit edit;
+  const class Module *module;   ///< Facility inserted, converted to, closed or reopened (nullptr on Remove).
+  const class Module *replaced; ///< Facility taken out by Remove or Convert, else nullptr.
+};
+
+// A map edit could not apply and changed nothing
+struct MapEditRejectedEvent {
+  std::string reason;
+};
+
+// The scene's occupancy history, once it exists (nullptr before it goes away)
+struct OccupancyHistoryEvent {
+  const class OccupancyHistory *history;
+};
+
+// A new forecast finished; the pointee belongs to the ForecastService and is only valid during the publish
+struct OccupancyForecastEvent {
+  const struct OccupancyForecast *forecast;
+};
+
 enum class SelectionType { NONE, CAR, FACILITY, SPOT, GENERAL };
 
 struct EntitySelectedEvent {
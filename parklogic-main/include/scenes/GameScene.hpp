@@ -1,14 +1,19 @@
 #pragma once
 #include "core/EventBus.hpp"
+#include "core/LaunchOptions.hpp"
 #include "events/GameEvents.hpp"
 #include "scenes/IScene.hpp"
 #include <memory>
 #include <set>
+#include <string>
 #include <vector>
 
 class GameScene : public IScene {
 public:
-  explicit GameScene(std::shared_ptr<EventBus> bus, MapConfig config);
+  /**
+   * @param options Command line; supplies the optional --trace, --record and --telemetry targets.
+   */
+  GameScene(std::shared_ptr<EventBus> bus, MapConfig config, const LaunchOptions &options = {});
   ~GameScene() override;
 
   void load() override;
@@ -16,18 +21,30 @@ public:
   void update(double dt) override;
   void draw() override;
 
+  const class EntityManager *getEntityManager() const { return entityManager.get(); } ///< Null before load().
+
 private:
   void handleInput();
 
   std::shared_ptr<EventBus> eventBus;
   std::vector<Subscription> eventTokens;
 
+  std::unique_ptr<class SystemScheduler> scheduler; ///< Runs the systems below each tick.
   std::unique_ptr<class EntityManager> entityManager;
   std::unique_ptr<class TrafficSystem> trafficSystem;
+  std::unique_ptr<class StuckWatchdog> watchdog;
+  std::unique_ptr<class MapEditor> mapEditor; ///< Applies the control socket's map edits.
+  std::unique_ptr<class ForecastService> forecast;
+  std::unique_ptr<class OccupancyHistory> history;
+  std::unique_ptr<class LoadGovernor> governor; ///< Null with --no-governor.
   std::unique_ptr<class GameHUD> gameHUD;
 
   std::unique_ptr<class CameraSystem> cameraSystem;
+  std::unique_ptr<class TrajectoryRecorder> recorder;
+  std::unique_ptr<class TelemetryPublisher> telemetry;
+  std::unique_ptr<class ControlServer> control;
   bool isPaused = false;
   MapConfig config;
+  LaunchOptions options;
   std::set<int> keysDown;
 };
@@ -0,0 +1,54 @@
+#pragma once
+#include "core/EventBus.hpp"
+#include "entities/map/Modules.hpp"
+#include "entities/map/World.hpp"
+#include "scenes/IScene.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+class CameraSystem;
+class TrajectoryReader;
+
+/**
+ * @class PlaybackScene
+ * @brief Viewer for trajectory recordings; no simulation runs.
+ *
+ * Regenerates the recorded layout from the stored MapConfig and draws the decoded car poses at the
+ * playhead. Controls: Space pause, Left/Right skip, Up/Down speed, Home/End, click or drag the
+ * timeline to scrub, WASD/scroll for the camera, ESC back to the menu.
+ */
+class PlaybackScene : public IScene {
+public:
+  /**
+   * @param bus Shared pointer to the EventBus.
+   * @param path Recording written by TrajectoryRecorder.
+   */
+  PlaybackScene(std::shared_ptr<EventBus> bus, std::string path);
+  ~PlaybackScene() override;
+
+  void load() override;
+  void unload() override;
+  void update(double dt) override;
+  void draw() override;
+
+private:
+  void seekTo(double seconds);
+  void scrubTo(Vector2 mousePosition);
+  void drawTimeline() const;
+  Rectangle timelineRect() const;
+
+  std::shared_ptr<EventBus> eventBus;
+  std::vector<Subscription> eventTokens;
+  std::string path;
+
+  std::unique_ptr<TrajectoryReader> reader;
+  std::unique_ptr<CameraSystem> cameraSystem;
+  std::unique_ptr<World> world;
+  std::vector<std::unique_ptr<Module>> modules;
+
+  double playhead = 0.0; ///< Seconds into the recording.
+  int speedIndex;        ///< Index into Config::Trajectory::PLAYBACK_SPEEDS.
+  bool paused = false;
+  bool scrubbing = false;
+};
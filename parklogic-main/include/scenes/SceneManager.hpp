@@ -1,8 +1,10 @@
 #pragma once
 #include "core/EventBus.hpp" // Ensure Subscription class is visible
+#include "core/LaunchOptions.hpp"
 #include "events/GameEvents.hpp"
 #include "scenes/IScene.hpp"
 #include <memory>
+#include <string>
 
 /**
  * @class SceneManager
@@ -17,8 +19,9 @@ public:
    * @brief Constructs the SceneManager.
    *
    * @param bus Shared pointer to the EventBus.
+   * @param options Command line; supplies the --trace, --record and --playback files.
    */
-  explicit SceneManager(std::shared_ptr<EventBus> bus);
+  explicit SceneManager(std::shared_ptr<EventBus> bus, LaunchOptions options = {});
 
   /**
    * @brief Destructor.
@@ -55,4 +58,5 @@ private:
   bool changeQueued = false;                 ///< Flag indicating a scene change is pending.
   SceneType nextScene = SceneType::MainMenu; ///< The next scene to load.
   MapConfig nextConfig;
+  LaunchOptions options;
 };
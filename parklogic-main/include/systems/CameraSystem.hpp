@@ -1,10 +1,13 @@
 #pragma once
 #include "core/EventBus.hpp"
+#include "core/WorldCoord.hpp"
 #include "raylib.h"
 #include <memory>
 #include <set>
 #include <vector>
 
+class SystemScheduler;
+
 /**
  * @class CameraSystem
  * @brief Manages the 2D game camera.
@@ -14,6 +17,7 @@
  * - Panning (WASD Keys).
  * - Clamping to World Bounds.
  * - Coordinate transformation (World <-> Screen).
+ * - The floating render origin (WorldCoord::SetRenderOrigin), kept at the target's chunk.
  */
 class CameraSystem {
 public:
@@ -30,6 +34,11 @@ public:
    */
   void update(double dt);
 
+  /**
+   * @brief Registers update() as the Input-stage system that moves the view.
+   */
+  void schedule(SystemScheduler &scheduler);
+
   /**
    * @brief Sets the world limits to prevent the camera from straying too far.
    * @param width World width in Meters.
@@ -38,21 +47,27 @@ public:
   void setWorldBounds(float width, float height);
 
   /**
-   * @brief Gets the underlying Raylib camera object.
+   * @brief Gets the underlying Raylib camera object, in render space (see WorldCoord::toRender).
    * @return Camera2D struct.
    */
-  Camera2D getCamera() const { return camera; }
+  Camera2D getCamera() const;
 
   // Setters for initial setup
-  void setTarget(Vector2 target) { camera.target = target; }
+  void setTarget(const WorldCoord &newTarget);
   void setOffset(Vector2 offset) { camera.offset = offset; }
   void setZoom(float zoom) { camera.zoom = zoom; }
 
 private:
+  /**
+   * @brief Publishes the visible area as a CameraViewEvent.
+   */
+  void publishView();
+
   std::shared_ptr<EventBus> eventBus;
   std::vector<Subscription> eventTokens;
 
-  Camera2D camera = {{0, 0}, {0, 0}, 0.0f, 1.0f};
+  Camera2D camera = {{0, 0}, {0, 0}, 0.0f, 1.0f}; ///< Offset and zoom; the target lives below.
+  WorldCoord target;                               ///< Point the camera looks at.
 
   float worldWidth = 0.0f;
   float worldHeight = 0.0f;
@@ -0,0 +1,67 @@
+#pragma once
+#include "core/JobPool.hpp"
+#include "core/LaunchOptions.hpp"
+#include "events/GameEvents.hpp"
+#include "systems/DiscreteEventSimulator.hpp"
+#include <vector>
+
+/**
+ * @file CapacityPlanner.hpp
+ * @brief Search for the cheapest facility mixes that serve a given demand.
+ */
+
+/**
+ * @class CapacityPlanner
+ * @brief Successive halving over the MapConfig facility counts, scored by the DiscreteEventSimulator.
+ *
+ * Candidates are all mixes of 0 to Config::Planner::MAX_PER_TYPE facilities of each kind (at least
+ * one facility), laid out with the --map-seed. Every rung runs ETA times longer than the one before;
+ * the last runs the full --hours, the first the shortest --hours / ETA^k that is still at least
+ * MIN_RUNG_HOURS. After each rung the candidates are sorted into Pareto fronts of cost (spots
+ * weighted by PARKING_SPOT_COST and CHARGING_SPOT_COST) against pass-through rate, and the best
+ * 1/ETA of them, but at least FINALISTS, go on to the next rung. In the front that gets cut, mixes
+ * meeting --max-pass-through go first, cheapest first, then the others by pass-through rate.
+ *
+ * All runs of a rung use the --seed, so every candidate sees the same arrivals, with the same
+ * batteries and charging wishes (common random numbers), and the comparison only reflects the
+ * layouts. Runs go in parallel on a JobPool. Maps are generated on the calling thread, since the
+ * generator draws from raylib's global random state.
+ */
+class CapacityPlanner {
+public:
+  explicit CapacityPlanner(const LaunchOptions &options);
+
+  CapacityPlanner(const CapacityPlanner &) = delete;
+  CapacityPlanner &operator=(const CapacityPlanner &) = delete;
+
+  /**
+   * @brief Runs every rung, then logs the final Pareto front and the cheapest mix meeting the target.
+   * @return false if no mix on the front meets --max-pass-through.
+   */
+  bool run();
+
+private:
+  struct Candidate {
+    MapConfig map;
+    double cost = 0.0;
+    DesReport report; ///< Of the latest rung the candidate ran in.
+
+    double passThrough() const; ///< Share of arrivals that found no spot (0-1).
+  };
+
+  std::vector<double> rungHours() const;
+
+  /// Runs the candidates for the given horizon and stores their reports and costs.
+  void evaluate(const std::vector<int> &ids, double hours);
+
+  /// The candidates best first: front by front, each front in the order described above.
+  std::vector<int> rank(const std::vector<int> &ids, std::vector<int> *firstFront = nullptr) const;
+
+  bool meetsTarget(const Candidate &candidate) const;
+  static bool Dominates(const Candidate &a, const Candidate &b);
+  static void Report(const Candidate &candidate, bool meetsTarget);
+
+  LaunchOptions options;
+  JobPool pool;
+  std::vector<Candidate> candidates;
+};
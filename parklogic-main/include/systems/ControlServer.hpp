@@ -0,0 +1,177 @@
+#pragma once
+#include "config.hpp"
+#include "core/EventBus.hpp"
+#include "core/Seqlock.hpp"
+#include "events/GameEvents.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+class EntityManager;
+class OccupancyHistory;
+
+/**
+ * @file ControlServer.hpp
+ * @brief Runtime control and queries over a local Unix domain socket.
+ */
+
+/**
+ * @struct ControlSnapshot
+ * @brief State answered by queries; refreshed by the simulation thread after every update.
+ */
+struct ControlSnapshot {
+  uint64_t tick = 0;
+  double simSeconds = 0.0;
+  double speed = 1.0;
+  int spawnLevel = 0;
+  bool paused = false;
+  GovernorStage governor = GovernorStage::Normal;
+  double speedFactor = 1.0; ///< LoadGovernor's share of the speed multiplier.
+  uint64_t stuckYields = 0;  ///< StuckWatchdog right-of-way grants.
+  uint64_t stuckRemoved = 0; ///< StuckWatchdog removals.
+  uint32_t cars = 0;
+  uint32_t carsByState[4] = {}; ///< Indexed by Car::CarState.
+  int freeSpots = 0;
+  int reservedSpots = 0;
+  int occupiedSpots = 0;
+  int facilityCount = 0; ///< Entries used in facilities (capped at SNAPSHOT_FACILITIES).
+
+  struct Facility {
+    int32_t id;   ///< Module::getFacilityId().
+    uint8_t type; ///< ModuleType.
+    bool closed;
+    uint16_t occupied;
+    uint16_t total;
+  } facilities[Config::Control::SNAPSHOT_FACILITIES] = {};
+
+  int entranceCount = 0; ///< Entries used in entrances (capped at SNAPSHOT_ENTRANCES).
+
+  /// Facility id on each side of an entrance road; FREE_SIDE or NO_SIDE without one.
+  struct Entrance {
+    int16_t top;
+    int16_t bottom;
+  } entrances[Config::Control::SNAPSHOT_ENTRANCES] = {};
+
+  static constexpr int16_t FREE_SIDE = -1; ///< Entrance without a facility (insert target).
+  static constexpr int16_t NO_SIDE = -2;   ///< The road has no entrance on that side.
+};
+
+/**
+ * @class ControlServer
+ * @brief Line protocol endpoint for scripting running (typically --headless) instances.
+ *
+ * An I/O thread owns the socket and all clients. Commands are only parsed there and queued; the
+ * simulation thread applies them as bus events at the next tick boundary (applyPendingCommands),
+ * exactly as if the HUD had been clicked. Queries are answered on the I/O thread from the
+ * Seqlock snapshot, so they never touch live simulation state and the tick never waits on a
+ * client (the queue lock is only try-locked on the simulation side).
+ *
+ * Protocol: one command per line, one reply line per command, "OK ..." or "ERR <reason>".
+ *   status | occupancy | history [row] [1s|1m|15m] [occupancy|reserved|price|queue] | map |
+ *   insert <entrance> <top|bottom> <type> | remove <facility> | convert <facility> <type> |
+ *   close <facility> | reopen <facility> | spawn-level <0-5> | speed <x> | pause | resume | spawn [n] |
+ *   quit | help
+ *
+ * history answers from the OccupancyHistory's lock-free read() on the I/O thread as well. The map
+ * edits are queued like any command, but their reply waits for the tick that applies them: "OK" (with
+ * the facility's id, "OK f<n>", unless it was removed) or "ERR <reason>" from the MapEditor. Until then
+ * the client's further lines wait too, so its replies stay in order. map lists entrance roads (e<n>)
+ * and facilities by their stable ids (f<n>), the ones the edits take.
+ */
+class ControlServer {
+public:
+  /**
+   * @brief Binds the socket and starts the I/O thread.
+   * @param socketPath Filesystem path of the socket (a stale file is replaced).
+   * @param bus Bus the queued commands are published on.
+   * @param entityManager Source of the snapshot.
+   * @throws std::runtime_error if the socket cannot be created (or the platform has none).
+   */
+  ControlServer(std::string socketPath, std::shared_ptr<EventBus> bus, const EntityManager &entityManager);
+
+  /**
+   * @brief Stops the I/O thread, disconnects clients and removes the socket file.
+   */
+  ~ControlServer();
+
+  ControlServer(const ControlServer &) = delete;
+  ControlServer &operator=(const ControlServer &) = delete;
+
+  /**
+   * @brief Publishes the events for all commands received since the last call (simulation thread).
+   */
+  void applyPendingCommands();
+
+  /**
+   * @brief Refreshes the query snapshot (simulation thread, after the tick).
+   */
+  void publishSnapshot();
+
+  /**
+   * @brief Source of the history query (nullptr: none). Must outlive the server or be unset first.
+   */
+  void setHistory(const OccupancyHistory *source) { history.store(source, std::memory_order_release); }
+
+private:
+  struct Command {
+    enum class Type { SpawnLevel, Speed, Pause, Resume, Spawn, Quit, EditMap } type;
+    double value = 0.0;
+    EditMapEvent edit{}; ///< EditMap only.
+    uint64_t ticket = 0; ///< EditMap only: ties the reply to the client waiting for it.
+  };
+
+  void serve();
+
+  /**
+   * @brief Runs one command line (I/O thread).
+   * @param ticket Set for a map edit, whose reply comes later (see handOverReplies); the result is then empty.
+   */
+  std::string execute(std::string_view line, uint64_t &ticket);
+  std::string queryHistory(std::string_view arguments) const;
+  std::string describeMap() const;
+  std::string parseEdit(std::string_view verb, std::string_view arguments, uint64_t &ticket);
+  void queue(Command command);
+
+  /// Passes the finished edits' replies to the I/O thread and wakes it (simulation thread, never waits).
+  void handOverReplies();
+
+  std::string socketPath;
+  std::shared_ptr<EventBus> eventBus;
+  const EntityManager &entityManager;
+  std::vector<Subscription> eventTokens;
+
+  int listenFd = -1;
+  int wakeFds[2] = {-1, -1}; ///< Self-pipe that interrupts poll() on shutdown or with edit replies.
+  std::thread ioThread;
+
+  std::mutex commandMutex;
+  std::vector<Command> pending;  ///< Filled by the I/O thread.
+  std::vector<Command> applying; ///< Swapped with pending by the simulation thread.
+  uint64_t nextTicket = 1;       ///< I/O thread.
+
+  using Reply = std::pair<uint64_t, std::string>; ///< Ticket and reply line of a map edit.
+  std::mutex replyMutex;
+  std::vector<Reply> replies;  ///< Handed to the I/O thread.
+  std::vector<Reply> finished; ///< Simulation thread: not handed over yet.
+  std::string editReply;       ///< Outcome of the edit being applied, from the MapEditor's events.
+
+  Seqlock<ControlSnapshot> snapshot;
+  std::atomic<const OccupancyHistory *> history{nullptr};
+
+  // Simulation thread state, mirrored from the bus
+  uint64_t tick = 0;
+  double simSeconds = 0.0;
+  double speed = 1.0;
+  int spawnLevel = 0;
+  bool paused = false;
+  GovernorStage governor = GovernorStage::Normal;
+  double speedFactor = 1.0;
+  uint64_t stuckYields = 0;
+  uint64_t stuckRemoved = 0;
+};
@@ -0,0 +1,223 @@
+#pragma once
+#include "core/MemoryStats.hpp"
+#include "entities/Car.hpp"
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <span>
+#include <vector>
+
+/**
+ * @file DemandScheduler.hpp
+ * @brief Configurable car arrival processes.
+ */
+
+/**
+ * @struct Arrival
+ * @brief One car that wants to enter the map.
+ */
+struct Arrival {
+  double time;            ///< Simulation time the car shows up at the map edge (seconds).
+  bool fromLeft;          ///< Entry side.
+  Car::CarType type;      ///< Combustion or electric.
+  Car::Priority priority; ///< Price or distance minded.
+  float dwell = -1.0f;    ///< Recorded time to stay parked (seconds), negative to draw it.
+  float battery = -1.0f;  ///< Recorded state of charge (0-100), negative to draw it.
+};
+
+class TraceReader;
+
+enum class ArrivalProcess {
+  FixedInterval, ///< Deterministic spacing of 1 / rate (the classic auto-spawn levels).
+  Poisson        ///< Exponential gaps, rate piecewise constant per hour of day.
+};
+
+/**
+ * @struct DemandProfile
+ * @brief Arrival process, time-of-day rate curve and traffic mix.
+ */
+struct DemandProfile {
+  const char *name = "Off";
+  ArrivalProcess process = ArrivalProcess::FixedInterval;
+  std::array<float, 24> hourlyRate{}; ///< Arrivals per second for each hour of day.
+  float electricShare = 0.5f;         ///< Fraction of EVs.
+  float distancePriorityShare = 0.5f; ///< Fraction of distance-minded drivers.
+
+  /**
+   * @brief Flat fixed-interval profile matching Config::Spawner::SPAWN_RATES[level].
+   */
+  static DemandProfile FromSpawnLevel(int level);
+
+  /**
+   * @brief Poisson arrivals following Config::Demand::COMMUTER_CURVE.
+   * @param scale Multiplier on COMMUTER_PEAK_RATE.
+   */
+  static DemandProfile Commuter(float scale);
+
+  /**
+   * @brief Flat Poisson load of Config::Demand::STRESS_RATE per unit of scale.
+   */
+  static DemandProfile Stress(float scale);
+};
+
+/**
+ * @class DemandScheduler
+ * @brief Samples arrivals ahead of time and queues them per entry lane.
+ *
+ * Arrivals are pre-sampled into a time-sorted queue up to PRESAMPLE_HORIZON ahead of the clock.
+ * Once due they move to the FIFO of their entry lane, where they wait until the caller finds the
+ * lane clear and admits them; any number can be due per tick. Lanes that stay blocked defer
+ * arrivals in order and shed load (balk) past MAX_DEFERRED_PER_LANE.
+ *
+ * With a trace attached (setTrace), arrivals are replayed from a recorded gate log instead of the
+ * profile: its timestamps (shifted so the first entry arrives now), vehicle classes, dwell times
+ * and states of charge are used as recorded, while entry side and priority still come from the
+ * profile's mix. Replay ends with the trace.
+ *
+ * The scheduler owns its random engine, so a seeded run produces the same arrivals regardless of
+ * other users of raylib's generator. Queues reuse their storage, so steady-state ticks do not
+ * allocate.
+ */
+class DemandScheduler {
+public:
+  struct Stats {
+    uint64_t sampled = 0;  ///< Arrivals generated.
+    uint64_t admitted = 0; ///< Arrivals that entered the map.
+    uint64_t balked = 0;   ///< Arrivals dropped because their lane queue was full.
+    double totalDelay = 0; ///< Sum of admission delays (seconds).
+  };
+
+  /**
+   * @struct Fork
+   * @brief The arrival process at one instant: profile, clock, pre-sampled arrivals and random engine.
+   *
+   * A scheduler restored from a fork draws the same arrivals the original would have. Lane queues
+   * and an attached trace are not part of it: a fork of a replaying scheduler continues with the
+   * profile.
+   */
+  struct Fork {
+    DemandProfile profile;
+    std::mt19937_64 rng;
+    double now = 0.0;
+    double lastSampleTime = 0.0;
+    std::vector<Arrival> upcoming;
+  };
+
+  explicit DemandScheduler(uint64_t seed);
+  ~DemandScheduler();
+
+  /**
+   * @brief Switches the arrival process. Already due (waiting) arrivals are kept.
+   *
+   * While a trace is replaying only the traffic mix changes.
+   */
+  void setProfile(const DemandProfile &profile);
+  const DemandProfile &getProfile() const { return profile; }
+
+  /**
+   * @brief Replays a gate log from now on, replacing the profile's arrival process.
+   */
+  void setTrace(std::unique_ptr<TraceReader> trace);
+  const TraceReader *getTrace() const { return trace.get(); }
+
+  /**
+   * @brief Advances the clock and moves due arrivals into their lane queues.
+   * @param dt Simulation seconds.
+   */
+  void advance(double dt);
+
+  /**
+   * @brief Queues an extra arrival right now (e.g. the manual Spawn button).
+   */
+  void requestArrival();
+
+  /**
+   * @brief Is someone waiting to enter on this side?
+   */
+  bool hasWaiting(bool fromLeft) const { return !lanes[fromLeft ? 1 : 0].empty(); }
+  size_t getWaiting(bool fromLeft) const { return lanes[fromLeft ? 1 : 0].size(); }
+
+  /**
+   * @brief Removes and returns the first waiting arrival of a lane. Requires hasWaiting().
+   */
+  Arrival admit(bool fromLeft);
+
+  /**
+   * @brief Pops the next arrival in time order, bypassing the lane queues.
+   *
+   * For models without road occupancy (the DES). Do not mix with advance()/admit().
+   */
+  Arrival popNext();
+
+  double getTime() const { return now; }
+
+  /**
+   * @brief Copies the arrival process into out, reusing its storage.
+   */
+  void fork(Fork &out) const;
+
+  /**
+   * @brief Continues from a fork; waiting arrivals, the trace and the stats are dropped.
+   */
+  void restore(const Fork &fork);
+
+  /**
+   * @brief Restarts the random engine (e.g. for another replication of a forked run).
+   */
+  void reseed(uint64_t seed) { rng.seed(seed); }
+
+  /**
+   * @brief Current time of day in hours [0, 24).
+   */
+  double getTimeOfDay() const;
+
+  const Stats &getStats() const { return stats; }
+
+private:
+  /**
+   * @brief FIFO over a vector that is compacted in place instead of reallocated.
+   */
+  class ArrivalQueue {
+  public:
+    bool empty() const { return head == items.size(); }
+    size_t size() const { return items.size() - head; }
+    const Arrival &front() const { return items[head]; }
+    std::span<const Arrival> view() const { return std::span<const Arrival>(items).subspan(head); }
+    void push(const Arrival &a) {
+      if (items.size() == items.capacity())
+        MemoryStats::markTickEventful(); // Grows to a new high
+      items.push_back(a);
+    }
+    Arrival pop();
+    void clear() {
+      items.clear();
+      head = 0;
+    }
+
+  private:
+    std::vector<Arrival> items;
+    size_t head = 0;
+  };
+
+  Arrival sampleNext();
+  Arrival sampleTrace();
+  Arrival makeArrival(double time);
+  double rateAt(double time) const;
+  void refill(double until);
+
+  DemandProfile profile;
+  std::mt19937_64 rng;
+
+  std::unique_ptr<TraceReader> trace;
+  bool traceStarted = false;
+  double traceOrigin = 0.0; ///< Trace timestamp minus simulation time.
+
+  double now = 0.0;
+  double lastSampleTime = 0.0; ///< Time of the last generated arrival (the process' own clock).
+
+  ArrivalQueue upcoming;             ///< Pre-sampled, time sorted.
+  std::array<ArrivalQueue, 2> lanes; ///< Due but not yet admitted, indexed by fromLeft.
+
+  Stats stats;
+};
@@ -0,0 +1,232 @@
+#pragma once
+#include "entities/Car.hpp"
+#include "entities/map/Modules.hpp"
+#include "systems/DemandScheduler.hpp"
+#include "systems/TrafficPolicy.hpp"
+#include <cstdint>
+#include <memory>
+#include <queue>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+/**
+ * @file DiscreteEventSimulator.hpp
+ * @brief Event-driven capacity model of a generated map.
+ */
+
+/**
+ * @struct DesConfig
+ * @brief Parameters of one discrete-event run.
+ */
+struct DesConfig {
+  DemandProfile demand = DemandProfile::FromSpawnLevel(3); ///< Arrival process and traffic mix.
+  double horizonSeconds = 7 * 24 * 3600.0;                 ///< Simulated time span.
+  uint64_t seed = 1;                                       ///< Seed of the run's random engine.
+  double sampleInterval = 300.0;                           ///< Spacing of the occupancy curve samples (seconds).
+  std::string tracePath;                                   ///< Gate log replayed instead of the demand profile.
+  bool facilityCurves = false;                             ///< Also sample every facility's occupancy.
+};
+
+/**
+ * @struct DesStart
+ * @brief Live state a run continues from instead of an empty map (see DiscreteEventSimulator::restart).
+ */
+struct DesStart {
+  /// A spot held by a car of the live simulation.
+  struct Hold {
+    int facility; ///< Index among the map's parking and charging modules, in module order.
+    int spot;
+    bool parked; ///< false: the spot is reserved and the car still on its way in.
+    /// Parked: time left on the car's timer, negative to draw a charging stay.
+    /// On its way: time since its path was assigned.
+    float seconds;
+    Car::CarType type;
+    Car::Priority priority;
+    bool enteredFromLeft;
+    float battery;
+  };
+
+  DemandScheduler::Fork demand; ///< Arrival process, clock (time of day) and random engine.
+  std::vector<Hold> holds;
+};
+
+/**
+ * @struct DesReport
+ * @brief Aggregate results of a run.
+ *
+ * Occupancy figures count OCCUPIED spots only (reserved spots whose car is still driving in are
+ * free for statistics), the same definition the dashboard uses.
+ */
+struct DesReport {
+  double simulatedSeconds = 0.0;
+  uint64_t eventsProcessed = 0;
+
+  int parkingSpots = 0; ///< Capacity of the layout.
+  int chargingSpots = 0;
+
+  uint64_t arrivals = 0;       ///< Cars spawned.
+  uint64_t parkedVisits = 0;   ///< Visits that ended at a parking spot.
+  uint64_t chargingVisits = 0; ///< Visits that ended at a charger.
+  uint64_t passedThrough = 0;  ///< Cars that found no free spot.
+
+  double meanOccupancy = 0.0;         ///< Time-weighted, all spots (0-1).
+  double meanParkingOccupancy = 0.0;  ///< Time-weighted, parking spots (0-1).
+  double meanChargingOccupancy = 0.0; ///< Time-weighted, charging spots (0-1).
+  double peakOccupancy = 0.0;         ///< Highest instantaneous occupancy (0-1).
+  double meanDwellSeconds = 0.0;      ///< Average time a car holds its spot.
+
+  std::vector<float> occupancyCurve; ///< Overall occupancy every DesConfig::sampleInterval.
+  std::vector<std::vector<float>> facilityCurves; ///< Per facility, with DesConfig::facilityCurves.
+
+  /**
+   * @brief Multi-line human readable summary.
+   */
+  std::string format() const;
+};
+
+/**
+ * @class DiscreteEventSimulator
+ * @brief Long-horizon capacity model that skips per-tick steering.
+ *
+ * Cars are reduced to a handful of events (arrive, reach spot, leave spot, leave map) processed in
+ * time order from a priority queue. Decisions come from TrafficPolicy, the same rules the
+ * TrafficSystem applies, and every travel time comes from the PathPlanner path the live car would
+ * drive, timed with PathPlanner::EstimateTravelTime (AIPhase speed factors). Charging departures are
+ * sampled in closed form from the same hazard the live model rolls every tick.
+ *
+ * Arrivals come from the same DemandScheduler the live game uses (profile or replayed trace), but
+ * enter at their sampled time:
+ * the entry lane clearance that defers live spawns is not modelled.
+ *
+ * Not modelled: acceleration, collision avoidance and queuing on the road. Cars never block each
+ * other, so the DES slightly underestimates time-to-spot when the road is congested.
+ *
+ * The simulator keeps its own copy of the facility layout; the Modules it was built from are never
+ * touched. Path precomputation draws from the calling thread's FrameArena, so callers outside the
+ * tick loop should reset it afterwards.
+ *
+ * restart() reuses that layout for another run from a captured live state, so forecasts pay for
+ * the path precomputation once. Cars waiting in the live entry lanes are not part of that state.
+ */
+class DiscreteEventSimulator {
+public:
+  /**
+   * @brief Builds the model from a map.
+   * @param modules Roads and facilities (e.g. from WorldGenerator or the EntityManager).
+   * @param config Run parameters.
+   */
+  DiscreteEventSimulator(const std::vector<std::unique_ptr<Module>> &modules, const DesConfig &config);
+
+  /**
+   * @brief Runs for the configured horizon. Call once per simulator, or once after each restart().
+   * @return The aggregated statistics.
+   */
+  DesReport run();
+
+  /**
+   * @brief Drops all dynamic state and continues from a live one at its clock.
+   * @param start Held spots and the arrival process; holds outside the layout are ignored.
+   * @param replication 0 continues the live arrival stream, higher values draw fresh arrivals.
+   */
+  void restart(const DesStart &start, uint64_t replication);
+
+  /**
+   * @brief Replaces the layout with the one of an edited map; the next restart() starts on it.
+   * @param modules Roads and facilities in module order; they must outlive the call.
+   */
+  void rebuild(std::span<const Module *const> modules);
+
+private:
+  enum class EventKind : uint8_t { Arrival, ReachSpot, LeaveSpot, LeaveMap };
+
+  struct Event {
+    double time;
+    uint64_t sequence; ///< Insertion order; breaks ties deterministically.
+    EventKind kind;
+    int car;
+
+    bool operator>(const Event &other) const {
+      return time != other.time ? time > other.time : sequence > other.sequence;
+    }
+  };
+
+  struct SimSpot {
+    float price;
+    float entryTime[2]; ///< Spawn to spot, indexed by enteredFromLeft.
+    float exitTime[2];  ///< Spot to map edge, indexed by exitRight.
+    SpotState state = SpotState::FREE;
+    int freeSlot = -1; ///< Position in SimFacility::freeSpots while FREE.
+  };
+
+  struct SimFacility {
+    ModuleType type;
+    WorldCoord position;
+    std::vector<SimSpot> spots;
+    std::vector<int> freeSpots; ///< Unordered list of FREE spot indices for O(1) random picks.
+    int occupied = 0;
+    bool closed = false; ///< Takes no new cars (Module::isClosed).
+  };
+
+  struct SimCar {
+    Car::CarType type;
+    Car::Priority priority;
+    bool enteredFromLeft;
+    float battery;
+    float dwell = -1.0f; ///< Replayed stay, negative to draw it.
+    int facility = -1;
+    int spot = -1;
+    double parkedAt = 0.0;
+  };
+
+  void buildModel(std::span<const Module *const> modules);
+  void schedule(double time, EventKind kind, int car);
+  void advanceClock(double time);
+
+  void occupy(int car);
+
+  void handleArrival();
+  void handleReachSpot(int car);
+  void handleLeaveSpot(int car);
+  void handleLeaveMap(int car);
+
+  int allocateCar();
+  void takeSpot(SimFacility &fac, int spot, SpotState state);
+  void releaseSpot(SimFacility &fac, int spot);
+
+  float uniform() { return std::uniform_real_distribution<float>(0.0f, 1.0f)(rng); }
+
+  DesConfig config;
+  std::mt19937_64 rng;        ///< Spot picks, stays and exits: these depend on the layout.
+  std::mt19937_64 arrivalRng; ///< Battery and charging wish, a fixed number of draws per arrival.
+  DemandScheduler demand;
+  Arrival nextArrival{}; ///< Arrival the pending Arrival event stands for.
+
+  // --- Static layout ---
+  std::vector<SimFacility> facilities;
+  WorldCoord spawnPoint[2] = {}; ///< Indexed by enteredFromLeft.
+  bool hasSpawn[2] = {};
+  float passThroughTime = 0.0f;
+  int parkingSpotTotal = 0;
+  int chargingSpotTotal = 0;
+
+  // --- Dynamic state ---
+  std::priority_queue<Event, std::vector<Event>, std::greater<>> queue;
+  uint64_t nextSequence = 0;
+  double now = 0.0;
+  double end = 0.0; ///< Clock at the horizon.
+  std::vector<SimCar> cars;
+  std::vector<int> freeCars;
+  std::vector<FacilityOffer> offers; ///< Reused per arrival.
+  int occupiedParking = 0;
+  int occupiedCharging = 0;
+
+  // --- Statistics ---
+  DesReport report;
+  double occupiedParkingSeconds = 0.0;
+  double occupiedChargingSeconds = 0.0;
+  double dwellSecondsTotal = 0.0;
+  uint64_t dwellCount = 0;
+  double nextSampleTime = 0.0;
+};
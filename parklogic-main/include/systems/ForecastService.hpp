@@ -0,0 +1,136 @@
+#pragma once
+#include "core/EventBus.hpp"
+#include "events/GameEvents.hpp"
+#include "systems/DiscreteEventSimulator.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class EntityManager;
+class Module;
+class SystemScheduler;
+class TrafficSystem;
+
+/**
+ * @file ForecastService.hpp
+ * @brief Background look-ahead of facility occupancy.
+ */
+
+/**
+ * @struct OccupancyForecast
+ * @brief Predicted occupancy from one captured live state onwards.
+ */
+struct OccupancyForecast {
+  double takenAt = 0.0;                   ///< Simulation time of the capture (seconds since the scene started).
+  double sampleInterval = 0.0;            ///< Seconds between curve samples; sample 0 is the capture itself.
+  std::vector<float> overall;             ///< Occupied share of all spots (0-1).
+  std::vector<const Module *> facilities; ///< Module of each facility curve.
+  std::vector<std::vector<float>> curves; ///< Occupied share per facility, sampled like overall.
+  double computeMillis = 0.0;             ///< Wall time the forecaster spent on it.
+
+  /// Elements the vectors hold room for; a copy into this forecast allocated if it changed.
+  size_t capacity() const;
+};
+
+/**
+ * @class ForecastService
+ * @brief Predicts occupancy Config::Forecast::HORIZON seconds ahead if current demand holds.
+ *
+ * A Bookkeeping system captures the live state while the forecaster thread is idle: every held
+ * spot with its car's timer, battery level and progress towards it, plus a fork of the
+ * DemandScheduler (profile, clock and random engine). The thread restarts a DiscreteEventSimulator
+ * from that state, averages Config::Forecast::REPLICATIONS runs and hands the curves back; the next
+ * capture publishes them as an OccupancyForecastEvent. The simulator is built once from the map,
+ * so a forecast costs event processing only.
+ *
+ * The ticking thread never waits for the forecaster: buffers are exchanged under a mutex the tick
+ * only try-locks, and nothing is captured while a forecast is in flight. Map edits do not wait
+ * either: a MapEditedEvent bumps the layout generation each capture is stamped with. When it
+ * changed, the forecaster rebuilds its model from the captured module list before forecasting, and
+ * the tick drops finished forecasts of an older generation instead of publishing them.
+ */
+class ForecastService {
+public:
+  /**
+   * @brief Builds the forecast model from the current map and starts the forecaster thread.
+   */
+  ForecastService(std::shared_ptr<EventBus> bus, const EntityManager &entityManager,
+                  const TrafficSystem &trafficSystem);
+  ~ForecastService();
+
+  ForecastService(const ForecastService &) = delete;
+  ForecastService &operator=(const ForecastService &) = delete;
+
+  /**
+   * @brief Registers the capture as a Bookkeeping system (Config::Scheduler::FORECAST_RATE).
+   */
+  void schedule(SystemScheduler &scheduler);
+
+  /**
+   * @brief Logs the forecast count, compute time and how far the horizon predictions were off.
+   */
+  void report() const;
+
+private:
+  struct Check {
+    double due;      ///< Simulation time the prediction is for.
+    float predicted; ///< Overall occupancy predicted for then.
+  };
+
+  struct Capture {
+    uint64_t generation = 0;             ///< Layout generation the state was captured on.
+    std::vector<const Module *> modules; ///< The module list then; removed ones stay alive (MapEditor).
+    DesStart start;
+  };
+
+  void indexFacilities();
+  void onMapEdited();
+
+  void capture();
+  void fillStart(DesStart &start) const;
+  float liveOccupancy() const;
+
+  void forecasterLoop();
+  void forecast(const Capture &capture, OccupancyForecast &out);
+
+  std::shared_ptr<EventBus> eventBus;
+  const EntityManager &entityManager;
+  const TrafficSystem &trafficSystem;
+  std::vector<Subscription> eventTokens;
+
+  // --- Forecaster thread ---
+  DiscreteEventSimulator model;
+  uint64_t modelGeneration = 0;                ///< Layout generation the model was built from.
+  std::vector<const Module *> modelFacilities; ///< Facilities of the model, in its order.
+  Capture work;
+  OccupancyForecast result;
+
+  // --- Exchange, under mutex ---
+  std::mutex mutex;
+  std::condition_variable wake;
+  Capture inbox;                 ///< Captured state waiting for the forecaster.
+  OccupancyForecast outbox;      ///< Finished forecast waiting to be published.
+  uint64_t outboxGeneration = 0; ///< Layout generation of the outbox forecast.
+  bool inboxReady = false;
+  bool outboxReady = false;
+  bool busy = false; ///< From a capture until its forecast is in the outbox.
+  bool stopping = false;
+
+  // --- Ticking thread ---
+  std::vector<const Module *> facilities; ///< Parking and charging modules in module order (the DES order).
+  std::unordered_map<const Module *, int> facilityIndex;
+  uint64_t layoutGeneration = 0; ///< Bumped by every map edit.
+  OccupancyForecast latest;
+  std::chrono::steady_clock::time_point lastCapture{};
+  std::vector<Check> checks; ///< Horizon predictions whose time has not come yet, oldest first.
+  uint64_t published = 0;
+  uint64_t checked = 0;
+  double absoluteError = 0.0;
+  double computeMillis = 0.0;
+
+  std::thread thread; ///< Last, so it starts after everything it uses.
+};
@@ -0,0 +1,81 @@
+#pragma once
+#include "core/EventBus.hpp"
+#include "events/GameEvents.hpp"
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * @file LoadGovernor.hpp
+ * @brief Keeps the tick within its wall-clock budget by shedding work in steps.
+ */
+
+/**
+ * @class LoadGovernor
+ * @brief Measures tick cost against the time the current pace allows and degrades stage by stage.
+ *
+ * At an effective speed multiplier s a tick may take FIXED_DELTA_TIME / s of wall time. Over every
+ * window of Config::Governor::WINDOW_TICKS the governor compares the time the ticks actually took
+ * with that budget. Above HIGH_LOAD for ESCALATE_WINDOWS windows in a row it escalates one
+ * GovernorStage; below LOW_LOAD for RELAX_WINDOWS windows in a row it relaxes one:
+ *
+ * - Demote: cars outside the camera view skip collision avoidance. Without a camera view (headless)
+ *   no car is distant, so this stage is skipped in both directions.
+ * - Slow: the loop runs at speedFactor x the requested speed, halved per escalation down to
+ *   MIN_SPEED_FACTOR, so simulated time slows down evenly instead of being dropped by the loop's
+ *   frame clamp.
+ * - Backpressure: arrivals wait in their lanes while the car count is at its level when this
+ *   stage began.
+ *
+ * Each window ends with a LoadGovernorEvent that the affected systems, the HUD, the control socket
+ * and the telemetry stream pick up. Stage changes are logged.
+ */
+class LoadGovernor {
+public:
+  explicit LoadGovernor(std::shared_ptr<EventBus> bus);
+
+  LoadGovernor(const LoadGovernor &) = delete;
+  LoadGovernor &operator=(const LoadGovernor &) = delete;
+
+  /**
+   * @brief Accounts one tick.
+   * @param dt Simulated seconds of the tick.
+   * @param tickSeconds Wall time its systems took.
+   */
+  void record(double dt, double tickSeconds);
+
+  GovernorStage getStage() const { return stage; }
+  double getSpeedFactor() const { return speedFactor; }
+  double getLoad() const { return load; }
+
+  /**
+   * @brief Logs how many windows were spent in each stage.
+   */
+  void report() const;
+
+  static const char *StageName(GovernorStage stage);
+
+private:
+  void escalate();
+  void relax();
+
+  std::shared_ptr<EventBus> eventBus;
+  std::vector<Subscription> eventTokens;
+
+  double requestedSpeed = 1.0;
+  bool viewKnown = false; ///< Set once a CameraViewEvent arrives (never when headless).
+  GovernorStage stage = GovernorStage::Normal;
+  double speedFactor = 1.0;
+  double load = 0.0;
+  int hotWindows = 0;  ///< Consecutive windows above HIGH_LOAD.
+  int calmWindows = 0; ///< Consecutive windows below LOW_LOAD.
+
+  // Current window
+  int windowTicks = 0;
+  double windowSeconds = 0.0; ///< Wall time the ticks took.
+  double windowBudget = 0.0;  ///< Wall time the effective pace allowed them.
+
+  std::array<uint64_t, 4> windowsAt{}; ///< Windows ended in each stage.
+  uint64_t escalations = 0;
+};
@@ -0,0 +1,94 @@
+#pragma once
+#include "core/EventBus.hpp"
+#include "entities/map/Modules.hpp"
+#include "events/GameEvents.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class EntityManager;
+class TrafficSystem;
+
+/**
+ * @file MapEditor.hpp
+ * @brief Runtime facility edits on a live map.
+ */
+
+/**
+ * @class MapEditor
+ * @brief Inserts, removes, converts, closes and reopens facilities while the simulation runs.
+ *
+ * Edits arrive as EditMapEvents (control socket) and are applied at the tick boundary. Each one
+ * touches only what depends on the facility; the world, the roads and the other facilities stay
+ * as they are:
+ * - Insert: builds a facility on a free side of an entrance road, where WorldGenerator would
+ *   have placed it. It must not overlap another facility or leave the world.
+ * - Remove: takes the facility out of the module list. Cars on their way there that have not
+ *   passed its gate pick another spot from where they are (TrafficSystem::assignDestination);
+ *   cars inside it leave for a map edge (TrafficSystem::evacuate).
+ * - Convert: Remove, then Insert of another type in the same place, in one step.
+ * - Close / Reopen: a closed facility takes no new cars; cars holding a spot there stay.
+ *
+ * A MapEditedEvent follows every applied edit while a replaced module is still alive, so the
+ * forecast, the history and the dashboard drop their references to it. Rejected edits change
+ * nothing; they are logged and published as a MapEditRejectedEvent with the reason.
+ *
+ * Facilities are addressed by their Module::getFacilityId(), which the EntityManager hands out in
+ * module order and never reuses. Removing a facility does not renumber the others, an inserted one
+ * gets the next free id and a converted one keeps its id. Entrance roads are numbered in module
+ * order among the roads with a side entrance (edits never add or remove roads).
+ */
+class MapEditor {
+public:
+  MapEditor(std::shared_ptr<EventBus> bus, EntityManager &entityManager, TrafficSystem &trafficSystem);
+
+  MapEditor(const MapEditor &) = delete;
+  MapEditor &operator=(const MapEditor &) = delete;
+
+  /**
+   * @brief Logs the applied and rejected edits and the mean time per edit; silent without edits.
+   */
+  void report() const;
+
+  static bool IsEntrance(const Module &module);
+  static bool ParseFacilityType(std::string_view name, ModuleType &type);
+  static const char *FacilityTypeName(ModuleType type); ///< As accepted by ParseFacilityType.
+
+private:
+  void apply(const EditMapEvent &e);
+  bool insert(int entrance, bool top, ModuleType type);
+  bool replace(Module *facility, bool convert, ModuleType type);
+  bool setClosed(Module *facility, bool closed);
+
+  /// Logs the reason and publishes it as a MapEditRejectedEvent; returns false.
+  bool reject(std::string reason);
+
+  Module *facilityAt(int id) const;
+  Module *entranceAt(int number) const;
+
+  /**
+   * @brief Builds a facility of the type on one side of the road, placed against its entrance.
+   * @return nullptr if the road has no entrance on that side.
+   */
+  static std::unique_ptr<Module> Build(Module &road, bool top, ModuleType type);
+
+  /**
+   * @brief Does the facility stay inside the world and clear of every other facility but `ignore`?
+   */
+  bool fits(const Module &facility, const Module *ignore) const;
+
+  std::shared_ptr<EventBus> eventBus;
+  EntityManager &entityManager;
+  TrafficSystem &trafficSystem;
+  std::vector<Subscription> eventTokens;
+  std::vector<std::unique_ptr<Module>> retired; ///< Removed facilities, kept until the scene ends.
+
+  uint64_t applied = 0;
+  uint64_t rejected = 0;
+  uint64_t replanned = 0; ///< Cars sent to another facility.
+  uint64_t evacuated = 0; ///< Cars sent out of a removed facility.
+  double editMillis = 0.0;
+  double worstMillis = 0.0;
+};
@@ -0,0 +1,127 @@
+#pragma once
+#include "core/EventBus.hpp"
+#include "events/GameEvents.hpp"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+class EntityManager;
+class Module;
+class SystemScheduler;
+class TrafficSystem;
+
+/**
+ * @file OccupancyHistory.hpp
+ * @brief Fixed-memory occupancy history at several resolutions.
+ */
+
+/**
+ * @class OccupancyHistory
+ * @brief Per-facility occupancy, reservations, price and queue depth over time, in constant memory.
+ *
+ * A Bookkeeping system samples every facility Config::History::SAMPLE_RATE times per simulated
+ * second. Row 0 (MAP_ROW) covers the whole map; the others are facilities, one each:
+ * - Occupancy: occupied share of the spots (0-1).
+ * - Reserved: spots held by cars on their way.
+ * - Price: the facility's price multiplier (map: the facility mean).
+ * - Queue: cars past the gate still searching their spot (map: arrivals waiting at the entries).
+ *
+ * Samples roll up into 1 s buckets, those into 1 min buckets and those into 15 min buckets. Each
+ * bucket keeps min, max and mean. Every Level is a ring of Config::History::CAPACITY buckets,
+ * allocated up front, so the memory does not depend on the length of the run.
+ *
+ * The sampler is the only writer and only appends: it fills the slot after the newest bucket and
+ * then publishes it by advancing the ring's head. read() copies without locking and retries in
+ * the rare case the writer lapped the copied range meanwhile, so readers never stall the tick.
+ *
+ * Rows are fixed at construction. On a MapEditedEvent a converted facility keeps the row of the
+ * one it replaced; a removed one leaves its row vacant (zeros from then on), and an inserted one
+ * takes the lowest vacant row, whose older buckets still describe the previous facility. With no
+ * vacant row the new facility is only part of the map row.
+ */
+class OccupancyHistory {
+public:
+  enum class Level { Second, Minute, Quarter, Count };
+  enum class Channel { Occupancy, Reserved, Price, Queue, Count };
+
+  static constexpr int LEVELS = (int)Level::Count;
+  static constexpr int CHANNELS = (int)Channel::Count;
+  static constexpr int MAP_ROW = 0;
+
+  struct Bucket {
+    float min;
+    float max;
+    float mean;
+  };
+
+  /**
+   * @brief Sizes the rings for the facilities of the current map.
+   */
+  OccupancyHistory(std::shared_ptr<EventBus> bus, const EntityManager &entityManager,
+                   const TrafficSystem &trafficSystem);
+
+  OccupancyHistory(const OccupancyHistory &) = delete;
+  OccupancyHistory &operator=(const OccupancyHistory &) = delete;
+
+  /**
+   * @brief Registers the sampler as a Bookkeeping system (Config::History::SAMPLE_RATE).
+   */
+  void schedule(SystemScheduler &scheduler);
+
+  /**
+   * @brief Row of a facility's series, or -1 if the module is not a facility or got no row.
+   */
+  int rowOf(const Module *module) const;
+  int getRowCount() const { return rows; }
+
+  /**
+   * @brief Copies the newest buckets of one series, oldest first. Safe from any thread.
+   * @param out Receives at most out.size() buckets (and at most Config::History::CAPACITY - 1).
+   * @return Number of buckets copied.
+   */
+  size_t read(Level level, int row, Channel channel, std::span<Bucket> out) const;
+
+  /**
+   * @brief Bytes held by the rings; fixed at construction.
+   */
+  size_t getMemoryBytes() const;
+
+  static double BucketSeconds(Level level);
+  static const char *LevelName(Level level);
+
+private:
+  struct Accumulator {
+    float min;
+    float max;
+    double sum;
+    uint32_t count;
+  };
+
+  struct Ring {
+    std::vector<Bucket> slots;        ///< CAPACITY x rows x CHANNELS.
+    std::atomic<uint64_t> head{0};    ///< Buckets ever completed; the newest is head - 1.
+    std::vector<Accumulator> open;    ///< Bucket in progress, rows x CHANNELS.
+    int inputs = 0;                   ///< Samples or finer buckets folded into it.
+  };
+
+  void onMapEdited(const MapEditedEvent &e);
+  void sample();
+  void add(int level, size_t index, float min, float max, float mean);
+  void close(int level);
+
+  std::shared_ptr<EventBus> eventBus;
+  const EntityManager &entityManager;
+  const TrafficSystem &trafficSystem;
+  std::vector<Subscription> eventTokens;
+
+  std::vector<const Module *> facilities; ///< Facility of row i + 1 (nullptr: vacant).
+  std::unordered_map<const Module *, int> facilityRows;
+  int rows = 0;
+  std::vector<float> values; ///< The current sample, rows x CHANNELS.
+
+  std::array<Ring, LEVELS> rings;
+};
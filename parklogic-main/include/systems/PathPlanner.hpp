@@ -3,11 +3,16 @@
 /**
  * @file PathPlanner.hpp
  * @brief Static utility class for calculating car paths.
+ *
+ * Generated paths are transient: they are allocated from the per-tick FrameArena and must be
+ * copied (e.g. by Car::setPath) before the end of the tick.
  */
 #include "config.hpp"
 #include "entities/Car.hpp"
 #include "entities/map/Modules.hpp"
 #include "entities/map/Waypoint.hpp"
+#include <memory_resource>
+#include <span>
 #include <vector>
 
 class PathPlanner {
@@ -18,16 +23,44 @@ public:
    * @param car The car entity (used for velocity/state).
    * @param targetFac The target facility module.
    * @param targetSpot The specific spot within the facility.
-   * @return std::vector<Waypoint> The ordered list of waypoints.
+   * @return std::pmr::vector<Waypoint> The ordered list of waypoints (FrameArena storage).
    */
-  static std::vector<Waypoint> GeneratePath(const Car *car, const Module *targetFac, const Spot &targetSpot);
+  static std::pmr::vector<Waypoint> GeneratePath(const Car *car, const Module *targetFac, const Spot &targetSpot);
+
+  /**
+   * @brief Car-less variant of GeneratePath, used by planners that have no live Car (e.g. the DES).
+   *
+   * @param startPos Position the path starts from.
+   * @param movingRight Direction of travel on the main road (selects the lane).
+   */
+  static std::pmr::vector<Waypoint> GeneratePath(const WorldCoord &startPos, bool movingRight, const Module *targetFac,
+                                                 const Spot &targetSpot);
 
   /**
    * @brief Constructs a path for a car to leave the facility and map.
    * @param finalX The X coordinate (in Meters) where the car should exit the map.
    */
-  static std::vector<Waypoint> GenerateExitPath(const Car *car, const Module *currentFac, const Spot &currentSpot,
-                                                bool exitRight, float finalX);
+  static std::pmr::vector<Waypoint> GenerateExitPath(const Car *car, const Module *currentFac,
+                                                     const Spot &currentSpot, bool exitRight, double finalX);
+
+  /**
+   * @brief Car-less variant of GenerateExitPath.
+   * @param startPos Position the path starts from (normally the spot itself).
+   */
+  static std::pmr::vector<Waypoint> GenerateExitPath(const WorldCoord &startPos, const Module *currentFac,
+                                                     const Spot &currentSpot, bool exitRight, double finalX);
+
+  /**
+   * @brief Estimates how long a car needs to drive a path.
+   *
+   * Each segment is driven at MAX_SPEED scaled by the speedLimitFactor of the waypoint it ends at,
+   * i.e. the AIPhase the segment was generated with. Acceleration and avoidance are ignored.
+   *
+   * @param startPos Position the path starts from.
+   * @param path The waypoints to follow.
+   * @return Travel time in seconds.
+   */
+  static float EstimateTravelTime(const WorldCoord &startPos, std::span<const Waypoint> path);
 
 private:
   /**
@@ -61,6 +94,6 @@ private:
   /**
    * @brief Adds a segment of waypoints from start to target, subdividing based on the Phase config.
    */
-  static void AddSegment(std::vector<Waypoint> &path, Vector2 startPos, Waypoint target,
+  static void AddSegment(std::pmr::vector<Waypoint> &path, const WorldCoord &startPos, Waypoint target,
                          const Config::CarAI::AIPhase &phase);
 };
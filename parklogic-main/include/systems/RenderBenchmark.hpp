@@ -0,0 +1,86 @@
+#pragma once
+#include "core/EventBus.hpp"
+#include "core/LaunchOptions.hpp"
+#include "core/MemoryStats.hpp"
+#include "core/RenderStats.hpp"
+#include "core/WorldCoord.hpp"
+#include <array>
+#include <memory>
+#include <vector>
+
+class GameScene;
+class Window;
+
+/**
+ * @file RenderBenchmark.hpp
+ * @brief Reproducible measurement of the rendering cost.
+ */
+
+/**
+ * @class RenderBenchmark
+ * @brief Renders one fixed scene along a scripted camera path and reports what the frames cost.
+ *
+ * The scene is the game's: the --map-seed layout, populated by Config::RenderBench::WARMUP_SECONDS
+ * of simulation seeded with --seed (or replaying --trace), then frozen so every run draws the same
+ * cars. The script zooms from Config::MIN_ZOOM to Config::MAX_ZOOM and back over the map center,
+ * then pans across the map at close, normal and wide zoom, Config::RenderBench::SEGMENT_FRAMES
+ * frames per segment.
+ *
+ * Frames go to the logical render target of a hidden window without vsync or frame cap (see
+ * Window), by default on a software GL driver. RenderStats splits every frame into passes; the
+ * report gives the frame time per segment and, per pass, the time, draw calls and texture binds.
+ * Frame time is wall time on the render thread, buffer swap included, which with a software
+ * driver covers the rasterization as well. Builds with PARKLOGIC_TRACK_ALLOCATIONS also report
+ * the heap allocations of the warm-up ticks and of each segment's frames.
+ */
+class RenderBenchmark {
+public:
+  /**
+   * @brief Opens the window and loads the scene; the simulation has not run yet.
+   */
+  explicit RenderBenchmark(const LaunchOptions &options);
+  ~RenderBenchmark();
+
+  RenderBenchmark(const RenderBenchmark &) = delete;
+  RenderBenchmark &operator=(const RenderBenchmark &) = delete;
+
+  /**
+   * @brief Warms the scene up, renders the script and logs the report.
+   */
+  void run();
+
+private:
+  struct Segment {
+    const char *name;
+    WorldCoord from;
+    WorldCoord to;
+    float zoomFrom;
+    float zoomTo;
+  };
+
+  /**
+   * @struct Totals
+   * @brief Frames of one segment, or of the whole script.
+   */
+  struct Totals {
+    std::vector<double> frameMillis;
+    std::array<RenderStats::PassCounters, RenderStats::PassCount> passes{};
+    std::array<uint32_t, RenderStats::PassCount> peakDrawCalls{};
+    MemoryStats::Report allocations; ///< Of all frames (PARKLOGIC_TRACK_ALLOCATIONS).
+
+    void add(const RenderStats::Frame &frame, const MemoryStats::Report &frameAllocations);
+  };
+
+  std::vector<Segment> script() const;
+  void warmUp();
+  void renderSegment(const Segment &segment, Totals &segmentTotals, Totals &scriptTotals);
+  static void Report(const char *name, Totals &totals);
+
+  LaunchOptions options;
+  std::shared_ptr<EventBus> eventBus;
+  std::vector<Subscription> eventTokens;
+  std::unique_ptr<Window> window;
+  std::unique_ptr<GameScene> scene;
+  float worldWidth = 0.0f;
+  float worldHeight = 0.0f;
+};
@@ -0,0 +1,112 @@
+#pragma once
+#include "config.hpp"
+#include "core/SharedMemory.hpp"
+#include "core/SpscRing.hpp"
+#include "entities/Car.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * @file ShardExchange.hpp
+ * @brief Shared memory through which the shard processes of one run talk to each other.
+ */
+
+/**
+ * @struct MigrationRecord
+ * @brief A car leaving its shard across a seam. Produced at the end of tick `tick`; the receiving
+ * shard simulates the car from tick + 1 on.
+ */
+struct MigrationRecord {
+  uint64_t tick;
+  Car::MigrationState car;
+};
+
+/**
+ * @struct GhostRecord
+ * @brief Pose of a car near a seam at the end of tick `tick`, for the neighbour's avoidance.
+ */
+struct GhostRecord {
+  uint64_t tick;
+  uint32_t id;
+  uint8_t state; ///< Car::CarState.
+  WorldCoord position;
+  Vector2 velocity;
+  float rotation;
+};
+
+using MigrationRing = SpscRing<MigrationRecord, Config::Shard::MIGRATION_RING>;
+using GhostRing = SpscRing<GhostRecord, Config::Shard::GHOST_RING>;
+
+/**
+ * @struct ShardStatus
+ * @brief Progress and counters of one shard; written only by that shard, read by everyone.
+ */
+struct alignas(64) ShardStatus {
+  std::atomic<uint64_t> completedTick{0}; ///< Lockstep barrier: last tick fully simulated and sent.
+  std::atomic<bool> finished{false};
+  std::atomic<uint32_t> cars{0};
+  std::atomic<uint32_t> parked{0};
+  std::atomic<uint64_t> spawned{0};
+  std::atomic<uint64_t> migratedOut{0};
+  std::atomic<uint64_t> ghostsSent{0};
+  std::atomic<uint64_t> ghostsDropped{0};
+  std::atomic<double> occupiedSpotSeconds{0.0}; ///< Over the facilities inside the shard.
+  std::atomic<double> busySeconds{0.0};         ///< Wall time spent simulating (not waiting).
+  std::atomic<uint64_t> tickAllocations{0};     ///< Heap allocations inside ticks (PARKLOGIC_TRACK_ALLOCATIONS).
+  std::atomic<uint64_t> tickAllocationBytes{0};
+};
+
+/**
+ * @class ShardExchange
+ * @brief Owns the shared segment of a sharded run and hands out its parts.
+ *
+ * Layout: stop flag, one ShardStatus per shard, per seam a migration and a ghost ring in each
+ * direction, then one state byte per spot of the map. The coordinator creates it before forking,
+ * so every shard inherits the mapping at the same address; all cross-process traffic goes through
+ * the lock-free rings and atomics in it.
+ */
+class ShardExchange {
+public:
+  /**
+   * @brief Creates and initializes the segment.
+   * @throws std::runtime_error if the segment cannot be created.
+   */
+  ShardExchange(int shardCount, size_t spotCount);
+
+  int getShardCount() const { return shardCount; }
+  ShardStatus &status(int shard) const { return statuses[shard]; }
+
+  void requestStop() const { header->stop.store(true, std::memory_order_relaxed); }
+  bool stopRequested() const { return header->stop.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief Ring from shard `from` to its neighbour `to` (|from - to| == 1).
+   */
+  MigrationRing &migrations(int from, int to) const;
+  GhostRing &ghosts(int from, int to) const;
+
+  /**
+   * @brief Moves the spot states of every facility into the segment (Module::bindSpotStates).
+   */
+  void bindSpotStates(const std::vector<std::unique_ptr<Module>> &modules) const;
+
+private:
+  struct Header {
+    std::atomic<bool> stop{false};
+  };
+
+  struct Seam {
+    MigrationRing migrations[2]; ///< [0] left to right, [1] right to left.
+    GhostRing ghosts[2];
+  };
+
+  int shardCount;
+  size_t spotCount;
+  std::unique_ptr<SharedMemory> memory;
+  Header *header = nullptr;
+  ShardStatus *statuses = nullptr;
+  Seam *seams = nullptr;
+  std::atomic<uint8_t> *spotStates = nullptr;
+};
@@ -0,0 +1,42 @@
+#pragma once
+#include "entities/map/Modules.hpp"
+#include <memory>
+#include <vector>
+
+/**
+ * @file ShardPlan.hpp
+ * @brief Partition of the map into vertical strips for multi-process runs.
+ */
+
+/**
+ * @struct ShardPlan
+ * @brief Seams along X; shard i simulates every car whose x lies in [lower(i), upper(i)).
+ *
+ * The map is a single east-west road, so strips along X are the natural cut: cars mostly cross a
+ * seam while driving along the road.
+ */
+struct ShardPlan {
+  std::vector<double> seams; ///< Ascending x positions of the boundaries (shardCount() - 1 of them).
+
+  int shardCount() const { return (int)seams.size() + 1; }
+
+  /**
+   * @brief Index of the shard owning position x.
+   */
+  int shardOf(double x) const;
+
+  double lower(int shard) const; ///< -infinity for the first shard.
+  double upper(int shard) const; ///< +infinity for the last shard.
+
+  /**
+   * @brief Places shards - 1 seams so every strip holds about the same number of spots.
+   *
+   * Seams sit on module edges, preferably ones that do not cut through a facility, so parked and
+   * manoeuvring cars rarely straddle two strips. A map with fewer edges than requested seams gets
+   * fewer shards.
+   *
+   * @param modules The generated map.
+   * @param shards Requested shard count (>= 1).
+   */
+  static ShardPlan Compute(const std::vector<std::unique_ptr<Module>> &modules, int shards);
+};
@@ -0,0 +1,88 @@
+#pragma once
+#include "core/EntityManager.hpp"
+#include "core/EventBus.hpp"
+#include "core/LaunchOptions.hpp"
+#include "core/SystemScheduler.hpp"
+#include "entities/map/WorldGenerator.hpp"
+#include "systems/ShardExchange.hpp"
+#include "systems/ShardPlan.hpp"
+#include "systems/StuckWatchdog.hpp"
+#include "systems/TrafficSystem.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @file ShardWorker.hpp
+ * @brief The simulation of one strip of a sharded run.
+ */
+
+/**
+ * @class ShardWorker
+ * @brief Runs EntityManager and TrafficSystem for the cars inside one shard's strip.
+ *
+ * Every shard holds the complete map (the facility choice stays global) but simulates only the
+ * cars inside its strip. Per tick it
+ *  1. waits until both neighbours finished the previous tick (shards stay in lockstep),
+ *  2. adopts the cars they handed over and refreshes the ghosts they mirrored,
+ *  3. runs the normal scheduled tick (single-threaded: the shards are the parallelism),
+ *  4. hands over cars that left the strip and mirrors those near a seam.
+ * Only the first and last shard spawn cars (at the map ends); spot reservations go through the
+ * shared spot states, so two shards can never reserve the same spot.
+ */
+class ShardWorker {
+public:
+  /**
+   * @param shard Index of the strip this process simulates.
+   * @param plan Seam positions.
+   * @param exchange Shared segment (inherited from the coordinator).
+   * @param map The generated map, with spot states already bound to the exchange.
+   * @param options Spawn level and demand trace.
+   */
+  ShardWorker(int shard, const ShardPlan &plan, const ShardExchange &exchange, GeneratedMap map,
+              const LaunchOptions &options);
+  ~ShardWorker();
+
+  ShardWorker(const ShardWorker &) = delete;
+  ShardWorker &operator=(const ShardWorker &) = delete;
+
+  /**
+   * @brief Simulates ticks 1..horizonTicks, or until a stop is requested.
+   * @param stopSignal Set by the signal handler of this process.
+   */
+  void run(uint64_t horizonTicks, const std::atomic<bool> &stopSignal);
+
+private:
+  bool waitForNeighbours(uint64_t tick, const std::atomic<bool> &stopSignal) const;
+  void receive(uint64_t tick);
+  void send(uint64_t tick);
+  int facilityIndex(const Module *facility) const;
+
+  int shard;
+  const ShardExchange &exchange;
+  double lowerX;
+  double upperX;
+  int neighbours[2] = {-1, -1}; ///< Left and right shard, -1 at the map ends.
+
+  std::shared_ptr<EventBus> eventBus;
+  std::unique_ptr<EntityManager> entityManager;
+  std::unique_ptr<TrafficSystem> trafficSystem;
+  std::unique_ptr<StuckWatchdog> watchdog;
+  SystemScheduler scheduler{0};
+  std::vector<Subscription> eventTokens;
+
+  std::unordered_map<const Module *, int> facilityIndices;
+  std::vector<const Module *> ownedFacilities; ///< Facilities inside the strip (occupancy statistic).
+  std::vector<std::unique_ptr<Car>> ghostPool; ///< Reused ghost cars; the first ghostCount are live.
+  size_t ghostCount = 0;
+
+  // Counters mirrored into ShardStatus after every tick
+  uint64_t spawned = 0;
+  uint64_t migratedOut = 0;
+  uint64_t ghostsSent = 0;
+  uint64_t ghostsDropped = 0;
+  double occupiedSpotSeconds = 0.0;
+  double busySeconds = 0.0;
+};
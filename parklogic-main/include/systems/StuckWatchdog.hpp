@@ -0,0 +1,65 @@
+#pragma once
+#include "core/EventBus.hpp"
+#include <cstdint>
+#include <memory>
+
+class EntityManager;
+class SystemScheduler;
+
+/**
+ * @file StuckWatchdog.hpp
+ * @brief Detection and deterministic recovery of cars that block each other for good.
+ */
+
+/**
+ * @class StuckWatchdog
+ * @brief Keeps head-on standoffs from growing the car population without bound.
+ *
+ * Once per simulated second (Config::Scheduler::WATCHDOG_RATE) it collects the DRIVING and EXITING
+ * cars that made no progress for Config::Watchdog::STALL_SECONDS (Car::getStalledSeconds) and
+ * indexes them by CLUSTER_RADIUS cells. Stalled cars within CLUSTER_RADIUS of each other form one
+ * cluster, such as two cars facing each other on an access road plus the queue behind them.
+ *
+ * Each cluster is resolved through its longest-stalled car (lowest id on ties), so the outcome does
+ * not depend on car order:
+ * - Right of way: while no car of the cluster has it, that car drives on without avoidance for
+ *   RIGHT_OF_WAY seconds and the others make way.
+ * - Removal: stalled for DESPAWN_SECONDS, it is removed instead, and its spot reservation is
+ *   freed. The queue behind it can then move.
+ *
+ * Interventions are logged, published as a StuckVehiclesEvent and summed up by report().
+ */
+class StuckWatchdog {
+public:
+  StuckWatchdog(std::shared_ptr<EventBus> bus, EntityManager &entityManager);
+
+  StuckWatchdog(const StuckWatchdog &) = delete;
+  StuckWatchdog &operator=(const StuckWatchdog &) = delete;
+
+  /**
+   * @brief Registers the sweep as a Traffic system (Config::Scheduler::WATCHDOG_RATE).
+   */
+  void schedule(SystemScheduler &scheduler);
+
+  /**
+   * @brief One sweep: finds the stalled clusters and resolves each.
+   */
+  void sweep();
+
+  uint64_t getRightOfWayCount() const { return rightOfWays; }
+  uint64_t getRemovedCount() const { return removed; }
+
+  /**
+   * @brief Logs the interventions; silent if there were none.
+   */
+  void report() const;
+
+private:
+  std::shared_ptr<EventBus> eventBus;
+  EntityManager &entityManager;
+
+  uint64_t sweepsWithStalls = 0;
+  uint64_t rightOfWays = 0;
+  uint64_t removed = 0;
+  size_t largestCluster = 0;
+};
@@ -0,0 +1,135 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * @file TelemetryLayout.hpp
+ * @brief Fixed layout of the live telemetry shared memory region (written by TelemetryPublisher).
+ *
+ * Region = RegionHeader (64 bytes), then SLOT_COUNT Slots. Each Slot is one complete tick:
+ * 64 bytes sequence line, TickStats (64), MAX_CARS x CarRecord (32), MAX_FACILITIES x
+ * FacilityRecord (32). All fields are little-endian and naturally aligned; offsets are fixed by the
+ * static_asserts below, so tools in any language can overlay the structs directly.
+ *
+ * Writer (once per tick, never blocks): pick the slot that is not `latest`, make its sequence odd,
+ * fill it, make the sequence even again, then store its index into `latest`.
+ *
+ * Reader (no locks, no copies required):
+ *   1. i = latest (acquire); s1 = slots[i].sequence (acquire); retry if s1 is odd
+ *   2. read whatever is needed straight from slots[i]
+ *   3. acquire fence; s2 = slots[i].sequence; the read is valid iff s1 == s2, otherwise retry
+ * Because the writer alternates slots, a reader has a whole tick (16.7 ms at 1x) to finish before
+ * the slot it is reading is touched again; retries only happen to readers slower than that.
+ *
+ * The region is ready once `magic` matches; the writer stores it last during setup.
+ */
+namespace TelemetryLayout {
+
+constexpr char MAGIC[8] = {'P', 'L', 'T', 'E', 'L', 'E', 'M', '1'};
+constexpr uint32_t VERSION = 1;
+constexpr uint32_t SLOT_COUNT = 2;
+constexpr uint32_t MAX_CARS = 2048;      // Cars beyond this are counted in TickStats::carsDropped
+constexpr uint32_t MAX_FACILITIES = 128; // Parking and charging modules, in world order
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "Shared memory sequences must be lock-free");
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "Shared memory indices must be lock-free");
+
+struct RegionHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t headerBytes;   ///< Offset of slot 0.
+  uint32_t slotBytes;     ///< Stride between slots.
+  uint32_t slotCount;
+  uint32_t maxCars;
+  uint32_t maxFacilities;
+  float tickSeconds;      ///< Simulated seconds per tick.
+  uint32_t writerPid;
+  std::atomic<uint32_t> latest; ///< Slot holding the most recent complete tick.
+  uint32_t reserved[5];
+};
+static_assert(sizeof(RegionHeader) == 64, "Telemetry header layout changed");
+
+struct TickStats {
+  uint64_t tick;           ///< Ticks simulated since the scene started (paused ticks excluded).
+  double simSeconds;       ///< Simulated time.
+  double tickMicros;       ///< Wall time the tick's systems took.
+  uint32_t carCount;       ///< Cars in the world (may exceed the records written).
+  uint32_t carsDropped;    ///< Cars not written because MAX_CARS was reached.
+  uint32_t facilityCount;  ///< FacilityRecords written.
+  uint32_t carsByState[4]; ///< Indexed by Car::CarState (DRIVING, ALIGNING, PARKED, EXITING).
+  float occupancy;         ///< OCCUPIED spots / all spots, 0-1.
+  uint8_t governorStage;   ///< GovernorStage (0 normal, 1 demote, 2 slow, 3 backpressure).
+  uint8_t reserved;
+  uint16_t demotedCars;    ///< Cars on the governor's cheap update path (saturates at 65535).
+  float speedFactor;       ///< Governor's share of the speed multiplier, 1 = unchanged.
+};
+static_assert(sizeof(TickStats) == 64, "Telemetry stats layout changed");
+
+struct CarRecord {
+  uint32_t id;       ///< Stable per scene (Car::getId).
+  float x, y;        ///< Meters.
+  float rotation;    ///< Degrees, 0 = facing up.
+  float speed;       ///< Meters per second.
+  float battery;     ///< 0-100 (EVs), 0 for combustion cars.
+  uint8_t state;     ///< Car::CarState.
+  uint8_t type;      ///< Car::CarType (0 combustion, 1 electric).
+  uint8_t priority;  ///< Car::Priority (0 price, 1 distance).
+  uint8_t flags;     ///< Bit 0: entered from the left.
+  int16_t facility;  ///< Index into Slot::facilities of the assigned facility, -1 if none.
+  int16_t spot;      ///< Spot index within that facility, -1 if none.
+};
+static_assert(sizeof(CarRecord) == 32, "Telemetry car layout changed");
+
+struct FacilityRecord {
+  float x, y;             ///< Top-left corner in meters.
+  float priceMultiplier;
+  float meanSpotPrice;
+  uint16_t spotCount;
+  uint16_t freeSpots;
+  uint16_t reservedSpots;
+  uint16_t occupiedSpots;
+  uint8_t type;           ///< ModuleType.
+  uint8_t reserved[7];
+};
+static_assert(sizeof(FacilityRecord) == 32, "Telemetry facility layout changed");
+
+struct alignas(64) Slot {
+  std::atomic<uint64_t> sequence; ///< Odd while the writer is filling the slot.
+  uint8_t sequencePad[56];        ///< Keeps the sequence on its own cache line.
+  TickStats stats;
+  CarRecord cars[MAX_CARS];
+  FacilityRecord facilities[MAX_FACILITIES];
+};
+static_assert(offsetof(Slot, stats) == 64 && offsetof(Slot, cars) == 128, "Telemetry slot layout changed");
+
+struct Region {
+  RegionHeader header;
+  Slot slots[SLOT_COUNT];
+};
+static_assert(offsetof(Region, slots) == 64, "Telemetry region layout changed");
+
+/**
+ * @brief Reader side of the protocol for C++ tools: runs read(slot) until it saw a consistent tick.
+ * @return false if the region is not initialized.
+ */
+template <typename F> bool ReadLatest(const Region &region, F &&read) {
+  if (std::memcmp(region.header.magic, MAGIC, sizeof(MAGIC)) != 0)
+    return false;
+
+  while (true) {
+    const Slot &slot = region.slots[region.header.latest.load(std::memory_order_acquire) % SLOT_COUNT];
+    uint64_t before = slot.sequence.load(std::memory_order_acquire);
+    if (before & 1)
+      continue;
+
+    read(slot);
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.sequence.load(std::memory_order_relaxed) == before)
+      return true;
+  }
+}
+
+} // namespace TelemetryLayout
@@ -0,0 +1,61 @@
+#pragma once
+#include "core/SharedMemory.hpp"
+#include "systems/TelemetryLayout.hpp"
+#include <string>
+#include <vector>
+
+class EntityManager;
+class LoadGovernor;
+class Module;
+
+/**
+ * @file TelemetryPublisher.hpp
+ * @brief Publishes live simulation state to shared memory.
+ */
+
+/**
+ * @class TelemetryPublisher
+ * @brief Writes one TelemetryLayout slot per tick for external dashboards and notebooks.
+ *
+ * publish() is called after every simulated tick. It only writes to memory it owns (the double
+ * buffered seqlock in TelemetryLayout.hpp), so readers can never stall or slow the simulation.
+ */
+class TelemetryPublisher {
+public:
+  /**
+   * @brief Creates the shared memory region and writes its header.
+   * @param name Shared memory name (e.g. "/parklogic").
+   * @param entityManager Source of cars and facilities.
+   * @param tickSeconds Simulated seconds per tick.
+   * @throws std::runtime_error if the region cannot be created.
+   */
+  TelemetryPublisher(const std::string &name, const EntityManager &entityManager, double tickSeconds);
+
+  TelemetryPublisher(const TelemetryPublisher &) = delete;
+  TelemetryPublisher &operator=(const TelemetryPublisher &) = delete;
+
+  /**
+   * @brief Writes the state at the end of a tick into the free slot and makes it the latest.
+   * @param dt Simulated seconds of this tick.
+   * @param tickMicros Wall time the tick took.
+   */
+  void publish(double dt, double tickMicros);
+
+  /**
+   * @brief Source of the governor fields of TickStats (stage 0 and factor 1 without one).
+   */
+  void setGovernor(const LoadGovernor *loadGovernor) { governor = loadGovernor; }
+
+private:
+  int facilityIndex(const Module *module) const;
+  void fill(TelemetryLayout::Slot &slot, double tickMicros);
+
+  SharedMemory memory;
+  TelemetryLayout::Region *region;
+  const EntityManager &entityManager;
+  const LoadGovernor *governor = nullptr;
+
+  std::vector<const Module *> facilities; ///< Reused each tick; position = FacilityRecord index.
+  uint64_t tick = 0;
+  double simSeconds = 0.0;
+};
@@ -0,0 +1,88 @@
+#pragma once
+#include "core/MappedFile.hpp"
+#include "entities/Car.hpp"
+#include <cstdint>
+#include <string>
+
+/**
+ * @file TraceReader.hpp
+ * @brief Streaming reader for recorded facility gate logs.
+ */
+
+/**
+ * @struct TraceRecord
+ * @brief One entry of a gate log.
+ */
+struct TraceRecord {
+  double time = 0.0;                           ///< Entry timestamp (seconds, arbitrary epoch).
+  Car::CarType type = Car::CarType::COMBUSTION; ///< Vehicle class.
+  float dwell = -1.0f;                         ///< Seconds between entry and exit, negative if unknown.
+  float battery = -1.0f;                       ///< State of charge on entry (0-100), negative if unknown.
+};
+
+/**
+ * @class TraceReader
+ * @brief Reads gate log records one at a time from a memory-mapped file.
+ *
+ * Two formats are accepted, told apart by the file's first bytes:
+ * - **CSV**: `timestamp,vehicle_class,dwell_seconds,state_of_charge`, one entry per line. The
+ *   timestamp is either seconds or `YYYY-MM-DD[T ]HH:MM:SS[.fff][Z]`; the class is `ev`/`electric`
+ *   or anything else for combustion; dwell and charge may be empty. A header line, blank lines and
+ *   `#` comments are skipped. Malformed lines are counted and skipped.
+ * - **Binary**: the compact form written by ConvertToBinary(): an 8 byte magic followed by fixed
+ *   24 byte little-endian records, parsed with no text handling at all.
+ *
+ * Memory stays constant regardless of trace length: the file is mapped, parsed in place, and the
+ * pages behind the read position are released as the reader advances. Records are expected in time
+ * order; stragglers are clamped to the previous timestamp and counted.
+ */
+class TraceReader {
+public:
+  /**
+   * @brief Opens a trace.
+   * @param path CSV or binary trace file.
+   * @throws std::runtime_error if the file cannot be mapped or has a corrupt binary header.
+   */
+  explicit TraceReader(const std::string &path);
+
+  /**
+   * @brief Reads the next record.
+   * @param out Receives the record.
+   * @return false at the end of the trace.
+   */
+  bool next(TraceRecord &out);
+
+  const std::string &getPath() const { return path; }
+  bool isBinary() const { return binary; }
+  uint64_t getRecordsRead() const { return recordsRead; }
+  uint64_t getMalformed() const { return malformed; } ///< Skipped CSV lines.
+  uint64_t getReordered() const { return reordered; } ///< Records clamped to keep time monotonic.
+
+  /**
+   * @brief Fraction of the file consumed (0-1).
+   */
+  double getProgress() const { return file.size() ? (double)offset / (double)file.size() : 1.0; }
+
+  /**
+   * @brief Converts any readable trace to the binary format.
+   * @return Number of records written.
+   * @throws std::runtime_error on I/O errors.
+   */
+  static uint64_t ConvertToBinary(const std::string &inputPath, const std::string &outputPath);
+
+private:
+  bool nextCsv(TraceRecord &out);
+  bool nextBinary(TraceRecord &out);
+  bool parseCsvLine(const char *begin, const char *end, TraceRecord &out);
+
+  std::string path;
+  MappedFile file;
+  bool binary = false;
+  size_t offset = 0;     ///< Read position in the mapping.
+  bool firstLine = true; ///< The next CSV line may be a header.
+
+  double lastTime = -1e300;
+  uint64_t recordsRead = 0;
+  uint64_t malformed = 0;
+  uint64_t reordered = 0;
+};
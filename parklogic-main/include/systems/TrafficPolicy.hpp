@@ -0,0 +1,102 @@
+#pragma once
+#include "entities/Car.hpp"
+#include "entities/map/Modules.hpp"
+#include <span>
+
+/**
+ * @file TrafficPolicy.hpp
+ * @brief Driver decision rules shared by the TrafficSystem and the discrete-event simulator.
+ *
+ * Every rule is a pure function. Randomness is passed in as a uniform roll in [0, 1) so that
+ * the live simulation (raylib's GetRandomValue) and the DES (its own seeded engine) make the
+ * same decisions from the same draws.
+ */
+
+/**
+ * @struct FacilityOffer
+ * @brief One candidate spot considered by a driver (normally one random free spot per facility).
+ */
+struct FacilityOffer {
+  int facility;   ///< Caller-defined facility index.
+  int spot;       ///< Spot index within the facility.
+  float distance; ///< Distance from the car to the facility (meters).
+  float price;    ///< Price of the offered spot.
+};
+
+namespace TrafficPolicy {
+
+/**
+ * @brief Is this module a parking facility (no chargers)?
+ */
+inline bool IsParking(ModuleType type) {
+  return type == ModuleType::SMALL_PARKING || type == ModuleType::LARGE_PARKING;
+}
+
+/**
+ * @brief Is this module a charging station?
+ */
+inline bool IsCharging(ModuleType type) {
+  return type == ModuleType::SMALL_CHARGING || type == ModuleType::LARGE_CHARGING;
+}
+
+/**
+ * @brief Decides whether an arriving car looks for a charger.
+ *
+ * Below BATTERY_LOW_THRESHOLD an EV always charges, above BATTERY_HIGH_THRESHOLD it never does,
+ * and in between the chance to park instead grows linearly with the battery level.
+ *
+ * @param roll Uniform random value in [0, 1).
+ */
+bool ShouldSeekCharging(Car::CarType type, float battery, float roll);
+
+/**
+ * @brief Does a facility of this type serve the car's current intent?
+ */
+bool Accepts(ModuleType facility, Car::CarType type, bool seekCharging);
+
+/**
+ * @brief Picks the offer the driver takes according to their Priority.
+ *
+ * PRIORITY_DISTANCE takes the closest facility, PRIORITY_PRICE the cheapest spot.
+ *
+ * @return Index into offers, or -1 if there is nothing to choose from (the car passes through).
+ */
+int ChooseOffer(std::span<const FacilityOffer> offers, Car::Priority priority);
+
+/**
+ * @brief Per-second hazard of an EV leaving a charger at the given battery level.
+ *
+ * Zero up to BATTERY_EXIT_THRESHOLD, rising linearly to 0.5/s at BATTERY_FORCE_EXIT_THRESHOLD,
+ * above which the car always leaves.
+ */
+float ChargingExitHazard(float battery);
+
+/**
+ * @brief Does a charging EV leave this tick?
+ * @param roll Uniform random value in [0, 1).
+ */
+bool ShouldLeaveCharger(float battery, float dt, float roll);
+
+/**
+ * @brief Samples the battery level at which a charging EV will leave.
+ *
+ * Closed-form inverse of the ChargingExitHazard survival function while charging at CHARGING_RATE,
+ * so event-driven models do not need to step the battery tick by tick.
+ *
+ * @param battery Battery level when charging starts.
+ * @param exponentialDraw A draw from Exp(1).
+ * @return Battery level at departure (clamped to BATTERY_FORCE_EXIT_THRESHOLD).
+ */
+float SampleChargingExitLevel(float battery, float exponentialDraw);
+
+/**
+ * @brief Chooses the side a parked car leaves towards.
+ *
+ * Distance-minded drivers return the way they came; price-minded ones pick at random.
+ *
+ * @param roll Uniform random value in [0, 1).
+ * @return true to leave to the right.
+ */
+bool ExitRight(Car::Priority priority, bool enteredFromLeft, float roll);
+
+} // namespace TrafficPolicy
@@ -1,18 +1,24 @@
 #pragma once
 #include "core/EntityManager.hpp"
 #include "core/EventBus.hpp"
+#include "systems/DemandScheduler.hpp"
 #include <memory>
+#include <utility>
 #include <vector>
 
+class SystemScheduler;
+
 /**
  * @class TrafficSystem
  * @brief Manages navigation, spawning, and high-level behavior of cars.
  *
  * The TrafficSystem acts as the "Director" for the simulation. It handles:
- * - Spawning cars at intervals.
+ * - Admitting arrivals from the DemandScheduler when the entry lane has room.
  * - Assigning parking spots and paths to cars.
  * - Monitoring car states (Parking, Exiting).
  * - Cleaning up cars that have exited the map.
+ *
+ * Its per-tick work runs as three scheduled systems (see schedule()).
  */
 class TrafficSystem {
 public:
@@ -20,17 +26,70 @@ public:
    * @brief Constructs the TrafficSystem.
    * @param bus Shared pointer to the EventBus.
    * @param entityManager Reference to the EntityManager for querying modules and cars.
+   * @param demandSeed Seed of the arrival process's random stream.
    */
-  TrafficSystem(std::shared_ptr<EventBus> bus, const EntityManager &entityManager);
+  TrafficSystem(std::shared_ptr<EventBus> bus, const EntityManager &entityManager, uint64_t demandSeed);
   ~TrafficSystem();
 
+  /**
+   * @brief Restricts which map entries admit arrivals (both by default).
+   *
+   * Arrivals drawn for a disabled entry are discarded. Used by sharded runs, where only the
+   * processes owning the map ends spawn cars.
+   */
+  void setEntrySides(bool left, bool right);
+
+  /**
+   * @brief Registers the traffic systems: arrival admission (Config::Scheduler::SPAWN_RATE),
+   *        spot occupation and despawns (every tick), and parked cars' charging and departure
+   *        (Config::Scheduler::PARKED_RATE).
+   */
+  void schedule(SystemScheduler &scheduler);
+
+  /**
+   * @brief The live arrival process (forked by the ForecastService).
+   */
+  const DemandScheduler &getDemand() const { return demand; }
+
+  /**
+   * @brief Picks a spot among the open facilities, reserves it and assigns the path there from
+   *        where the car is; passes the car through if nothing suits. Runs for every spawned car.
+   */
+  void assignDestination(Car *car);
+
+  /**
+   * @brief Sends a car out of its facility towards a map edge, from wherever it is inside, and
+   *        frees its spot. The facility must still exist; the car's parking context is kept.
+   */
+  void evacuate(Car *car);
+
 private:
   std::shared_ptr<EventBus> eventBus;
   const EntityManager &entityManager;
   std::vector<Subscription> eventTokens;
 
   int currentSpawnLevel = 0;
-  float spawnTimer = 0.0f;
+  int demandProfileIndex = 0; ///< 0: Fixed, 1: Commuter, 2: Stress.
+  DemandScheduler demand;
+  bool entryEnabled[2] = {true, true}; ///< Indexed by enteredFromLeft.
+  size_t carLimit = 0;                 ///< LoadGovernor backpressure: no admissions at this many cars (0 = off).
+
+  /**
+   * @brief Lane start points, indexed by enteredFromLeft.
+   */
+  struct SpawnPoints {
+    bool has[2] = {};
+    WorldCoord pos[2] = {};
+  };
+
+  std::pair<double, double> roadExtent() const; ///< Left and right end of the main road (meters).
+  void setSpawnLevel(int level);
+  void applyDemandProfile();
+  SpawnPoints findSpawnPoints() const;
+  bool isLaneClear(const WorldCoord &spawnPos) const;
+  void spawnCar(const Arrival &arrival, const WorldCoord &spawnPos);
 
-  void spawnCar();
+  void admitArrivals(double dt);
+  void updateLifecycle();
+  void updateParkedCars(double dt);
 };
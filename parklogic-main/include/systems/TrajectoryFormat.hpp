@@ -0,0 +1,154 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/**
+ * @file TrajectoryFormat.hpp
+ * @brief On-disk layout shared by TrajectoryRecorder and TrajectoryReader.
+ *
+ * File = FileHeader, then chunks, then the chunk index and an IndexFooter.
+ *
+ * Each chunk holds up to FileHeader::ticksPerChunk consecutive ticks: a keyframe with every car's
+ * absolute pose, followed by one delta frame per further tick. Poses are quantized (centimeters,
+ * 1/16 degree) and deltas are zigzag varints, so a driving car costs ~3 bytes per tick and runs of
+ * unchanged (parked) cars collapse into a single skip count. Seeking decodes at most one chunk.
+ *
+ * Keyframe:    varint count, then count x { varint idDelta, zz x, zz y, varint rot, u8 state, str texture }
+ * Delta frame: varint removed, removed x varint idDelta (ids ascending)
+ *              varint added, added x keyframe entry (new ids are always the largest)
+ *              runs over the surviving cars: varint unchangedRun, then one changed car
+ *              { zz dx, zz dy, varint (zz drot << 1 | stateChanged), [u8 state] }, until all are covered
+ *
+ * All integers are little-endian. A file without footer (recording interrupted) is still readable:
+ * the reader rebuilds the index by walking the chunk headers.
+ */
+namespace TrajectoryFormat {
+
+constexpr char FILE_MAGIC[8] = {'P', 'L', 'T', 'R', 'A', 'J', '0', '1'};
+constexpr char INDEX_MAGIC[8] = {'P', 'L', 'T', 'R', 'J', 'I', 'D', 'X'};
+constexpr uint32_t CHUNK_MAGIC = 0x4B4E4843; // "CHNK"
+constexpr uint32_t VERSION = 1;
+
+constexpr float POSITION_SCALE = 100.0f; // Units per meter (1 cm)
+constexpr float ROTATION_SCALE = 16.0f;  // Units per degree
+constexpr int32_t ROTATION_UNITS = 360 * 16;
+
+struct FileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t ticksPerChunk;
+  double tickSeconds;
+  // MapConfig of the recorded scene; the viewer regenerates the identical world from it
+  int32_t smallParkingCount;
+  int32_t largeParkingCount;
+  int32_t smallChargingCount;
+  int32_t largeChargingCount;
+  uint32_t mapSeed;
+  uint32_t reserved[5];
+};
+static_assert(sizeof(FileHeader) == 64, "Trajectory header layout changed");
+
+struct ChunkHeader {
+  uint32_t magic;
+  uint32_t firstTick;
+  uint32_t tickCount;
+  uint32_t payloadBytes;
+};
+static_assert(sizeof(ChunkHeader) == 16, "Trajectory chunk header layout changed");
+
+struct IndexEntry {
+  uint32_t firstTick;
+  uint32_t tickCount;
+  uint64_t offset; ///< File offset of the ChunkHeader.
+};
+static_assert(sizeof(IndexEntry) == 16, "Trajectory index layout changed");
+
+struct IndexFooter {
+  char magic[8];
+  uint64_t indexOffset;
+  uint32_t chunkCount;
+  uint32_t totalTicks;
+};
+static_assert(sizeof(IndexFooter) == 24, "Trajectory footer layout changed");
+
+/**
+ * @brief One car at one tick, quantized.
+ */
+struct QuantizedPose {
+  uint32_t id;
+  int32_t x;
+  int32_t y;
+  int32_t rotation; ///< [0, ROTATION_UNITS)
+  uint8_t state;    ///< Car::CarState
+  uint16_t texture; ///< Index into the decoder's texture name table.
+};
+
+// --- Varint helpers ---
+
+inline uint32_t ZigZag(int32_t v) { return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31); }
+inline int32_t UnZigZag(uint32_t v) { return (int32_t)(v >> 1) ^ -(int32_t)(v & 1); }
+
+inline void PutVarint(std::vector<uint8_t> &out, uint32_t v) {
+  while (v >= 0x80) {
+    out.push_back((uint8_t)(v | 0x80));
+    v >>= 7;
+  }
+  out.push_back((uint8_t)v);
+}
+
+/**
+ * @brief Bounds-checked cursor over a chunk payload.
+ */
+struct ByteReader {
+  const uint8_t *pos;
+  const uint8_t *end;
+  bool failed = false;
+
+  uint32_t varint() {
+    uint32_t result = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+      if (pos >= end) {
+        failed = true;
+        return 0;
+      }
+      uint8_t b = *pos++;
+      result |= (uint32_t)(b & 0x7F) << shift;
+      if (!(b & 0x80))
+        return result;
+    }
+    failed = true;
+    return 0;
+  }
+
+  uint8_t byte() {
+    if (pos >= end) {
+      failed = true;
+      return 0;
+    }
+    return *pos++;
+  }
+
+  std::string string() {
+    uint32_t length = varint();
+    if (failed || length > (uint32_t)(end - pos)) {
+      failed = true;
+      return {};
+    }
+    std::string s(reinterpret_cast<const char *>(pos), length);
+    pos += length;
+    return s;
+  }
+};
+
+inline int32_t WrapRotation(int32_t delta) {
+  delta %= ROTATION_UNITS;
+  if (delta >= ROTATION_UNITS / 2)
+    delta -= ROTATION_UNITS;
+  if (delta < -ROTATION_UNITS / 2)
+    delta += ROTATION_UNITS;
+  return delta;
+}
+
+} // namespace TrajectoryFormat
@@ -0,0 +1,80 @@
+#pragma once
+#include "core/MappedFile.hpp"
+#include "events/GameEvents.hpp"
+#include "systems/TrajectoryFormat.hpp"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @file TrajectoryReader.hpp
+ * @brief Random-access decoder for trajectory recordings.
+ */
+
+/**
+ * @class TrajectoryReader
+ * @brief Decodes a TrajectoryRecorder file from a read-only mapping.
+ *
+ * seek() lands on any tick by decoding the chunk keyframe and at most ticksPerChunk - 1 delta
+ * frames; moving forward within a chunk decodes only the new frames, so normal playback costs one
+ * delta frame per tick. Decoded poses are kept sorted by car id and reuse their storage.
+ */
+class TrajectoryReader {
+public:
+  /**
+   * @brief Opens a recording and loads (or rebuilds) its chunk index.
+   * @throws std::runtime_error if the file is not a trajectory recording.
+   */
+  explicit TrajectoryReader(const std::string &path);
+
+  /**
+   * @brief Layout of the recorded scene.
+   */
+  MapConfig getMapConfig() const;
+
+  double getTickSeconds() const { return header.tickSeconds; }
+  uint32_t getTickCount() const { return totalTicks; }
+  double getDuration() const { return totalTicks * header.tickSeconds; }
+
+  /**
+   * @brief Decodes the poses at a tick (clamped to the recording).
+   * @return false if the recording is empty or corrupt at that point.
+   */
+  bool seek(uint32_t tick);
+
+  uint32_t getCurrentTick() const { return currentTick; }
+
+  /**
+   * @brief Poses at the current tick, sorted by car id.
+   */
+  const std::vector<TrajectoryFormat::QuantizedPose> &getPoses() const { return poses; }
+
+  const std::string &getTextureName(uint16_t texture) const { return textureNames[texture]; }
+
+private:
+  void loadIndex();
+  void rebuildIndex();
+  bool beginChunk(size_t chunk);
+  bool decodeFrame();
+  bool readEntry(TrajectoryFormat::ByteReader &in, uint32_t previousId, TrajectoryFormat::QuantizedPose &out);
+
+  std::string path;
+  MappedFile file;
+  TrajectoryFormat::FileHeader header{};
+  std::vector<TrajectoryFormat::IndexEntry> index;
+  uint32_t totalTicks = 0;
+
+  // --- Decoder state ---
+  bool positioned = false;
+  size_t chunk = 0;                  ///< Chunk the cursor is in.
+  TrajectoryFormat::ByteReader cursor{nullptr, nullptr};
+  uint32_t currentTick = 0;
+  uint32_t chunkEndTick = 0;         ///< One past the last tick of the current chunk.
+
+  std::vector<TrajectoryFormat::QuantizedPose> poses;
+  std::vector<TrajectoryFormat::QuantizedPose> added; ///< Scratch for decodeFrame().
+  std::vector<uint32_t> removedIds;                   ///< Scratch for decodeFrame().
+
+  std::vector<std::string> textureNames;
+  std::unordered_map<std::string, uint16_t> textureIds;
+};
@@ -0,0 +1,82 @@
+#pragma once
+#include "entities/Car.hpp"
+#include "events/GameEvents.hpp"
+#include "systems/TrajectoryFormat.hpp"
+#include <fstream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @file TrajectoryRecorder.hpp
+ * @brief Writes every car's pose per tick to a compact trajectory file.
+ */
+
+/**
+ * @class TrajectoryRecorder
+ * @brief Delta/quantization encoder for post-incident analysis recordings.
+ *
+ * capture() is called once per simulation tick after all systems ran. Ticks are encoded into an
+ * in-memory chunk buffer (reused, so steady-state ticks do not allocate) and each completed chunk
+ * is appended to the file with a single write; the chunk index is written by finish(). See
+ * TrajectoryFormat.hpp for the layout.
+ */
+class TrajectoryRecorder {
+public:
+  /**
+   * @brief Creates the file and writes its header.
+   * @param path Output file.
+   * @param map Layout of the recorded scene (seed must be resolved, i.e. non-zero).
+   * @param tickSeconds Simulated time per captured tick.
+   * @throws std::runtime_error if the file cannot be created.
+   */
+  TrajectoryRecorder(const std::string &path, const MapConfig &map, double tickSeconds);
+
+  /**
+   * @brief Calls finish().
+   */
+  ~TrajectoryRecorder();
+
+  TrajectoryRecorder(const TrajectoryRecorder &) = delete;
+  TrajectoryRecorder &operator=(const TrajectoryRecorder &) = delete;
+
+  /**
+   * @brief Records the poses of all cars for one tick.
+   */
+  void capture(const std::vector<std::unique_ptr<Car>> &cars);
+
+  /**
+   * @brief Flushes the open chunk and writes the index. Further captures are ignored.
+   */
+  void finish();
+
+  uint32_t getTickCount() const { return tick; }
+  uint64_t getBytesWritten() const { return bytesWritten; }
+
+private:
+  void writeEntry(const TrajectoryFormat::QuantizedPose &pose, uint32_t previousId);
+  void encodeDelta();
+  void flushChunk();
+  uint16_t internTexture(const std::string &name);
+
+  std::string path;
+  std::ofstream out;
+  bool finished = false;
+
+  uint32_t ticksPerChunk;
+  uint32_t tick = 0;           ///< Ticks captured so far.
+  uint32_t chunkFirstTick = 0; ///< First tick of the open chunk.
+  uint32_t ticksInChunk = 0;
+  uint64_t bytesWritten = 0;
+
+  std::vector<uint8_t> payload; ///< Open chunk, reused.
+  std::vector<TrajectoryFormat::IndexEntry> index;
+
+  std::vector<TrajectoryFormat::QuantizedPose> previous; ///< Last tick, sorted by id.
+  std::vector<TrajectoryFormat::QuantizedPose> current;  ///< This tick, sorted by id.
+  std::vector<uint32_t> removedIds;                      ///< Scratch for encodeDelta().
+
+  std::vector<std::string> textureNames;
+  std::unordered_map<std::string, uint16_t> textureIds;
+};
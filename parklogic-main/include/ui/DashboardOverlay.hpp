@@ -7,18 +7,26 @@
 #include "core/EntityManager.hpp"
 #include "core/EventBus.hpp"
 #include "events/GameEvents.hpp"
+#include "systems/ForecastService.hpp"
+#include "systems/OccupancyHistory.hpp"
 #include "ui/UIElement.hpp"
 #include <memory>
 #include <vector>
 
+class SystemScheduler;
+
 /**
  * @class DashboardOverlay
  * @brief Displays real-time debug information and entity details.
  *
  * Supports displaying:
  * - General Simulator stats (FPS, Entity count).
+ * - Trip latency percentiles (TripTelemetry), a second page of the general panel (T).
  * - Selected Car details.
  * - Facility occupancy and economics.
+ * - Occupancy forecasts (ForecastService), overall and per facility.
+ * - Load governor stage, speed factor and load (LoadGovernor).
+ * - Occupancy sparklines from the OccupancyHistory, overall and per facility (Y cycles 1 s / 1 min / 15 min).
  */
 class DashboardOverlay : public UIElement {
 public:
@@ -28,16 +36,55 @@ public:
   void update(double dt) override;
   void draw() override;
 
+  /**
+   * @brief Registers the occupancy aggregation as a low-rate Bookkeeping system
+   *        (Config::Scheduler::DASHBOARD_RATE) instead of recounting every spot every frame.
+   */
+  void schedule(SystemScheduler &scheduler);
+
 private:
   EntityManager *entityManager;
   std::vector<Subscription> eventTokens;
 
   EntitySelectedEvent currentSelection;
 
+  /// Spot counts of the general panel, refreshed by the scheduled aggregation.
+  struct Occupancy {
+    int facilities = 0;
+    int parkingLots = 0;
+    int chargingStations = 0;
+    int totalSpots = 0;
+    int occupiedSpots = 0;
+    int parkingSpots = 0;
+    int occupiedParking = 0;
+    int chargingSpots = 0;
+    int occupiedCharging = 0;
+  };
+  Occupancy occupancy;
+
+  void refreshOccupancy();
+
+  OccupancyForecast forecast; ///< Latest OccupancyForecastEvent, copied.
+  bool hasForecast = false;
+
+  const std::vector<float> *forecastFor(const Module *module) const;
+
+  LoadGovernorEvent governor{}; ///< Latest load window.
+  bool hasGovernor = false;
+
+  const OccupancyHistory *history = nullptr; ///< Read through its lock-free read(); owned by the scene.
+  OccupancyHistory::Level historyLevel = OccupancyHistory::Level::Minute;
+
+  /// Label and occupancy sparkline of one history row; advances y past them. Draws nothing without buckets.
+  void drawHistory(int x, int &y, int width, int row) const;
+  bool hasHistory(int row) const;
+
   void drawGeneralInfo(int x, int y, int width);
+  void drawTripInfo(int x, int y, int width);
   void drawCarInfo(int x, int y, int width);
   void drawFacilityInfo(int x, int y, int width);
   void drawSpotInfo(int x, int y, int width);
 
   bool visible = true;
+  bool tripPage = false; ///< General panel shows trip latencies instead of occupancy.
 };
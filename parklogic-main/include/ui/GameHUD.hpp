@@ -10,6 +10,8 @@
 #include <vector>
 
 class EntityManager;
+class DashboardOverlay;
+class SystemScheduler;
 
 /**
  * @class GameHUD
@@ -25,9 +27,15 @@ public:
   void update(double dt);
   void draw();
 
+  /**
+   * @brief Registers the HUD's low-rate aggregates with the scene's scheduler.
+   */
+  void schedule(SystemScheduler &scheduler);
+
 private:
   std::shared_ptr<EventBus> eventBus;
   UIManager uiManager;
+  std::shared_ptr<DashboardOverlay> dashboard;
   std::vector<Subscription> eventTokens;
 
   bool isPaused = false;
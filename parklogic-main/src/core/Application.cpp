@@ -1,5 +1,7 @@
 #include "core/Application.hpp"
+#include "core/FrameArena.hpp"
 #include "core/Logger.hpp"
+#include "core/MemoryStats.hpp"
 #include "events/GameEvents.hpp"
 #include "events/WindowEvents.hpp"
 
@@ -11,19 +13,19 @@
  * and high-level event management (e.g., window closing).
  */
 
-Application::Application() {
+Application::Application(const LaunchOptions &options) {
   Logger::Info("Application Starting...");
 
   // Initialize core systems
   eventBus = std::make_shared<EventBus>();
   window = std::make_unique<Window>(eventBus);
   inputSystem = std::make_unique<InputSystem>(eventBus, *window);
-  sceneManager = std::make_unique<SceneManager>(eventBus);
+  sceneManager = std::make_unique<SceneManager>(eventBus, options);
   eventLogger = std::make_unique<EventLogger>(eventBus);
   gameLoop = std::make_unique<GameLoop>();
 
-  // Start with the main menu
-  sceneManager->setScene(SceneType::MainMenu);
+  // Start with the main menu (or straight into the viewer for --playback)
+  sceneManager->setScene(options.mode == LaunchMode::Playback ? SceneType::Playback : SceneType::MainMenu);
 
   // Subscribe to the WindowCloseEvent to stop the application loop
   closeEventToken = eventBus->subscribe<WindowCloseEvent>([this](const WindowCloseEvent &) {
@@ -35,6 +37,9 @@ Application::Application() {
   eventTokens.push_back(eventBus->subscribe<SimulationSpeedChangedEvent>(
       [this](const SimulationSpeedChangedEvent &e) { gameLoop->setSpeedMultiplier(e.speedMultiplier); }));
 
+  eventTokens.push_back(eventBus->subscribe<LoadGovernorEvent>(
+      [this](const LoadGovernorEvent &e) { gameLoop->setSpeedFactor(e.speedFactor); }));
+
   // Subscribe to Scene Changes to reset speed
   eventTokens.push_back(eventBus->subscribe<SceneChangeEvent>([this](const SceneChangeEvent &e) {
     if (e.newScene != SceneType::Game) {
@@ -47,9 +52,26 @@ void Application::run() {
   gameLoop->run([this](double dt) { this->update(dt); }, [this]() { this->render(); }, [this]() { return isRunning; });
 }
 
-void Application::update(double dt) { sceneManager->update(dt); }
+Application::~Application() {
+  if constexpr (MemoryStats::Enabled) {
+    Logger::Info("MemoryStats: total allocations {}, peak live {} bytes", MemoryStats::getTotalAllocations(),
+                 MemoryStats::getPeakLiveBytes());
+  }
+}
+
+void Application::update(double dt) {
+  MemoryStats::beginTick();
+  sceneManager->update(dt);
+
+  // End of tick: drop all transient simulation scratch memory
+  FrameArena::Get().reset();
+  MemoryStats::endTick();
+}
 
 void Application::render() {
+  MemoryStats::beginFrame();
+  ProfileZoneScope zone(ProfileZone::Rendering);
+
   if (window->shouldClose()) {
     eventBus->publish(WindowCloseEvent{});
   }
@@ -59,4 +81,5 @@ void Application::render() {
   sceneManager->render();
 
   window->endDrawing();
+  MemoryStats::endFrame();
 }
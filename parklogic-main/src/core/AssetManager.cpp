@@ -33,6 +33,11 @@ Texture2D AssetManager::GetTexture(const std::string &name) {
   return textures[name];
 }
 
+const Texture2D *AssetManager::FindTexture(const std::string &name) const {
+  auto it = textures.find(name);
+  return it == textures.end() ? nullptr : &it->second;
+}
+
 void AssetManager::UnloadTexture(const std::string &name) {
   if (textures.find(name) != textures.end()) {
     ::UnloadTexture(textures[name]);
@@ -0,0 +1,213 @@
+#include "core/CongestionMap.hpp"
+#include "config.hpp"
+#include "core/Logger.hpp"
+#include "core/MemoryStats.hpp"
+#include "raylib.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+/**
+ * @file CongestionMap.cpp
+ * @brief Thread-local accumulation, merging, overlay and dump of the congestion grid.
+ */
+
+struct CongestionMap::LocalBuffer {
+  struct Record {
+    uint32_t cell;
+    float dwell;
+    float distance;
+    float braking;
+    uint32_t sideSteps;
+  };
+
+  std::array<Record, Config::Congestion::LOCAL_RECORDS> records;
+  size_t count = 0;
+
+  LocalBuffer();
+  ~LocalBuffer();
+};
+
+namespace {
+
+// Every thread that ever recorded, so a merge can reach all of their buffers
+std::mutex registryMutex;
+std::vector<CongestionMap::LocalBuffer *> registry;
+
+CongestionMap::LocalBuffer &localBuffer() {
+  static thread_local CongestionMap::LocalBuffer buffer;
+  return buffer;
+}
+
+} // namespace
+
+CongestionMap::LocalBuffer::LocalBuffer() {
+  MemoryStats::markTickEventful(); // Once per thread
+  std::lock_guard lock(registryMutex);
+  registry.push_back(this);
+}
+
+CongestionMap::LocalBuffer::~LocalBuffer() {
+  std::lock_guard lock(registryMutex);
+  std::erase(registry, this);
+}
+
+CongestionMap::~CongestionMap() { detach(); }
+
+void CongestionMap::attach(float worldWidth, float worldHeight) {
+  detach();
+  MemoryStats::markTickEventful();
+  cols = std::max(1, (int)std::ceil(worldWidth / Config::Congestion::CELL_SIZE));
+  rows = std::max(1, (int)std::ceil(worldHeight / Config::Congestion::CELL_SIZE));
+  cells.assign((size_t)cols * rows, Cell{});
+  seconds = 0.0;
+
+  {
+    // Records still pending from a previous map index a different grid
+    std::lock_guard lock(registryMutex);
+    for (LocalBuffer *buffer : registry)
+      buffer->count = 0;
+  }
+  active.store(this, std::memory_order_release);
+}
+
+void CongestionMap::detach() {
+  CongestionMap *expected = this;
+  active.compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel);
+}
+
+void CongestionMap::Record(const WorldCoord &position, float dt, float speed, float braking, bool sideStep) {
+  CongestionMap *map = active.load(std::memory_order_acquire);
+  if (!map)
+    return;
+
+  int col = (int)std::floor(position.x() / Config::Congestion::CELL_SIZE);
+  int row = (int)std::floor(position.y() / Config::Congestion::CELL_SIZE);
+  if (col < 0 || row < 0 || col >= map->cols || row >= map->rows)
+    return; // Spawn and exit points lie just beyond the map edge
+
+  LocalBuffer &buffer = localBuffer();
+  if (buffer.count == buffer.records.size())
+    map->fold(buffer);
+  buffer.records[buffer.count++] = {(uint32_t)(row * map->cols + col), dt, speed * dt, braking * dt, sideStep ? 1u : 0u};
+}
+
+void CongestionMap::fold(LocalBuffer &buffer) {
+  std::lock_guard lock(foldMutex);
+  for (size_t i = 0; i < buffer.count; ++i) {
+    const LocalBuffer::Record &record = buffer.records[i];
+    Cell &cell = cells[record.cell];
+    cell.dwell += record.dwell;
+    cell.distance += record.distance;
+    cell.braking += record.braking;
+    cell.sideSteps += record.sideSteps;
+  }
+  buffer.count = 0;
+}
+
+void CongestionMap::mergeTick(double dt) {
+  if (active.load(std::memory_order_acquire) != this)
+    return;
+  seconds += dt;
+
+  std::lock_guard lock(registryMutex);
+  for (LocalBuffer *buffer : registry) {
+    if (buffer->count > 0)
+      fold(*buffer);
+  }
+}
+
+CongestionMap::Metric CongestionMap::cycleMetric() {
+  metric = (Metric)(((int)metric + 1) % (int)Metric::Count);
+  return metric;
+}
+
+const char *CongestionMap::MetricName(Metric metric) {
+  switch (metric) {
+  case Metric::Off:
+    return "off";
+  case Metric::Dwell:
+    return "dwell";
+  case Metric::Speed:
+    return "slowdown";
+  case Metric::Braking:
+    return "braking";
+  case Metric::SideSteps:
+    return "side-steps";
+  default:
+    return "?";
+  }
+}
+
+void CongestionMap::draw(const WorldCoord &viewMin, const WorldCoord &viewMax) const {
+  if (metric == Metric::Off || cells.empty())
+    return;
+
+  const float size = Config::Congestion::CELL_SIZE;
+  int firstCol = std::clamp((int)std::floor(viewMin.x() / size), 0, cols - 1);
+  int lastCol = std::clamp((int)std::floor(viewMax.x() / size), 0, cols - 1);
+  int firstRow = std::clamp((int)std::floor(viewMin.y() / size), 0, rows - 1);
+  int lastRow = std::clamp((int)std::floor(viewMax.y() / size), 0, rows - 1);
+
+  auto value = [&](const Cell &cell) -> float {
+    if (cell.dwell <= 0.0f)
+      return 0.0f;
+    switch (metric) {
+    case Metric::Dwell:
+      return cell.dwell;
+    case Metric::Speed:
+      // How far below cruise speed cars are here on average (already 0..1)
+      return std::clamp(1.0f - (cell.distance / cell.dwell) / Config::CarAI::MAX_SPEED, 0.0f, 1.0f);
+    case Metric::Braking:
+      return cell.braking / cell.dwell;
+    case Metric::SideSteps:
+      return (float)cell.sideSteps;
+    default:
+      return 0.0f;
+    }
+  };
+
+  // Scale to the hottest visible cell, so the overlay stays readable at any zoom and run length
+  float peak = metric == Metric::Speed ? 1.0f : 0.0f;
+  if (metric != Metric::Speed) {
+    for (int row = firstRow; row <= lastRow; ++row)
+      for (int col = firstCol; col <= lastCol; ++col)
+        peak = std::max(peak, value(cellAt(col, row)));
+  }
+  if (peak <= 0.0f)
+    return;
+
+  for (int row = firstRow; row <= lastRow; ++row) {
+    for (int col = firstCol; col <= lastCol; ++col) {
+      float t = value(cellAt(col, row)) / peak;
+      if (t <= 0.0f)
+        continue;
+      // Yellow (cool) to red (hot), more opaque as it heats up
+      Color color = {255, (unsigned char)(220.0f * (1.0f - t)), 0,
+                     (unsigned char)(Config::Congestion::MAX_ALPHA * (0.25f + 0.75f * t))};
+      Vector2 corner = WorldCoord::FromMeters(col * (double)size, row * (double)size).toRender();
+      DrawRectangleV(corner, {size, size}, color);
+    }
+  }
+}
+
+bool CongestionMap::dump(const std::string &path) const {
+  DumpHeader header{};
+  std::memcpy(header.magic, "PLHEAT01", sizeof(header.magic));
+  header.cols = (uint32_t)cols;
+  header.rows = (uint32_t)rows;
+  header.cellSize = Config::Congestion::CELL_SIZE;
+  header.seconds = seconds;
+
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  out.write(reinterpret_cast<const char *>(cells.data()), (std::streamsize)(cells.size() * sizeof(Cell)));
+  if (!out) {
+    Logger::Error("CongestionMap: write to {} failed", path);
+    return false;
+  }
+  Logger::Info("CongestionMap: wrote {}x{} cells ({:.1f} simulated h) to {}", cols, rows, seconds / 3600.0, path);
+  return true;
+}
@@ -8,11 +8,17 @@
  * Handles entity updates, drawing order, and event-driven entity creation/destruction.
  */
 
+#include "config.hpp"
 #include "core/EntityManager.hpp"
 #include "core/Logger.hpp"
+#include "core/MemoryStats.hpp"
+#include "core/RenderStats.hpp"
+#include "core/SystemScheduler.hpp"
 #include "entities/Car.hpp"
+#include "entities/map/WorldChunkStore.hpp"
 #include "entities/map/WorldGenerator.hpp"
 #include "events/GameEvents.hpp"
+#include <algorithm>
 
 EntityManager::EntityManager(std::shared_ptr<EventBus> bus) : eventBus(bus) {
   // Subscribe to GenerateWorldEvent
@@ -25,14 +31,31 @@ EntityManager::EntityManager(std::shared_ptr<EventBus> bus) : eventBus(bus) {
       this->addModule(std::move(mod));
     }
 
+    if (world && WorldChunkStore::IsWorthwhile(*world)) {
+      try {
+        chunkStore = std::make_unique<WorldChunkStore>(*world, WorldChunkStore::DefaultPath());
+      } catch (const std::exception &ex) {
+        Logger::Error("EntityManager: map stays resident: {}", ex.what());
+      }
+    }
+
     // Publish WorldBounds
     if (world) {
+      congestion.attach(world->getWidth(), world->getHeight());
+      trips.attach();
       eventBus->publish(WorldBoundsEvent{world->getWidth(), world->getHeight()});
     }
   }));
 
-  // Subscribe to GameUpdateEvent
-  eventTokens.push_back(eventBus->subscribe<GameUpdateEvent>([this](const GameUpdateEvent &e) { this->update(e.dt); }));
+  eventTokens.push_back(eventBus->subscribe<CameraViewEvent>([this](const CameraViewEvent &e) {
+    viewKnown = true;
+    viewMin = e.min;
+    viewMax = e.max;
+  }));
+
+  eventTokens.push_back(eventBus->subscribe<LoadGovernorEvent>([this](const LoadGovernorEvent &e) {
+    demoteDistant = e.stage >= GovernorStage::Demote;
+  }));
 
   // Subscribe to DrawWorldEvent
   eventTokens.push_back(eventBus->subscribe<DrawWorldEvent>([this](const DrawWorldEvent &) { this->draw(); }));
@@ -45,9 +68,14 @@ EntityManager::EntityManager(std::shared_ptr<EventBus> bus) : eventBus(bus) {
     auto car = std::make_unique<Car>(e.position, world.get(), e.velocity, static_cast<Car::CarType>(e.carType));
     car->setPriority(static_cast<Car::Priority>(e.priority));
     car->setEnteredFromLeft(e.enteredFromLeft);
+    if (e.battery >= 0.0f && car->getType() == Car::CarType::ELECTRIC)
+      car->setBatteryLevel(e.battery);
+    if (e.dwell >= 0.0f)
+      car->setParkingDuration(e.dwell);
 
     Car *carPtr = car.get();
     this->addCar(std::move(car));
+    carPtr->stampTrip(TripMilestone::Spawn);
 
     // Notify that a car has spawned
     eventBus->publish(CarSpawnedEvent{carPtr});
@@ -57,9 +85,16 @@ EntityManager::EntityManager(std::shared_ptr<EventBus> bus) : eventBus(bus) {
   eventTokens.push_back(eventBus->subscribe<AssignPathEvent>([](const AssignPathEvent &e) {
     if (e.car) {
       e.car->setPath(e.path);
+      // Cars turned away get a path straight to the map edge
+      e.car->stampTrip(e.car->getState() == Car::CarState::EXITING ? TripMilestone::PassThrough
+                                                                   : TripMilestone::PathAssigned);
     }
   }));
 
+  eventTokens.push_back(eventBus->subscribe<CycleCongestionOverlayEvent>([this](const CycleCongestionOverlayEvent &) {
+    Logger::Info("EntityManager: congestion overlay {}", CongestionMap::MetricName(congestion.cycleMetric()));
+  }));
+
   // Track Dashboard State
   eventTokens.push_back(eventBus->subscribe<ToggleDashboardEvent>([this](const ToggleDashboardEvent&) {
       this->dashboardVisible = !this->dashboardVisible;
@@ -80,7 +115,20 @@ EntityManager::EntityManager(std::shared_ptr<EventBus> bus) : eventBus(bus) {
 
 EntityManager::~EntityManager() { clear(); }
 
+void EntityManager::schedule(SystemScheduler &scheduler) {
+  using S = SystemScheduler;
+  scheduler.add({"cars", S::Stage::Simulation, S::FACILITIES, S::CARS, Config::TICK_RATE,
+                 [this](double dt) { updateCars(dt); }});
+  scheduler.add({"chunks", S::Stage::Simulation, S::VIEW, S::CHUNKS, Config::TICK_RATE,
+                 [this](double) { updateChunks(); }});
+}
+
 void EntityManager::update(double dt) {
+  updateCars(dt);
+  updateChunks();
+}
+
+void EntityManager::updateCars(double dt) {
   if (world) {
     world->update(dt);
   }
@@ -89,46 +137,147 @@ void EntityManager::update(double dt) {
   // Note: Cars need access to other cars for collision avoidance/logic
   // Currently Car::updateWithNeighbors takes a vector of unique_ptr<Car>
   // We might need to refactor Car::updateWithNeighbors to take a raw pointer list or reference to the vector
+  ProfileZoneScope zone(ProfileZone::CarUpdate);
+  demotedCars = 0;
   for (auto &car : cars) {
-    car->updateWithNeighbors(dt, &cars);
+    if (demoteDistant && isDistant(car->getPosition())) {
+      car->updateWithNeighbors(dt, nullptr); // Cheap path while the governor sheds load: no avoidance
+      demotedCars++;
+    } else {
+      car->updateWithNeighbors(dt, &cars, ghosts);
+    }
+  }
+  congestion.mergeTick(dt);
+  trips.drain();
+}
+
+bool EntityManager::isDistant(const WorldCoord &position) const {
+  if (!viewKnown)
+    return false; // Without a view every car keeps avoidance; the governor slows down instead
+  return isOutsideView(position, Config::Governor::DEMOTE_MARGIN);
+}
+
+bool EntityManager::isOutsideView(const WorldCoord &position, double margin) const {
+  return position.x() < viewMin.x() - margin || position.x() > viewMax.x() + margin ||
+         position.y() < viewMin.y() - margin || position.y() > viewMax.y() + margin;
+}
+
+void EntityManager::updateChunks() {
+  if (chunkStore) {
+    // Only drawing reads the background, so what is on screen is all that must stay resident
+    if (viewKnown)
+      chunkStore->pin(viewMin.x(), viewMax.x());
+    chunkStore->endTick();
   }
 }
 
 void EntityManager::draw() {
   if (world) {
-    world->draw();
+    RenderPassScope pass(RenderPass::WorldTiles);
+    if (viewKnown)
+      world->drawArea(viewMin, viewMax);
+    else
+      world->draw();
+  }
+
+  {
+    RenderPassScope pass(RenderPass::Modules);
+    moduleSprites.build(drawPool, (int)modules.size(), [this](int i, SpriteQuad &quad) {
+      const Module &mod = *modules[i];
+      if (viewKnown) {
+        Vector2 fromMin = mod.worldPosition - viewMin;
+        Vector2 toMax = viewMax - mod.worldPosition;
+        if (fromMin.x + mod.getWidth() < 0 || fromMin.y + mod.getHeight() < 0 || toMax.x < 0 || toMax.y < 0)
+          return; // Off screen
+      }
+      quad = mod.spriteQuad();
+    });
+    moduleSprites.submit();
   }
 
-  for (const auto &mod : modules) {
-    mod->draw();
+  if (congestion.getMetric() != CongestionMap::Metric::Off && world) {
+    RenderPassScope pass(RenderPass::Overlay);
+    // Without a camera view yet, the whole map
+    congestion.draw(viewKnown ? viewMin : WorldCoord{},
+                    viewKnown ? viewMax : WorldCoord::FromMeters(world->getWidth(), world->getHeight()));
   }
 
-  for (const auto &car : cars) {
-    bool showPath = car->isSelected() && this->dashboardVisible;
-    car->draw(showPath);
+  {
+    RenderPassScope pass(RenderPass::Cars);
+    if (dashboardVisible) {
+      for (const auto &car : cars) {
+        if (car->isSelected())
+          car->drawPath();
+      }
+    }
+    carSprites.build(drawPool, (int)cars.size(), [this](int i, SpriteQuad &quad) {
+      const Car &car = *cars[i];
+      if (viewKnown && isOutsideView(car.getPosition(), Config::Render::CAR_CULL_MARGIN))
+        return; // Off screen
+      quad = Car::SpriteQuadAt(car.getTextureName(), car.getPosition().toRender(), car.getRotation());
+    });
+    carSprites.submit();
   }
 
   // Draw Mask last (Foreground)
   if (world) {
+    RenderPassScope pass(RenderPass::Overlay);
     world->drawOverlay();
     world->drawMask();
   }
 }
 
-void EntityManager::setWorld(std::unique_ptr<World> w) { world = std::move(w); }
+void EntityManager::setWorld(std::unique_ptr<World> w) {
+  MemoryStats::markTickEventful();
+  world = std::move(w);
+}
+
+void EntityManager::addModule(std::unique_ptr<Module> module) {
+  MemoryStats::markTickEventful();
+  if (module->getSpotCount() > 0 && module->getFacilityId() < 0) // A converted facility keeps its number
+    module->setFacilityId(nextFacilityId++);
+  modules.push_back(std::move(module));
+}
+
+std::unique_ptr<Module> EntityManager::removeModule(const Module *module) {
+  auto it = std::find_if(modules.begin(), modules.end(),
+                         [module](const std::unique_ptr<Module> &ptr) { return ptr.get() == module; });
+  if (it == modules.end())
+    return nullptr;
+  MemoryStats::markTickEventful();
+  std::unique_ptr<Module> removed = std::move(*it);
+  modules.erase(it);
+  return removed;
+}
 
-void EntityManager::addModule(std::unique_ptr<Module> module) { modules.push_back(std::move(module)); }
+void EntityManager::addCar(std::unique_ptr<Car> car) {
+  MemoryStats::markTickEventful();
+  if (car->getId() == 0) { // Cars handed over by another shard keep their id
+    car->setId(nextCarId);
+    nextCarId += carIdStride;
+  }
+  cars.push_back(std::move(car));
+}
 
-void EntityManager::addCar(std::unique_ptr<Car> car) { cars.push_back(std::move(car)); }
+void EntityManager::setCarIdSequence(uint32_t first, uint32_t stride) {
+  nextCarId = first;
+  carIdStride = stride;
+}
 
 void EntityManager::clear() {
+  congestion.detach();
+  trips.detach();
   cars.clear();
   modules.clear();
   world.reset();
+  chunkStore.reset(); // After everything that points into its mapping
+  viewKnown = false;
+  nextFacilityId = 0;
 }
 
 void EntityManager::removeCar(Car *car) {
   if (!car)
     return;
+  MemoryStats::markTickEventful();
   std::erase_if(cars, [car](const std::unique_ptr<Car> &ptr) { return ptr.get() == car; });
 }
@@ -56,10 +56,25 @@ EventLogger::EventLogger(std::shared_ptr<EventBus> bus) : eventBus(bus) {
   subscriptions.push_back(eventBus->subscribe<CycleAutoSpawnLevelEvent>(
       [](const CycleAutoSpawnLevelEvent &) { Logger::Info("Event: CycleAutoSpawnLevelEvent"); }));
 
+  subscriptions.push_back(eventBus->subscribe<SetAutoSpawnLevelEvent>([](const SetAutoSpawnLevelEvent &e) {
+    Logger::Info("Event: SetAutoSpawnLevelEvent [Level: {}]", e.level);
+  }));
+
   subscriptions.push_back(eventBus->subscribe<AutoSpawnLevelChangedEvent>([](const AutoSpawnLevelChangedEvent &e) {
     Logger::Info("Event: AutoSpawnLevelChangedEvent [Level: {}]", e.newLevel);
   }));
 
+  subscriptions.push_back(eventBus->subscribe<LoadDemandTraceEvent>([](const LoadDemandTraceEvent &e) {
+    Logger::Info("Event: LoadDemandTraceEvent [Path: {}]", e.path);
+  }));
+
+  subscriptions.push_back(eventBus->subscribe<CycleDemandProfileEvent>(
+      [](const CycleDemandProfileEvent &) { Logger::Info("Event: CycleDemandProfileEvent"); }));
+
+  subscriptions.push_back(eventBus->subscribe<DemandProfileChangedEvent>([](const DemandProfileChangedEvent &e) {
+    Logger::Info("Event: DemandProfileChangedEvent [Profile: {}]", e.name);
+  }));
+
   subscriptions.push_back(eventBus->subscribe<SpawnCarRequestEvent>(
       [](const SpawnCarRequestEvent &) { Logger::Info("Event: SpawnCarRequestEvent"); }));
 
@@ -0,0 +1,77 @@
+#include "core/FrameArena.hpp"
+#include "config.hpp"
+#include "core/Logger.hpp"
+#include "core/MemoryStats.hpp"
+#include <algorithm>
+#include <bit>
+#include <new>
+
+/**
+ * @file FrameArena.cpp
+ * @brief Implementation of the per-tick monotonic arena.
+ */
+
+namespace {
+/// Room in front of an overflow block's payload: the header, rounded up so the payload stays aligned.
+size_t headerSizeFor(size_t headerBytes, size_t alignment) { return (headerBytes + alignment - 1) & ~(alignment - 1); }
+} // namespace
+
+FrameArena::FrameArena() : capacity(static_cast<size_t>(Config::FRAME_ARENA_INITIAL_BYTES)) {
+  buffer = std::make_unique<std::byte[]>(capacity);
+}
+
+FrameArena::~FrameArena() {
+  // Release any overflow blocks left over from an unfinished tick
+  reset();
+}
+
+void *FrameArena::do_allocate(size_t bytes, size_t alignment) {
+  // Fast path: bump the offset inside the inline buffer
+  size_t base = reinterpret_cast<size_t>(buffer.get());
+  size_t aligned = (base + offset + alignment - 1) & ~(alignment - 1);
+  size_t newOffset = (aligned - base) + bytes;
+
+  if (newOffset <= capacity) {
+    offset = newOffset;
+    return reinterpret_cast<void *>(aligned);
+  }
+
+  // Slow path: the tick outgrew the buffer. Serve it from the heap and remember it
+  // so reset() can free it and size the buffer for next time.
+  size_t headerSize = headerSizeFor(sizeof(OverflowBlock), alignment);
+  auto *raw = static_cast<std::byte *>(::operator new(headerSize + bytes, std::align_val_t{alignment}));
+  auto *block = reinterpret_cast<OverflowBlock *>(raw + headerSize - sizeof(OverflowBlock));
+  block->next = overflowHead;
+  block->size = headerSize + bytes;
+  block->alignment = alignment;
+  overflowHead = block;
+  overflowBytes += bytes + alignment;
+
+  return raw + headerSize;
+}
+
+void FrameArena::reset() {
+  size_t demand = offset + overflowBytes;
+  highWater = std::max(highWater, demand);
+
+  if (overflowHead) {
+    while (overflowHead) {
+      OverflowBlock *block = overflowHead;
+      overflowHead = block->next;
+
+      size_t headerSize = headerSizeFor(sizeof(OverflowBlock), block->alignment);
+      auto *raw = reinterpret_cast<std::byte *>(block) - (headerSize - sizeof(OverflowBlock));
+      ::operator delete(raw, block->size, std::align_val_t{block->alignment});
+    }
+
+    // Grow once so the next tick of the same size fits inline
+    MemoryStats::markTickEventful(); // A warm-up, not a steady-state allocation
+    size_t newCapacity = std::bit_ceil(demand);
+    Logger::Info("FrameArena: tick needed {} bytes, growing buffer {} -> {}", demand, capacity, newCapacity);
+    buffer = std::make_unique<std::byte[]>(newCapacity);
+    capacity = newCapacity;
+  }
+
+  offset = 0;
+  overflowBytes = 0;
+}
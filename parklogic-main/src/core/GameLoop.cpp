@@ -30,8 +30,8 @@ void GameLoop::run(std::function<void(double)> update, std::function<void()> ren
     if (frameTime > 0.25)
       frameTime = 0.25;
 
-    // Apply speed multiplier to accumulating time
-    frameTime *= speedMultiplier;
+    // Apply speed multiplier (and the governor's share of it) to accumulating time
+    frameTime *= speedMultiplier * speedFactor;
 
     accumulator += frameTime;
 
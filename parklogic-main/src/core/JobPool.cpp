@@ -0,0 +1,92 @@
+#include "core/JobPool.hpp"
+#include "core/FrameArena.hpp"
+#include "core/MemoryStats.hpp"
+
+/**
+ * @file JobPool.cpp
+ * @brief Batch dispatch and the worker loop.
+ */
+
+JobPool::JobPool(int workers) {
+  threads.reserve(workers);
+  for (int i = 0; i < workers; ++i)
+    threads.emplace_back([this]() { workerLoop(); });
+}
+
+JobPool::~JobPool() {
+  {
+    std::lock_guard lock(mutex);
+    stopping = true;
+  }
+  wake.notify_all();
+  for (std::thread &thread : threads)
+    thread.join();
+}
+
+void JobPool::dispatch(int count, Trampoline call, void *context) {
+  if (count <= 0)
+    return;
+  if (threads.empty() || count == 1) {
+    for (int i = 0; i < count; ++i)
+      call(context, i);
+    return;
+  }
+
+  {
+    std::unique_lock lock(mutex);
+    // A worker that joined the previous batch late may still be claiming from it
+    idle.wait(lock, [this]() { return busyWorkers == 0; });
+    batchCall = call;
+    batchContext = context;
+    batchCount = count;
+    nextJob.store(0, std::memory_order_relaxed);
+    remainingJobs.store(count, std::memory_order_relaxed);
+    generation++;
+  }
+  wake.notify_all();
+
+  claimJobs(call, context, count, false);
+
+  std::unique_lock lock(mutex);
+  idle.wait(lock, [this]() { return remainingJobs.load(std::memory_order_acquire) == 0 && busyWorkers == 0; });
+}
+
+void JobPool::claimJobs(Trampoline call, void *context, int count, bool resetArena) {
+  int index;
+  while ((index = nextJob.fetch_add(1, std::memory_order_relaxed)) < count) {
+    call(context, index);
+    if (resetArena)
+      FrameArena::Get().reset();
+    if (remainingJobs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      std::lock_guard lock(mutex);
+      idle.notify_all();
+    }
+  }
+}
+
+void JobPool::workerLoop() {
+  MemoryStats::joinTicks(); // Scheduler batches run inside the tick
+  uint64_t seen = 0;
+  while (true) {
+    Trampoline call;
+    void *context;
+    int count;
+    {
+      std::unique_lock lock(mutex);
+      wake.wait(lock, [&]() { return stopping || generation != seen; });
+      if (stopping)
+        return;
+      seen = generation;
+      call = batchCall;
+      context = batchContext;
+      count = batchCount;
+      busyWorkers++;
+    }
+
+    claimJobs(call, context, count, true);
+
+    std::lock_guard lock(mutex);
+    busyWorkers--;
+    idle.notify_all();
+  }
+}
@@ -0,0 +1,184 @@
+#include "core/LaunchOptions.hpp"
+#include "config.hpp"
+#include "core/Logger.hpp"
+#include <cstdlib>
+#include <format>
+#include <stdexcept>
+#include <string>
+
+/**
+ * @file LaunchOptions.cpp
+ * @brief Command line parsing.
+ */
+
+namespace {
+
+double parseNumber(const std::string &flag, const char *value) {
+  if (!value)
+    throw std::invalid_argument("Missing value for " + flag);
+
+  char *end = nullptr;
+  double result = std::strtod(value, &end);
+  if (end == value || *end != '\0')
+    throw std::invalid_argument("Invalid value '" + std::string(value) + "' for " + flag);
+  return result;
+}
+
+} // namespace
+
+LaunchOptions LaunchOptions::Parse(int argc, char **argv) {
+  LaunchOptions options;
+  bool mapSeedSet = false;
+
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    const char *next = (i + 1 < argc) ? argv[i + 1] : nullptr;
+
+    if (arg == "--des") {
+      options.mode = LaunchMode::DES;
+    } else if (arg == "--headless") {
+      options.mode = LaunchMode::Headless;
+    } else if (arg == "--render-bench") {
+      options.mode = LaunchMode::RenderBench;
+    } else if (arg == "--plan") {
+      options.mode = LaunchMode::Plan;
+    } else if (arg == "--max-pass-through") {
+      options.maxPassThrough = parseNumber(arg, next);
+      ++i;
+    } else if (arg == "--control") {
+      if (!next)
+        throw std::invalid_argument("Missing value for " + arg);
+      options.control = next;
+      ++i;
+    } else if (arg == "--shards") {
+      options.shards = (int)parseNumber(arg, next);
+      ++i;
+    } else if (arg == "--hours") {
+      options.hours = parseNumber(arg, next);
+      ++i;
+    } else if (arg == "--spawn-level") {
+      options.spawnLevel = (int)parseNumber(arg, next);
+      ++i;
+    } else if (arg == "--demand") {
+      if (!next)
+        throw std::invalid_argument("Missing value for " + arg);
+      options.demand = next;
+      ++i;
+    } else if (arg == "--trace") {
+      if (!next)
+        throw std::invalid_argument("Missing value for " + arg);
+      options.trace = next;
+      ++i;
+    } else if (arg == "--convert-trace") {
+      if (i + 2 >= argc)
+        throw std::invalid_argument("--convert-trace needs an input and an output file");
+      options.mode = LaunchMode::ConvertTrace;
+      options.trace = argv[i + 1];
+      options.traceOutput = argv[i + 2];
+      i += 2;
+    } else if (arg == "--record") {
+      if (!next)
+        throw std::invalid_argument("Missing value for " + arg);
+      options.record = next;
+      ++i;
+    } else if (arg == "--playback") {
+      if (!next)
+        throw std::invalid_argument("Missing value for " + arg);
+      options.mode = LaunchMode::Playback;
+      options.playback = next;
+      ++i;
+    } else if (arg == "--telemetry") {
+      if (!next)
+        throw std::invalid_argument("Missing value for " + arg);
+      options.telemetry = next;
+      ++i;
+    } else if (arg == "--heatmap") {
+      if (!next)
+        throw std::invalid_argument("Missing value for " + arg);
+      options.heatmap = next;
+      ++i;
+    } else if (arg == "--no-governor") {
+      options.governor = false;
+    } else if (arg == "--seed") {
+      options.seed = (uint64_t)parseNumber(arg, next);
+      ++i;
+    } else if (arg == "--map-seed") {
+      options.map.seed = (unsigned int)parseNumber(arg, next);
+      mapSeedSet = true;
+      ++i;
+    } else if (arg == "--small-parking") {
+      options.map.smallParkingCount = (int)parseNumber(arg, next);
+      ++i;
+    } else if (arg == "--large-parking") {
+      options.map.largeParkingCount = (int)parseNumber(arg, next);
+      ++i;
+    } else if (arg == "--small-charging") {
+      options.map.smallChargingCount = (int)parseNumber(arg, next);
+      ++i;
+    } else if (arg == "--large-charging") {
+      options.map.largeChargingCount = (int)parseNumber(arg, next);
+      ++i;
+    } else if (arg == "--help" || arg == "-h") {
+      PrintUsage();
+      std::exit(0);
+    } else {
+      throw std::invalid_argument("Unknown option: " + arg);
+    }
+  }
+
+  if (options.spawnLevel < 1 || options.spawnLevel > 5)
+    throw std::invalid_argument("--spawn-level must be between 1 and 5");
+  if (options.demand != "fixed" && options.demand != "commuter" && options.demand != "stress")
+    throw std::invalid_argument("--demand must be fixed, commuter or stress");
+  if (options.hours <= 0.0)
+    throw std::invalid_argument("--hours must be positive");
+  if (options.maxPassThrough < 0.0 || options.maxPassThrough > 100.0)
+    throw std::invalid_argument("--max-pass-through must be between 0 and 100");
+  if (options.shards != 0 && (options.shards < 1 || options.shards > Config::Shard::MAX_SHARDS))
+    throw std::invalid_argument(std::format("--shards must be between 1 and {}", Config::Shard::MAX_SHARDS));
+  if (options.shards != 0 && options.mode != LaunchMode::Headless)
+    throw std::invalid_argument("--shards requires --headless");
+  if (options.shards != 0 && !options.heatmap.empty())
+    throw std::invalid_argument("--heatmap is not supported with --shards");
+
+  // Batch runs are reproducible by default: derive the map from the run seed
+  if (!mapSeedSet)
+    options.map.seed = (unsigned int)(options.seed == 0 ? 1 : options.seed);
+
+  return options;
+}
+
+DemandProfile LaunchOptions::demandProfile() const {
+  if (demand == "commuter")
+    return DemandProfile::Commuter((float)spawnLevel);
+  if (demand == "stress")
+    return DemandProfile::Stress((float)spawnLevel);
+  return DemandProfile::FromSpawnLevel(spawnLevel);
+}
+
+void LaunchOptions::PrintUsage() {
+  Logger::Info("Usage: parklogic [options]");
+  Logger::Info("  --des                 Run a discrete-event capacity study instead of the game");
+  Logger::Info("  --headless            Run the game simulation without a window (stops after --hours)");
+  Logger::Info("  --control SOCKET      Accept runtime commands and queries on a Unix socket");
+  Logger::Info("  --shards N            Headless: split the map across N processes (runs unpaced)");
+  Logger::Info("  --render-bench        Render a seeded map along a scripted camera path offscreen and report costs");
+  Logger::Info("  --plan                Search facility mixes for the cheapest that meet --max-pass-through (DES)");
+  Logger::Info("  --max-pass-through P  Planner: share of arrivals that may find no spot, in % (default 5)");
+  Logger::Info("  --hours H             Simulated horizon in hours (default 168)");
+  Logger::Info("  --spawn-level L       Auto-spawn level 1-5 (default 3)");
+  Logger::Info("  --demand P            Arrival profile: fixed, commuter or stress (default fixed)");
+  Logger::Info("  --trace FILE          Replay a gate log (CSV or binary) instead of the demand profile");
+  Logger::Info("  --convert-trace IN OUT  Convert a CSV gate log to the compact binary format and exit");
+  Logger::Info("  --record FILE         Record every car's trajectory during the game");
+  Logger::Info("  --playback FILE       View a trajectory recording (no simulation)");
+  Logger::Info("  --telemetry NAME      Publish live state to shared memory NAME (e.g. /parklogic)");
+  Logger::Info("  --heatmap FILE        Dump the congestion heatmap to FILE when the game ends (J dumps it live)");
+  Logger::Info("  --no-governor         Never shed work or slow down when ticks fall behind (benchmarks)");
+  Logger::Info("  --seed S              Run seed (default 1)");
+  Logger::Info("  --map-seed S          Layout seed (default: run seed)");
+  Logger::Info("  --small-parking N     Map layout counts (defaults match the MapConfig scene)");
+  Logger::Info("  --large-parking N");
+  Logger::Info("  --small-charging N");
+  Logger::Info("  --large-charging N");
+}
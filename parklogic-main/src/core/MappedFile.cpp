@@ -0,0 +1,151 @@
+#include "core/MappedFile.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @file MappedFile.cpp
+ * @brief POSIX and Win32 implementations of MappedFile.
+ */
+
+// Release granularity: dropping pages one by one would cost a syscall per page
+static constexpr size_t RELEASE_CHUNK = 64 * 1024 * 1024;
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string &path, Access access) {
+  DWORD flags = access == Access::Sequential ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_FLAG_RANDOM_ACCESS;
+  HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                            flags, nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+    throw std::runtime_error("MappedFile: cannot open " + path);
+  fileHandle = file;
+
+  LARGE_INTEGER fileSize;
+  if (!GetFileSizeEx(file, &fileSize)) {
+    CloseHandle(file);
+    throw std::runtime_error("MappedFile: cannot stat " + path);
+  }
+  length = (size_t)fileSize.QuadPart;
+  if (length == 0)
+    return; // Nothing to map; data() stays null
+
+  HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!mapping) {
+    CloseHandle(file);
+    throw std::runtime_error("MappedFile: cannot map " + path);
+  }
+  mappingHandle = mapping;
+
+  base = static_cast<const char *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+  if (!base) {
+    CloseHandle(mapping);
+    CloseHandle(file);
+    throw std::runtime_error("MappedFile: cannot map " + path);
+  }
+}
+
+MappedFile::~MappedFile() {
+  if (base)
+    UnmapViewOfFile(base);
+  if (mappingHandle)
+    CloseHandle(mappingHandle);
+  if (fileHandle)
+    CloseHandle(fileHandle);
+}
+
+void MappedFile::releaseBefore(size_t offset) { released = offset; }
+
+void MappedFile::release(size_t, size_t) {}
+
+void MappedFile::prefetch(size_t, size_t) {}
+
+size_t MappedFile::PageSize() {
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return (size_t)info.dwPageSize;
+}
+
+#else
+
+MappedFile::MappedFile(const std::string &path, Access access) {
+  fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    throw std::runtime_error("MappedFile: cannot open " + path);
+
+  struct stat st;
+  if (::fstat(fd, &st) != 0) {
+    ::close(fd);
+    throw std::runtime_error("MappedFile: cannot stat " + path);
+  }
+  length = (size_t)st.st_size;
+  if (length == 0)
+    return; // mmap rejects empty lengths; data() stays null
+
+  void *p = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (p == MAP_FAILED) {
+    ::close(fd);
+    throw std::runtime_error("MappedFile: cannot map " + path);
+  }
+  base = static_cast<const char *>(p);
+
+  // Streaming readers want aggressive read-ahead, random ones none (it would load neighbours too)
+  ::madvise(p, length, access == Access::Sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+}
+
+MappedFile::~MappedFile() {
+  if (base)
+    ::munmap(const_cast<char *>(base), length);
+  if (fd >= 0)
+    ::close(fd);
+}
+
+void MappedFile::releaseBefore(size_t offset) {
+  if (!base || offset < released + RELEASE_CHUNK)
+    return;
+
+  size_t page = PageSize();
+  size_t end = offset / page * page;
+  if (end <= released)
+    return;
+
+  // Clean, read-only file pages: dropping them is free and they would be re-read on access
+  ::madvise(const_cast<char *>(base) + released, end - released, MADV_DONTNEED);
+  released = end;
+}
+
+void MappedFile::release(size_t offset, size_t bytes) {
+  if (!base || offset >= length)
+    return;
+
+  size_t page = PageSize();
+  size_t first = (offset + page - 1) / page * page;
+  size_t last = std::min(offset + bytes, length) / page * page;
+  if (last <= first)
+    return;
+  ::madvise(const_cast<char *>(base) + first, last - first, MADV_DONTNEED);
+}
+
+void MappedFile::prefetch(size_t offset, size_t bytes) {
+  if (!base || offset >= length)
+    return;
+
+  size_t page = PageSize();
+  size_t first = offset / page * page;
+  size_t last = std::min(offset + bytes, length);
+  ::madvise(const_cast<char *>(base) + first, last - first, MADV_WILLNEED);
+}
+
+size_t MappedFile::PageSize() { return (size_t)::sysconf(_SC_PAGESIZE); }
+
+#endif
@@ -0,0 +1,261 @@
+#include "core/MemoryStats.hpp"
+#include "core/Logger.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <format>
+#include <new>
+
+/**
+ * @file MemoryStats.cpp
+ * @brief Allocation counters and the optional global operator new/delete replacement.
+ */
+
+namespace {
+// Counters are updated from operator new on any thread, hence atomics (relaxed is enough for statistics).
+std::array<std::atomic<uint64_t>, MemoryStats::ZoneCount> zoneAllocations{};
+std::array<std::atomic<uint64_t>, MemoryStats::ZoneCount> zoneBytes{};
+std::atomic<uint64_t> totalAllocations{0};
+std::atomic<int64_t> liveBytes{0};
+std::atomic<int64_t> peakLiveBytes{0};
+
+// What the tick threads allocated while a tick window was open (see MemoryStats::joinTicks)
+std::array<std::atomic<uint64_t>, MemoryStats::ZoneCount> tickZoneAllocations{};
+std::array<std::atomic<uint64_t>, MemoryStats::ZoneCount> tickZoneBytes{};
+std::atomic<bool> tickOpen{false};
+
+// Tick / frame windows are only touched by the main thread.
+MemoryStats::Report frameStart;
+MemoryStats::Report lastTick;
+MemoryStats::Report lastFrame;
+MemoryStats::Report tickTotals;
+std::atomic<bool> tickEventful{false}; // Also set by scheduler workers during a tick
+
+MemoryStats::Report snapshot(const std::array<std::atomic<uint64_t>, MemoryStats::ZoneCount> &allocations,
+                             const std::array<std::atomic<uint64_t>, MemoryStats::ZoneCount> &bytes) {
+  MemoryStats::Report r;
+  for (size_t i = 0; i < MemoryStats::ZoneCount; ++i) {
+    r.zones[i].allocations = allocations[i].load(std::memory_order_relaxed);
+    r.zones[i].bytes = bytes[i].load(std::memory_order_relaxed);
+    r.allocations += r.zones[i].allocations;
+    r.bytes += r.zones[i].bytes;
+  }
+  return r;
+}
+
+MemoryStats::Report difference(const MemoryStats::Report &end, const MemoryStats::Report &begin) {
+  MemoryStats::Report r;
+  r.allocations = end.allocations - begin.allocations;
+  r.bytes = end.bytes - begin.bytes;
+  for (size_t i = 0; i < MemoryStats::ZoneCount; ++i) {
+    r.zones[i].allocations = end.zones[i].allocations - begin.zones[i].allocations;
+    r.zones[i].bytes = end.zones[i].bytes - begin.zones[i].bytes;
+  }
+  return r;
+}
+} // namespace
+
+const MemoryStats::Report &MemoryStats::getLastTick() { return lastTick; }
+const MemoryStats::Report &MemoryStats::getLastFrame() { return lastFrame; }
+const MemoryStats::Report &MemoryStats::getTickTotals() { return tickTotals; }
+
+void MemoryStats::Report::add(const Report &other) {
+  allocations += other.allocations;
+  bytes += other.bytes;
+  for (size_t i = 0; i < ZoneCount; ++i) {
+    zones[i].allocations += other.zones[i].allocations;
+    zones[i].bytes += other.zones[i].bytes;
+  }
+}
+uint64_t MemoryStats::getTotalAllocations() { return totalAllocations.load(std::memory_order_relaxed); }
+int64_t MemoryStats::getLiveBytes() { return liveBytes.load(std::memory_order_relaxed); }
+int64_t MemoryStats::getPeakLiveBytes() { return peakLiveBytes.load(std::memory_order_relaxed); }
+MemoryStats::Report MemoryStats::getTotals() { return snapshot(zoneAllocations, zoneBytes); }
+MemoryStats::Report MemoryStats::Since(const Report &totals) { return difference(getTotals(), totals); }
+
+const char *MemoryStats::ZoneName(ProfileZone zone) {
+  switch (zone) {
+  case ProfileZone::Other:
+    return "Other";
+  case ProfileZone::CarUpdate:
+    return "Car Update";
+  case ProfileZone::TrafficHandler:
+    return "Traffic";
+  case ProfileZone::PathPlanning:
+    return "Path Planning";
+  case ProfileZone::EventDispatch:
+    return "Event Dispatch";
+  case ProfileZone::Rendering:
+    return "Rendering";
+  default:
+    return "?";
+  }
+}
+
+void MemoryStats::recordAllocation(size_t bytes) {
+  auto zone = static_cast<size_t>(currentZone);
+  zoneAllocations[zone].fetch_add(1, std::memory_order_relaxed);
+  zoneBytes[zone].fetch_add(bytes, std::memory_order_relaxed);
+  totalAllocations.fetch_add(1, std::memory_order_relaxed);
+  if (tickThread && tickOpen.load(std::memory_order_relaxed)) {
+    tickZoneAllocations[zone].fetch_add(1, std::memory_order_relaxed);
+    tickZoneBytes[zone].fetch_add(bytes, std::memory_order_relaxed);
+  }
+
+  int64_t live = liveBytes.fetch_add((int64_t)bytes, std::memory_order_relaxed) + (int64_t)bytes;
+  int64_t peak = peakLiveBytes.load(std::memory_order_relaxed);
+  while (live > peak && !peakLiveBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+  }
+}
+
+void MemoryStats::recordDeallocation(size_t bytes) { liveBytes.fetch_sub((int64_t)bytes, std::memory_order_relaxed); }
+
+void MemoryStats::beginTick() {
+  if constexpr (!Enabled)
+    return;
+  tickThread = true;
+  tickEventful.store(false, std::memory_order_relaxed);
+  for (size_t i = 0; i < ZoneCount; ++i) {
+    tickZoneAllocations[i].store(0, std::memory_order_relaxed);
+    tickZoneBytes[i].store(0, std::memory_order_relaxed);
+  }
+  tickOpen.store(true, std::memory_order_relaxed);
+}
+
+void MemoryStats::endTick() {
+  if constexpr (!Enabled)
+    return;
+  tickOpen.store(false, std::memory_order_relaxed);
+  lastTick = snapshot(tickZoneAllocations, tickZoneBytes);
+  tickTotals.add(lastTick);
+
+#ifdef PARKLOGIC_ALLOC_STRICT
+  if (!tickEventful.load(std::memory_order_relaxed) && lastTick.allocations > 0) {
+    Logger::Error("MemoryStats: steady-state tick allocated! {}", FormatReport(lastTick));
+    std::abort();
+  }
+#endif
+}
+
+void MemoryStats::beginFrame() {
+  if constexpr (!Enabled)
+    return;
+  frameStart = snapshot(zoneAllocations, zoneBytes);
+}
+
+void MemoryStats::endFrame() {
+  if constexpr (!Enabled)
+    return;
+  lastFrame = difference(snapshot(zoneAllocations, zoneBytes), frameStart);
+}
+
+void MemoryStats::markTickEventful() { tickEventful.store(true, std::memory_order_relaxed); }
+
+std::string MemoryStats::FormatReport(const Report &report) {
+  std::string out = std::format("allocs={} bytes={} live={} peak={}", report.allocations, report.bytes,
+                                getLiveBytes(), getPeakLiveBytes());
+  for (size_t i = 0; i < ZoneCount; ++i) {
+    if (report.zones[i].allocations > 0) {
+      out += std::format(" [{}: {} / {}B]", ZoneName(static_cast<ProfileZone>(i)), report.zones[i].allocations,
+                         report.zones[i].bytes);
+    }
+  }
+  return out;
+}
+
+// -----------------------------------------------------------------------------
+// Global operator new/delete replacement
+// -----------------------------------------------------------------------------
+#ifdef PARKLOGIC_TRACK_ALLOCATIONS
+
+namespace {
+
+// Every block carries its size in a header so deletes can be accounted without sized-delete support.
+// 16 bytes keeps the default new alignment.
+constexpr size_t HEADER_SIZE = 16;
+
+void *trackedAlloc(size_t size, size_t alignment) {
+  size_t header = std::max(HEADER_SIZE, alignment);
+  size_t total = header + size;
+  void *raw = nullptr;
+
+  if (alignment <= HEADER_SIZE) {
+    raw = std::malloc(total);
+  } else {
+#ifdef _MSC_VER
+    raw = _aligned_malloc(total, alignment);
+#else
+    total = (total + alignment - 1) & ~(alignment - 1); // aligned_alloc wants a multiple of alignment
+    raw = std::aligned_alloc(alignment, total);
+#endif
+  }
+  if (!raw)
+    return nullptr;
+
+  *static_cast<size_t *>(raw) = size;
+  MemoryStats::recordAllocation(size);
+  return static_cast<std::byte *>(raw) + header;
+}
+
+void trackedFree(void *ptr, size_t alignment) noexcept {
+  if (!ptr)
+    return;
+  size_t header = std::max(HEADER_SIZE, alignment);
+  void *raw = static_cast<std::byte *>(ptr) - header;
+  MemoryStats::recordDeallocation(*static_cast<size_t *>(raw));
+
+  if (alignment <= HEADER_SIZE) {
+    std::free(raw);
+  } else {
+#ifdef _MSC_VER
+    _aligned_free(raw);
+#else
+    std::free(raw);
+#endif
+  }
+}
+
+void *allocOrThrow(size_t size, size_t alignment) {
+  void *p = trackedAlloc(size == 0 ? 1 : size, alignment);
+  if (!p)
+    throw std::bad_alloc();
+  return p;
+}
+
+constexpr size_t DEFAULT_ALIGN = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+} // namespace
+
+void *operator new(size_t size) { return allocOrThrow(size, DEFAULT_ALIGN); }
+void *operator new[](size_t size) { return allocOrThrow(size, DEFAULT_ALIGN); }
+void *operator new(size_t size, const std::nothrow_t &) noexcept { return trackedAlloc(size ? size : 1, DEFAULT_ALIGN); }
+void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+  return trackedAlloc(size ? size : 1, DEFAULT_ALIGN);
+}
+void *operator new(size_t size, std::align_val_t al) { return allocOrThrow(size, static_cast<size_t>(al)); }
+void *operator new[](size_t size, std::align_val_t al) { return allocOrThrow(size, static_cast<size_t>(al)); }
+void *operator new(size_t size, std::align_val_t al, const std::nothrow_t &) noexcept {
+  return trackedAlloc(size ? size : 1, static_cast<size_t>(al));
+}
+void *operator new[](size_t size, std::align_val_t al, const std::nothrow_t &) noexcept {
+  return trackedAlloc(size ? size : 1, static_cast<size_t>(al));
+}
+
+void operator delete(void *p) noexcept { trackedFree(p, DEFAULT_ALIGN); }
+void operator delete[](void *p) noexcept { trackedFree(p, DEFAULT_ALIGN); }
+void operator delete(void *p, size_t) noexcept { trackedFree(p, DEFAULT_ALIGN); }
+void operator delete[](void *p, size_t) noexcept { trackedFree(p, DEFAULT_ALIGN); }
+void operator delete(void *p, const std::nothrow_t &) noexcept { trackedFree(p, DEFAULT_ALIGN); }
+void operator delete[](void *p, const std::nothrow_t &) noexcept { trackedFree(p, DEFAULT_ALIGN); }
+void operator delete(void *p, std::align_val_t al) noexcept { trackedFree(p, static_cast<size_t>(al)); }
+void operator delete[](void *p, std::align_val_t al) noexcept { trackedFree(p, static_cast<size_t>(al)); }
+void operator delete(void *p, size_t, std::align_val_t al) noexcept { trackedFree(p, static_cast<size_t>(al)); }
+void operator delete[](void *p, size_t, std::align_val_t al) noexcept { trackedFree(p, static_cast<size_t>(al)); }
+void operator delete(void *p, std::align_val_t al, const std::nothrow_t &) noexcept {
+  trackedFree(p, static_cast<size_t>(al));
+}
+void operator delete[](void *p, std::align_val_t al, const std::nothrow_t &) noexcept {
+  trackedFree(p, static_cast<size_t>(al));
+}
+
+#endif // PARKLOGIC_TRACK_ALLOCATIONS
@@ -0,0 +1,139 @@
+#include "core/RenderStats.hpp"
+#include "rlgl.h"
+#include <algorithm>
+#include <stdexcept>
+
+/**
+ * @file RenderStats.cpp
+ * @brief GL call counting and pass timing for the render benchmark.
+ */
+
+#ifdef _WIN32
+#define PARKLOGIC_GLAPI __stdcall
+#else
+#define PARKLOGIC_GLAPI
+#endif
+
+// raylib's desktop backend reaches GL through glad's loader pointers (filled in by InitWindow)
+extern "C" {
+extern void(PARKLOGIC_GLAPI *glad_glDrawArrays)(unsigned int mode, int first, int count);
+extern void(PARKLOGIC_GLAPI *glad_glDrawElements)(unsigned int mode, int count, unsigned int type,
+                                                  const void *indices);
+extern void(PARKLOGIC_GLAPI *glad_glBindTexture)(unsigned int target, unsigned int texture);
+}
+
+namespace {
+constexpr unsigned int GL_TEXTURE_2D_TARGET = 0x0DE1;
+
+decltype(glad_glDrawArrays) realDrawArrays = nullptr;
+decltype(glad_glDrawElements) realDrawElements = nullptr;
+decltype(glad_glBindTexture) realBindTexture = nullptr;
+unsigned int boundTexture = 0; ///< Last 2D texture bound; rlgl rebinds it for every draw call of a batch.
+
+void PARKLOGIC_GLAPI drawArrays(unsigned int mode, int first, int count) {
+  RenderStats::countDraw();
+  realDrawArrays(mode, first, count);
+}
+
+void PARKLOGIC_GLAPI drawElements(unsigned int mode, int count, unsigned int type, const void *indices) {
+  RenderStats::countDraw();
+  realDrawElements(mode, count, type, indices);
+}
+
+void PARKLOGIC_GLAPI bindTexture(unsigned int target, unsigned int texture) {
+  if (target != GL_TEXTURE_2D_TARGET || texture != boundTexture)
+    RenderStats::countBind();
+  if (target == GL_TEXTURE_2D_TARGET)
+    boundTexture = texture;
+  realBindTexture(target, texture);
+}
+} // namespace
+
+bool RenderStats::enabled = false;
+RenderPass RenderStats::currentPass = RenderPass::Other;
+RenderStats::Frame RenderStats::frame{};
+std::chrono::steady_clock::time_point RenderStats::frameStart{};
+
+uint32_t RenderStats::Frame::drawCalls() const {
+  uint32_t total = 0;
+  for (const PassCounters &pass : passes)
+    total += pass.drawCalls;
+  return total;
+}
+
+uint32_t RenderStats::Frame::textureBinds() const {
+  uint32_t total = 0;
+  for (const PassCounters &pass : passes)
+    total += pass.textureBinds;
+  return total;
+}
+
+void RenderStats::Enable() {
+  if (enabled)
+    return;
+  if (!glad_glDrawArrays || !glad_glDrawElements || !glad_glBindTexture)
+    throw std::runtime_error("RenderStats: no OpenGL entry points loaded (window not open?)");
+
+  realDrawArrays = glad_glDrawArrays;
+  realDrawElements = glad_glDrawElements;
+  realBindTexture = glad_glBindTexture;
+  glad_glDrawArrays = drawArrays;
+  glad_glDrawElements = drawElements;
+  glad_glBindTexture = bindTexture;
+  enabled = true;
+}
+
+void RenderStats::beginFrame() {
+  frame = Frame{};
+  currentPass = RenderPass::Other;
+  frameStart = std::chrono::steady_clock::now();
+}
+
+const RenderStats::Frame &RenderStats::endFrame() {
+  frame.millis = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frameStart).count();
+
+  // Other is whatever the passes did not account for
+  double inPasses = 0.0;
+  for (size_t i = 1; i < PassCount; ++i)
+    inPasses += frame.passes[i].millis;
+  frame.passes[(size_t)RenderPass::Other].millis = std::max(0.0, frame.millis - inPasses);
+  return frame;
+}
+
+const char *RenderStats::PassName(RenderPass pass) {
+  switch (pass) {
+  case RenderPass::Other:
+    return "other";
+  case RenderPass::WorldTiles:
+    return "world tiles";
+  case RenderPass::Modules:
+    return "modules";
+  case RenderPass::Cars:
+    return "cars";
+  case RenderPass::Overlay:
+    return "overlay";
+  case RenderPass::HUD:
+    return "hud";
+  default:
+    return "?";
+  }
+}
+
+RenderPassScope::RenderPassScope(RenderPass pass) {
+  if (!RenderStats::enabled)
+    return;
+  rlDrawRenderBatchActive(); // Geometry queued so far belongs to the enclosing pass
+  active = true;
+  previous = RenderStats::currentPass;
+  RenderStats::currentPass = pass;
+  start = std::chrono::steady_clock::now();
+}
+
+RenderPassScope::~RenderPassScope() {
+  if (!active)
+    return;
+  rlDrawRenderBatchActive();
+  RenderStats::frame.passes[(size_t)RenderStats::currentPass].millis +=
+      std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  RenderStats::currentPass = previous;
+}
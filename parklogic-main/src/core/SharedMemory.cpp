@@ -0,0 +1,83 @@
+#include "core/SharedMemory.hpp"
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @file SharedMemory.cpp
+ * @brief POSIX and Win32 implementations of SharedMemory.
+ */
+
+#ifdef _WIN32
+
+SharedMemory::SharedMemory(std::string segmentName, size_t size) : length(size) {
+  // Win32 names have no leading slash; "Local\" keeps them per session
+  name = segmentName.starts_with('/') ? segmentName.substr(1) : segmentName;
+  std::string objectName = "Local\\" + name;
+
+  HANDLE mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, (DWORD)((uint64_t)size >> 32),
+                                      (DWORD)(size & 0xFFFFFFFF), objectName.c_str());
+  if (!mapping)
+    throw std::runtime_error("SharedMemory: cannot create " + objectName);
+  mappingHandle = mapping;
+
+  base = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+  if (!base) {
+    CloseHandle(mapping);
+    throw std::runtime_error("SharedMemory: cannot map " + objectName);
+  }
+  std::memset(base, 0, length);
+}
+
+SharedMemory::~SharedMemory() {
+  // The object disappears with its last handle
+  if (base)
+    UnmapViewOfFile(base);
+  if (mappingHandle)
+    CloseHandle(mappingHandle);
+}
+
+#else
+
+SharedMemory::SharedMemory(std::string segmentName, size_t size) : length(size) {
+  name = segmentName.starts_with('/') ? segmentName : "/" + segmentName;
+
+  // Without O_EXCL a segment left behind by a crashed run is simply reused
+  int fd = ::shm_open(name.c_str(), O_CREAT | O_RDWR, 0644);
+  if (fd < 0)
+    throw std::runtime_error("SharedMemory: cannot create " + name);
+
+  if (::ftruncate(fd, (off_t)size) != 0) {
+    ::close(fd);
+    ::shm_unlink(name.c_str());
+    throw std::runtime_error("SharedMemory: cannot resize " + name);
+  }
+
+  void *p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd); // The mapping keeps the segment alive
+  if (p == MAP_FAILED) {
+    ::shm_unlink(name.c_str());
+    throw std::runtime_error("SharedMemory: cannot map " + name);
+  }
+  base = p;
+  std::memset(base, 0, length);
+}
+
+SharedMemory::~SharedMemory() {
+  if (base)
+    ::munmap(base, length);
+  ::shm_unlink(name.c_str());
+}
+
+#endif
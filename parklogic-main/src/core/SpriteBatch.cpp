@@ -0,0 +1,70 @@
+#include "core/SpriteBatch.hpp"
+#include "raymath.h"
+#include "rlgl.h"
+#include <cmath>
+
+/**
+ * @file SpriteBatch.cpp
+ * @brief Quad corners (as raylib's DrawTexturePro computes them) and their submission.
+ */
+
+SpriteQuad SpriteBatch::Quad(const Texture2D &texture, Rectangle dest, Vector2 origin, float rotation) {
+  SpriteQuad quad;
+  if (texture.id == 0)
+    return quad;
+  quad.texture = texture.id;
+
+  if (rotation == 0.0f) {
+    float x = dest.x - origin.x;
+    float y = dest.y - origin.y;
+    quad.topLeft = {x, y};
+    quad.topRight = {x + dest.width, y};
+    quad.bottomLeft = {x, y + dest.height};
+    quad.bottomRight = {x + dest.width, y + dest.height};
+    return quad;
+  }
+
+  float sinRotation = sinf(rotation * DEG2RAD);
+  float cosRotation = cosf(rotation * DEG2RAD);
+  float dx = -origin.x;
+  float dy = -origin.y;
+  auto corner = [&](float cx, float cy) {
+    return Vector2{dest.x + cx * cosRotation - cy * sinRotation, dest.y + cx * sinRotation + cy * cosRotation};
+  };
+  quad.topLeft = corner(dx, dy);
+  quad.topRight = corner(dx + dest.width, dy);
+  quad.bottomLeft = corner(dx, dy + dest.height);
+  quad.bottomRight = corner(dx + dest.width, dy + dest.height);
+  return quad;
+}
+
+void SpriteBatch::submit() const {
+  unsigned int bound = 0;
+  for (const SpriteQuad &quad : quads) {
+    if (quad.texture == 0)
+      continue;
+    if (quad.texture != bound) {
+      if (bound != 0)
+        rlEnd();
+      rlSetTexture(quad.texture); // Starts a new draw call only when the texture changes
+      rlBegin(RL_QUADS);
+      rlColor4ub(255, 255, 255, 255);
+      rlNormal3f(0.0f, 0.0f, 1.0f);
+      bound = quad.texture;
+    }
+    rlCheckRenderBatchLimit(4); // Flushes a full batch between quads, never inside one
+
+    rlTexCoord2f(0.0f, 0.0f);
+    rlVertex2f(quad.topLeft.x, quad.topLeft.y);
+    rlTexCoord2f(0.0f, 1.0f);
+    rlVertex2f(quad.bottomLeft.x, quad.bottomLeft.y);
+    rlTexCoord2f(1.0f, 1.0f);
+    rlVertex2f(quad.bottomRight.x, quad.bottomRight.y);
+    rlTexCoord2f(1.0f, 0.0f);
+    rlVertex2f(quad.topRight.x, quad.topRight.y);
+  }
+  if (bound != 0) {
+    rlEnd();
+    rlSetTexture(0);
+  }
+}
@@ -0,0 +1,135 @@
+#include "core/SystemScheduler.hpp"
+#include "core/Logger.hpp"
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+
+/**
+ * @file SystemScheduler.cpp
+ * @brief Dependency graph, staggered rates, wave execution and timing report.
+ */
+
+void SystemScheduler::Timing::add(double micros) {
+  runs++;
+  totalMicros += micros;
+  worstMicros = std::max(worstMicros, micros);
+}
+
+SystemScheduler::SystemScheduler(int workers) : pool(workers) {}
+
+int SystemScheduler::DefaultWorkers() {
+  int cores = (int)std::thread::hardware_concurrency();
+  return std::clamp(cores - 1, 0, Config::Scheduler::MAX_WORKERS);
+}
+
+void SystemScheduler::add(System system) {
+  if ((int)entries.size() == Config::Scheduler::MAX_SYSTEMS)
+    throw std::length_error("SystemScheduler: too many systems");
+
+  Entry entry;
+  entry.system = std::move(system);
+  entry.period = std::max(1, (int)std::lround((double)Config::TICK_RATE / std::max(1, entry.system.rate)));
+  if (entry.period > 1)
+    entry.phase = lowRateSystems++ % entry.period; // Staggered against the other low-rate systems
+
+  uint32_t touches = entry.system.reads | entry.system.writes;
+  for (size_t i = 0; i < entries.size(); ++i) {
+    const System &other = entries[i].system;
+    if (other.stage > entry.system.stage)
+      continue; // Added out of stage order: it depends on us instead
+    bool conflict = (entry.system.writes & (other.reads | other.writes)) || (touches & other.writes);
+    if (conflict)
+      entry.dependencies |= 1u << i;
+  }
+
+  // Systems of later stages that were added before this one wait for it
+  size_t self = entries.size();
+  for (Entry &other : entries) {
+    if (other.system.stage <= entry.system.stage)
+      continue;
+    uint32_t otherTouches = other.system.reads | other.system.writes;
+    if ((other.system.writes & touches) || (otherTouches & entry.system.writes))
+      other.dependencies |= 1u << self;
+  }
+
+  Logger::Info("SystemScheduler: {} ({} stage, every {} tick{})", entry.system.name, StageName(entry.system.stage),
+               entry.period, entry.period > 1 ? "s" : "");
+  entries.push_back(std::move(entry));
+}
+
+void SystemScheduler::run(Entry &entry) {
+  auto start = std::chrono::steady_clock::now();
+  entry.system.update(entry.elapsed);
+  entry.lastMicros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+  entry.timing.add(entry.lastMicros);
+  entry.elapsed = 0.0;
+}
+
+void SystemScheduler::tick(double dt) {
+  uint32_t due = 0;
+  for (size_t i = 0; i < entries.size(); ++i) {
+    Entry &entry = entries[i];
+    entry.elapsed += dt;
+    if ((int)(ticks % (uint64_t)entry.period) == entry.phase)
+      due |= 1u << i;
+  }
+  ticks++;
+
+  // Waves: every due system whose due dependencies have all finished
+  uint32_t pending = due;
+  while (pending) {
+    int count = 0;
+    for (uint32_t bits = pending; bits; bits &= bits - 1) {
+      int i = std::countr_zero(bits);
+      if ((entries[i].dependencies & pending) == 0)
+        wave[count++] = i;
+    }
+    auto job = [this](int slot) { run(entries[wave[slot]]); };
+    pool.run(count, job);
+    for (int slot = 0; slot < count; ++slot)
+      pending &= ~(1u << wave[slot]);
+  }
+
+  std::array<double, (size_t)Stage::Count> stageMicros{};
+  std::array<bool, (size_t)Stage::Count> stageRan{};
+  for (uint32_t bits = due; bits; bits &= bits - 1) {
+    const Entry &entry = entries[std::countr_zero(bits)];
+    stageMicros[(size_t)entry.system.stage] += entry.lastMicros;
+    stageRan[(size_t)entry.system.stage] = true;
+  }
+  for (size_t s = 0; s < stageMicros.size(); ++s) {
+    if (stageRan[s])
+      stageTimings[s].add(stageMicros[s]);
+  }
+}
+
+const char *SystemScheduler::StageName(Stage stage) {
+  switch (stage) {
+  case Stage::Input:
+    return "input";
+  case Stage::Simulation:
+    return "simulation";
+  case Stage::Traffic:
+    return "traffic";
+  case Stage::Bookkeeping:
+    return "bookkeeping";
+  default:
+    return "?";
+  }
+}
+
+void SystemScheduler::report() const {
+  Logger::Info("SystemScheduler: {} ticks, {} worker threads", ticks, pool.getWorkerCount());
+  auto line = [](const char *kind, const char *name, const Timing &t) {
+    if (t.runs == 0)
+      return;
+    Logger::Info("SystemScheduler: {} {:<18} {:>9} runs  mean {:8.1f} us  worst {:9.1f} us", kind, name, t.runs,
+                 t.totalMicros / (double)t.runs, t.worstMicros);
+  };
+  for (size_t s = 0; s < stageTimings.size(); ++s)
+    line("stage ", StageName((Stage)s), stageTimings[s]);
+  for (const Entry &entry : entries)
+    line("system", entry.system.name, entry.timing);
+}
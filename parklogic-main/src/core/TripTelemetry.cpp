@@ -0,0 +1,93 @@
+#include "core/TripTelemetry.hpp"
+#include "core/Logger.hpp"
+
+/**
+ * @file TripTelemetry.cpp
+ * @brief Milestone stamping, ring draining and the percentile report.
+ */
+
+TripTelemetry::~TripTelemetry() { detach(); }
+
+void TripTelemetry::attach() {
+  detach();
+  while (ring.front()) // Events of a previous scene
+    ring.pop();
+  histograms = {};
+  counts = {};
+  dropped.store(0, std::memory_order_relaxed);
+  active.store(this, std::memory_order_release);
+}
+
+void TripTelemetry::detach() {
+  TripTelemetry *expected = this;
+  active.compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel);
+}
+
+void TripTelemetry::Record(uint32_t carId, Stamps &stamps, TripMilestone milestone) {
+  if (stamps.reached(milestone))
+    return;
+  stamps.at[(int)milestone] = stamps.clock;
+
+  TripTelemetry *telemetry = active.load(std::memory_order_acquire);
+  if (telemetry && !telemetry->ring.tryPush(Event{carId, milestone, stamps}))
+    telemetry->dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+void TripTelemetry::drain() {
+  while (const Event *event = ring.front()) {
+    const Stamps &s = event->stamps;
+    counts[(int)event->milestone]++;
+
+    switch (event->milestone) {
+    case TripMilestone::GateEntry:
+      if (s.reached(TripMilestone::Spawn))
+        record(Metric::Search, s.since(TripMilestone::Spawn, TripMilestone::GateEntry));
+      break;
+    case TripMilestone::Parked:
+      if (s.reached(TripMilestone::Spawn))
+        record(Metric::TimeToPark, s.since(TripMilestone::Spawn, TripMilestone::Parked));
+      if (s.reached(TripMilestone::GateEntry))
+        record(Metric::Maneuver, s.since(TripMilestone::GateEntry, TripMilestone::Parked));
+      break;
+    case TripMilestone::Despawn:
+      if (s.reached(TripMilestone::ExitStart))
+        record(Metric::Exit, s.since(TripMilestone::ExitStart, TripMilestone::Despawn));
+      else if (s.reached(TripMilestone::PassThrough) && s.reached(TripMilestone::Spawn))
+        record(Metric::PassThrough, s.since(TripMilestone::Spawn, TripMilestone::Despawn));
+      break;
+    default:
+      break;
+    }
+    ring.pop();
+  }
+}
+
+const char *TripTelemetry::MetricName(Metric metric) {
+  switch (metric) {
+  case Metric::TimeToPark:
+    return "time-to-park";
+  case Metric::Search:
+    return "search";
+  case Metric::Maneuver:
+    return "maneuver";
+  case Metric::Exit:
+    return "exit";
+  case Metric::PassThrough:
+    return "pass-through";
+  default:
+    return "?";
+  }
+}
+
+void TripTelemetry::report() const {
+  Logger::Info("Trips: {} spawned, {} parked, {} passed through, {} despawned, {} removed stuck ({} events dropped)",
+               getCount(TripMilestone::Spawn), getCount(TripMilestone::Parked), getCount(TripMilestone::PassThrough),
+               getCount(TripMilestone::Despawn), getCount(TripMilestone::Removed), getDropped());
+  for (int m = 0; m < METRICS; ++m) {
+    const LatencyHistogram &h = histograms[m];
+    if (h.count() == 0)
+      continue;
+    Logger::Info("Trips: {:<13} n={:<7} p50 {:7.1f} s  p90 {:7.1f} s  p99 {:7.1f} s  max {:7.1f} s",
+                 MetricName((Metric)m), h.count(), h.percentile(50), h.percentile(90), h.percentile(99), h.max());
+  }
+}
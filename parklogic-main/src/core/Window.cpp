@@ -3,6 +3,7 @@
 #include "core/Logger.hpp"
 #include "events/WindowEvents.hpp"
 #include <algorithm>
+#include <cstdlib>
 #include <stdexcept>
 
 /**
@@ -13,9 +14,10 @@
  * and maintaining aspect ratio during resizing.
  */
 
-Window::Window(std::shared_ptr<EventBus> bus) : eventBus(bus), scale(1.0f), offsetX(0.0f), offsetY(0.0f) {
+Window::Window(std::shared_ptr<EventBus> bus, bool offscreen)
+    : eventBus(bus), scale(1.0f), offsetX(0.0f), offsetY(0.0f) {
 
-  initRaylib();
+  initRaylib(offscreen);
 
   // Initialize the render texture for the logical resolution
   target = LoadRenderTexture(Config::LOGICAL_WIDTH, Config::LOGICAL_HEIGHT);
@@ -37,16 +39,24 @@ Window::~Window() {
   Logger::Info("Window Closed");
 }
 
-void Window::initRaylib() {
-  if (Config::VSYNC_ENABLED)
-    SetConfigFlags(FLAG_VSYNC_HINT);
-  SetConfigFlags(FLAG_WINDOW_RESIZABLE);
+void Window::initRaylib(bool offscreen) {
+  if (offscreen) {
+#ifndef _WIN32
+    // Mesa's llvmpipe: comparable numbers on machines with and without a GPU (=0 keeps the GPU)
+    setenv("LIBGL_ALWAYS_SOFTWARE", "1", 0);
+#endif
+    SetConfigFlags(FLAG_WINDOW_HIDDEN);
+  } else {
+    if (Config::VSYNC_ENABLED)
+      SetConfigFlags(FLAG_VSYNC_HINT);
+    SetConfigFlags(FLAG_WINDOW_RESIZABLE);
+  }
   SetTraceLogLevel(LOG_WARNING);
 
   InitWindow(Config::INITIAL_WINDOW_WIDTH, Config::INITIAL_WINDOW_HEIGHT, Config::WINDOW_TITLE);
   SetExitKey(KEY_NULL);
   SetWindowMinSize(640, 360);
-  SetTargetFPS(Config::TARGET_FPS);
+  SetTargetFPS(offscreen ? 0 : Config::TARGET_FPS); // 0: no frame cap
 
   if (!IsWindowReady())
     throw std::runtime_error("Failed to Initialize Raylib Window");
@@ -0,0 +1,239 @@
+#include "entities/AvoidanceKernel.hpp"
+#include <cmath>
+
+#if defined(PARKLOGIC_SIMD) && (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define PARKLOGIC_AVX2_KERNEL 1
+#include <immintrin.h>
+#endif
+
+/**
+ * @file AvoidanceKernel.cpp
+ * @brief Scalar and AVX2 evaluation of the avoidance force terms.
+ *
+ * Keep the two paths operation for operation alike: each term is computed with the same
+ * multiplications, divisions and square roots in the same order, which is what makes the
+ * deterministic build bit-exact. Built with -ffp-contract=off (see CMakeLists.txt) so the
+ * compiler does not fuse them into FMAs on either side.
+ */
+
+namespace {
+namespace A = Config::CarAI::Avoidance;
+
+/// Far enough to be outside every corridor and radius; pads a batch to whole groups of 8.
+constexpr float INERT_OFFSET = 1.0e6f;
+
+void accumulateScalar(const AvoidanceKernel::Self &self, const AvoidanceKernel::NeighborBatch &batch,
+                      AvoidanceKernel::Totals &totals) {
+  Vector2 &acc = totals.acceleration;
+  for (int i = 0; i < batch.count; ++i) {
+    float ox = batch.offsetX[i];
+    float oy = batch.offsetY[i];
+    float dotForward = ox * self.heading.x + oy * self.heading.y;
+    float dotSide = ox * self.side.x + oy * self.side.y;
+
+    if (dotForward > 0.0f && dotForward < self.lookAhead && std::fabs(dotSide) < A::LANE_HALF_WIDTH) {
+      float proximity = 1.0f - dotForward / self.lookAhead;
+      float brakingForce = A::BRAKING_GAIN * (proximity * proximity);
+      acc.x += self.heading.x * -brakingForce;
+      acc.y += self.heading.y * -brakingForce;
+      totals.braking += brakingForce;
+
+      float alignment = self.heading.x * batch.headingX[i] + self.heading.y * batch.headingY[i];
+      if (alignment < A::HEAD_ON_ALIGNMENT || self.speed < A::CRAWL_SPEED) {
+        float steer = A::SIDE_STEP_FORCE * (dotSide > 0.0f ? -1.0f : 1.0f); // Away from their side
+        acc.x += self.side.x * steer;
+        acc.y += self.side.y * steer;
+        totals.sideStepped = true;
+      }
+
+      if (self.speed > batch.speed[i]) {
+        float matchForce = (self.speed - batch.speed[i]) * A::MATCH_GAIN;
+        acc.x += self.heading.x * -matchForce;
+        acc.y += self.heading.y * -matchForce;
+        totals.braking += matchForce;
+      }
+    }
+
+    float dist = std::sqrt(ox * ox + oy * oy);
+    if (dist < A::REPULSION_RADIUS) {
+      float push = A::REPULSION_FORCE * (1.0f - dist / A::REPULSION_RADIUS);
+      float nx = dist > 0.0f ? ox / dist : ox;
+      float ny = dist > 0.0f ? oy / dist : oy;
+      acc.x += nx * -push;
+      acc.y += ny * -push;
+    }
+  }
+}
+
+#ifdef PARKLOGIC_AVX2_KERNEL
+bool hasAvx2() {
+  static const bool supported = __builtin_cpu_supports("avx2");
+  return supported;
+}
+
+__attribute__((target("avx2"))) void accumulateAvx2(const AvoidanceKernel::Self &self,
+                                                     const AvoidanceKernel::NeighborBatch &batch, int groups,
+                                                     AvoidanceKernel::Totals &totals) {
+  const __m256 zero = _mm256_setzero_ps();
+  const __m256 one = _mm256_set1_ps(1.0f);
+  const __m256 sign = _mm256_set1_ps(-0.0f);
+  const __m256 hx = _mm256_set1_ps(self.heading.x);
+  const __m256 hy = _mm256_set1_ps(self.heading.y);
+  const __m256 sx = _mm256_set1_ps(self.side.x);
+  const __m256 sy = _mm256_set1_ps(self.side.y);
+  const __m256 speed = _mm256_set1_ps(self.speed);
+  const __m256 lookAhead = _mm256_set1_ps(self.lookAhead);
+  const __m256 crawling = self.speed < A::CRAWL_SPEED ? _mm256_castsi256_ps(_mm256_set1_epi32(-1)) : zero;
+
+#ifndef PARKLOGIC_DETERMINISTIC
+  __m256 accX = zero, accY = zero, braking = zero;
+#endif
+  int sideSteps = 0;
+
+  for (int g = 0; g < groups; ++g) {
+    const int i = g * 8;
+    __m256 ox = _mm256_load_ps(batch.offsetX + i);
+    __m256 oy = _mm256_load_ps(batch.offsetY + i);
+    __m256 dotForward = _mm256_add_ps(_mm256_mul_ps(ox, hx), _mm256_mul_ps(oy, hy));
+    __m256 dotSide = _mm256_add_ps(_mm256_mul_ps(ox, sx), _mm256_mul_ps(oy, sy));
+
+    __m256 corridor = _mm256_and_ps(
+        _mm256_and_ps(_mm256_cmp_ps(dotForward, zero, _CMP_GT_OQ), _mm256_cmp_ps(dotForward, lookAhead, _CMP_LT_OQ)),
+        _mm256_cmp_ps(_mm256_andnot_ps(sign, dotSide), _mm256_set1_ps(A::LANE_HALF_WIDTH), _CMP_LT_OQ));
+
+    __m256 proximity = _mm256_sub_ps(one, _mm256_div_ps(dotForward, lookAhead));
+    __m256 brakingForce = _mm256_mul_ps(_mm256_set1_ps(A::BRAKING_GAIN), _mm256_mul_ps(proximity, proximity));
+    __m256 negBraking = _mm256_xor_ps(brakingForce, sign);
+    __m256 brakeX = _mm256_mul_ps(hx, negBraking);
+    __m256 brakeY = _mm256_mul_ps(hy, negBraking);
+
+    __m256 alignment = _mm256_add_ps(_mm256_mul_ps(hx, _mm256_load_ps(batch.headingX + i)),
+                                     _mm256_mul_ps(hy, _mm256_load_ps(batch.headingY + i)));
+    __m256 sideStep = _mm256_and_ps(
+        corridor, _mm256_or_ps(_mm256_cmp_ps(alignment, _mm256_set1_ps(A::HEAD_ON_ALIGNMENT), _CMP_LT_OQ), crawling));
+    __m256 steer = _mm256_blendv_ps(_mm256_set1_ps(A::SIDE_STEP_FORCE), _mm256_set1_ps(-A::SIDE_STEP_FORCE),
+                                    _mm256_cmp_ps(dotSide, zero, _CMP_GT_OQ));
+    __m256 sideX = _mm256_mul_ps(sx, steer);
+    __m256 sideY = _mm256_mul_ps(sy, steer);
+
+    __m256 neighborSpeed = _mm256_load_ps(batch.speed + i);
+    __m256 match = _mm256_and_ps(corridor, _mm256_cmp_ps(speed, neighborSpeed, _CMP_GT_OQ));
+    __m256 matchForce = _mm256_mul_ps(_mm256_sub_ps(speed, neighborSpeed), _mm256_set1_ps(A::MATCH_GAIN));
+    __m256 negMatch = _mm256_xor_ps(matchForce, sign);
+    __m256 matchX = _mm256_mul_ps(hx, negMatch);
+    __m256 matchY = _mm256_mul_ps(hy, negMatch);
+
+    __m256 dist = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(ox, ox), _mm256_mul_ps(oy, oy)));
+    __m256 radius = _mm256_set1_ps(A::REPULSION_RADIUS);
+    __m256 repel = _mm256_cmp_ps(dist, radius, _CMP_LT_OQ);
+    __m256 push = _mm256_mul_ps(_mm256_set1_ps(A::REPULSION_FORCE), _mm256_sub_ps(one, _mm256_div_ps(dist, radius)));
+    __m256 negPush = _mm256_xor_ps(push, sign);
+    __m256 apart = _mm256_cmp_ps(dist, zero, _CMP_GT_OQ);
+    __m256 pushX = _mm256_mul_ps(_mm256_blendv_ps(ox, _mm256_div_ps(ox, dist), apart), negPush);
+    __m256 pushY = _mm256_mul_ps(_mm256_blendv_ps(oy, _mm256_div_ps(oy, dist), apart), negPush);
+
+    sideSteps |= _mm256_movemask_ps(sideStep);
+
+#ifdef PARKLOGIC_DETERMINISTIC
+    // Same additions in the same order as the scalar path, one neighbor after the other
+    alignas(32) float terms[12][8];
+    _mm256_store_ps(terms[0], brakeX);
+    _mm256_store_ps(terms[1], brakeY);
+    _mm256_store_ps(terms[2], brakingForce);
+    _mm256_store_ps(terms[3], sideX);
+    _mm256_store_ps(terms[4], sideY);
+    _mm256_store_ps(terms[5], matchX);
+    _mm256_store_ps(terms[6], matchY);
+    _mm256_store_ps(terms[7], matchForce);
+    _mm256_store_ps(terms[8], pushX);
+    _mm256_store_ps(terms[9], pushY);
+    int corridorMask = _mm256_movemask_ps(corridor);
+    int sideMask = _mm256_movemask_ps(sideStep);
+    int matchMask = _mm256_movemask_ps(match);
+    int repelMask = _mm256_movemask_ps(repel);
+
+    Vector2 &acc = totals.acceleration;
+    for (int lane = 0; lane < 8; ++lane) {
+      int bit = 1 << lane;
+      if (corridorMask & bit) {
+        acc.x += terms[0][lane];
+        acc.y += terms[1][lane];
+        totals.braking += terms[2][lane];
+        if (sideMask & bit) {
+          acc.x += terms[3][lane];
+          acc.y += terms[4][lane];
+        }
+        if (matchMask & bit) {
+          acc.x += terms[5][lane];
+          acc.y += terms[6][lane];
+          totals.braking += terms[7][lane];
+        }
+      }
+      if (repelMask & bit) {
+        acc.x += terms[8][lane];
+        acc.y += terms[9][lane];
+      }
+    }
+#else
+    accX = _mm256_add_ps(accX, _mm256_and_ps(corridor, brakeX));
+    accY = _mm256_add_ps(accY, _mm256_and_ps(corridor, brakeY));
+    accX = _mm256_add_ps(accX, _mm256_and_ps(sideStep, sideX));
+    accY = _mm256_add_ps(accY, _mm256_and_ps(sideStep, sideY));
+    accX = _mm256_add_ps(accX, _mm256_and_ps(match, matchX));
+    accY = _mm256_add_ps(accY, _mm256_and_ps(match, matchY));
+    accX = _mm256_add_ps(accX, _mm256_and_ps(repel, pushX));
+    accY = _mm256_add_ps(accY, _mm256_and_ps(repel, pushY));
+    braking = _mm256_add_ps(braking, _mm256_and_ps(corridor, brakingForce));
+    braking = _mm256_add_ps(braking, _mm256_and_ps(match, matchForce));
+#endif
+  }
+
+#ifndef PARKLOGIC_DETERMINISTIC
+  alignas(32) float lanes[3][8];
+  _mm256_store_ps(lanes[0], accX);
+  _mm256_store_ps(lanes[1], accY);
+  _mm256_store_ps(lanes[2], braking);
+  for (int lane = 0; lane < 8; ++lane) {
+    totals.acceleration.x += lanes[0][lane];
+    totals.acceleration.y += lanes[1][lane];
+    totals.braking += lanes[2][lane];
+  }
+#endif
+  if (sideSteps)
+    totals.sideStepped = true;
+}
+#endif
+} // namespace
+
+void AvoidanceKernel::Accumulate(const Self &self, NeighborBatch &batch, Totals &totals) {
+#ifdef PARKLOGIC_AVX2_KERNEL
+  if (batch.count > 0 && hasAvx2()) {
+    int padded = (batch.count + 7) / 8 * 8;
+    for (int i = batch.count; i < padded; ++i) {
+      batch.offsetX[i] = INERT_OFFSET;
+      batch.offsetY[i] = INERT_OFFSET;
+      batch.speed[i] = 0.0f;
+      batch.headingX[i] = 0.0f;
+      batch.headingY[i] = 0.0f;
+    }
+    accumulateAvx2(self, batch, padded / 8, totals);
+    batch.count = 0;
+    return;
+  }
+#endif
+  accumulateScalar(self, batch, totals);
+  batch.count = 0;
+}
+
+const char *AvoidanceKernel::Name() {
+#ifdef PARKLOGIC_AVX2_KERNEL
+  if (hasAvx2()) {
+#ifdef PARKLOGIC_DETERMINISTIC
+    return "AVX2 (deterministic)";
+#else
+    return "AVX2";
+#endif
+  }
+#endif
+  return "scalar";
+}
@@ -1,11 +1,16 @@
 #include "entities/Car.hpp"
+#include "entities/AvoidanceKernel.hpp"
+#include "entities/map/FlowField.hpp"
 #include "entities/map/World.hpp"
 #include "raymath.h"
+#include <algorithm>
 #include <memory>
 #include <vector>
 
 #include "config.hpp"
 #include "core/AssetManager.hpp"
+#include "core/CongestionMap.hpp"
+#include "core/SpriteBatch.hpp"
 
 /**
  * @file Car.cpp
@@ -21,8 +26,9 @@
  * @param startPos The initial position of the car (in meters).
  * @param world Pointer to the world environment for boundary checking.
  */
-Car::Car(Vector2 startPos, const World * /*world*/, Vector2 initialVelocity, CarType type)
-    : position(startPos), velocity(initialVelocity), acceleration{0, 0}, maxSpeed(15.0f), maxForce(60.0f), type(type) {
+Car::Car(WorldCoord startPos, const World * /*world*/, Vector2 initialVelocity, CarType type)
+    : position(startPos), velocity(initialVelocity), acceleration{0, 0}, progressFrom(startPos),
+      maxSpeed(Config::CarAI::MAX_SPEED), maxForce(60.0f), type(type) {
 
   // Pick visual based on type
   int variant = GetRandomValue(1, 3);
@@ -48,6 +54,67 @@ void Car::charge(float amount) {
   }
 }
 
+void Car::setPose(const WorldCoord &newPosition, Vector2 newVelocity, float rotation) {
+  position = newPosition;
+  velocity = newVelocity;
+  currentRotation = rotation;
+}
+
+Car::MigrationState Car::saveMigrationState(int32_t facilityIndex) const {
+  MigrationState m{};
+  m.id = id;
+  m.type = (uint8_t)type;
+  m.priority = (uint8_t)priority;
+  m.state = (uint8_t)state;
+  m.enteredFromLeft = enteredFromLeft;
+  m.position = position;
+  m.velocity = velocity;
+  m.currentRotation = currentRotation;
+  m.targetRotation = targetRotation;
+  m.parkingTimer = parkingTimer;
+  m.parkingDuration = parkingDuration;
+  m.batteryLevel = batteryLevel;
+  m.facilityIndex = parkedFacility ? facilityIndex : -1;
+  m.spotIndex = parkedSpotIndex;
+  m.spot = parkedSpot;
+  m.trip = trip;
+  textureName.copy(m.textureName, sizeof(m.textureName) - 1);
+
+  // An overlong path keeps its final waypoint, which carries stopAtEnd
+  m.waypointCount = (uint32_t)std::min(waypoints.size(), (size_t)MAX_MIGRATION_WAYPOINTS);
+  for (uint32_t i = 0; i < m.waypointCount; ++i) {
+    const Waypoint &wp = (i + 1 == m.waypointCount) ? waypoints.back() : waypoints[i];
+    m.waypoints[i] = {wp.position, wp.tolerance, wp.id, wp.entryAngle, wp.speedLimitFactor, wp.stopAtEnd, wp.flowGoal};
+  }
+  return m;
+}
+
+std::unique_ptr<Car> Car::FromMigrationState(const MigrationState &m, const Module *facility) {
+  auto car = std::make_unique<Car>(m.position, nullptr, m.velocity, (CarType)m.type);
+  car->id = m.id;
+  car->priority = (Priority)m.priority;
+  car->state = (CarState)m.state;
+  car->enteredFromLeft = m.enteredFromLeft;
+  car->currentRotation = m.currentRotation;
+  car->targetRotation = m.targetRotation;
+  car->parkingTimer = m.parkingTimer;
+  car->parkingDuration = m.parkingDuration;
+  car->batteryLevel = m.batteryLevel;
+  car->trip = m.trip;
+  car->progressAt = m.trip.clock; // The stall clock restarts with the hand-over
+  car->progressFrom = m.position;
+  car->textureName = m.textureName; // The constructor drew a random variant
+  if (facility)
+    car->setParkingContext(facility, m.spot, m.spotIndex);
+
+  for (uint32_t i = 0; i < m.waypointCount; ++i) {
+    const auto &wp = m.waypoints[i];
+    car->waypoints.emplace_back(wp.position, wp.tolerance, wp.id, wp.entryAngle, wp.stopAtEnd, wp.speedLimitFactor);
+    car->waypoints.back().flowGoal = wp.flowGoal;
+  }
+  return car;
+}
+
 void Car::setParkingContext(const Module *fac, const Spot &spot, int spotIndex) {
   parkedFacility = fac;
   parkedSpot = spot;
@@ -74,8 +141,12 @@ void Car::update(double dt) { updateWithNeighbors(dt, nullptr); }
  *
  * @param dt Delta time.
  * @param cars List of other cars for collision checks.
+ * @param ghosts Cars of neighbouring shards near the seam, avoided like local ones.
  */
-void Car::updateWithNeighbors(double dt, const std::vector<std::unique_ptr<Car>> *cars) {
+void Car::updateWithNeighbors(double dt, const std::vector<std::unique_ptr<Car>> *cars,
+                              std::span<const std::unique_ptr<Car>> ghosts) {
+  trip.clock += (float)dt;
+
   // 1. Handle Static States
   if (state == CarState::PARKED) {
     parkingTimer -= (float)dt;
@@ -85,24 +156,29 @@ void Car::updateWithNeighbors(double dt, const std::vector<std::unique_ptr<Car>>
   // 2. Path Following (Seek)
   if (!waypoints.empty()) {
     Waypoint &currentWp = waypoints.front();
-    seek(currentWp);
+    if (!followFlow(currentWp))
+      seek(currentWp);
 
-    if (Vector2Distance(position, currentWp.position) < currentWp.tolerance) {
+    if (WorldCoord::Distance(position, currentWp.position) < currentWp.tolerance) {
       if (waypoints.size() == 1) {
         if (currentWp.stopAtEnd && state == CarState::DRIVING) {
           velocity = {0, 0};
           acceleration = {0, 0};
           state = CarState::ALIGNING;
           targetRotation = currentWp.entryAngle;
+          stampTrip(TripMilestone::SpotArrival);
         }
       }
+      if (currentWp.id == Waypoint::GATE_ID && state == CarState::DRIVING)
+        stampTrip(TripMilestone::GateEntry);
       waypoints.pop_front();
+      markProgress();
     }
   } else {
     if (state == CarState::ALIGNING) {
       // Smooth Rotation Logic
       float targetDeg = (targetRotation * RAD2DEG) + 90.0f;
-      float rotSpeed = 120.0f;
+      float rotSpeed = Config::CarAI::ALIGN_ROTATION_SPEED;
       float diff = targetDeg - currentRotation;
       while (diff > 180.0f)
         diff -= 360.0f;
@@ -112,8 +188,11 @@ void Car::updateWithNeighbors(double dt, const std::vector<std::unique_ptr<Car>>
       if (fabs(diff) < 1.0f) {
         currentRotation = targetDeg;
         state = CarState::PARKED;
-        parkingTimer =
-            (float)GetRandomValue((int)(Config::PARKING_MIN_TIME * 10), (int)(Config::PARKING_MAX_TIME * 10)) / 10.0f;
+        stampTrip(TripMilestone::Parked);
+        parkingTimer = hasParkingDuration() ? parkingDuration
+                                            : (float)GetRandomValue((int)(Config::PARKING_MIN_TIME * 10),
+                                                                    (int)(Config::PARKING_MAX_TIME * 10)) /
+                                                  10.0f;
       } else {
         float change = rotSpeed * (float)dt;
         if (change > fabs(diff))
@@ -127,66 +206,49 @@ void Car::updateWithNeighbors(double dt, const std::vector<std::unique_ptr<Car>>
   }
 
   // 3. Collision Avoidance (Enhanced to prevent Head-On Deadlocks)
-  if (cars && (state == CarState::DRIVING || state == CarState::EXITING)) {
+  float brakingApplied = 0.0f; // Reported to the CongestionMap
+  bool sideStepped = false;
+  if (rightOfWay > 0.0f) {
+    rightOfWay -= (float)dt; // Granted by the StuckWatchdog: the others make way
+  } else if (cars && (state == CarState::DRIVING || state == CarState::EXITING)) {
+    namespace A = Config::CarAI::Avoidance;
     // Fallback to rotation-based heading if velocity is zero to prevent getting stuck
-    Vector2 heading = (Vector2Length(velocity) > 0.1f) ? Vector2Normalize(velocity)
-                                                       : Vector2{cosf((currentRotation - 90.0f) * DEG2RAD),
-                                                                 sinf((currentRotation - 90.0f) * DEG2RAD)};
-    Vector2 sideVec = {-heading.y, heading.x};
-
-    float currentSpeed = Vector2Length(velocity);
-    float lookAheadDist = 5.0f + (currentSpeed * 1.5f);
-    float laneWidth = 2.2f;
+    auto headingOf = [](const Car *car) {
+      return (Vector2Length(car->velocity) > 0.1f) ? Vector2Normalize(car->velocity)
+                                                   : Vector2{cosf((car->currentRotation - 90.0f) * DEG2RAD),
+                                                             sinf((car->currentRotation - 90.0f) * DEG2RAD)};
+    };
+    AvoidanceKernel::Self self;
+    self.heading = headingOf(this);
+    self.side = {-self.heading.y, self.heading.x};
+    self.speed = Vector2Length(velocity);
+    self.lookAhead = A::LOOK_AHEAD + (self.speed * A::LOOK_AHEAD_PER_SPEED);
+
+    // Gather the moving cars within reach; the kernel works out the forces a batch at a time
+    AvoidanceKernel::NeighborBatch batch;
+    AvoidanceKernel::Totals totals{acceleration};
+    auto gather = [&](const Car *other) {
+      if (other == this || other->state == CarState::PARKED)
+        return;
+      Vector2 toOther = other->position - position;
+      if (Vector2LengthSqr(toOther) > self.lookAhead * self.lookAhead)
+        return;
+      batch.push(toOther, Vector2Length(other->velocity), headingOf(other));
+      if (batch.full())
+        AvoidanceKernel::Accumulate(self, batch, totals);
+    };
 
     for (const auto &other : *cars) {
-      if (other.get() == this || other->state == CarState::PARKED)
-        continue;
-
-      Vector2 toOther = Vector2Subtract(other->getPosition(), position);
-      float distSq = Vector2LengthSqr(toOther);
-      if (distSq > lookAheadDist * lookAheadDist)
-        continue;
-
-      float dotForward = Vector2DotProduct(toOther, heading);
-      float dotSide = Vector2DotProduct(toOther, sideVec);
-
-      // If car is in the frontal corridor
-      if (dotForward > 0 && dotForward < lookAheadDist && fabsf(dotSide) < laneWidth) {
-
-        // A. Braking Logic
-        float proximity = 1.0f - (dotForward / lookAheadDist);
-        float brakingForce = 45.0f * (proximity * proximity);
-        applyForce(Vector2Scale(heading, -brakingForce));
-
-        // B. Deadlock Breaker (The Fix)
-        // If we are facing each other or very slow, nudge to the side
-        Vector2 otherHeading = (Vector2Length(other->velocity) > 0.1f)
-                                   ? Vector2Normalize(other->velocity)
-                                   : Vector2{cosf((other->currentRotation - 90.0f) * DEG2RAD),
-                                             sinf((other->currentRotation - 90.0f) * DEG2RAD)};
-
-        float alignment = Vector2DotProduct(heading, otherHeading);
-        if (alignment < -0.3f || currentSpeed < 0.5f) {
-          // Force a side-step: steer away from their position relative to us
-          float steerDir = (dotSide > 0) ? -1.0f : 1.0f;
-          applyForce(Vector2Scale(sideVec, 25.0f * steerDir));
-        }
-
-        // C. Match velocity
-        float otherSpeed = Vector2Length(other->velocity);
-        if (currentSpeed > otherSpeed) {
-          float matchForce = (currentSpeed - otherSpeed) * 12.0f;
-          applyForce(Vector2Scale(heading, -matchForce));
-        }
-      }
-
-      // Lateral repulsion (keeps cars from overlapping)
-      float dist = sqrtf(distSq);
-      if (dist < 1.8f) {
-        float pushStrength = 30.0f * (1.0f - (dist / 1.8f));
-        applyForce(Vector2Scale(Vector2Normalize(toOther), -pushStrength));
-      }
+      gather(other.get());
+    }
+    for (const auto &ghost : ghosts) {
+      gather(ghost.get());
     }
+    AvoidanceKernel::Accumulate(self, batch, totals);
+
+    acceleration = totals.acceleration;
+    brakingApplied = totals.braking;
+    sideStepped = totals.sideStepped;
   }
 
   // 4. Physics Integration
@@ -199,7 +261,9 @@ void Car::updateWithNeighbors(double dt, const std::vector<std::unique_ptr<Car>>
       velocity = Vector2Scale(Vector2Normalize(velocity), maxSpeed);
     }
 
-    position = Vector2Add(position, Vector2Scale(velocity, (float)dt));
+    position += Vector2Scale(velocity, (float)dt);
+    if (WorldCoord::Distance(position, progressFrom) > Config::Watchdog::PROGRESS_DISTANCE)
+      markProgress();
 
     // 5. Smooth Rotation (Enhanced responsiveness)
     float speed = Vector2Length(velocity);
@@ -215,6 +279,8 @@ void Car::updateWithNeighbors(double dt, const std::vector<std::unique_ptr<Car>>
       float rotationFactor = (speed < 1.0f) ? 0.1f : 0.15f;
       currentRotation += angleDiff * rotationFactor;
     }
+
+    CongestionMap::Record(position, (float)dt, speed, brakingApplied, sideStepped);
   }
 
   acceleration = {0, 0};
@@ -224,41 +290,54 @@ void Car::updateWithNeighbors(double dt, const std::vector<std::unique_ptr<Car>>
  * @brief Draws the car, its velocity vector, and its current waypoints.
  */
 void Car::draw(bool showPath) {
+  if (showPath)
+    drawPath();
+
+  DrawSprite(textureName, position.toRender(), currentRotation); // Use smoothed rotation
+
+  // Draw velocity vector (heading) for debug
+  // Vector2 velEnd = Vector2Add(position, Vector2Scale(velocity, 0.5f));
+  // DrawLineV(position, velEnd, GREEN);
+}
+
+void Car::drawPath() const {
   // Draw Waypoints and paths (in Meters)
-  if (showPath && !waypoints.empty()) {
-    for (size_t i = 0; i < waypoints.size(); ++i) {
-      Vector2 wpPos = waypoints[i].position;
-      // Radius: 0.25 meters
-      DrawCircleV(wpPos, 0.25f, Fade(BLUE, 0.5f));
-      if (i > 0) {
-        Vector2 prevWpPos = waypoints[i - 1].position;
-        DrawLineV(prevWpPos, wpPos, Fade(BLUE, 0.3f));
-      } else {
-        DrawLineV(position, wpPos, Fade(BLUE, 0.3f));
-      }
+  for (size_t i = 0; i < waypoints.size(); ++i) {
+    Vector2 wpPos = waypoints[i].position.toRender();
+    // Radius: 0.25 meters
+    DrawCircleV(wpPos, 0.25f, Fade(BLUE, 0.5f));
+    if (i > 0) {
+      Vector2 prevWpPos = waypoints[i - 1].position.toRender();
+      DrawLineV(prevWpPos, wpPos, Fade(BLUE, 0.3f));
+    } else {
+      DrawLineV(position.toRender(), wpPos, Fade(BLUE, 0.3f));
     }
   }
+}
 
-  // Draw Car
-  Texture2D tex = AssetManager::Get().GetTexture(textureName);
-
-  // Dimensions in Meters
-  // Art pixel dimensions: 17 x 31
-  float width = 17.0f / static_cast<float>(Config::ART_PIXELS_PER_METER);
-  float height = 31.0f / static_cast<float>(Config::ART_PIXELS_PER_METER);
+namespace {
+// Dimensions in Meters
+// Art pixel dimensions: 17 x 31
+constexpr float SPRITE_WIDTH = 17.0f / static_cast<float>(Config::ART_PIXELS_PER_METER);
+constexpr float SPRITE_HEIGHT = 31.0f / static_cast<float>(Config::ART_PIXELS_PER_METER);
+} // namespace
 
-  // Rotation
-  float rotation = currentRotation; // Use smoothed rotation
+void Car::DrawSprite(const std::string &textureName, Vector2 position, float rotation) {
+  Texture2D tex = AssetManager::Get().GetTexture(textureName);
 
   Rectangle source = {0, 0, (float)tex.width, (float)tex.height};
-  Rectangle dest = {position.x, position.y, width, height};
-  Vector2 origin = {width / 2.0f, height / 2.0f};
+  Rectangle dest = {position.x, position.y, SPRITE_WIDTH, SPRITE_HEIGHT};
+  Vector2 origin = {SPRITE_WIDTH / 2.0f, SPRITE_HEIGHT / 2.0f};
 
   DrawTexturePro(tex, source, dest, origin, rotation, WHITE);
+}
 
-  // Draw velocity vector (heading) for debug
-  // Vector2 velEnd = Vector2Add(position, Vector2Scale(velocity, 0.5f));
-  // DrawLineV(position, velEnd, GREEN);
+SpriteQuad Car::SpriteQuadAt(const std::string &textureName, Vector2 position, float rotation) {
+  const Texture2D *tex = AssetManager::Get().FindTexture(textureName);
+  if (!tex)
+    return {};
+  Rectangle dest = {position.x, position.y, SPRITE_WIDTH, SPRITE_HEIGHT};
+  return SpriteBatch::Quad(*tex, dest, {SPRITE_WIDTH / 2.0f, SPRITE_HEIGHT / 2.0f}, rotation);
 }
 
 /**
@@ -268,11 +347,14 @@ void Car::draw(bool showPath) {
  */
 void Car::addWaypoint(Waypoint wp) { waypoints.push_back(wp); }
 
-void Car::setPath(const std::vector<Waypoint> &path) {
-  waypoints.clear();
-  for (const auto &wp : path) {
-    waypoints.push_back(wp);
-  }
+void Car::setPath(std::span<const Waypoint> path) {
+  waypoints.assign(path.begin(), path.end());
+  markProgress();
+}
+
+void Car::markProgress() {
+  progressAt = trip.clock;
+  progressFrom = position;
 }
 
 /**
@@ -287,14 +369,38 @@ void Car::clearWaypoints() { waypoints.clear(); }
  */
 void Car::applyForce(Vector2 force) { acceleration = Vector2Add(acceleration, force); }
 
+/**
+ * @brief Steers along the facility's precomputed flow field: one cell lookup gives the heading and
+ * the speed limit, so a car crossing a lot follows the aisles without a correction waypoint chain.
+ *
+ * @param wp The current waypoint; only segments tagged with a flow goal are field-steered.
+ * @return Whether a steering force was applied.
+ */
+bool Car::followFlow(const Waypoint &wp) {
+  if (wp.flowGoal < 0 || !parkedFacility || !parkedFacility->getFlowField())
+    return false;
+
+  FlowField::Sample cell;
+  if (!parkedFacility->getFlowField()->sample(wp.flowGoal, position - parkedFacility->worldPosition, cell))
+    return false;
+
+  Vector2 desired = Vector2Scale(cell.direction, maxSpeed * cell.speedFactor);
+  Vector2 steer = Vector2Subtract(desired, velocity);
+  if (Vector2Length(steer) > maxForce) {
+    steer = Vector2Scale(Vector2Normalize(steer), maxForce);
+  }
+
+  applyForce(steer);
+  return true;
+}
+
 /**
  * @brief Calculates the steering force required to move towards a target position (Seek behavior).
  *
  * @param target The target position to seek.
  */
 void Car::seek(const Waypoint &wp) {
-  Vector2 target = wp.position;
-  Vector2 desired = Vector2Subtract(target, position);
+  Vector2 desired = wp.position - position;
   float dist = Vector2Length(desired);
   desired = Vector2Normalize(desired);
 
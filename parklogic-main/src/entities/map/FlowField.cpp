@@ -0,0 +1,269 @@
+#include "entities/map/FlowField.hpp"
+#include "config.hpp"
+#include "core/Logger.hpp"
+#include "entities/map/Modules.hpp"
+#include "raymath.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <unordered_map>
+
+/**
+ * @file FlowField.cpp
+ * @brief Construction of the per-template interior flow fields.
+ */
+
+namespace {
+
+constexpr float UNREACHED = std::numeric_limits<float>::max();
+
+// 8-neighbourhood: four straight steps, then four diagonals
+constexpr int DX[8] = {1, -1, 0, 0, 1, 1, -1, -1};
+constexpr int DY[8] = {0, 0, 1, -1, 1, -1, 1, -1};
+
+struct Grid {
+  int cols;
+  int rows;
+  float cell;
+
+  int index(int x, int y) const { return y * cols + x; }
+  bool contains(int x, int y) const { return x >= 0 && y >= 0 && x < cols && y < rows; }
+  Vector2 center(int x, int y) const { return {(x + 0.5f) * cell, (y + 0.5f) * cell}; }
+};
+
+/**
+ * @brief Dijkstra distances (meters) from the source cells.
+ * @param blocked Cells that cannot be entered, or nullptr if all can; diagonal steps never cut a blocked corner.
+ */
+std::vector<float> distanceField(const Grid &grid, const std::vector<uint8_t> *blocked,
+                                 const std::vector<int> &sources) {
+  std::vector<float> dist((size_t)grid.cols * grid.rows, UNREACHED);
+  using Entry = std::pair<float, int>;
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<>> open;
+  for (int i : sources) {
+    dist[i] = 0.0f;
+    open.push({0.0f, i});
+  }
+
+  auto isBlocked = [&](int x, int y) { return blocked && (*blocked)[grid.index(x, y)]; };
+
+  while (!open.empty()) {
+    auto [d, i] = open.top();
+    open.pop();
+    if (d > dist[i])
+      continue;
+    int x = i % grid.cols;
+    int y = i / grid.cols;
+    for (int n = 0; n < 8; ++n) {
+      int nx = x + DX[n];
+      int ny = y + DY[n];
+      if (!grid.contains(nx, ny) || isBlocked(nx, ny))
+        continue;
+      if (n >= 4 && (isBlocked(x + DX[n], y) || isBlocked(x, y + DY[n])))
+        continue;
+      float nd = d + (n < 4 ? grid.cell : grid.cell * 1.41421356f);
+      int ni = grid.index(nx, ny);
+      if (nd < dist[ni]) {
+        dist[ni] = nd;
+        open.push({nd, ni});
+      }
+    }
+  }
+  return dist;
+}
+
+/// Adds the cells under the segment a-b (inclusive) to the goal set.
+void markSegment(const Grid &grid, Vector2 a, Vector2 b, std::vector<uint8_t> &isGoal, std::vector<int> &goals) {
+  int steps = std::max(1, (int)std::ceil(Vector2Distance(a, b) / (grid.cell * 0.5f)));
+  for (int s = 0; s <= steps; ++s) {
+    Vector2 p = Vector2Lerp(a, b, (float)s / (float)steps);
+    int x = (int)std::floor(p.x / grid.cell);
+    int y = (int)std::floor(p.y / grid.cell);
+    if (!grid.contains(x, y) || isGoal[grid.index(x, y)])
+      continue;
+    isGoal[grid.index(x, y)] = 1;
+    goals.push_back(grid.index(x, y));
+  }
+}
+
+} // namespace
+
+const FlowField &FlowField::For(const ModuleTemplate &layout) {
+  static std::mutex mutex;
+  static std::unordered_map<const ModuleTemplate *, std::unique_ptr<FlowField>> fields;
+
+  std::lock_guard lock(mutex);
+  std::unique_ptr<FlowField> &field = fields[&layout];
+  if (!field)
+    field = std::make_unique<FlowField>(layout);
+  return *field;
+}
+
+FlowField::FlowField(const ModuleTemplate &layout) {
+  namespace Flow = Config::CarAI::Flow;
+  Grid grid{std::max(1, (int)std::ceil(layout.width / Flow::CELL_SIZE)),
+            std::max(1, (int)std::ceil(layout.height / Flow::CELL_SIZE)), Flow::CELL_SIZE};
+  cols = grid.cols;
+  rows = grid.rows;
+  size_t cellCount = (size_t)cols * rows;
+
+  // 1. Stalls: the footprint of a car parked in each spot
+  std::vector<uint8_t> blocked(cellCount, 0);
+  for (const SpotLayout &spot : layout.spots) {
+    Vector2 along = {cosf(spot.orientation), sinf(spot.orientation)};
+    Vector2 across = {-along.y, along.x};
+    for (int y = 0; y < rows; ++y) {
+      for (int x = 0; x < cols; ++x) {
+        Vector2 d = Vector2Subtract(grid.center(x, y), spot.localPosition);
+        if (fabsf(Vector2DotProduct(d, along)) <= Flow::STALL_LENGTH / 2.0f &&
+            fabsf(Vector2DotProduct(d, across)) <= Flow::STALL_WIDTH / 2.0f)
+          blocked[grid.index(x, y)] = 1;
+      }
+    }
+  }
+
+  // 2. Goals: the exit lane of the gate, then the aisle of each row (spots grouped by orientation)
+  std::vector<std::vector<int>> goalCells(1);
+  std::vector<std::vector<uint8_t>> goalMasks(1, std::vector<uint8_t>(cellCount, 0));
+
+  Vector2 exitGate = layout.gatePosition(!layout.isTop); // Mirrors PathPlanner::GenerateExitPath
+  for (int y = 0; y < rows; ++y) {
+    for (int x = 0; x < cols; ++x) {
+      if (Vector2Distance(grid.center(x, y), exitGate) <= Flow::EXIT_GOAL_RADIUS) {
+        goalMasks[EXIT][grid.index(x, y)] = 1;
+        goalCells[EXIT].push_back(grid.index(x, y));
+      }
+    }
+  }
+
+  std::vector<float> rowAngles;
+  spotGoals.resize(layout.spots.size());
+  for (size_t i = 0; i < layout.spots.size(); ++i) {
+    const SpotLayout &spot = layout.spots[i];
+    auto row = std::find_if(rowAngles.begin(), rowAngles.end(),
+                            [&](float angle) { return fabsf(angle - spot.orientation) < 1e-3f; });
+    if (row == rowAngles.end()) {
+      rowAngles.push_back(spot.orientation);
+      row = rowAngles.end() - 1;
+    }
+    spotGoals[i] = (uint8_t)(1 + (row - rowAngles.begin()));
+  }
+  goalCount = 1 + (int)rowAngles.size();
+  goalCells.resize(goalCount);
+  goalMasks.resize(goalCount, std::vector<uint8_t>(cellCount, 0));
+
+  for (int g = 1; g < goalCount; ++g) {
+    // A row's alignment points are collinear; the aisle runs between the outermost two
+    float angle = rowAngles[g - 1];
+    Vector2 back = {-cosf(angle) * Config::CarAI::ALIGN_DISTANCE, -sinf(angle) * Config::CarAI::ALIGN_DISTANCE};
+    Vector2 side = {-sinf(angle), cosf(angle)};
+    Vector2 first{}, last{};
+    float lo = UNREACHED, hi = -UNREACHED;
+    for (size_t i = 0; i < layout.spots.size(); ++i) {
+      if (spotGoals[i] != g)
+        continue;
+      Vector2 align = Vector2Add(layout.spots[i].localPosition, back);
+      float t = Vector2DotProduct(align, side);
+      if (t < lo) {
+        lo = t;
+        first = align;
+      }
+      if (t > hi) {
+        hi = t;
+        last = align;
+      }
+    }
+    markSegment(grid, first, last, goalMasks[g], goalCells[g]);
+  }
+
+  for (const auto &goals : goalCells) {
+    for (int i : goals)
+      blocked[i] = 0; // A goal is always enterable
+  }
+
+  // 3. Clearance from stalls and walls, shared by all layers' speed limits
+  std::vector<int> obstacles;
+  for (int y = 0; y < rows; ++y) {
+    for (int x = 0; x < cols; ++x) {
+      if (blocked[grid.index(x, y)] || x == 0 || y == 0 || x == cols - 1 || y == rows - 1)
+        obstacles.push_back(grid.index(x, y));
+    }
+  }
+  std::vector<float> clearance = distanceField(grid, nullptr, obstacles);
+
+  // 4. One direction and speed per cell and goal
+  const float slowSpeed = Config::CarAI::Phases::MANEUVER.speedFactor;
+  const float openSpeed = Config::CarAI::Phases::ACCESS.speedFactor;
+  cells.assign(cellCount * goalCount, Cell{0, 0, 0});
+
+  for (int g = 0; g < goalCount; ++g) {
+    std::vector<float> dist = distanceField(grid, &blocked, goalCells[g]);
+    Cell *layer = cells.data() + cellCount * g;
+
+    // Distance of a neighbour, or uphill of the cell itself if the neighbour cannot be driven on
+    auto distAt = [&](int x, int y, float fallback) {
+      if (!grid.contains(x, y) || blocked[grid.index(x, y)] || dist[grid.index(x, y)] == UNREACHED)
+        return fallback;
+      return dist[grid.index(x, y)];
+    };
+
+    for (int y = 0; y < rows; ++y) {
+      for (int x = 0; x < cols; ++x) {
+        int i = grid.index(x, y);
+        if (blocked[i] || goalMasks[g][i] || dist[i] == UNREACHED)
+          continue;
+
+        // Down the gradient, which follows the shortest route without the 45-degree zigzag of
+        // the 8-neighbour steps
+        float uphill = dist[i] + grid.cell;
+        Vector2 direction = {distAt(x - 1, y, uphill) - distAt(x + 1, y, uphill),
+                             distAt(x, y - 1, uphill) - distAt(x, y + 1, uphill)};
+        bool usable = Vector2Length(direction) > 1e-3f;
+        if (usable) {
+          direction = Vector2Normalize(direction);
+          Vector2 ahead = Vector2Add(grid.center(x, y), Vector2Scale(direction, grid.cell));
+          usable = distAt((int)std::floor(ahead.x / grid.cell), (int)std::floor(ahead.y / grid.cell), UNREACHED) <
+                   dist[i];
+        }
+
+        // On ridges and around stall corners, fall back to the steepest neighbour
+        if (!usable) {
+          float best = dist[i];
+          for (int n = 0; n < 8; ++n) {
+            float nd = distAt(x + DX[n], y + DY[n], UNREACHED);
+            if (nd < best) {
+              best = nd;
+              direction = Vector2Normalize({(float)DX[n], (float)DY[n]});
+            }
+          }
+        }
+
+        float open = std::clamp(std::min(clearance[i], dist[i]) / Flow::SLOW_RADIUS, 0.0f, 1.0f);
+        float speed = slowSpeed + (openSpeed - slowSpeed) * open;
+        layer[i] = {(int8_t)std::lround(direction.x * 127.0f), (int8_t)std::lround(direction.y * 127.0f),
+                    (uint8_t)std::clamp((int)std::lround(speed * 255.0f), 1, 255)};
+      }
+    }
+  }
+
+  Logger::Info("FlowField: {} ({}x{} cells, {} goals)", layout.texture, cols, rows, goalCount);
+}
+
+bool FlowField::sample(int goal, Vector2 local, Sample &out) const {
+  int x = (int)std::floor(local.x / Config::CarAI::Flow::CELL_SIZE);
+  int y = (int)std::floor(local.y / Config::CarAI::Flow::CELL_SIZE);
+  if (goal < 0 || goal >= goalCount || x < 0 || y < 0 || x >= cols || y >= rows)
+    return false;
+
+  const Cell &cell = cells[(size_t)goal * cols * rows + (size_t)y * cols + x];
+  if (cell.speed == 0)
+    return false;
+
+  out.direction = {cell.dx / 127.0f, cell.dy / 127.0f};
+  out.speedFactor = cell.speed / 255.0f;
+  return true;
+}
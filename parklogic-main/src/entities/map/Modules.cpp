@@ -1,55 +1,246 @@
 #include "entities/map/Modules.hpp"
 #include "config.hpp"
 #include "core/AssetManager.hpp"
+#include "core/FrameArena.hpp"
+#include "core/SpriteBatch.hpp"
+#include "entities/map/FlowField.hpp"
 #include "raylib.h"
 #include "raymath.h"
+#include <array>
 
 // --- Helper Conversion ---
 
-static float P2M(float artPixels) {
+static constexpr float P2M(float artPixels) {
   // ART_PIXELS_PER_METER = 7
   // So if input is art pixels, we just divide by 7.
   return artPixels / static_cast<float>(Config::ART_PIXELS_PER_METER);
 }
 
+// --- Templates ---
+// Every module of a type and orientation shares one of these tables, so the geometry is built
+// once (at compile time) and stays cache-hot however many facilities the map has.
+
+namespace {
+
+constexpr float LEFT = PI;           // Spot orientations (radians)
+constexpr float RIGHT = 0.0f;
+constexpr float UP = 3 * PI / 2;
+constexpr float DOWN = PI / 2;
+
+/// Spots along a vertical wall: one art-pixel x, a list of art-pixel ys.
+template <size_t N> constexpr std::array<SpotLayout, N> spotColumn(float x, const float (&ys)[N], float angle) {
+  std::array<SpotLayout, N> spots{};
+  for (size_t i = 0; i < N; ++i)
+    spots[i] = {{P2M(x), P2M(ys[i])}, angle};
+  return spots;
+}
+
+/// Spots along a horizontal wall: a list of art-pixel xs, one art-pixel y.
+template <size_t N> constexpr std::array<SpotLayout, N> spotRow(const float (&xs)[N], float y, float angle) {
+  std::array<SpotLayout, N> spots{};
+  for (size_t i = 0; i < N; ++i)
+    spots[i] = {{P2M(xs[i]), P2M(y)}, angle};
+  return spots;
+}
+
+template <size_t A, size_t B>
+constexpr std::array<SpotLayout, A + B> join(const std::array<SpotLayout, A> &a, const std::array<SpotLayout, B> &b) {
+  std::array<SpotLayout, A + B> spots{};
+  for (size_t i = 0; i < A; ++i)
+    spots[i] = a[i];
+  for (size_t i = 0; i < B; ++i)
+    spots[A + i] = b[i];
+  return spots;
+}
+
+constexpr LocalWaypoint waypoint(Vector2 localPos) { return {localPos, 1.0f, -1, 0.0f, false}; }
+
+// --- Roads ---
+// normal road : left (0 78) right (283 78) size (283 155)
+// entrance roads : left (0 78) right (283 78) up(142 0) down(142 155) size (284 155)
+// Y in meters = 78 / 7 = 11.14
+
+constexpr float ROAD_Y = P2M(78);
+constexpr float ENTRANCE_X = P2M(142);
+constexpr float ENTRANCE_W = P2M(284);
+constexpr float ROAD_H = P2M(155);
+
+constexpr AttachmentPoint NORMAL_ROAD_ATTACH[] = {{{0, ROAD_Y}, {-1, 0}}, {{P2M(283), ROAD_Y}, {1, 0}}};
+constexpr AttachmentPoint UP_ENTRANCE_ATTACH[] = {
+    {{0, ROAD_Y}, {-1, 0}}, {{ENTRANCE_W, ROAD_Y}, {1, 0}}, {{ENTRANCE_X, 0}, {0, -1}}};
+constexpr AttachmentPoint DOWN_ENTRANCE_ATTACH[] = {
+    {{0, ROAD_Y}, {-1, 0}}, {{ENTRANCE_W, ROAD_Y}, {1, 0}}, {{ENTRANCE_X, ROAD_H}, {0, 1}}};
+constexpr AttachmentPoint DOUBLE_ENTRANCE_ATTACH[] = {{{0, ROAD_Y}, {-1, 0}},
+                                                      {{ENTRANCE_W, ROAD_Y}, {1, 0}},
+                                                      {{ENTRANCE_X, 0}, {0, -1}},
+                                                      {{ENTRANCE_X, ROAD_H}, {0, 1}}};
+
+constexpr LocalWaypoint NORMAL_ROAD_WAYPOINTS[] = {waypoint({P2M(283) / 2.0f, ROAD_Y})};
+constexpr LocalWaypoint ENTRANCE_WAYPOINTS[] = {waypoint({ENTRANCE_X, ROAD_Y})};
+
+constexpr ModuleTemplate NORMAL_ROAD = {
+    ModuleType::GENERIC, false, "road", P2M(283), ROAD_H, NORMAL_ROAD_ATTACH, NORMAL_ROAD_WAYPOINTS, {}, 0, 0, 1};
+constexpr ModuleTemplate UP_ENTRANCE = {
+    ModuleType::GENERIC, false, "entrance_up", ENTRANCE_W, ROAD_H, UP_ENTRANCE_ATTACH, ENTRANCE_WAYPOINTS, {}, 0, 0, 1};
+constexpr ModuleTemplate DOWN_ENTRANCE = {ModuleType::GENERIC, false, "entrance_down", ENTRANCE_W, ROAD_H,
+                                          DOWN_ENTRANCE_ATTACH, ENTRANCE_WAYPOINTS, {}, 0, 0, 1};
+constexpr ModuleTemplate DOUBLE_ENTRANCE = {ModuleType::GENERIC, false, "entrance_double", ENTRANCE_W, ROAD_H,
+                                            DOUBLE_ENTRANCE_ATTACH, ENTRANCE_WAYPOINTS, {}, 0, 0, 1};
+
+// --- Facilities ---
+
+namespace Depth = Config::CarAI::GateDepth;
+
+/*
+small parking up : 218 330 (274*330)
+small parking down : 218 0 (274*330)
+large charging : same layout as small parking
+*/
+constexpr float SMALL_W = P2M(274);
+constexpr float SMALL_H = P2M(330);
+constexpr AttachmentPoint SMALL_UP_ATTACH[] = {{{P2M(218), SMALL_H}, {0, 1}}};
+constexpr AttachmentPoint SMALL_DOWN_ATTACH[] = {{{P2M(218), 0}, {0, -1}}};
+constexpr LocalWaypoint SMALL_WAYPOINTS[] = {waypoint({P2M(218), SMALL_H / 2.0f})};
+
+// UP: 5 spots Left oriented (x=37) and 5 Up oriented (y=38)
+// DOWN: 5 spots Left oriented (x=37) and 5 Down oriented (y=292)
+constexpr auto SMALL_UP_SPOTS =
+    join(spotColumn(37, {236, 199, 163, 127, 91}, LEFT), spotRow({90, 126, 162, 198, 234}, 38, UP));
+constexpr auto SMALL_DOWN_SPOTS =
+    join(spotColumn(37, {94, 131, 167, 203, 239}, LEFT), spotRow({90, 126, 162, 198, 234}, 292, DOWN));
+
+// Base Price: $2.0, Variance $0.5
+constexpr ModuleTemplate SMALL_PARKING_UP = {ModuleType::SMALL_PARKING, true, "parking_small_up", SMALL_W, SMALL_H,
+                                             SMALL_UP_ATTACH, SMALL_WAYPOINTS, SMALL_UP_SPOTS, 2.0f, 0.5f, 1.0f,
+                                             Depth::SMALL_PARKING};
+constexpr ModuleTemplate SMALL_PARKING_DOWN = {ModuleType::SMALL_PARKING, false, "parking_small_down", SMALL_W, SMALL_H,
+                                               SMALL_DOWN_ATTACH, SMALL_WAYPOINTS, SMALL_DOWN_SPOTS, 2.0f, 0.5f, 1.0f,
+                                               Depth::SMALL_PARKING};
+
+// Charging is more expensive (2-5x more than parking). Base Price: $8.0, Variance $2.0, multiplier x1.5
+constexpr ModuleTemplate LARGE_CHARGING_UP = {ModuleType::LARGE_CHARGING, true, "charging_large_up", SMALL_W, SMALL_H,
+                                              SMALL_UP_ATTACH, SMALL_WAYPOINTS, SMALL_UP_SPOTS, 8.0f, 2.0f, 1.5f,
+                                              Depth::LARGE_CHARGING};
+constexpr ModuleTemplate LARGE_CHARGING_DOWN = {ModuleType::LARGE_CHARGING, false, "charging_large_down", SMALL_W,
+                                                SMALL_H, SMALL_DOWN_ATTACH, SMALL_WAYPOINTS, SMALL_DOWN_SPOTS, 8.0f,
+                                                2.0f, 1.5f, Depth::LARGE_CHARGING};
+
+/*
+large parking up : 218 363 (436*363)
+large parking down : 218 0 (436*363)
+*/
+constexpr float LARGE_W = P2M(436);
+constexpr float LARGE_H = P2M(363);
+constexpr AttachmentPoint LARGE_UP_ATTACH[] = {{{P2M(218), LARGE_H}, {0, 1}}};
+constexpr AttachmentPoint LARGE_DOWN_ATTACH[] = {{{P2M(218), 0}, {0, -1}}};
+constexpr LocalWaypoint LARGE_WAYPOINTS[] = {waypoint({P2M(218), LARGE_H / 2.0f})};
+
+// 6 Left (x=38), 6 Right (x=389) at the same ys, 8 Up (y=38) or Down (y=325)
+constexpr auto LARGE_UP_SPOTS = join(join(spotColumn(38, {269, 233, 197, 161, 125, 89}, LEFT),
+                                          spotColumn(389, {269, 233, 197, 161, 125, 89}, RIGHT)),
+                                     spotRow({92, 128, 164, 200, 236, 272, 308, 344}, 38, UP));
+constexpr auto LARGE_DOWN_SPOTS = join(join(spotColumn(38, {94, 130, 166, 202, 238, 274}, LEFT),
+                                            spotColumn(389, {94, 130, 166, 202, 238, 274}, RIGHT)),
+                                       spotRow({92, 128, 164, 200, 236, 272, 308, 344}, 325, DOWN));
+
+// Base Price: $1.0, Variance $0.5
+constexpr ModuleTemplate LARGE_PARKING_UP = {ModuleType::LARGE_PARKING, true, "parking_large_up", LARGE_W, LARGE_H,
+                                             LARGE_UP_ATTACH, LARGE_WAYPOINTS, LARGE_UP_SPOTS, 1.0f, 0.5f, 1.0f,
+                                             Depth::LARGE_PARKING};
+constexpr ModuleTemplate LARGE_PARKING_DOWN = {ModuleType::LARGE_PARKING, false, "parking_large_down", LARGE_W, LARGE_H,
+                                               LARGE_DOWN_ATTACH, LARGE_WAYPOINTS, LARGE_DOWN_SPOTS, 1.0f, 0.5f, 1.0f,
+                                               Depth::LARGE_PARKING};
+
+/*
+small charging up : 163 168 (219*168)
+small charging down : 163 0 (219*168)
+*/
+constexpr float CHARGER_W = P2M(219);
+constexpr float CHARGER_H = P2M(168);
+constexpr AttachmentPoint CHARGER_UP_ATTACH[] = {{{P2M(163), CHARGER_H}, {0, 1}}};
+constexpr AttachmentPoint CHARGER_DOWN_ATTACH[] = {{{P2M(163), 0}, {0, -1}}};
+// Waypoint moved closer to the entrance (bottom when up, top when down)
+constexpr LocalWaypoint CHARGER_UP_WAYPOINTS[] = {waypoint({P2M(163), CHARGER_H * 0.85f})};
+constexpr LocalWaypoint CHARGER_DOWN_WAYPOINTS[] = {waypoint({P2M(163), CHARGER_H * 0.15f})};
+
+// 5 Up (y=38) or Down (y=130)
+constexpr auto CHARGER_UP_SPOTS = spotRow({38, 73, 109, 145, 181}, 38, UP);
+constexpr auto CHARGER_DOWN_SPOTS = spotRow({38, 73, 109, 145, 181}, 130, DOWN);
+
+// Base Price: $10.0, Variance $1.0
+constexpr ModuleTemplate SMALL_CHARGING_UP = {ModuleType::SMALL_CHARGING, true, "charging_small_up", CHARGER_W,
+                                              CHARGER_H, CHARGER_UP_ATTACH, CHARGER_UP_WAYPOINTS, CHARGER_UP_SPOTS,
+                                              10.0f, 1.0f, 1.0f, Depth::SMALL_CHARGING};
+constexpr ModuleTemplate SMALL_CHARGING_DOWN = {ModuleType::SMALL_CHARGING, false, "charging_small_down", CHARGER_W,
+                                                CHARGER_H, CHARGER_DOWN_ATTACH, CHARGER_DOWN_WAYPOINTS,
+                                                CHARGER_DOWN_SPOTS, 10.0f, 1.0f, 1.0f, Depth::SMALL_CHARGING};
+
+} // namespace
+
+Vector2 ModuleTemplate::gatePosition(bool rightLane) const {
+  // Horizontal center from the local waypoint (the entrance axis), else the middle of the module
+  float x = waypoints.empty() ? width / 2.0f : waypoints[0].position.x;
+  x += rightLane ? P2M(Config::ENTRANCE_LANE_OFFSET) : -P2M(Config::ENTRANCE_LANE_OFFSET);
+
+  // Top facilities open at their bottom edge and are driven into upwards (-Y), bottom ones the reverse
+  float y = isTop ? height - gateDepth : gateDepth;
+  return {x, y};
+}
+
 // --- Module Base Class ---
 
-Module::Module(float w, float h) : width(w), height(h) {
+Module::Module(const ModuleTemplate &layout) : layout(&layout) {
   // Base random multiplier for this facility (1.0 to 3.0)
   // This makes some facilities "posh" and others "cheap"
-  priceMultiplier = (float)GetRandomValue(10, 30) / 10.0f;
+  priceMultiplier = (float)GetRandomValue(10, 30) / 10.0f * layout.multiplierBoost;
+
+  size_t count = layout.spots.size();
+  if (count == 0)
+    return; // Roads
+
+  ownStates = std::make_unique<std::atomic<uint8_t>[]>(count); // Value-initialized: all FREE
+  spotStates = ownStates.get();
+  spotPrices = std::make_unique<float[]>(count);
+  assignRandomPricesToSpots(layout.basePrice, layout.priceVariance);
+  flowField = &FlowField::For(layout);
 }
 
 void Module::assignRandomPricesToSpots(float baseSpotPrice, float variance) {
-  for (auto &spot : spots) {
+  for (size_t i = 0; i < getSpotCount(); ++i) {
     // Spot Price = Base * FacilityMultiplier + RandomVariance
     float r = (float)GetRandomValue(-(int)(variance * 10), (int)(variance * 10)) / 10.0f;
-    spot.price = (baseSpotPrice * priceMultiplier) + r;
-    if (spot.price < 0.5f)
-      spot.price = 0.5f; // Min price
+    float price = (baseSpotPrice * priceMultiplier) + r;
+    spotPrices[i] = price < 0.5f ? 0.5f : price; // Min price
   }
 }
 
 void Module::draw() const {
-  // Default draw: outline (in Meters)
-  // DrawRectangleLinesEx({worldPosition.x, worldPosition.y, width, height}, 0.1f, BLACK);
+  Texture2D tex = AssetManager::Get().GetTexture(layout->texture);
+  Rectangle source = {0, 0, (float)tex.width, (float)tex.height};
+  // DrawTexturePro destination uses width/height in world units
+  DrawTexturePro(tex, source, renderRect(), {0, 0}, 0.0f, WHITE);
 
   // Draw Waypoints (Debug)
-  // for (const auto &lwp : localWaypoints) {
-  //   Vector2 globalPos = Vector2Add(worldPosition, lwp.position);
+  // for (const auto &lwp : getLocalWaypoints()) {
+  //   Vector2 globalPos = (worldPosition + lwp.position).toRender();
   //   DrawCircleV(globalPos, 0.2f, Fade(ORANGE, 0.6f));
   // }
 }
 
-void Module::addWaypoint(Vector2 localPos, float tolerance, int id, float angle, bool stop) {
-  localWaypoints.emplace_back(localPos, tolerance, id, angle, stop);
+SpriteQuad Module::spriteQuad() const {
+  const Texture2D *tex = AssetManager::Get().FindTexture(layout->texture);
+  return tex ? SpriteBatch::Quad(*tex, renderRect(), {0, 0}, 0.0f) : SpriteQuad{};
+}
+
+Rectangle Module::renderRect() const {
+  Vector2 topLeft = worldPosition.toRender();
+  return {topLeft.x, topLeft.y, getWidth(), getHeight()};
 }
 
 std::vector<Waypoint> Module::getGlobalWaypoints() const {
   std::vector<Waypoint> globalWps;
-  for (const auto &lwp : localWaypoints) {
-    globalWps.emplace_back(Vector2Add(worldPosition, lwp.position), lwp.tolerance, lwp.id, lwp.entryAngle,
-                           lwp.stopAtEnd);
+  for (const auto &lwp : getLocalWaypoints()) {
+    globalWps.emplace_back(worldPosition + lwp.position, lwp.tolerance, lwp.id, lwp.entryAngle, lwp.stopAtEnd);
   }
   return globalWps;
 }
@@ -70,7 +261,7 @@ std::vector<Waypoint> Module::getPath() const {
 }
 
 const AttachmentPoint *Module::getAttachmentPointByNormal(Vector2 normal) const {
-  for (const auto &ap : attachmentPoints) {
+  for (const auto &ap : getAttachmentPoints()) {
     // Approx comparison
     if (Vector2Distance(ap.normal, normal) < 0.1f) {
       return &ap;
@@ -83,9 +274,11 @@ const AttachmentPoint *Module::getAttachmentPointByNormal(Vector2 normal) const
 // Logic moved to PathPlanner system.
 
 int Module::getRandomSpotIndex() const {
-  std::vector<int> freeIndices;
-  for (int i = 0; i < (int)spots.size(); ++i) {
-    if (spots[i].state == SpotState::FREE) {
+  int count = (int)getSpotCount();
+  std::pmr::vector<int> freeIndices(FrameArena::Get().resource());
+  freeIndices.reserve(count);
+  for (int i = 0; i < count; ++i) {
+    if (stateAt(i) == SpotState::FREE) {
       freeIndices.push_back(i);
     }
   }
@@ -98,352 +291,79 @@ int Module::getRandomSpotIndex() const {
 }
 
 Spot Module::getSpot(int index) const {
-  if (index >= 0 && index < (int)spots.size()) {
-    return spots[index];
+  if (index >= 0 && index < (int)getSpotCount()) {
+    const SpotLayout &spot = layout->spots[index];
+    return {spot.localPosition, spot.orientation, index, stateAt(index), spotPrices[index]};
   }
   return {{0, 0}, 0, -1, SpotState::FREE}; // Safe default
 }
 
+float Module::getSpotPrice(int index) const {
+  if (index >= 0 && index < (int)getSpotCount())
+    return spotPrices[index];
+  return 0.0f;
+}
+
 void Module::setSpotState(int index, SpotState state) {
-  if (index >= 0 && index < (int)spots.size()) {
-    spots[index].state = state;
+  if (index >= 0 && index < (int)getSpotCount()) {
+    spotStates[index].store((uint8_t)state, std::memory_order_release);
+  }
+}
+
+bool Module::tryReserveSpot(int index) {
+  if (index < 0 || index >= (int)getSpotCount())
+    return false;
+
+  uint8_t expected = (uint8_t)SpotState::FREE;
+  return spotStates[index].compare_exchange_strong(expected, (uint8_t)SpotState::RESERVED, std::memory_order_acq_rel);
+}
+
+void Module::bindSpotStates(std::atomic<uint8_t> *states) {
+  for (int i = 0; i < (int)getSpotCount(); ++i) {
+    states[i].store((uint8_t)stateAt(i), std::memory_order_relaxed);
   }
+  spotStates = states;
+  ownStates.reset();
 }
 
 Module::SpotCounts Module::getSpotCounts() const {
   SpotCounts counts = {0, 0, 0};
-  for (const auto &spot : spots) {
-    if (spot.state == SpotState::FREE)
+  for (int i = 0; i < (int)getSpotCount(); ++i) {
+    SpotState state = stateAt(i);
+    if (state == SpotState::FREE)
       counts.free++;
-    else if (spot.state == SpotState::RESERVED)
+    else if (state == SpotState::RESERVED)
       counts.reserved++;
-    else if (spot.state == SpotState::OCCUPIED)
+    else if (state == SpotState::OCCUPIED)
       counts.occupied++;
   }
   return counts;
 }
 
 float Module::getOccupancyPercentage() const {
-  if (spots.empty())
+  int count = (int)getSpotCount();
+  if (count == 0)
     return 0.0f;
 
   int occupiedCount = 0;
-  for (const auto &spot : spots) {
-    if (spot.state == SpotState::OCCUPIED) {
+  for (int i = 0; i < count; ++i) {
+    if (stateAt(i) == SpotState::OCCUPIED) {
       occupiedCount++;
     }
   }
-  return (float)occupiedCount / (float)spots.size();
+  return (float)occupiedCount / (float)count;
 }
 
 // --- Roads ---
-// normal road : left (0 78) right (283 78) size (283 155)
-
-NormalRoad::NormalRoad() : Module(P2M(283), P2M(155)) {
-  // Left: 0, 78 (art pixels)
-  // Right: 283, 78
-  // Y in meters = 78 / 7 = 11.14
-
-  float yCenter = P2M(78);
-
-  // Left (-1, 0)
-  attachmentPoints.push_back({{0, yCenter}, {-1, 0}});
-  // Right (1, 0)
-  attachmentPoints.push_back({{width, yCenter}, {1, 0}});
 
-  // Waypoints: Center
-  addWaypoint({width / 2.0f, yCenter});
-}
-
-void NormalRoad::draw() const {
-  Texture2D tex = AssetManager::Get().GetTexture("road");
-  Rectangle source = {0, 0, (float)tex.width, (float)tex.height};
-  // DrawTexturePro destination uses width/height in world units
-  Rectangle dest = {worldPosition.x, worldPosition.y, width, height};
-  DrawTexturePro(tex, source, dest, {0, 0}, 0.0f, WHITE);
-
-  Module::draw();
-}
-
-// up entrance road : left (0 78) right (283 78) up(142 0) size (284 155)
-UpEntranceRoad::UpEntranceRoad() : Module(P2M(284), P2M(155)) {
-  float yCenter = P2M(78);
-  float xCenter = P2M(142);
-
-  attachmentPoints.push_back({{0, yCenter}, {-1, 0}});    // Left
-  attachmentPoints.push_back({{width, yCenter}, {1, 0}}); // Right
-  attachmentPoints.push_back({{xCenter, 0}, {0, -1}});    // Up
-
-  addWaypoint({xCenter, yCenter});
-}
-
-void UpEntranceRoad::draw() const {
-  Texture2D tex = AssetManager::Get().GetTexture("entrance_up");
-  Rectangle source = {0, 0, (float)tex.width, (float)tex.height};
-  Rectangle dest = {worldPosition.x, worldPosition.y, width, height};
-  DrawTexturePro(tex, source, dest, {0, 0}, 0.0f, WHITE);
-  Module::draw();
-}
-
-// down entrance road : left (0 78) right (283 78) down(142 155) size (284 155)
-DownEntranceRoad::DownEntranceRoad() : Module(P2M(284), P2M(155)) {
-  float yCenter = P2M(78);
-  float xCenter = P2M(142);
-
-  attachmentPoints.push_back({{0, yCenter}, {-1, 0}});     // Left
-  attachmentPoints.push_back({{width, yCenter}, {1, 0}});  // Right
-  attachmentPoints.push_back({{xCenter, height}, {0, 1}}); // Down
-
-  addWaypoint({xCenter, yCenter});
-}
-
-void DownEntranceRoad::draw() const {
-  Texture2D tex = AssetManager::Get().GetTexture("entrance_down");
-  Rectangle source = {0, 0, (float)tex.width, (float)tex.height};
-  Rectangle dest = {worldPosition.x, worldPosition.y, width, height};
-  DrawTexturePro(tex, source, dest, {0, 0}, 0.0f, WHITE);
-  Module::draw();
-}
-
-// double entrance road : left (0 78) right (283 78) up(142 0) down(142 155) size (284 155)
-DoubleEntranceRoad::DoubleEntranceRoad() : Module(P2M(284), P2M(155)) {
-  float yCenter = P2M(78);
-  float xCenter = P2M(142);
-
-  attachmentPoints.push_back({{0, yCenter}, {-1, 0}});     // Left
-  attachmentPoints.push_back({{width, yCenter}, {1, 0}});  // Right
-  attachmentPoints.push_back({{xCenter, 0}, {0, -1}});     // Up
-  attachmentPoints.push_back({{xCenter, height}, {0, 1}}); // Down
-
-  addWaypoint({xCenter, yCenter});
-}
-
-void DoubleEntranceRoad::draw() const {
-  Texture2D tex = AssetManager::Get().GetTexture("entrance_double");
-  Rectangle source = {0, 0, (float)tex.width, (float)tex.height};
-  Rectangle dest = {worldPosition.x, worldPosition.y, width, height};
-  DrawTexturePro(tex, source, dest, {0, 0}, 0.0f, WHITE);
-  Module::draw();
-}
-
-// (Removed getEntryWaypoint implementation)
+NormalRoad::NormalRoad() : Module(NORMAL_ROAD) {}
+UpEntranceRoad::UpEntranceRoad() : Module(UP_ENTRANCE) {}
+DownEntranceRoad::DownEntranceRoad() : Module(DOWN_ENTRANCE) {}
+DoubleEntranceRoad::DoubleEntranceRoad() : Module(DOUBLE_ENTRANCE) {}
 
 // --- Facilities ---
 
-/*
-small parking up : 218 330 (274*330)
-small parking down : 218 0 (274*330)
-*/
-
-SmallParking::SmallParking(bool isTop) : Module(P2M(274), P2M(330)), isTop(isTop) {
-  if (isTop) {
-    attachmentPoints.push_back({{P2M(218), height}, {0, 1}});
-
-    // Small Parking UP
-    // 5 spots Left oriented (x=37)
-    // Ys: 236, 199, 163, 127, 91
-    float xLeft = P2M(37);
-    float ysLeft[] = {236, 199, 163, 127, 91};
-    for (float y : ysLeft)
-      spots.push_back({{xLeft, P2M(y)}, PI, 0}); // Angle PI = LEFT
-
-    // 5 spots Up oriented (y=38)
-    // Xs: 90, 126, 162, 198, 234
-    float yUp = P2M(38);
-    float xsUp[] = {90, 126, 162, 198, 234};
-    for (float x : xsUp)
-      spots.push_back({{P2M(x), yUp}, 3 * PI / 2, 0}); // Angle 3PI/2 = UP
-
-  } else {
-    attachmentPoints.push_back({{P2M(218), 0}, {0, -1}});
-
-    // Small Parking DOWN
-    // 5 spots Left oriented (x=37)
-    // Ys: 94, 131, 167, 203, 239
-    float xLeft = P2M(37);
-    float ysLeft[] = {94, 131, 167, 203, 239};
-    for (float y : ysLeft)
-      spots.push_back({{xLeft, P2M(y)}, PI, 0}); // Angle PI = LEFT
-
-    // 5 spots Down oriented (y=292)
-    // Xs: 90, 126, 162, 198, 234
-    float yDown = P2M(292);
-    float xsDown[] = {90, 126, 162, 198, 234};
-    for (float x : xsDown)
-      spots.push_back({{P2M(x), yDown}, PI / 2, 0}); // Angle PI/2 = DOWN
-  }
-  addWaypoint({P2M(218), height / 2.0f});
-
-  // Base Price: $2.0, Variance $0.5
-  assignRandomPricesToSpots(2.0f, 0.5f);
-}
-
-void SmallParking::draw() const {
-  const char *texName = isTop ? "parking_small_up" : "parking_small_down";
-  Texture2D tex = AssetManager::Get().GetTexture(texName);
-  Rectangle source = {0, 0, (float)tex.width, (float)tex.height};
-  Rectangle dest = {worldPosition.x, worldPosition.y, width, height};
-  DrawTexturePro(tex, source, dest, {0, 0}, 0.0f, WHITE);
-  Module::draw();
-}
-
-/*
-large parking up : 218 363 (436*363)
-large parking down : 218 0 (436*363)
-*/
-LargeParking::LargeParking(bool isTop) : Module(P2M(436), P2M(363)), isTop(isTop) {
-  if (isTop) {
-    attachmentPoints.push_back({{P2M(218), height}, {0, 1}});
-
-    // Large Parking UP
-    // 6 Left (x=38)
-    float xLeft = P2M(38);
-    float ysLeft[] = {269, 233, 197, 161, 125, 89};
-    for (float y : ysLeft)
-      spots.push_back({{xLeft, P2M(y)}, PI, 0});
-
-    // 6 Right (x=389)
-    float xRight = P2M(389);
-    // Same Ys as left
-    for (float y : ysLeft)
-      spots.push_back({{xRight, P2M(y)}, 0.0f, 0}); // Angle 0 = RIGHT
-
-    // 8 Up (y=38)
-    float yUp = P2M(38);
-    float xsUp[] = {92, 128, 164, 200, 236, 272, 308, 344};
-    for (float x : xsUp)
-      spots.push_back({{P2M(x), yUp}, 3 * PI / 2, 0});
-
-  } else {
-    attachmentPoints.push_back({{P2M(218), 0}, {0, -1}});
-
-    // Large Parking DOWN
-    // 6 Left (x=38)
-    float xLeft = P2M(38);
-    float ysLeft[] = {94, 130, 166, 202, 238, 274};
-    for (float y : ysLeft)
-      spots.push_back({{xLeft, P2M(y)}, PI, 0});
-
-    // 6 Right (x=389)
-    float xRight = P2M(389);
-    for (float y : ysLeft)
-      spots.push_back({{xRight, P2M(y)}, 0.0f, 0});
-
-    // 8 Down (y=325)
-    float yDown = P2M(325);
-    float xsDown[] = {92, 128, 164, 200, 236, 272, 308, 344};
-    for (float x : xsDown)
-      spots.push_back({{P2M(x), yDown}, PI / 2, 0});
-  }
-  addWaypoint({P2M(218), height / 2.0f});
-
-  // Base Price: $1.0, Variance $0.5
-  assignRandomPricesToSpots(1.0f, 0.5f);
-}
-
-void LargeParking::draw() const {
-  const char *texName = isTop ? "parking_large_up" : "parking_large_down";
-  Texture2D tex = AssetManager::Get().GetTexture(texName);
-  Rectangle source = {0, 0, (float)tex.width, (float)tex.height};
-  Rectangle dest = {worldPosition.x, worldPosition.y, width, height};
-  DrawTexturePro(tex, source, dest, {0, 0}, 0.0f, WHITE);
-  Module::draw();
-}
-
-/*
-small charging up : 163 168 (219*168)
-small charging down : 163 0 (219*168)
-*/
-SmallChargingStation::SmallChargingStation(bool isTop) : Module(P2M(219), P2M(168)), isTop(isTop) {
-  if (isTop) {
-    attachmentPoints.push_back({{P2M(163), height}, {0, 1}});
-
-    // Small Charging UP
-    // 5 Up (y=38)
-    float yUp = P2M(38);
-    float xsUp[] = {38, 73, 109, 145, 181};
-    for (float x : xsUp)
-      spots.push_back({{P2M(x), yUp}, 3 * PI / 2, 0});
-
-  } else {
-    attachmentPoints.push_back({{P2M(163), 0}, {0, -1}});
-
-    // Small Charging DOWN
-    // 5 Down (y=130)
-    float yDown = P2M(130);
-    float xsDown[] = {38, 73, 109, 145, 181};
-    for (float x : xsDown)
-      spots.push_back({{P2M(x), yDown}, PI / 2, 0});
-  }
-  if (isTop) {
-    // Entrance at Bottom (Height)
-    // Original Center: Height/2
-    // Fix: Move closer to entrance (Height * 0.8)
-    addWaypoint({P2M(163), height * 0.85f});
-  } else {
-    // Entrance at Top (0)
-    // Fix: Move closer to entrance (Height * 0.2)
-    addWaypoint({P2M(163), height * 0.15f});
-  }
-
-  // Charging is more expensive (2-5x more than parking)
-  // Base Price: $10.0, Variance $1.0
-  // priceMultiplier *= 1.5f; // Add extra multiplier boost for being a charging station module?
-  assignRandomPricesToSpots(10.0f, 1.0f);
-}
-
-void SmallChargingStation::draw() const {
-  const char *texName = isTop ? "charging_small_up" : "charging_small_down";
-  Texture2D tex = AssetManager::Get().GetTexture(texName);
-  Rectangle source = {0, 0, (float)tex.width, (float)tex.height};
-  Rectangle dest = {worldPosition.x, worldPosition.y, width, height};
-  DrawTexturePro(tex, source, dest, {0, 0}, 0.0f, WHITE);
-  Module::draw();
-}
-
-/*
-large charging up : 218 330 (274*330)
-large charging down : 218 0 (274*330)
-*/
-LargeChargingStation::LargeChargingStation(bool isTop) : Module(P2M(274), P2M(330)), isTop(isTop) {
-  if (isTop) {
-    attachmentPoints.push_back({{P2M(218), height}, {0, 1}});
-    // Same layout as Small Parking UP
-    float xLeft = P2M(37);
-    float ysLeft[] = {236, 199, 163, 127, 91};
-    for (float y : ysLeft)
-      spots.push_back({{xLeft, P2M(y)}, PI, 0});
-
-    float yUp = P2M(38);
-    float xsUp[] = {90, 126, 162, 198, 234};
-    for (float x : xsUp)
-      spots.push_back({{P2M(x), yUp}, 3 * PI / 2, 0});
-
-  } else {
-    attachmentPoints.push_back({{P2M(218), 0}, {0, -1}});
-    // Same layout as Small Parking DOWN
-    float xLeft = P2M(37);
-    float ysLeft[] = {94, 131, 167, 203, 239};
-    for (float y : ysLeft)
-      spots.push_back({{xLeft, P2M(y)}, PI, 0});
-
-    float yDown = P2M(292);
-    float xsDown[] = {90, 126, 162, 198, 234};
-    for (float x : xsDown)
-      spots.push_back({{P2M(x), yDown}, PI / 2, 0});
-  }
-  addWaypoint({P2M(218), height / 2.0f});
-
-  // Base Price: $8.0, Variance $2.0
-  priceMultiplier *= 1.5f;
-  assignRandomPricesToSpots(8.0f, 2.0f);
-}
-
-void LargeChargingStation::draw() const {
-  const char *texName = isTop ? "charging_large_up" : "charging_large_down";
-  Texture2D tex = AssetManager::Get().GetTexture(texName);
-  Rectangle source = {0, 0, (float)tex.width, (float)tex.height};
-  Rectangle dest = {worldPosition.x, worldPosition.y, width, height};
-  DrawTexturePro(tex, source, dest, {0, 0}, 0.0f, WHITE);
-  Module::draw();
-}
+SmallParking::SmallParking(bool isTop) : Module(isTop ? SMALL_PARKING_UP : SMALL_PARKING_DOWN) {}
+LargeParking::LargeParking(bool isTop) : Module(isTop ? LARGE_PARKING_UP : LARGE_PARKING_DOWN) {}
+SmallChargingStation::SmallChargingStation(bool isTop) : Module(isTop ? SMALL_CHARGING_UP : SMALL_CHARGING_DOWN) {}
+LargeChargingStation::LargeChargingStation(bool isTop) : Module(isTop ? LARGE_CHARGING_UP : LARGE_CHARGING_DOWN) {}
@@ -2,7 +2,10 @@
 #include "config.hpp"
 #include "core/AssetManager.hpp"
 #include "core/Logger.hpp"
+#include "core/WorldCoord.hpp"
+#include "entities/map/WorldChunkStore.hpp"
 #include "raylib.h"
+#include <algorithm>
 #include <cmath>
 
 /**
@@ -12,8 +15,7 @@
  * Handles background rendering (tiling) and global map visualization (grid, overlay).
  */
 
-World::World(float width, float height) : width(width), height(height), showGrid(false) {
-  // Load Textures
+void World::LoadAssets() {
   auto &AM = AssetManager::Get();
   AM.LoadTexture("grass1", "assets/grass1.png");
   AM.LoadTexture("grass2", "assets/grass2.png");
@@ -44,7 +46,9 @@ World::World(float width, float height) : width(width), height(height), showGrid
   AM.LoadTexture("car21", "assets/car21.png");
   AM.LoadTexture("car22", "assets/car22.png");
   AM.LoadTexture("car23", "assets/car23.png");
+}
 
+World::World(float width, float height) : width(width), height(height), showGrid(false) {
   tileTextures = {"grass1", "grass2", "grass3", "grass4"};
 
   // Calculate Tile Size in Meters
@@ -55,35 +59,57 @@ World::World(float width, float height) : width(width), height(height), showGrid
   tileHeightMeter = tileWidthMeter;
 
   // Generate Tile Map
-  int cols = std::ceil(width / tileWidthMeter);
-  int rows = std::ceil(height / tileHeightMeter);
+  tileCols = std::ceil(width / tileWidthMeter);
+  tileRows = std::ceil(height / tileHeightMeter);
 
-  backgroundTiles.resize(rows, std::vector<int>(cols));
+  // Stored column by column so a strip of the map is contiguous, but drawn row by row as
+  // before, so seeded maps keep their look
+  backgroundTiles.resize((size_t)tileCols * tileRows);
 
-  for (int y = 0; y < rows; ++y) {
-    for (int x = 0; x < cols; ++x) {
-      backgroundTiles[y][x] = GetRandomValue(0, tileTextures.size() - 1);
+  for (int y = 0; y < tileRows; ++y) {
+    for (int x = 0; x < tileCols; ++x) {
+      backgroundTiles[(size_t)x * tileRows + y] = (uint8_t)GetRandomValue(0, tileTextures.size() - 1);
     }
   }
 
-  Logger::Info("World initialized with {}x{} background tiles.", cols, rows);
+  Logger::Info("World initialized with {}x{} background tiles.", tileCols, tileRows);
 }
 
 void World::update(double /*dt*/) {
   // World update logic (if any)
 }
 
-void World::draw() {
+const uint8_t *World::tileColumn(int col) const {
+  if (tileStore)
+    return tileStore->tileColumn(col);
+  return &backgroundTiles[(size_t)col * tileRows];
+}
+
+void World::attachTileStore(const WorldChunkStore *store) {
+  tileStore = store;
+  std::vector<uint8_t>().swap(backgroundTiles);
+}
+
+void World::draw() { drawArea(WorldCoord{}, WorldCoord::FromMeters(width, height)); }
+
+void World::drawArea(const WorldCoord &min, const WorldCoord &max) {
   // Draw Background Tiles
   auto &AM = AssetManager::Get();
 
-  for (size_t y = 0; y < backgroundTiles.size(); ++y) {
-    for (size_t x = 0; x < backgroundTiles[y].size(); ++x) {
-      int tileIndex = backgroundTiles[y][x];
+  int x0 = std::max(0, (int)std::floor(min.x() / tileWidthMeter));
+  int x1 = std::min(tileCols, (int)std::ceil(max.x() / tileWidthMeter));
+  int y0 = std::max(0, (int)std::floor(min.y() / tileHeightMeter));
+  int y1 = std::min(tileRows, (int)std::ceil(max.y() / tileHeightMeter));
+
+  for (int x = x0; x < x1; ++x) {
+    const uint8_t *column = tileColumn(x);
+    for (int y = y0; y < y1; ++y) {
+      int tileIndex = column[y];
       Texture2D tex = AM.GetTexture(tileTextures[tileIndex]);
 
       Rectangle source = {0, 0, (float)tex.width, (float)tex.height};
-      Rectangle dest = {x * tileWidthMeter, y * tileHeightMeter, tileWidthMeter, tileHeightMeter};
+      Vector2 topLeft = WorldCoord::FromMeters(x * (double)tileWidthMeter, y * (double)tileHeightMeter).toRender();
+      Rectangle dest = {topLeft.x, topLeft.y, tileWidthMeter, tileHeightMeter};
       Vector2 origin = {0, 0};
 
       DrawTexturePro(tex, source, dest, origin, 0.0f, WHITE);
@@ -92,9 +118,12 @@ void World::draw() {
 }
 
 void World::drawOverlay() {
+  // Everything below is relative to the world's top-left corner in render space
+  Vector2 o = WorldCoord{}.toRender();
+
   // Draw World Boundary (in Meters)
   // User wanted this over everything
-  DrawRectangleLinesEx({0, 0, width, height}, 0.1f, BLACK);
+  DrawRectangleLinesEx({o.x, o.y, width, height}, 0.1f, BLACK);
 
   // Draw Grid
   if (showGrid) {
@@ -102,10 +131,10 @@ void World::drawOverlay() {
     float spacing = 1.0f;
 
     for (float x = 0; x <= width; x += spacing) {
-      DrawLineV({x, 0}, {x, height}, Fade(LIGHTGRAY, 0.3f));
+      DrawLineV({o.x + x, o.y}, {o.x + x, o.y + height}, Fade(LIGHTGRAY, 0.3f));
     }
     for (float y = 0; y <= height; y += spacing) {
-      DrawLineV({0, y}, {width, y}, Fade(LIGHTGRAY, 0.3f));
+      DrawLineV({o.x, o.y + y}, {o.x + width, o.y + y}, Fade(LIGHTGRAY, 0.3f));
     }
   }
 }
@@ -118,16 +147,17 @@ void World::drawMask() {
   // We want to cover a large area.
   // Let's assume a safe large margin, e.g. 10000 meters.
   float hugeMargin = 10000.0f;
+  Vector2 o = WorldCoord{}.toRender();
 
   // Top
-  DrawRectangleRec({-hugeMargin, -hugeMargin, width + 2 * hugeMargin, hugeMargin}, maskColor);
+  DrawRectangleRec({o.x - hugeMargin, o.y - hugeMargin, width + 2 * hugeMargin, hugeMargin}, maskColor);
 
   // Bottom
-  DrawRectangleRec({-hugeMargin, height, width + 2 * hugeMargin, hugeMargin}, maskColor);
+  DrawRectangleRec({o.x - hugeMargin, o.y + height, width + 2 * hugeMargin, hugeMargin}, maskColor);
 
   // Left
-  DrawRectangleRec({-hugeMargin, 0, hugeMargin, height}, maskColor);
+  DrawRectangleRec({o.x - hugeMargin, o.y, hugeMargin, height}, maskColor);
 
   // Right
-  DrawRectangleRec({width, 0, hugeMargin, height}, maskColor);
+  DrawRectangleRec({o.x + width, o.y, hugeMargin, height}, maskColor);
 }
@@ -0,0 +1,166 @@
+#include "entities/map/WorldChunkStore.hpp"
+#include "config.hpp"
+#include "core/Logger.hpp"
+#include "entities/map/World.hpp"
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+
+/**
+ * @file WorldChunkStore.cpp
+ * @brief Backing file layout, paging and eviction of map chunks.
+ *
+ * File layout: one section per chunk, each starting on a page boundary so that evicting a chunk
+ * never drops a neighbour's pages. A section holds the chunk's tile columns, column-major, one
+ * byte per tile.
+ */
+
+namespace {
+
+size_t alignUp(size_t value, size_t alignment) { return (value + alignment - 1) / alignment * alignment; }
+
+int chunkOf(double x, int chunkCount) {
+  return std::clamp((int)std::floor(x / Config::World::CHUNK_SIZE), 0, chunkCount - 1);
+}
+
+} // namespace
+
+WorldChunkStore::WorldChunkStore(World &world, const std::string &path) : path(path) {
+  // Whole tile columns per chunk; with 256 m chunks and 32/7 m tiles the strips line up exactly
+  columnsPerChunk = std::max(1, (int)std::floor(Config::World::CHUNK_SIZE / world.getTileSize()));
+  tileRows = world.getTileRows();
+  int tileCols = world.getTileColumns();
+  int chunkCount = std::max(1, (tileCols + columnsPerChunk - 1) / columnsPerChunk);
+  chunks.resize(chunkCount);
+  residentChunks.reserve(chunkCount);
+
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  if (!out)
+    throw std::runtime_error("WorldChunkStore: cannot create " + path);
+
+  size_t page = MappedFile::PageSize();
+  size_t position = 0;
+  for (int c = 0; c < chunkCount; ++c) {
+    Chunk &chunk = chunks[c];
+    chunk.offset = alignUp(position, page);
+    chunk.firstColumn = c * columnsPerChunk;
+    int lastColumn = std::min(tileCols, chunk.firstColumn + columnsPerChunk);
+    chunk.bytes = (size_t)(lastColumn - chunk.firstColumn) * tileRows;
+
+    out.seekp((std::streamoff)chunk.offset);
+    for (int col = chunk.firstColumn; col < lastColumn; ++col)
+      out.write(reinterpret_cast<const char *>(world.tileColumn(col)), tileRows);
+    position = chunk.offset + chunk.bytes;
+  }
+  out.close();
+  if (!out)
+    throw std::runtime_error("WorldChunkStore: cannot write " + path);
+
+  file = std::make_unique<MappedFile>(path, MappedFile::Access::Random);
+#ifndef _WIN32
+  // The mapping keeps the data alive; unlinking now means a crash cannot leak the file
+  std::filesystem::remove(this->path);
+  this->path.clear();
+#endif
+
+  // Nothing is resident until the first pins
+  world.attachTileStore(this);
+
+  Logger::Info("WorldChunkStore: {} chunks, {} KB paged to {}", chunkCount, file->size() / 1024, path);
+}
+
+WorldChunkStore::~WorldChunkStore() {
+  Logger::Info("WorldChunkStore: {} page-ins, {} evictions over {} chunks", pageIns, evictions, chunks.size());
+  file.reset();
+  if (!path.empty()) {
+    std::error_code ignored;
+    std::filesystem::remove(path, ignored);
+  }
+}
+
+bool WorldChunkStore::IsWorthwhile(const World &world) {
+  return world.getWidth() >= Config::World::PAGED_MIN_CHUNKS * Config::World::CHUNK_SIZE;
+}
+
+std::string WorldChunkStore::DefaultPath() {
+  auto name = std::format("parklogic-world-{:08x}.chunks", std::random_device{}());
+  return (std::filesystem::temp_directory_path() / name).string();
+}
+
+void WorldChunkStore::pin(double fromX, double toX) {
+  int first = chunkOf(std::min(fromX, toX), (int)chunks.size());
+  int last = chunkOf(std::max(fromX, toX), (int)chunks.size());
+  for (int c = first; c <= last; ++c)
+    pinChunk(c);
+}
+
+void WorldChunkStore::pinChunk(int chunk) {
+  chunk = std::clamp(chunk, 0, (int)chunks.size() - 1);
+  Chunk &entry = chunks[chunk];
+  if (entry.lastPinned == tick)
+    return;
+  entry.lastPinned = tick;
+
+  if (!entry.resident) {
+    file->prefetch(entry.offset, entry.bytes);
+    entry.resident = true;
+    residentChunks.push_back(chunk);
+    ++pageIns;
+  }
+}
+
+void WorldChunkStore::evict(int chunk) {
+  Chunk &entry = chunks[chunk];
+  file->release(entry.offset, entry.bytes);
+  entry.resident = false;
+  std::erase(residentChunks, chunk);
+  ++evictions;
+}
+
+void WorldChunkStore::endTick() {
+  int unpinned = 0;
+  for (int c : residentChunks) {
+    if (chunks[c].lastPinned != tick)
+      ++unpinned;
+  }
+
+  // Least recently pinned first; the cache keeps chunks the camera just left
+  while (unpinned > Config::World::CACHED_CHUNKS) {
+    int oldest = -1;
+    for (int c : residentChunks) {
+      if (chunks[c].lastPinned != tick && (oldest == -1 || chunks[c].lastPinned < chunks[oldest].lastPinned))
+        oldest = c;
+    }
+    evict(oldest);
+    --unpinned;
+  }
+
+  // Reads outside the pins (e.g. a full draw before the first view) fault evicted chunks back in
+  if (tick % Config::World::SWEEP_INTERVAL == 0) {
+    int c = 0;
+    while (c < (int)chunks.size()) {
+      if (chunks[c].resident) {
+        ++c;
+        continue;
+      }
+      int end = c;
+      while (end < (int)chunks.size() && !chunks[end].resident)
+        ++end;
+      const Chunk &last = chunks[end - 1];
+      file->release(chunks[c].offset, last.offset + last.bytes - chunks[c].offset);
+      c = end;
+    }
+  }
+
+  ++tick;
+}
+
+const uint8_t *WorldChunkStore::tileColumn(int col) const {
+  const Chunk &chunk = chunks[col / columnsPerChunk];
+  return reinterpret_cast<const uint8_t *>(file->data() + chunk.offset) +
+         (size_t)(col - chunk.firstColumn) * tileRows;
+}
@@ -24,7 +24,13 @@ GeneratedMap WorldGenerator::generate(const MapConfig &config) {
   std::vector<std::unique_ptr<Module>> modules;
   std::vector<PlannedUnit> plan;
   std::random_device rd;
-  std::mt19937 gen(rd());
+  std::mt19937 gen(config.seed != 0 ? config.seed : rd());
+
+  // Module prices and background tiles draw from raylib's generator
+  if (config.seed != 0) {
+    SetRandomSeed(config.seed);
+    Logger::Info("Using map seed {}", config.seed);
+  }
 
   int smallParkingLeft = config.smallParkingCount;
   int largeParkingLeft = config.largeParkingCount;
@@ -105,17 +111,18 @@ GeneratedMap WorldGenerator::generate(const MapConfig &config) {
   }
 
   // 2. PLACEMENT
-  float currentX = 0.0f; // This tracks the current "connection point" X
-  float startY = 50.0f;
-  float safeX_top = -1e6f;
-  float safeX_bottom = -1e6f;
-  float safeX_road = -1e6f;
-
-  auto placeRoadAt = [&](float &x, float y) {
+  // Accumulated in double: a long road of float-width pieces would drift at the far end
+  double currentX = 0.0; // This tracks the current "connection point" X
+  double startY = 50.0;
+  double safeX_top = -1e6;
+  double safeX_bottom = -1e6;
+  double safeX_road = -1e6;
+
+  auto placeRoadAt = [&](double &x, double y) {
     auto road = std::make_unique<NormalRoad>();
     const auto *leftAtt = road->getAttachmentPointByNormal({-1, 0});
     const auto *rightAtt = road->getAttachmentPointByNormal({1, 0});
-    road->worldPosition = {x - leftAtt->position.x, y - leftAtt->position.y};
+    road->worldPosition = WorldCoord::FromMeters(x - leftAtt->position.x, y - leftAtt->position.y);
     x += (rightAtt->position.x - leftAtt->position.x);
     modules.push_back(std::move(road));
   };
@@ -129,18 +136,18 @@ GeneratedMap WorldGenerator::generate(const MapConfig &config) {
     while (collision) {
       collision = false;
       const auto *roadLeft = unit.road->getAttachmentPointByNormal({-1, 0});
-      Vector2 roadWorldPos = {currentX - roadLeft->position.x, startY - roadLeft->position.y};
+      double roadWorldX = currentX - roadLeft->position.x;
 
       auto getFacLeftX = [&](const std::unique_ptr<Module> &fac, Vector2 normal) {
         if (!fac)
-          return 1e9f;
+          return 1e9;
         const auto *rAtt = unit.road->getAttachmentPointByNormal(normal);
         const auto *fAtt = fac->getAttachmentPointByNormal(Vector2Scale(normal, -1.0f));
-        return (roadWorldPos.x + rAtt->position.x) - fAtt->position.x;
+        return (roadWorldX + rAtt->position.x) - fAtt->position.x;
       };
 
       if (getFacLeftX(unit.topFacility, {0, -1}) < safeX_top ||
-          getFacLeftX(unit.bottomFacility, {0, 1}) < safeX_bottom || roadWorldPos.x < safeX_road) {
+          getFacLeftX(unit.bottomFacility, {0, 1}) < safeX_bottom || roadWorldX < safeX_road) {
         placeRoadAt(currentX, startY);
         safeX_road = currentX;
         collision = true;
@@ -148,15 +155,15 @@ GeneratedMap WorldGenerator::generate(const MapConfig &config) {
     }
 
     const auto *rL = unit.road->getAttachmentPointByNormal({-1, 0});
-    unit.road->worldPosition = {currentX - rL->position.x, startY - rL->position.y};
+    unit.road->worldPosition = WorldCoord::FromMeters(currentX - rL->position.x, startY - rL->position.y);
 
-    auto placeFac = [&](std::unique_ptr<Module> &fac, Vector2 normal, float &sideSafeX) {
+    auto placeFac = [&](std::unique_ptr<Module> &fac, Vector2 normal, double &sideSafeX) {
       if (!fac)
         return;
       const auto *rAtt = unit.road->getAttachmentPointByNormal(normal);
       const auto *fAtt = fac->getAttachmentPointByNormal(Vector2Scale(normal, -1.0f));
-      fac->worldPosition = Vector2Subtract(Vector2Add(unit.road->worldPosition, rAtt->position), fAtt->position);
-      sideSafeX = fac->worldPosition.x + fac->getWidth();
+      fac->worldPosition = unit.road->worldPosition + Vector2Subtract(rAtt->position, fAtt->position);
+      sideSafeX = fac->worldPosition.x() + fac->getWidth();
       modules.push_back(std::move(fac));
     };
 
@@ -164,15 +171,15 @@ GeneratedMap WorldGenerator::generate(const MapConfig &config) {
     placeFac(unit.bottomFacility, {0, 1}, safeX_bottom);
 
     const auto *rR = unit.road->getAttachmentPointByNormal({1, 0});
-    currentX = unit.road->worldPosition.x + rR->position.x;
+    currentX = unit.road->worldPosition.x() + rR->position.x;
     safeX_road = currentX;
     modules.push_back(std::move(unit.road));
   }
 
   // 3. TAIL PADDING
-  float facMaxX = currentX;
+  double facMaxX = currentX;
   for (const auto &mod : modules)
-    facMaxX = std::max(facMaxX, mod->worldPosition.x + mod->getWidth());
+    facMaxX = std::max(facMaxX, mod->worldPosition.x() + mod->getWidth());
 
   // Ensure road covers all facilities
   while (currentX < (facMaxX - 0.1f))
@@ -182,56 +189,55 @@ GeneratedMap WorldGenerator::generate(const MapConfig &config) {
   placeRoadAt(currentX, startY);
 
   // 4. WORLD BOUNDS & TILE ALIGNMENT
-  float minX = 1e9f, minY = 1e9f, maxX = -1e9f, maxY = -1e9f;
+  double minX = 1e9, minY = 1e9, maxX = -1e9, maxY = -1e9;
   for (const auto &mod : modules) {
-    minX = std::min(minX, mod->worldPosition.x);
-    minY = std::min(minY, mod->worldPosition.y);
-    maxX = std::max(maxX, mod->worldPosition.x + mod->getWidth());
-    maxY = std::max(maxY, mod->worldPosition.y + mod->getHeight());
+    minX = std::min(minX, mod->worldPosition.x());
+    minY = std::min(minY, mod->worldPosition.y());
+    maxX = std::max(maxX, mod->worldPosition.x() + mod->getWidth());
+    maxY = std::max(maxY, mod->worldPosition.y() + mod->getHeight());
   }
 
-  float tileM = (float)Config::BACKGROUND_TILE_SIZE / (float)Config::ART_PIXELS_PER_METER;
+  double tileM = (double)Config::BACKGROUND_TILE_SIZE / (double)Config::ART_PIXELS_PER_METER;
 
   // The "contentWidth" is what we have now.
   // We want the world to be a multiple of tileM.
-  float currentWorldWidth = maxX - minX;
-  float worldWidth = std::ceil(currentWorldWidth / tileM) * tileM;
+  double currentWorldWidth = maxX - minX;
+  double worldWidth = std::ceil(currentWorldWidth / tileM) * tileM;
 
   // IMPORTANT: If worldWidth > currentWorldWidth, we have a visual gap at the edge.
   // We add more roads until currentX (the road end) reaches or passes the worldWidth.
-  float targetX = minX + worldWidth;
+  double targetX = minX + worldWidth;
   while (currentX < (targetX - 0.1f)) {
     placeRoadAt(currentX, startY);
   }
 
   // Finalize world height
-  float yPad = tileM * 2.0f;
-  float worldHeight = std::ceil(((maxY - minY) + 2 * yPad) / tileM) * tileM;
+  double yPad = tileM * 2.0;
+  double worldHeight = std::ceil(((maxY - minY) + 2 * yPad) / tileM) * tileM;
 
   // 5. NORMALIZE (Shift everything so road start is exactly 0)
   // Find the first road's left attachment world X to make it 0
-  float offsetX = -minX;
-  float offsetY = yPad - minY;
+  double offsetX = -minX;
+  double offsetY = yPad - minY;
   for (auto &mod : modules) {
-    mod->worldPosition.x += offsetX;
-    mod->worldPosition.y += offsetY;
+    mod->worldPosition = WorldCoord::FromMeters(mod->worldPosition.x() + offsetX, mod->worldPosition.y() + offsetY);
   }
 
   // 6. EXTERNAL ROADS (Truly outside)
-  float finalRoadY = startY + offsetY;
+  double finalRoadY = startY + offsetY;
 
   // External Left: Connects to X=0
   auto extL = std::make_unique<NormalRoad>();
   const auto *attL = extL->getAttachmentPointByNormal({1, 0});
-  extL->worldPosition = {-attL->position.x, finalRoadY - attL->position.y};
+  extL->worldPosition = WorldCoord::FromMeters(-attL->position.x, finalRoadY - attL->position.y);
   modules.push_back(std::move(extL));
 
   // External Right: Connects to X=worldWidth
   auto extR = std::make_unique<NormalRoad>();
   const auto *attR = extR->getAttachmentPointByNormal({-1, 0});
-  extR->worldPosition = {worldWidth - attR->position.x, finalRoadY - attR->position.y};
+  extR->worldPosition = WorldCoord::FromMeters(worldWidth - attR->position.x, finalRoadY - attR->position.y);
   modules.push_back(std::move(extR));
 
-  auto world = std::make_unique<World>(worldWidth, worldHeight);
+  auto world = std::make_unique<World>((float)worldWidth, (float)worldHeight);
   return {std::move(world), std::move(modules)};
 }
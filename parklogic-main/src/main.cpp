@@ -1,18 +1,349 @@
+#include "config.hpp"
 #include "core/Application.hpp"
+#include "core/FrameArena.hpp"
+#include "core/LaunchOptions.hpp"
 #include "core/Logger.hpp"
+#include "core/MemoryStats.hpp"
+#include "entities/map/WorldGenerator.hpp"
+#include "events/GameEvents.hpp"
+#include "events/WindowEvents.hpp"
+#include "scenes/GameScene.hpp"
+#include "systems/CapacityPlanner.hpp"
+#include "systems/DiscreteEventSimulator.hpp"
+#include "systems/RenderBenchmark.hpp"
+#include "systems/ShardExchange.hpp"
+#include "systems/ShardPlan.hpp"
+#include "systems/ShardWorker.hpp"
+#include "systems/TraceReader.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
 #include <exception>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+
+#ifndef _WIN32
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief Runs a windowless discrete-event capacity study and prints the report.
+ *
+ * @param options Parsed command line (layout, demand, horizon, seed).
+ * @return 0 on success.
+ */
+static int runDesStudy(const LaunchOptions &options) {
+  Logger::Info("DES: {} h, {} demand at spawn level {}, seed {}", options.hours, options.demand, options.spawnLevel,
+               options.seed);
+
+  GeneratedMap map = WorldGenerator::generate(options.map);
+
+  DesConfig config;
+  config.demand = options.demandProfile();
+  config.tracePath = options.trace;
+  config.horizonSeconds = options.hours * 3600.0;
+  config.seed = options.seed;
+
+  MemoryStats::Report allocationsBefore = MemoryStats::getTotals();
+  auto start = std::chrono::steady_clock::now();
+  DiscreteEventSimulator simulator(map.modules, config);
+  DesReport report = simulator.run();
+  double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  FrameArena::Get().reset();
+
+  Logger::Info("{}", report.format());
+  Logger::Info("DES: finished in {:.2f} s wall time", wallSeconds);
+  if constexpr (MemoryStats::Enabled) {
+    Logger::Info("DES: {}", MemoryStats::FormatReport(MemoryStats::Since(allocationsBefore)));
+  }
+  return 0;
+}
+
+static std::atomic<bool> stopRequested{false};
+
+static void onStopSignal(int) { stopRequested = true; }
+
+/**
+ * @brief Runs the game simulation without a window until --hours of simulated time, a quit
+ * command or SIGINT/SIGTERM.
+ *
+ * Same fixed-timestep pacing as GameLoop (wall clock x speed multiplier), with the frame replaced
+ * by a sleep. Meant to be driven through --control and observed through --telemetry/--record.
+ *
+ * @param options Parsed command line (layout, spawn level, horizon, side channels).
+ * @return 0 on success.
+ */
+static int runHeadless(const LaunchOptions &options) {
+  using Clock = std::chrono::steady_clock;
+
+  auto bus = std::make_shared<EventBus>();
+  double speedMultiplier = 1.0;
+  bool running = true;
+  std::vector<Subscription> tokens;
+  tokens.push_back(bus->subscribe<SimulationSpeedChangedEvent>(
+      [&](const SimulationSpeedChangedEvent &e) { speedMultiplier = e.speedMultiplier; }));
+  double speedFactor = 1.0;
+  tokens.push_back(
+      bus->subscribe<LoadGovernorEvent>([&](const LoadGovernorEvent &e) { speedFactor = e.speedFactor; }));
+  tokens.push_back(bus->subscribe<WindowCloseEvent>([&](const WindowCloseEvent &) { running = false; }));
+
+  uint64_t ticks = 0;
+  tokens.push_back(bus->subscribe<GameUpdateEvent>([&](const GameUpdateEvent &) { ticks++; }));
+
+  std::signal(SIGINT, onStopSignal);
+  std::signal(SIGTERM, onStopSignal);
+
+  GameScene scene(bus, options.map, options);
+  scene.load();
+  Logger::Info("Headless: running {} h at spawn level {}", options.hours, options.spawnLevel);
+
+  const double dt = Config::FIXED_DELTA_TIME;
+  const uint64_t horizonTicks = (uint64_t)(options.hours * 3600.0 / dt);
+  auto currentTime = Clock::now();
+  double accumulator = 0.0;
+
+  while (running && !stopRequested && ticks < horizonTicks) {
+    auto newTime = Clock::now();
+    double frameTime = std::min(std::chrono::duration<double>(newTime - currentTime).count(), 0.25);
+    currentTime = newTime;
+    accumulator += frameTime * speedMultiplier * speedFactor;
+
+    // Paused updates still run, so queued commands (e.g. resume) are applied
+    while (accumulator >= dt && running) {
+      MemoryStats::beginTick();
+      scene.update(dt);
+      FrameArena::Get().reset();
+      MemoryStats::endTick();
+      accumulator -= dt;
+    }
+
+    std::this_thread::sleep_for(std::chrono::duration<double>((dt - accumulator) / (speedMultiplier * speedFactor)));
+  }
+
+  scene.unload();
+  Logger::Info("Headless: stopped after {} ticks ({:.1f} simulated hours)", ticks, ticks * dt / 3600.0);
+  if constexpr (MemoryStats::Enabled) {
+    Logger::Info("Headless: ticks {}", MemoryStats::FormatReport(MemoryStats::getTickTotals()));
+  }
+  return 0;
+}
+
+/**
+ * @brief Runs the headless simulation split across --shards processes and prints a merged report.
+ *
+ * The coordinator generates the map once, places the seams and creates the shared exchange, then
+ * forks one ShardWorker per strip (each inherits the map and the mapping). It only watches: it
+ * prints progress, forwards SIGINT/SIGTERM as a stop request and merges the shard counters at the
+ * end. Shards run unpaced, as fast as the slowest strip allows.
+ *
+ * @param options Parsed command line (layout, spawn level, horizon, shard count).
+ * @return 0 on success, 1 if a shard failed.
+ */
+static int runSharded(const LaunchOptions &options) {
+#ifdef _WIN32
+  throw std::runtime_error("--shards needs fork(), which this platform does not provide");
+#else
+  using Clock = std::chrono::steady_clock;
+
+  if (!options.control.empty() || !options.telemetry.empty() || !options.record.empty())
+    Logger::Warn("Shards: --control, --telemetry and --record are per process and ignored in sharded runs");
+
+  GeneratedMap map = WorldGenerator::generate(options.map);
+  ShardPlan plan = ShardPlan::Compute(map.modules, options.shards);
+  if (plan.shardCount() < options.shards)
+    Logger::Warn("Shards: the map only has room for {} seams, running {} shards", plan.seams.size(),
+                 plan.shardCount());
+
+  size_t spotCount = 0;
+  for (const auto &mod : map.modules) {
+    spotCount += mod->getSpotCount();
+  }
+
+  ShardExchange exchange(plan.shardCount(), spotCount);
+  exchange.bindSpotStates(map.modules);
+
+  std::signal(SIGINT, onStopSignal);
+  std::signal(SIGTERM, onStopSignal);
+
+  const double dt = Config::FIXED_DELTA_TIME;
+  const uint64_t horizonTicks = (uint64_t)(options.hours * 3600.0 / dt);
+  Logger::Info("Shards: running {} h at spawn level {} on {} shards, {} spots", options.hours, options.spawnLevel,
+               plan.shardCount(), spotCount);
+
+  // Every shard logs to the same stdout; whole lines keep their output from interleaving
+  std::cout.flush();
+  std::setvbuf(stdout, nullptr, _IOLBF, BUFSIZ);
+
+  auto start = Clock::now();
+  std::vector<pid_t> workers;
+  for (int shard = 0; shard < plan.shardCount(); ++shard) {
+    pid_t pid = ::fork();
+    if (pid < 0) {
+      Logger::Error("Shards: fork failed for shard {}", shard);
+      exchange.requestStop();
+      break;
+    }
+
+    if (pid == 0) {
+      int code = 0;
+      try {
+        ShardWorker worker(shard, plan, exchange, std::move(map), options);
+        worker.run(horizonTicks, stopRequested);
+      } catch (const std::exception &e) {
+        Logger::Error("Shard {}: {}", shard, e.what());
+        exchange.requestStop();
+        code = 1;
+      }
+      std::cout.flush();
+      std::_Exit(code); // The coordinator owns the segment and removes it
+    }
+    workers.push_back(pid);
+  }
+
+  // Watch until every shard exited
+  int failed = 0;
+  size_t running = workers.size();
+  auto nextReport = Clock::now() + std::chrono::duration<double>(Config::Shard::REPORT_INTERVAL);
+  while (running > 0) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    if (stopRequested)
+      exchange.requestStop();
+
+    for (pid_t &pid : workers) {
+      int status = 0;
+      if (pid <= 0 || ::waitpid(pid, &status, WNOHANG) != pid)
+        continue;
+      pid = 0;
+      running--;
+      if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        failed++;
+        exchange.requestStop(); // Its neighbours would wait forever
+      }
+    }
+
+    if (Clock::now() >= nextReport) {
+      nextReport += std::chrono::duration<double>(Config::Shard::REPORT_INTERVAL);
+      uint64_t slowest = std::numeric_limits<uint64_t>::max();
+      uint32_t cars = 0;
+      for (int shard = 0; shard < plan.shardCount(); ++shard) {
+        slowest = std::min(slowest, exchange.status(shard).completedTick.load(std::memory_order_relaxed));
+        cars += exchange.status(shard).cars.load(std::memory_order_relaxed);
+      }
+      Logger::Info("Shards: {:.2f} simulated h, {} cars", slowest * dt / 3600.0, cars);
+    }
+  }
+  double wallSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+  // Merge: migrations cancel out globally, so exits are spawns minus cars still on the map
+  uint64_t ticks = std::numeric_limits<uint64_t>::max();
+  uint64_t spawned = 0, migrations = 0, ghosts = 0, ghostsDropped = 0;
+  uint32_t cars = 0, parked = 0;
+  double occupiedSpotSeconds = 0.0;
+  for (int shard = 0; shard < plan.shardCount(); ++shard) {
+    const ShardStatus &s = exchange.status(shard);
+    ticks = std::min(ticks, s.completedTick.load());
+    spawned += s.spawned.load();
+    migrations += s.migratedOut.load();
+    ghosts += s.ghostsSent.load();
+    ghostsDropped += s.ghostsDropped.load();
+    cars += s.cars.load();
+    parked += s.parked.load();
+    occupiedSpotSeconds += s.occupiedSpotSeconds.load();
+  }
+  if (ticks == std::numeric_limits<uint64_t>::max())
+    ticks = 0;
+
+  int occupiedNow = 0;
+  for (const auto &mod : map.modules) {
+    occupiedNow += mod->getSpotCounts().occupied; // Bound to the shared states
+  }
+
+  double simSeconds = ticks * dt;
+  Logger::Info("Shards: {} ticks ({:.2f} simulated h) on {} shards in {:.1f} s wall ({:.0f} ticks/s)", ticks,
+               simSeconds / 3600.0, plan.shardCount(), wallSeconds, wallSeconds > 0 ? ticks / wallSeconds : 0.0);
+  Logger::Info("Shards: {} cars spawned, {} exited, {} on the map ({} parked)", spawned, spawned - cars, cars,
+               parked);
+  Logger::Info("Shards: mean occupancy {:.3f}, final occupancy {:.3f}",
+               spotCount > 0 && simSeconds > 0 ? occupiedSpotSeconds / (spotCount * simSeconds) : 0.0,
+               spotCount > 0 ? (double)occupiedNow / spotCount : 0.0);
+  Logger::Info("Shards: {} hand-overs, {} ghost records ({} dropped)", migrations, ghosts, ghostsDropped);
+  for (int shard = 0; shard < plan.shardCount(); ++shard) {
+    const ShardStatus &s = exchange.status(shard);
+    Logger::Info("Shard {}: x in [{}, {}), {} cars, busy {:.1f} s", shard, plan.lower(shard), plan.upper(shard),
+                 s.cars.load(), s.busySeconds.load());
+    if constexpr (MemoryStats::Enabled) {
+      Logger::Info("Shard {}: ticks allocs={} bytes={}", shard, s.tickAllocations.load(), s.tickAllocationBytes.load());
+    }
+  }
+  return failed > 0 ? 1 : 0;
+#endif
+}
+
+/**
+ * @brief Searches the facility mixes for the cheapest ones that serve the demand (see CapacityPlanner).
+ *
+ * @param options Parsed command line (demand, horizon, seed, map seed, pass-through target).
+ * @return 0 if a mix meets --max-pass-through, 1 otherwise.
+ */
+static int runCapacityPlanner(const LaunchOptions &options) {
+  CapacityPlanner planner(options);
+  return planner.run() ? 0 : 1;
+}
+
+/**
+ * @brief Renders a seeded scene along the benchmark's camera script offscreen and logs the frame costs.
+ *
+ * @param options Parsed command line (layout, spawn level, seed or trace).
+ * @return 0 on success.
+ */
+static int runRenderBenchmark(const LaunchOptions &options) {
+  RenderBenchmark benchmark(options);
+  benchmark.run();
+  return 0;
+}
 
 /**
  * @brief Main entry point of the application.
  *
- * Initializes the Application instance and runs the game loop.
+ * Parses the command line, then either runs a batch mode or initializes the Application
+ * instance and runs the game loop.
  * Catches and logs any unhandled exceptions.
  *
  * @return 0 on success, -1 on error.
  */
-int main() {
+int main(int argc, char **argv) {
   try {
-    Application app;
+    LaunchOptions options = LaunchOptions::Parse(argc, argv);
+
+    if (options.mode == LaunchMode::DES) {
+      return runDesStudy(options);
+    }
+
+    if (options.mode == LaunchMode::Plan) {
+      return runCapacityPlanner(options);
+    }
+
+    if (options.mode == LaunchMode::Headless) {
+      return options.shards > 0 ? runSharded(options) : runHeadless(options);
+    }
+
+    if (options.mode == LaunchMode::RenderBench) {
+      return runRenderBenchmark(options);
+    }
+
+    if (options.mode == LaunchMode::ConvertTrace) {
+      TraceReader::ConvertToBinary(options.trace, options.traceOutput);
+      return 0;
+    }
+
+    Application app(options);
     app.run();
   } catch (const std::exception &e) {
     Logger::Error("Fatal Error: {}", e.what());
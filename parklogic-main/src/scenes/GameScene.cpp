@@ -2,13 +2,27 @@
 #include "config.hpp"
 #include "core/EntityManager.hpp"
 #include "core/Logger.hpp"
+#include "core/RenderStats.hpp"
+#include "core/SystemScheduler.hpp"
+#include "entities/AvoidanceKernel.hpp"
+#include "entities/map/World.hpp"
 #include "events/GameEvents.hpp"
 #include "events/InputEvents.hpp"
 #include "raymath.h"
 #include "systems/CameraSystem.hpp"
+#include "systems/ControlServer.hpp"
+#include "systems/ForecastService.hpp"
+#include "systems/LoadGovernor.hpp"
+#include "systems/MapEditor.hpp"
+#include "systems/OccupancyHistory.hpp"
+#include "systems/StuckWatchdog.hpp"
+#include "systems/TelemetryPublisher.hpp"
 #include "systems/TrafficSystem.hpp"
+#include "systems/TrajectoryRecorder.hpp"
 #include "ui/GameHUD.hpp"
+#include <chrono>
 #include <format>
+#include <random>
 
 /**
  * @file GameScene.cpp
@@ -18,22 +32,98 @@
  * and the main game update/draw logic.
  */
 
-GameScene::GameScene(std::shared_ptr<EventBus> bus, MapConfig config) : eventBus(bus), config(config) {}
+GameScene::GameScene(std::shared_ptr<EventBus> bus, MapConfig config, const LaunchOptions &options)
+    : eventBus(bus), config(config), options(options) {}
 
 GameScene::~GameScene() { Logger::Info("GameScene Destroyed"); }
 
 void GameScene::load() {
   Logger::Info("Loading GameScene (Generated World)...");
 
+  // Without a window there is no GPU for textures and nothing to show, so skip camera and HUD
+  bool headless = options.mode == LaunchMode::Headless;
+  // Batch runs repeat with their --seed: the benchmark draws the same cars, headless runs replay the same traffic
+  bool seeded = headless || options.mode == LaunchMode::RenderBench;
+  if (seeded)
+    SetRandomSeed((unsigned int)options.seed);
+
   // Initialize Managers
-  cameraSystem = std::make_unique<CameraSystem>(eventBus);
   entityManager = std::make_unique<EntityManager>(eventBus);
-  trafficSystem = std::make_unique<TrafficSystem>(eventBus, *entityManager);
-  gameHUD = std::make_unique<GameHUD>(eventBus, entityManager.get());
+  Logger::Info("GameScene: {} avoidance kernel", AvoidanceKernel::Name());
+  trafficSystem = std::make_unique<TrafficSystem>(eventBus, *entityManager,
+                                                  seeded ? options.seed : (uint64_t)std::random_device{}());
+  watchdog = std::make_unique<StuckWatchdog>(eventBus, *entityManager);
+  mapEditor = std::make_unique<MapEditor>(eventBus, *entityManager, *trafficSystem);
+  if (!headless) {
+    cameraSystem = std::make_unique<CameraSystem>(eventBus);
+    gameHUD = std::make_unique<GameHUD>(eventBus, entityManager.get());
+  }
 
-  // Generate World via Event
+  // Generate World via Event. Resolve a random seed here so recordings can regenerate the layout.
+  if (config.seed == 0)
+    config.seed = std::random_device{}();
+  if (!headless)
+    World::LoadAssets();
   eventBus->publish(GenerateWorldEvent{config});
 
+  // Look-ahead on its own thread, fed from the live state by a scheduled capture
+  forecast = std::make_unique<ForecastService>(eventBus, *entityManager, *trafficSystem);
+  history = std::make_unique<OccupancyHistory>(eventBus, *entityManager, *trafficSystem);
+  eventBus->publish(OccupancyHistoryEvent{history.get()});
+
+  // Tick order and rates: declared by the systems, not by the order they subscribed in
+  scheduler = std::make_unique<SystemScheduler>();
+  entityManager->setDrawPool(&scheduler->getPool()); // Drawing happens between ticks
+  if (cameraSystem)
+    cameraSystem->schedule(*scheduler);
+  entityManager->schedule(*scheduler);
+  trafficSystem->schedule(*scheduler);
+  watchdog->schedule(*scheduler);
+  forecast->schedule(*scheduler);
+  history->schedule(*scheduler);
+  if (gameHUD)
+    gameHUD->schedule(*scheduler);
+
+  if (options.governor)
+    governor = std::make_unique<LoadGovernor>(eventBus);
+
+  if (!options.record.empty()) {
+    try {
+      recorder = std::make_unique<TrajectoryRecorder>(options.record, config, Config::FIXED_DELTA_TIME);
+    } catch (const std::exception &e) {
+      Logger::Error("GameScene: recording disabled: {}", e.what());
+    }
+  }
+
+  if (!options.telemetry.empty()) {
+    try {
+      telemetry = std::make_unique<TelemetryPublisher>(options.telemetry, *entityManager, Config::FIXED_DELTA_TIME);
+      telemetry->setGovernor(governor.get());
+    } catch (const std::exception &e) {
+      Logger::Error("GameScene: telemetry disabled: {}", e.what());
+    }
+  }
+
+  if (!options.control.empty()) {
+    try {
+      control = std::make_unique<ControlServer>(options.control, eventBus, *entityManager);
+      control->setHistory(history.get());
+    } catch (const std::exception &e) {
+      Logger::Error("GameScene: control socket disabled: {}", e.what());
+    }
+  }
+
+  if (!options.trace.empty())
+    eventBus->publish(LoadDemandTraceEvent{options.trace});
+
+  eventTokens.push_back(eventBus->subscribe<GamePausedEvent>([this](const GamePausedEvent &) { isPaused = true; }));
+  eventTokens.push_back(eventBus->subscribe<GameResumedEvent>([this](const GameResumedEvent &) { isPaused = false; }));
+
+  if (seeded)
+    eventBus->publish(SetAutoSpawnLevelEvent{options.spawnLevel});
+  if (headless)
+    return; // No input
+
   // Setup Camera
   cameraSystem->setZoom(1.0f);
 
@@ -46,6 +136,12 @@ void GameScene::load() {
       Logger::Info("Switching to MainMenu");
       eventBus->publish(SceneChangeEvent{SceneType::MainMenu, {}});
     }
+    if (e.key == KEY_H) {
+      eventBus->publish(CycleCongestionOverlayEvent{});
+    }
+    if (e.key == KEY_J) {
+      entityManager->getCongestionMap().dump(options.heatmap.empty() ? "congestion.heatmap" : options.heatmap);
+    }
     if (e.key == KEY_P) {
       if (isPaused) {
         eventBus->publish(GameResumedEvent{});
@@ -58,9 +154,6 @@ void GameScene::load() {
   eventTokens.push_back(
       eventBus->subscribe<KeyReleasedEvent>([this](const KeyReleasedEvent &e) { keysDown.erase(e.key); }));
 
-  eventTokens.push_back(eventBus->subscribe<GamePausedEvent>([this](const GamePausedEvent &) { isPaused = true; }));
-  eventTokens.push_back(eventBus->subscribe<GameResumedEvent>([this](const GameResumedEvent &) { isPaused = false; }));
-
   // Mouse Click Handling
   eventTokens.push_back(eventBus->subscribe<MouseClickEvent>([this](const MouseClickEvent &e) {
     if (e.down && e.button == MOUSE_BUTTON_LEFT) {
@@ -69,7 +162,7 @@ void GameScene::load() {
       renderCamera.zoom *= Config::PPM;
 
       // e.position is already in Logical Coordinates (thanks to InputSystem)
-      Vector2 worldPos = GetScreenToWorld2D(e.position, renderCamera);
+      WorldCoord worldPos = WorldCoord::FromRender(GetScreenToWorld2D(e.position, renderCamera));
 
       EntitySelectedEvent selectionEvent;
       selectionEvent.type = SelectionType::GENERAL; // Default
@@ -79,11 +172,10 @@ void GameScene::load() {
       // 1. Check Cars
       if (entityManager) {
         for (const auto &car : entityManager->getCars()) {
-          Vector2 pos = car->getPosition();
           // Check distance in World Space (Meters)
           // Car radius ~0.5m - 1.0m?
           // Using 0.8m as clickable radius
-          if (CheckCollisionPointCircle(worldPos, pos, 0.8f)) {
+          if (WorldCoord::Distance(worldPos, car->getPosition()) < 0.8f) {
             selectionEvent.type = SelectionType::CAR;
             selectionEvent.car = car.get();
             found = true;
@@ -94,9 +186,11 @@ void GameScene::load() {
         // 2. Check Facilities
         if (!found) {
           for (const auto &mod : entityManager->getModules()) {
-            Rectangle rec = {mod->worldPosition.x, mod->worldPosition.y, mod->getWidth(), mod->getHeight()};
+            // Tested in the module's own frame
+            Vector2 localPos = worldPos - mod->worldPosition;
+            Rectangle rec = {0, 0, mod->getWidth(), mod->getHeight()};
 
-            if (CheckCollisionPointRec(worldPos, rec)) {
+            if (CheckCollisionPointRec(localPos, rec)) {
               selectionEvent.type = SelectionType::FACILITY;
               selectionEvent.module = mod.get();
               found = true;
@@ -110,10 +204,7 @@ void GameScene::load() {
 
               for (size_t i = 0; i < mod->getSpotCount(); i++) {
                 Spot s = mod->getSpot(i);
-                Vector2 spotWorldPos = {mod->worldPosition.x + s.localPosition.x,
-                                        mod->worldPosition.y + s.localPosition.y};
-
-                float dSq = Vector2DistanceSqr(worldPos, spotWorldPos);
+                float dSq = Vector2DistanceSqr(localPos, s.localPosition);
                 if (dSq < thresholdSq && dSq < minDistSq) {
                   minDistSq = dSq;
                   bestSpotIndex = (int)i;
@@ -140,6 +231,31 @@ void GameScene::load() {
 }
 
 void GameScene::unload() {
+  control.reset(); // Stops its I/O thread before the state it reports goes away
+  if (scheduler) {
+    entityManager->setDrawPool(nullptr);
+    scheduler->report();
+    scheduler.reset(); // Joins its workers before the systems they run go away
+  }
+  if (forecast) {
+    forecast->report();
+    forecast.reset(); // Joins the forecaster
+  }
+  eventBus->publish(OccupancyHistoryEvent{nullptr});
+  history.reset();
+  if (governor) {
+    governor->report();
+    governor.reset();
+    eventBus->publish(LoadGovernorEvent{GovernorStage::Normal, 1.0, 0.0}); // The loop gets its full speed back
+  }
+  recorder.reset(); // Finishes the file
+  telemetry.reset();
+  if (!options.heatmap.empty())
+    entityManager->getCongestionMap().dump(options.heatmap);
+  entityManager->getTripTelemetry().report();
+  watchdog->report();
+  mapEditor->report();
+  mapEditor.reset();
   entityManager->clear();
   eventTokens.clear();
 }
@@ -154,11 +270,29 @@ void GameScene::handleInput() {
 }
 
 void GameScene::update(double dt) {
-  gameHUD->update(dt);
+  if (gameHUD)
+    gameHUD->update(dt);
+
+  // Tick boundary: commands received since the last update take effect now
+  if (control)
+    control->applyPendingCommands();
 
   if (!isPaused) {
-    eventBus->publish(GameUpdateEvent{dt});
+    auto tickStart = std::chrono::steady_clock::now();
+    scheduler->tick(dt);
+    eventBus->publish(GameUpdateEvent{dt}); // Observers (tick counters, control socket)
+    std::chrono::duration<double, std::micro> tickTime = std::chrono::steady_clock::now() - tickStart;
+    if (governor)
+      governor->record(dt, tickTime.count() * 1e-6);
+
+    if (recorder)
+      recorder->capture(entityManager->getCars());
+    if (telemetry)
+      telemetry->publish(dt, tickTime.count());
   }
+
+  if (control)
+    control->publishSnapshot();
 }
 
 void GameScene::draw() {
@@ -172,5 +306,6 @@ void GameScene::draw() {
 
   eventBus->publish(EndCameraEvent{});
 
+  RenderPassScope pass(RenderPass::HUD);
   gameHUD->draw();
 }
@@ -0,0 +1,192 @@
+#include "scenes/PlaybackScene.hpp"
+#include "config.hpp"
+#include "core/Logger.hpp"
+#include "entities/Car.hpp"
+#include "entities/map/WorldGenerator.hpp"
+#include "events/GameEvents.hpp"
+#include "events/InputEvents.hpp"
+#include "systems/CameraSystem.hpp"
+#include "systems/TrajectoryReader.hpp"
+#include <algorithm>
+#include <format>
+
+/**
+ * @file PlaybackScene.cpp
+ * @brief Implementation of the trajectory viewer.
+ */
+
+static constexpr int SPEED_COUNT = (int)std::size(Config::Trajectory::PLAYBACK_SPEEDS);
+
+static std::string FormatClock(double seconds) {
+  int total = (int)seconds;
+  return std::format("{:02}:{:02}:{:02}", total / 3600, (total / 60) % 60, total % 60);
+}
+
+PlaybackScene::PlaybackScene(std::shared_ptr<EventBus> bus, std::string path)
+    : eventBus(bus), path(std::move(path)), speedIndex(Config::Trajectory::DEFAULT_SPEED_INDEX) {}
+
+PlaybackScene::~PlaybackScene() { Logger::Info("PlaybackScene Destroyed"); }
+
+void PlaybackScene::load() {
+  Logger::Info("Loading PlaybackScene ({})...", path);
+
+  try {
+    reader = std::make_unique<TrajectoryReader>(path);
+  } catch (const std::exception &e) {
+    Logger::Error("PlaybackScene: {}", e.what());
+    eventBus->publish(SceneChangeEvent{SceneType::MainMenu, {}});
+    return;
+  }
+
+  // Same seed and counts -> the generator rebuilds the recorded layout
+  World::LoadAssets();
+  GeneratedMap map = WorldGenerator::generate(reader->getMapConfig());
+  world = std::move(map.world);
+  modules = std::move(map.modules);
+
+  cameraSystem = std::make_unique<CameraSystem>(eventBus);
+  cameraSystem->setZoom(1.0f);
+  eventBus->publish(WorldBoundsEvent{world->getWidth(), world->getHeight()});
+
+  reader->seek(0);
+
+  eventTokens.push_back(eventBus->subscribe<KeyPressedEvent>([this](const KeyPressedEvent &e) {
+    switch (e.key) {
+    case KEY_ESCAPE:
+      eventBus->publish(SceneChangeEvent{SceneType::MainMenu, {}});
+      break;
+    case KEY_SPACE:
+      paused = !paused;
+      break;
+    case KEY_LEFT:
+      seekTo(playhead - Config::Trajectory::SEEK_STEP);
+      break;
+    case KEY_RIGHT:
+      seekTo(playhead + Config::Trajectory::SEEK_STEP);
+      break;
+    case KEY_UP:
+      speedIndex = std::min(speedIndex + 1, SPEED_COUNT - 1);
+      break;
+    case KEY_DOWN:
+      speedIndex = std::max(speedIndex - 1, 0);
+      break;
+    case KEY_HOME:
+      seekTo(0.0);
+      break;
+    case KEY_END:
+      seekTo(reader->getDuration());
+      break;
+    default:
+      break;
+    }
+  }));
+
+  eventTokens.push_back(eventBus->subscribe<MouseClickEvent>([this](const MouseClickEvent &e) {
+    if (e.button != MOUSE_BUTTON_LEFT)
+      return;
+    if (!e.down) {
+      scrubbing = false;
+      return;
+    }
+
+    Rectangle bar = timelineRect();
+    bar.y -= 8; // Generous hit area
+    bar.height += 16;
+    if (CheckCollisionPointRec(e.position, bar)) {
+      scrubbing = true;
+      scrubTo(e.position);
+    }
+  }));
+
+  eventTokens.push_back(eventBus->subscribe<MouseMovedEvent>([this](const MouseMovedEvent &e) {
+    if (scrubbing)
+      scrubTo(e.position);
+  }));
+}
+
+void PlaybackScene::unload() {
+  eventTokens.clear();
+  reader.reset();
+}
+
+Rectangle PlaybackScene::timelineRect() const {
+  return {20.0f, (float)Config::LOGICAL_HEIGHT - 70.0f, (float)Config::LOGICAL_WIDTH - 40.0f, 12.0f};
+}
+
+void PlaybackScene::seekTo(double seconds) {
+  if (!reader)
+    return;
+  playhead = std::clamp(seconds, 0.0, reader->getDuration());
+  reader->seek((uint32_t)(playhead / reader->getTickSeconds()));
+}
+
+void PlaybackScene::scrubTo(Vector2 mousePosition) {
+  Rectangle bar = timelineRect();
+  double fraction = std::clamp((mousePosition.x - bar.x) / bar.width, 0.0f, 1.0f);
+  seekTo(fraction * reader->getDuration());
+}
+
+void PlaybackScene::update(double dt) {
+  if (!reader)
+    return;
+
+  cameraSystem->update(dt);
+  if (world)
+    world->update(dt);
+
+  float wheel = GetMouseWheelMove();
+  if (wheel != 0) {
+    eventBus->publish(CameraZoomEvent{wheel * 0.1f});
+  }
+
+  if (!paused && !scrubbing) {
+    seekTo(playhead + dt * Config::Trajectory::PLAYBACK_SPEEDS[speedIndex]);
+    if (playhead >= reader->getDuration())
+      paused = true; // Stop at the end; Home or Left to replay
+  }
+}
+
+void PlaybackScene::draw() {
+  ClearBackground(RAYWHITE);
+  if (!reader)
+    return;
+
+  eventBus->publish(BeginCameraEvent{});
+
+  world->draw();
+  for (const auto &mod : modules) {
+    mod->draw();
+  }
+
+  // Rendering only reads decoded poses
+  for (const auto &pose : reader->getPoses()) {
+    WorldCoord position = WorldCoord::FromMeters((double)pose.x / TrajectoryFormat::POSITION_SCALE,
+                                                 (double)pose.y / TrajectoryFormat::POSITION_SCALE);
+    Car::DrawSprite(reader->getTextureName(pose.texture), position.toRender(),
+                    pose.rotation / TrajectoryFormat::ROTATION_SCALE);
+  }
+
+  world->drawOverlay();
+  world->drawMask();
+
+  eventBus->publish(EndCameraEvent{});
+
+  drawTimeline();
+}
+
+void PlaybackScene::drawTimeline() const {
+  Rectangle bar = timelineRect();
+  double duration = std::max(reader->getDuration(), 1e-9);
+  float fraction = (float)(playhead / duration);
+
+  DrawRectangleRec(bar, Fade(DARKGRAY, 0.6f));
+  DrawRectangleRec({bar.x, bar.y, bar.width * fraction, bar.height}, MAROON);
+  DrawCircleV({bar.x + bar.width * fraction, bar.y + bar.height / 2}, 9.0f, MAROON);
+
+  std::string status = std::format("{} / {}   {}x   {} cars{}", FormatClock(playhead), FormatClock(duration),
+                                   Config::Trajectory::PLAYBACK_SPEEDS[speedIndex], reader->getPoses().size(),
+                                   paused ? "   PAUSED" : "");
+  DrawText(status.c_str(), (int)bar.x, (int)bar.y - 30, 20, DARKGRAY);
+  DrawText("PLAYBACK  Space: Pause | Left/Right: Skip | Up/Down: Speed | Drag bar: Scrub | ESC: Menu", 10,
+           Config::LOGICAL_HEIGHT - 30, 20, DARKGRAY);
+}
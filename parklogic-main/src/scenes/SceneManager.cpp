@@ -1,10 +1,13 @@
 #include "scenes/SceneManager.hpp"
 #include "core/Logger.hpp"
+#include "core/MemoryStats.hpp"
 #include "scenes/GameScene.hpp"
 #include "scenes/MainMenuScene.hpp"
 #include "scenes/MapConfigScene.hpp"
+#include "scenes/PlaybackScene.hpp"
 
-SceneManager::SceneManager(std::shared_ptr<EventBus> bus) : eventBus(bus) {
+SceneManager::SceneManager(std::shared_ptr<EventBus> bus, LaunchOptions options)
+    : eventBus(bus), options(std::move(options)) {
   // Subscribe to SceneChangeEvent to handle scene transitions requested by other components
   sceneChangeToken = eventBus->subscribe<SceneChangeEvent>([this](const SceneChangeEvent &e) {
     changeQueued = true;
@@ -29,6 +32,7 @@ void SceneManager::render() {
 }
 
 void SceneManager::setScene(SceneType type) {
+  MemoryStats::markTickEventful();
   if (currentScene) {
     currentScene->unload();
     Logger::Info("Scene Unloaded");
@@ -41,7 +45,10 @@ void SceneManager::setScene(SceneType type) {
     currentScene = std::make_unique<MapConfigScene>(eventBus);
     break;
   case SceneType::Game:
-    currentScene = std::make_unique<GameScene>(eventBus, nextConfig);
+    currentScene = std::make_unique<GameScene>(eventBus, nextConfig, options);
+    break;
+  case SceneType::Playback:
+    currentScene = std::make_unique<PlaybackScene>(eventBus, options.playback);
     break;
   }
   if (currentScene) {
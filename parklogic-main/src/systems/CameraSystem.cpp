@@ -1,8 +1,10 @@
 #include "systems/CameraSystem.hpp"
 #include "config.hpp"
 #include "core/Logger.hpp"
+#include "core/SystemScheduler.hpp"
 #include "events/GameEvents.hpp"
 #include "events/InputEvents.hpp"
+#include <algorithm>
 
 /**
  * @file CameraSystem.cpp
@@ -25,10 +27,14 @@ CameraSystem::CameraSystem(std::shared_ptr<EventBus> bus) : eventBus(bus) {
 
     camera.zoom *= factor;
 
-    if (camera.zoom < 0.1f)
-      camera.zoom = 0.1f;
-    if (camera.zoom > 5.0f)
-      camera.zoom = 5.0f;
+    camera.zoom = std::clamp(camera.zoom, Config::MIN_ZOOM, Config::MAX_ZOOM);
+  }));
+
+  // Scripted placement (render benchmark); the view follows at once, without waiting for a tick
+  eventTokens.push_back(eventBus->subscribe<SetCameraViewEvent>([this](const SetCameraViewEvent &e) {
+    camera.zoom = std::clamp(e.zoom, Config::MIN_ZOOM, Config::MAX_ZOOM);
+    setTarget(e.target);
+    publishView();
   }));
 
   // Subscribe to Move Event
@@ -36,8 +42,7 @@ CameraSystem::CameraSystem(std::shared_ptr<EventBus> bus) : eventBus(bus) {
     // Correct for speed multiplier if this comes from update loop?
     // Actually CameraMoveEvent comes mainly from external (if any).
     // Standard movement is in update() below.
-    camera.target.x += e.delta.x;
-    camera.target.y += e.delta.y;
+    setTarget(target + e.delta);
   }));
 
   // Track Keys
@@ -53,19 +58,16 @@ CameraSystem::CameraSystem(std::shared_ptr<EventBus> bus) : eventBus(bus) {
       speedMultiplier = 1.0; // Safety
   }));
 
-  // Subscribe to GameUpdateEvent
-  eventTokens.push_back(eventBus->subscribe<GameUpdateEvent>([this](const GameUpdateEvent &e) { this->update(e.dt); }));
-
   // Subscribe to WorldBoundsEvent
   eventTokens.push_back(eventBus->subscribe<WorldBoundsEvent>([this](const WorldBoundsEvent &e) {
     this->setWorldBounds(e.width, e.height);
     // Center camera on world
-    this->setTarget({e.width / 2.0f, e.height / 2.0f});
+    this->setTarget(WorldCoord::FromMeters(e.width / 2.0, e.height / 2.0));
   }));
 
   // Subscribe to Render Events
   eventTokens.push_back(eventBus->subscribe<BeginCameraEvent>([this](const BeginCameraEvent &) {
-    Camera2D renderCamera = camera;
+    Camera2D renderCamera = getCamera();
     renderCamera.zoom *= Config::PPM;
     BeginMode2D(renderCamera);
   }));
@@ -75,6 +77,23 @@ CameraSystem::CameraSystem(std::shared_ptr<EventBus> bus) : eventBus(bus) {
 
 CameraSystem::~CameraSystem() { eventTokens.clear(); }
 
+void CameraSystem::schedule(SystemScheduler &scheduler) {
+  scheduler.add({"camera", SystemScheduler::Stage::Input, 0, SystemScheduler::VIEW, Config::TICK_RATE,
+                 [this](double dt) { update(dt); }});
+}
+
+Camera2D CameraSystem::getCamera() const {
+  Camera2D renderSpace = camera;
+  renderSpace.target = target.toRender();
+  return renderSpace;
+}
+
+void CameraSystem::setTarget(const WorldCoord &newTarget) {
+  target = newTarget;
+  // Draw calls are issued relative to the chunk on screen, so their floats stay small
+  WorldCoord::SetRenderOrigin(target);
+}
+
 void CameraSystem::setWorldBounds(float width, float height) {
   worldWidth = width;
   worldHeight = height;
@@ -98,18 +117,22 @@ void CameraSystem::update(double dt) {
   if (keysDown.contains(KEY_D))
     delta.x += speed * effectiveDt;
 
-  camera.target.x += delta.x;
-  camera.target.y += delta.y;
+  WorldCoord next = target + delta;
 
   // Clamp Camera Target to World Bounds
   if (boundsSet) {
-    if (camera.target.x < 0)
-      camera.target.x = 0;
-    if (camera.target.y < 0)
-      camera.target.y = 0;
-    if (camera.target.x > worldWidth)
-      camera.target.x = worldWidth;
-    if (camera.target.y > worldHeight)
-      camera.target.y = worldHeight;
+    double x = std::clamp(next.x(), 0.0, (double)worldWidth);
+    double y = std::clamp(next.y(), 0.0, (double)worldHeight);
+    if (x != next.x() || y != next.y())
+      next = WorldCoord::FromMeters(x, y);
   }
+  setTarget(next);
+  publishView();
+}
+
+void CameraSystem::publishView() {
+  // Visible area: the offset is half the logical screen, in pixels
+  float scale = camera.zoom * Config::PPM;
+  Vector2 halfExtent = {camera.offset.x / scale, camera.offset.y / scale};
+  eventBus->publish(CameraViewEvent{target + Vector2{-halfExtent.x, -halfExtent.y}, target + halfExtent});
 }
@@ -0,0 +1,178 @@
+#include "systems/CapacityPlanner.hpp"
+#include "config.hpp"
+#include "core/FrameArena.hpp"
+#include "core/Logger.hpp"
+#include "core/SystemScheduler.hpp"
+#include "entities/map/WorldGenerator.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <memory>
+
+/**
+ * @file CapacityPlanner.cpp
+ * @brief Candidate grid, rungs, Pareto ranking and report of the capacity planner.
+ */
+
+namespace P = Config::Planner;
+
+double CapacityPlanner::Candidate::passThrough() const {
+  return report.arrivals > 0 ? (double)report.passedThrough / (double)report.arrivals : 0.0;
+}
+
+CapacityPlanner::CapacityPlanner(const LaunchOptions &launchOptions)
+    : options(launchOptions), pool(SystemScheduler::DefaultWorkers()) {
+  for (int smallParking = 0; smallParking <= P::MAX_PER_TYPE; ++smallParking)
+    for (int largeParking = 0; largeParking <= P::MAX_PER_TYPE; ++largeParking)
+      for (int smallCharging = 0; smallCharging <= P::MAX_PER_TYPE; ++smallCharging)
+        for (int largeCharging = 0; largeCharging <= P::MAX_PER_TYPE; ++largeCharging) {
+          if (smallParking + largeParking + smallCharging + largeCharging == 0)
+            continue;
+          Candidate candidate;
+          candidate.map = {smallParking, largeParking, smallCharging, largeCharging, options.map.seed};
+          candidates.push_back(candidate);
+        }
+}
+
+std::vector<double> CapacityPlanner::rungHours() const {
+  std::vector<double> hours{options.hours};
+  while (hours.front() / P::ETA >= P::MIN_RUNG_HOURS)
+    hours.insert(hours.begin(), hours.front() / P::ETA);
+  return hours;
+}
+
+void CapacityPlanner::evaluate(const std::vector<int> &ids, double hours) {
+  DesConfig config;
+  config.demand = options.demandProfile();
+  config.tracePath = options.trace;
+  config.horizonSeconds = hours * 3600.0;
+  config.seed = options.seed; // The same arrivals for every candidate
+
+  // The generator seeds raylib's global generator, so layouts are built here, one after the other
+  std::vector<std::unique_ptr<DiscreteEventSimulator>> simulators;
+  simulators.reserve(ids.size());
+  Logger::SetMinimumLevel(Logger::Level::Warning); // Four lines per map otherwise
+  for (int id : ids) {
+    GeneratedMap map = WorldGenerator::generate(candidates[id].map);
+    simulators.push_back(std::make_unique<DiscreteEventSimulator>(map.modules, config));
+    FrameArena::Get().reset(); // The paths were only needed to time them
+  }
+  Logger::SetMinimumLevel(Logger::Level::Info);
+
+  auto job = [&](int i) { candidates[ids[i]].report = simulators[i]->run(); };
+  pool.run((int)ids.size(), job);
+  FrameArena::Get().reset(); // Jobs the calling thread ran
+
+  for (int id : ids) {
+    Candidate &candidate = candidates[id];
+    candidate.cost = candidate.report.parkingSpots * P::PARKING_SPOT_COST +
+                     candidate.report.chargingSpots * P::CHARGING_SPOT_COST;
+  }
+}
+
+bool CapacityPlanner::meetsTarget(const Candidate &candidate) const {
+  return candidate.passThrough() * 100.0 <= options.maxPassThrough;
+}
+
+bool CapacityPlanner::Dominates(const Candidate &a, const Candidate &b) {
+  double ap = a.passThrough();
+  double bp = b.passThrough();
+  return a.cost <= b.cost && ap <= bp && (a.cost < b.cost || ap < bp);
+}
+
+std::vector<int> CapacityPlanner::rank(const std::vector<int> &ids, std::vector<int> *firstFront) const {
+  std::vector<int> ranked;
+  std::vector<int> remaining = ids;
+  std::vector<int> front;
+  std::vector<int> dominated;
+  while (!remaining.empty()) {
+    front.clear();
+    dominated.clear();
+    for (int id : remaining) {
+      bool beaten = std::any_of(remaining.begin(), remaining.end(),
+                                [&](int other) { return Dominates(candidates[other], candidates[id]); });
+      (beaten ? dominated : front).push_back(id);
+    }
+
+    // Toward the target: mixes meeting it cheapest first, then the others closest to it first
+    std::sort(front.begin(), front.end(), [&](int a, int b) {
+      const Candidate &ca = candidates[a];
+      const Candidate &cb = candidates[b];
+      bool am = meetsTarget(ca);
+      bool bm = meetsTarget(cb);
+      if (am != bm)
+        return am;
+      if (am)
+        return ca.cost != cb.cost ? ca.cost < cb.cost : a < b;
+      return ca.passThrough() != cb.passThrough() ? ca.passThrough() < cb.passThrough() : a < b;
+    });
+    if (firstFront && ranked.empty())
+      *firstFront = front;
+
+    ranked.insert(ranked.end(), front.begin(), front.end());
+    remaining.swap(dominated);
+  }
+  return ranked;
+}
+
+bool CapacityPlanner::run() {
+  std::vector<double> hours = rungHours();
+  Logger::Info("Planner: {} mixes of up to {} facilities per kind, {} rungs of {:.1f} to {:.1f} h, target {:.1f}% "
+               "pass-through, {} workers",
+               candidates.size(), P::MAX_PER_TYPE, hours.size(), hours.front(), hours.back(), options.maxPassThrough,
+               pool.getWorkerCount());
+
+  std::vector<int> survivors((size_t)candidates.size());
+  for (size_t i = 0; i < survivors.size(); ++i)
+    survivors[i] = (int)i;
+
+  std::vector<int> front;
+  for (size_t rung = 0; rung < hours.size(); ++rung) {
+    auto start = std::chrono::steady_clock::now();
+    evaluate(survivors, hours[rung]);
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<int> ranked = rank(survivors, &front);
+    Logger::Info("Planner: rung {}: {} mixes x {:.1f} h in {:.2f} s wall, {} on the front", rung + 1,
+                 survivors.size(), hours[rung], wallSeconds, front.size());
+
+    if (rung + 1 < hours.size()) {
+      size_t keep = std::max<size_t>(P::FINALISTS, (ranked.size() + P::ETA - 1) / P::ETA);
+      ranked.resize(std::min(keep, ranked.size()));
+      survivors = ranked;
+    }
+  }
+
+  // The front of the final rung, cheapest first
+  std::sort(front.begin(), front.end(), [&](int a, int b) { return candidates[a].cost < candidates[b].cost; });
+  Logger::Info("Planner: Pareto front of cost against pass-through after {:.1f} h:", hours.back());
+  const Candidate *best = nullptr;
+  for (int id : front) {
+    const Candidate &candidate = candidates[id];
+    bool meets = meetsTarget(candidate);
+    Report(candidate, meets);
+    if (meets && !best)
+      best = &candidate;
+  }
+
+  if (!best) {
+    Logger::Warn("Planner: no mix of up to {} facilities per kind keeps pass-through under {:.1f}%", P::MAX_PER_TYPE,
+                 options.maxPassThrough);
+    return false;
+  }
+  Logger::Info("Planner: cheapest mix under {:.1f}% pass-through: --small-parking {} --large-parking {} "
+               "--small-charging {} --large-charging {}",
+               options.maxPassThrough, best->map.smallParkingCount, best->map.largeParkingCount,
+               best->map.smallChargingCount, best->map.largeChargingCount);
+  return true;
+}
+
+void CapacityPlanner::Report(const Candidate &candidate, bool meetsTarget) {
+  const MapConfig &map = candidate.map;
+  const DesReport &report = candidate.report;
+  Logger::Info("Planner:   {}/{}/{}/{} (small/large parking, small/large charging): {} parking + {} charging spots, "
+               "cost {:.0f}, pass-through {:.2f}%, occupancy {:.1f}%{}",
+               map.smallParkingCount, map.largeParkingCount, map.smallChargingCount, map.largeChargingCount,
+               report.parkingSpots, report.chargingSpots, candidate.cost, candidate.passThrough() * 100.0,
+               report.meanOccupancy * 100.0, meetsTarget ? "  <- meets target" : "");
+}
@@ -0,0 +1,528 @@
+#include "systems/ControlServer.hpp"
+#include "core/EntityManager.hpp"
+#include "core/Logger.hpp"
+#include "entities/Car.hpp"
+#include "entities/map/Modules.hpp"
+#include "events/GameEvents.hpp"
+#include "events/WindowEvents.hpp"
+#include "systems/LoadGovernor.hpp"
+#include "systems/MapEditor.hpp"
+#include "systems/OccupancyHistory.hpp"
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <format>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @file ControlServer.cpp
+ * @brief Implementation of the control socket.
+ */
+
+namespace {
+
+std::string_view trim(std::string_view s) {
+  while (!s.empty() && (s.front() == ' ' || s.front() == '\t'))
+    s.remove_prefix(1);
+  while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r'))
+    s.remove_suffix(1);
+  return s;
+}
+
+bool parseNumber(std::string_view s, double &out) {
+  auto [ptr, ec] = std::from_chars(s.data(), s.data() + s.size(), out);
+  return ec == std::errc() && ptr == s.data() + s.size();
+}
+
+/// Splits off the first word of `rest`.
+std::string_view nextWord(std::string_view &rest) {
+  size_t split = rest.find(' ');
+  std::string_view word = rest.substr(0, split);
+  rest = split == std::string_view::npos ? std::string_view{} : trim(rest.substr(split + 1));
+  return word;
+}
+
+/// A facility or entrance number, with or without its prefix ("f3", "3").
+bool parseIndex(std::string_view word, char prefix, int &out) {
+  if (!word.empty() && word.front() == prefix)
+    word.remove_prefix(1);
+  auto [ptr, ec] = std::from_chars(word.data(), word.data() + word.size(), out);
+  return ec == std::errc() && ptr == word.data() + word.size() && !word.empty() && out >= 0;
+}
+
+// Bytes written to the wake pipe
+constexpr char WAKE_STOP = 1;
+constexpr char WAKE_REPLIES = 2;
+
+} // namespace
+
+ControlServer::ControlServer(std::string path, std::shared_ptr<EventBus> bus, const EntityManager &em)
+    : socketPath(std::move(path)), eventBus(bus), entityManager(em) {
+#ifdef _WIN32
+  throw std::runtime_error("ControlServer: Unix domain sockets are not supported on this platform");
+#else
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  if (socketPath.size() >= sizeof(address.sun_path))
+    throw std::runtime_error("ControlServer: socket path too long: " + socketPath);
+  std::copy(socketPath.begin(), socketPath.end(), address.sun_path);
+
+  listenFd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (listenFd < 0)
+    throw std::runtime_error("ControlServer: cannot create socket");
+
+  ::unlink(socketPath.c_str()); // Left behind by a crashed run
+  if (::bind(listenFd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 ||
+      ::listen(listenFd, Config::Control::MAX_CLIENTS) != 0 || ::pipe(wakeFds) != 0) {
+    ::close(listenFd);
+    throw std::runtime_error("ControlServer: cannot listen on " + socketPath);
+  }
+  ::fcntl(listenFd, F_SETFL, O_NONBLOCK);
+  ::fcntl(wakeFds[1], F_SETFL, O_NONBLOCK); // The simulation thread never blocks on it
+
+  // Mirror the state the HUD changes, so queries report it no matter who changed it
+  eventTokens.push_back(eventBus->subscribe<GameUpdateEvent>([this](const GameUpdateEvent &e) {
+    tick++;
+    simSeconds += e.dt;
+  }));
+  eventTokens.push_back(eventBus->subscribe<AutoSpawnLevelChangedEvent>(
+      [this](const AutoSpawnLevelChangedEvent &e) { spawnLevel = e.newLevel; }));
+  eventTokens.push_back(eventBus->subscribe<SimulationSpeedChangedEvent>(
+      [this](const SimulationSpeedChangedEvent &e) { speed = e.speedMultiplier; }));
+  eventTokens.push_back(eventBus->subscribe<LoadGovernorEvent>([this](const LoadGovernorEvent &e) {
+    governor = e.stage;
+    speedFactor = e.speedFactor;
+  }));
+  eventTokens.push_back(eventBus->subscribe<StuckVehiclesEvent>([this](const StuckVehiclesEvent &e) {
+    stuckYields = e.rightOfWays;
+    stuckRemoved = e.removed;
+  }));
+  eventTokens.push_back(eventBus->subscribe<MapEditedEvent>([this](const MapEditedEvent &e) {
+    editReply = e.module ? std::format("OK f{}", e.module->getFacilityId()) : "OK";
+  }));
+  eventTokens.push_back(eventBus->subscribe<MapEditRejectedEvent>(
+      [this](const MapEditRejectedEvent &e) { editReply = "ERR " + e.reason; }));
+  eventTokens.push_back(eventBus->subscribe<GamePausedEvent>([this](const GamePausedEvent &) { paused = true; }));
+  eventTokens.push_back(eventBus->subscribe<GameResumedEvent>([this](const GameResumedEvent &) { paused = false; }));
+
+  publishSnapshot();
+  ioThread = std::thread([this]() { serve(); });
+  Logger::Info("ControlServer: Listening on {}", socketPath);
+#endif
+}
+
+ControlServer::~ControlServer() {
+#ifndef _WIN32
+  if (ioThread.joinable()) {
+    char wake = WAKE_STOP;
+    (void)!::write(wakeFds[1], &wake, 1);
+    ioThread.join();
+  }
+  for (int fd : {listenFd, wakeFds[0], wakeFds[1]}) {
+    if (fd >= 0)
+      ::close(fd);
+  }
+  ::unlink(socketPath.c_str());
+#endif
+}
+
+void ControlServer::queue(Command command) {
+  std::lock_guard<std::mutex> lock(commandMutex);
+  pending.push_back(command);
+}
+
+void ControlServer::applyPendingCommands() {
+  {
+    // Never wait for the I/O thread: if it is mid-push, the commands go out next tick
+    std::unique_lock<std::mutex> lock(commandMutex, std::try_to_lock);
+    if (lock.owns_lock())
+      applying.swap(pending);
+  }
+
+  for (const Command &command : applying) {
+    switch (command.type) {
+    case Command::Type::SpawnLevel:
+      eventBus->publish(SetAutoSpawnLevelEvent{(int)command.value});
+      break;
+    case Command::Type::Speed:
+      eventBus->publish(SimulationSpeedChangedEvent{command.value});
+      break;
+    case Command::Type::Pause:
+      if (!paused)
+        eventBus->publish(GamePausedEvent{});
+      break;
+    case Command::Type::Resume:
+      if (paused)
+        eventBus->publish(GameResumedEvent{});
+      break;
+    case Command::Type::Spawn:
+      for (int i = 0; i < (int)command.value; ++i) {
+        eventBus->publish(SpawnCarRequestEvent{});
+      }
+      break;
+    case Command::Type::Quit:
+      eventBus->publish(WindowCloseEvent{});
+      break;
+    case Command::Type::EditMap:
+      editReply = "ERR the map cannot be edited here"; // Unless a MapEditor answers
+      eventBus->publish(command.edit);
+      finished.emplace_back(command.ticket, std::move(editReply));
+      break;
+    }
+  }
+  applying.clear();
+  handOverReplies();
+}
+
+void ControlServer::handOverReplies() {
+  if (finished.empty())
+    return;
+  {
+    std::unique_lock<std::mutex> lock(replyMutex, std::try_to_lock);
+    if (!lock.owns_lock())
+      return; // The I/O thread is collecting; try again next tick
+    std::move(finished.begin(), finished.end(), std::back_inserter(replies));
+  }
+  finished.clear();
+#ifndef _WIN32
+  char wake = WAKE_REPLIES;
+  (void)!::write(wakeFds[1], &wake, 1); // A full pipe already holds a wake-up
+#endif
+}
+
+void ControlServer::publishSnapshot() {
+  ControlSnapshot s;
+  s.tick = tick;
+  s.simSeconds = simSeconds;
+  s.speed = speed;
+  s.spawnLevel = spawnLevel;
+  s.paused = paused;
+  s.governor = governor;
+  s.speedFactor = speedFactor;
+  s.stuckYields = stuckYields;
+  s.stuckRemoved = stuckRemoved;
+
+  const auto &cars = entityManager.getCars();
+  s.cars = (uint32_t)cars.size();
+  for (const auto &car : cars) {
+    s.carsByState[(size_t)car->getState()]++;
+  }
+
+  // Entrance roads, sorted by address so each facility finds its road by binary search
+  std::array<std::pair<const Module *, int>, Config::Control::SNAPSHOT_ENTRANCES> roads;
+  for (const auto &module : entityManager.getModules()) {
+    if (!MapEditor::IsEntrance(*module) || s.entranceCount == Config::Control::SNAPSHOT_ENTRANCES)
+      continue;
+    roads[s.entranceCount] = {module.get(), s.entranceCount};
+    s.entrances[s.entranceCount++] = {
+        module->getAttachmentPointByNormal({0, -1}) ? ControlSnapshot::FREE_SIDE : ControlSnapshot::NO_SIDE,
+        module->getAttachmentPointByNormal({0, 1}) ? ControlSnapshot::FREE_SIDE : ControlSnapshot::NO_SIDE};
+  }
+  auto roadsEnd = roads.begin() + s.entranceCount;
+  std::sort(roads.begin(), roadsEnd);
+
+  for (const auto &module : entityManager.getModules()) {
+    if (module->getSpotCount() == 0)
+      continue;
+
+    Module::SpotCounts counts = module->getSpotCounts();
+    s.freeSpots += counts.free;
+    s.reservedSpots += counts.reserved;
+    s.occupiedSpots += counts.occupied;
+    if (s.facilityCount < Config::Control::SNAPSHOT_FACILITIES) {
+      s.facilities[s.facilityCount++] = {module->getFacilityId(), (uint8_t)module->getType(), module->isClosed(),
+                                         (uint16_t)counts.occupied, (uint16_t)module->getSpotCount()};
+    }
+
+    auto road = std::lower_bound(roads.begin(), roadsEnd, std::pair<const Module *, int>{module->getParent(), 0});
+    if (road != roadsEnd && road->first == module->getParent()) {
+      ControlSnapshot::Entrance &entrance = s.entrances[road->second];
+      (module->isUp() ? entrance.top : entrance.bottom) = (int16_t)std::min(module->getFacilityId(), (int)INT16_MAX);
+    }
+  }
+
+  snapshot.store(s);
+}
+
+std::string ControlServer::execute(std::string_view line, uint64_t &ticket) {
+  line = trim(line);
+  size_t split = line.find(' ');
+  std::string_view verb = line.substr(0, split);
+  std::string_view argument = split == std::string_view::npos ? std::string_view{} : trim(line.substr(split + 1));
+  double value = 0.0;
+
+  if (verb == "status") {
+    ControlSnapshot s = snapshot.load();
+    int spots = s.freeSpots + s.reservedSpots + s.occupiedSpots;
+    return std::format("OK tick={} time={:.2f} paused={} speed={} spawn_level={} cars={} driving={} parked={} "
+                       "occupancy={:.3f} governor={} speed_factor={} stuck_yields={} stuck_removed={}",
+                       s.tick, s.simSeconds, s.paused ? 1 : 0, s.speed, s.spawnLevel, s.cars, s.carsByState[0],
+                       s.carsByState[2], spots > 0 ? (double)s.occupiedSpots / spots : 0.0,
+                       LoadGovernor::StageName(s.governor), s.speedFactor, s.stuckYields, s.stuckRemoved);
+  }
+  if (verb == "occupancy") {
+    ControlSnapshot s = snapshot.load();
+    int spots = s.freeSpots + s.reservedSpots + s.occupiedSpots;
+    std::string reply = std::format("OK {:.3f} occupied={} reserved={} free={}",
+                                    spots > 0 ? (double)s.occupiedSpots / spots : 0.0, s.occupiedSpots,
+                                    s.reservedSpots, s.freeSpots);
+    for (int i = 0; i < s.facilityCount; ++i) {
+      reply += std::format(" f{}={}/{}", s.facilities[i].id, s.facilities[i].occupied, s.facilities[i].total);
+    }
+    return reply;
+  }
+  if (verb == "history")
+    return queryHistory(argument);
+  if (verb == "map")
+    return describeMap();
+  if (verb == "insert" || verb == "remove" || verb == "convert" || verb == "close" || verb == "reopen")
+    return parseEdit(verb, argument, ticket);
+  if (verb == "spawn-level") {
+    if (!parseNumber(argument, value) || value < 0 || value > 5 || value != (int)value)
+      return "ERR spawn-level takes an integer 0-5";
+    queue({Command::Type::SpawnLevel, value});
+    return "OK";
+  }
+  if (verb == "speed") {
+    if (!parseNumber(argument, value) || value < Config::Control::MIN_SPEED || value > Config::Control::MAX_SPEED)
+      return std::format("ERR speed takes a multiplier {}-{}", Config::Control::MIN_SPEED,
+                         Config::Control::MAX_SPEED);
+    queue({Command::Type::Speed, value});
+    return "OK";
+  }
+  if (verb == "pause" || verb == "resume" || verb == "quit") {
+    queue({verb == "pause" ? Command::Type::Pause : verb == "resume" ? Command::Type::Resume : Command::Type::Quit});
+    return "OK";
+  }
+  if (verb == "spawn") {
+    value = 1.0;
+    if (!argument.empty() && (!parseNumber(argument, value) || value < 1 || value > 1000))
+      return "ERR spawn takes a count 1-1000";
+    queue({Command::Type::Spawn, value});
+    return "OK";
+  }
+  if (verb == "help") {
+    return "OK status | occupancy | history [row] [1s|1m|15m] [occupancy|reserved|price|queue] | map | "
+           "insert <entrance> <top|bottom> <type> | remove <facility> | convert <facility> <type> | close <facility> | "
+           "reopen <facility> | spawn-level <0-5> | speed <x> | pause | resume | spawn [n] | quit";
+  }
+  return std::format("ERR unknown command '{}'", verb);
+}
+
+std::string ControlServer::queryHistory(std::string_view arguments) const {
+  const OccupancyHistory *source = history.load(std::memory_order_acquire);
+  if (!source)
+    return "ERR no history";
+
+  static constexpr const char *levels[] = {"1s", "1m", "15m"};
+  static constexpr const char *channels[] = {"occupancy", "reserved", "price", "queue"};
+  double row = 0.0;
+  int level = (int)OccupancyHistory::Level::Minute;
+  int channel = (int)OccupancyHistory::Channel::Occupancy;
+
+  // Positional: row, level, channel
+  int position = 0;
+  while (!arguments.empty()) {
+    size_t split = arguments.find(' ');
+    std::string_view word = arguments.substr(0, split);
+    arguments = split == std::string_view::npos ? std::string_view{} : trim(arguments.substr(split + 1));
+
+    if (position == 0) {
+      if (!parseNumber(word, row) || row < 0 || row >= source->getRowCount() || row != (int)row)
+        return std::format("ERR history row is 0 (map) to {}", source->getRowCount() - 1);
+    } else if (position == 1) {
+      level = (int)(std::find(std::begin(levels), std::end(levels), word) - std::begin(levels));
+      if (level == OccupancyHistory::LEVELS)
+        return "ERR history level is 1s, 1m or 15m";
+    } else if (position == 2) {
+      channel = (int)(std::find(std::begin(channels), std::end(channels), word) - std::begin(channels));
+      if (channel == OccupancyHistory::CHANNELS)
+        return "ERR history channel is occupancy, reserved, price or queue";
+    } else {
+      return "ERR history takes [row] [level] [channel]";
+    }
+    position++;
+  }
+
+  OccupancyHistory::Bucket buckets[Config::Control::HISTORY_BUCKETS];
+  size_t count = source->read((OccupancyHistory::Level)level, (int)row, (OccupancyHistory::Channel)channel, buckets);
+  float low = 0.0f;
+  float high = 0.0f;
+  std::string means;
+  for (size_t i = 0; i < count; ++i) {
+    low = i == 0 ? buckets[i].min : std::min(low, buckets[i].min);
+    high = i == 0 ? buckets[i].max : std::max(high, buckets[i].max);
+    means += std::format("{}{:.3f}", i == 0 ? "" : ",", buckets[i].mean);
+  }
+  return std::format("OK row={} level={} {} n={} min={:.3f} max={:.3f} means={}", (int)row, levels[level],
+                     channels[channel], count, low, high, count > 0 ? means : "-");
+}
+
+std::string ControlServer::describeMap() const {
+  ControlSnapshot s = snapshot.load();
+  auto side = [](int16_t facility) {
+    return facility >= 0 ? std::format("f{}", facility) : facility == ControlSnapshot::FREE_SIDE ? "-" : "x";
+  };
+
+  std::string reply = std::format("OK entrances={} facilities={}", s.entranceCount, s.facilityCount);
+  for (int i = 0; i < s.entranceCount; ++i) {
+    reply += std::format(" e{}={}/{}", i, side(s.entrances[i].top), side(s.entrances[i].bottom));
+  }
+  for (int i = 0; i < s.facilityCount; ++i) {
+    reply += std::format(" f{}={}{}", s.facilities[i].id, MapEditor::FacilityTypeName((ModuleType)s.facilities[i].type),
+                         s.facilities[i].closed ? ",closed" : "");
+  }
+  return reply;
+}
+
+std::string ControlServer::parseEdit(std::string_view verb, std::string_view arguments, uint64_t &ticket) {
+  EditMapEvent edit{MapEdit::Remove, 0};
+  ModuleType type = ModuleType::SMALL_PARKING;
+  static constexpr const char *typeError = "small-parking, large-parking, small-charging or large-charging";
+
+  if (verb == "insert") {
+    edit.edit = MapEdit::Insert;
+    bool entrance = parseIndex(nextWord(arguments), 'e', edit.target);
+    std::string_view side = nextWord(arguments);
+    if (!entrance || (side != "top" && side != "bottom"))
+      return "ERR insert takes <entrance> <top|bottom> <type>";
+    if (!MapEditor::ParseFacilityType(nextWord(arguments), type))
+      return std::format("ERR facility type is {}", typeError);
+    edit.top = side == "top";
+  } else {
+    edit.edit = verb == "remove"    ? MapEdit::Remove
+                : verb == "convert" ? MapEdit::Convert
+                : verb == "close"   ? MapEdit::Close
+                                    : MapEdit::Reopen;
+    if (!parseIndex(nextWord(arguments), 'f', edit.target))
+      return std::format("ERR {} takes a facility id", verb);
+    if (edit.edit == MapEdit::Convert && !MapEditor::ParseFacilityType(nextWord(arguments), type))
+      return std::format("ERR facility type is {}", typeError);
+  }
+  if (!arguments.empty())
+    return std::format("ERR unexpected '{}'", arguments);
+
+  edit.type = (int)type;
+  ticket = nextTicket++;
+  queue({Command::Type::EditMap, 0.0, edit, ticket});
+  return {}; // Answered once the edit ran
+}
+
+#ifndef _WIN32
+
+namespace {
+bool sendAll(int fd, const std::string &reply) {
+  return ::send(fd, reply.data(), reply.size(), MSG_NOSIGNAL | MSG_DONTWAIT) == (ssize_t)reply.size();
+}
+} // namespace
+
+void ControlServer::serve() {
+  struct Client {
+    int fd;
+    std::string buffer;
+    uint64_t awaiting = 0; ///< Ticket of the edit whose reply is due; later lines wait for it.
+  };
+  std::vector<Client> clients;
+  std::vector<pollfd> fds;
+  std::vector<Reply> ready;
+
+  // Runs the client's complete lines up to the first edit; false once it cannot take a reply
+  auto drain = [this](Client &client) {
+    size_t newline;
+    while (!client.awaiting && (newline = client.buffer.find('\n')) != std::string::npos) {
+      uint64_t ticket = 0;
+      std::string reply = execute(std::string_view(client.buffer).substr(0, newline), ticket) + "\n";
+      client.buffer.erase(0, newline + 1);
+      client.awaiting = ticket;
+      // Replies are a few hundred bytes at most; a client that cannot take them is dropped
+      if (!ticket && !sendAll(client.fd, reply))
+        return false;
+    }
+    return client.buffer.size() <= (size_t)Config::Control::MAX_LINE;
+  };
+  auto drop = [](Client &client) {
+    ::close(client.fd);
+    client.fd = -1;
+  };
+
+  while (true) {
+    fds.clear();
+    fds.push_back({wakeFds[0], POLLIN, 0});
+    fds.push_back({listenFd, POLLIN, 0});
+    for (const Client &client : clients) {
+      fds.push_back({client.fd, POLLIN, 0});
+    }
+
+    if (::poll(fds.data(), fds.size(), -1) < 0)
+      continue; // EINTR
+    if (fds[0].revents) {
+      char wake[64];
+      ssize_t n = ::read(wakeFds[0], wake, sizeof(wake));
+      if (n <= 0 || std::find(wake, wake + n, WAKE_STOP) != wake + n)
+        break; // Shutdown
+    }
+
+    if (fds[1].revents & POLLIN) {
+      int fd = ::accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+      if (fd >= 0 && (int)clients.size() >= Config::Control::MAX_CLIENTS) {
+        const char refused[] = "ERR too many clients\n";
+        (void)!::send(fd, refused, sizeof(refused) - 1, MSG_NOSIGNAL);
+        ::close(fd);
+      } else if (fd >= 0) {
+        clients.push_back({fd, {}});
+      }
+    }
+
+    // Client i is fds[i + 2]; clients accepted above are polled next round
+    for (size_t i = 0; i + 2 < fds.size(); ++i) {
+      if (!fds[i + 2].revents)
+        continue;
+      Client &client = clients[i];
+
+      char data[512];
+      ssize_t n = ::recv(client.fd, data, sizeof(data), 0);
+      if (n > 0)
+        client.buffer.append(data, (size_t)n);
+      if (n <= 0 || !drain(client))
+        drop(client);
+    }
+
+    // Edits the simulation thread has run; replies to clients that left are dropped
+    {
+      std::lock_guard<std::mutex> lock(replyMutex);
+      ready.swap(replies);
+    }
+    for (Reply &reply : ready) {
+      auto client = std::find_if(clients.begin(), clients.end(),
+                                 [&](const Client &c) { return c.fd >= 0 && c.awaiting == reply.first; });
+      if (client == clients.end())
+        continue;
+      reply.second += "\n";
+      client->awaiting = 0;
+      if (!sendAll(client->fd, reply.second) || !drain(*client))
+        drop(*client);
+    }
+    ready.clear();
+    std::erase_if(clients, [](const Client &client) { return client.fd < 0; });
+  }
+
+  for (const Client &client : clients) {
+    ::close(client.fd);
+  }
+}
+
+#else
+
+void ControlServer::serve() {}
+
+#endif
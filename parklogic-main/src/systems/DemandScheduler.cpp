@@ -0,0 +1,242 @@
+#include "systems/DemandScheduler.hpp"
+#include "config.hpp"
+#include "core/Logger.hpp"
+#include "systems/TraceReader.hpp"
+#include <cmath>
+#include <limits>
+
+/**
+ * @file DemandScheduler.cpp
+ * @brief Implementation of the arrival processes and lane queues.
+ */
+
+static constexpr double SECONDS_PER_HOUR = 3600.0;
+
+// --- DemandProfile ---
+
+DemandProfile DemandProfile::FromSpawnLevel(int level) {
+  DemandProfile p;
+  p.name = "Fixed";
+  p.process = ArrivalProcess::FixedInterval;
+  float interval = Config::Spawner::SPAWN_RATES[level];
+  p.hourlyRate.fill(interval > 0.0f ? 1.0f / interval : 0.0f);
+  p.electricShare = Config::Demand::ELECTRIC_SHARE;
+  p.distancePriorityShare = Config::Demand::DISTANCE_PRIORITY_SHARE;
+  return p;
+}
+
+DemandProfile DemandProfile::Commuter(float scale) {
+  DemandProfile p;
+  p.name = "Commuter";
+  p.process = ArrivalProcess::Poisson;
+  for (int h = 0; h < 24; ++h) {
+    p.hourlyRate[h] = Config::Demand::COMMUTER_CURVE[h] * Config::Demand::COMMUTER_PEAK_RATE * scale;
+  }
+  p.electricShare = Config::Demand::ELECTRIC_SHARE;
+  p.distancePriorityShare = Config::Demand::DISTANCE_PRIORITY_SHARE;
+  return p;
+}
+
+DemandProfile DemandProfile::Stress(float scale) {
+  DemandProfile p;
+  p.name = "Stress";
+  p.process = ArrivalProcess::Poisson;
+  p.hourlyRate.fill(Config::Demand::STRESS_RATE * scale);
+  p.electricShare = Config::Demand::ELECTRIC_SHARE;
+  p.distancePriorityShare = Config::Demand::DISTANCE_PRIORITY_SHARE;
+  return p;
+}
+
+// --- DemandScheduler ---
+
+DemandScheduler::DemandScheduler(uint64_t seed) : rng(seed) {}
+
+DemandScheduler::~DemandScheduler() = default;
+
+void DemandScheduler::setProfile(const DemandProfile &p) {
+  profile = p;
+  if (trace)
+    return; // Pre-read trace entries must not be dropped
+
+  // Both processes restart from "now": Poisson is memoryless, and a fixed interval starts a
+  // fresh countdown just like the old spawn timer did.
+  upcoming.clear();
+  lastSampleTime = now;
+}
+
+void DemandScheduler::setTrace(std::unique_ptr<TraceReader> reader) {
+  trace = std::move(reader);
+  traceStarted = false;
+  upcoming.clear();
+  lastSampleTime = now;
+}
+
+double DemandScheduler::getTimeOfDay() const {
+  return std::fmod(Config::Demand::DAY_START_HOUR + now / SECONDS_PER_HOUR, 24.0);
+}
+
+double DemandScheduler::rateAt(double time) const {
+  double hours = std::fmod(Config::Demand::DAY_START_HOUR + time / SECONDS_PER_HOUR, 24.0);
+  return profile.hourlyRate[(int)hours % 24];
+}
+
+Arrival DemandScheduler::sampleNext() {
+  if (trace)
+    return sampleTrace();
+
+  double t = lastSampleTime;
+  double dayOffset = Config::Demand::DAY_START_HOUR * SECONDS_PER_HOUR;
+  bool found = false;
+
+  // Walk hour by hour; the rate is constant within an hour, so an exponential gap that stays
+  // inside the hour is exact, and one that crosses it restarts at the boundary (memorylessness).
+  // Two days without a single non-zero hour means the profile is off.
+  for (int hop = 0; hop < 48 && !found; ++hop) {
+    double hourEnd = (std::floor((dayOffset + t) / SECONDS_PER_HOUR) + 1.0) * SECONDS_PER_HOUR - dayOffset;
+    double rate = rateAt(t);
+
+    if (rate > 0.0) {
+      if (profile.process == ArrivalProcess::FixedInterval) {
+        t += 1.0 / rate;
+        found = true;
+      } else {
+        double gap = std::exponential_distribution<double>(rate)(rng);
+        if (t + gap < hourEnd) {
+          t += gap;
+          found = true;
+        }
+      }
+    }
+    if (!found)
+      t = hourEnd;
+  }
+
+  if (!found)
+    return Arrival{std::numeric_limits<double>::infinity(), true, Car::CarType::COMBUSTION,
+                   Car::Priority::PRIORITY_PRICE};
+
+  lastSampleTime = t;
+  return makeArrival(t);
+}
+
+Arrival DemandScheduler::sampleTrace() {
+  TraceRecord rec;
+  if (!trace->next(rec)) {
+    if (traceStarted) {
+      Logger::Info("DemandScheduler: trace {} finished after {} records", trace->getPath(), trace->getRecordsRead());
+      traceStarted = false;
+    }
+    lastSampleTime = std::numeric_limits<double>::infinity(); // Stop refilling
+    return Arrival{lastSampleTime, true, Car::CarType::COMBUSTION, Car::Priority::PRIORITY_PRICE};
+  }
+
+  if (!traceStarted) {
+    traceOrigin = rec.time - lastSampleTime;
+    traceStarted = true;
+  }
+
+  double t = rec.time - traceOrigin;
+  lastSampleTime = t;
+
+  Arrival a = makeArrival(t);
+  a.type = rec.type;
+  a.dwell = rec.dwell;
+  a.battery = rec.battery;
+  return a;
+}
+
+Arrival DemandScheduler::makeArrival(double time) {
+  std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+  Arrival a;
+  a.time = time;
+  a.fromLeft = uniform(rng) < 0.5f;
+  a.type = uniform(rng) < profile.electricShare ? Car::CarType::ELECTRIC : Car::CarType::COMBUSTION;
+  a.priority =
+      uniform(rng) < profile.distancePriorityShare ? Car::Priority::PRIORITY_DISTANCE : Car::Priority::PRIORITY_PRICE;
+
+  stats.sampled++;
+  return a;
+}
+
+void DemandScheduler::refill(double until) {
+  while (lastSampleTime <= until) {
+    Arrival a = sampleNext();
+    if (std::isinf(a.time))
+      break;
+    upcoming.push(a);
+  }
+}
+
+void DemandScheduler::advance(double dt) {
+  now += dt;
+  refill(now + Config::Spawner::PRESAMPLE_HORIZON);
+
+  while (!upcoming.empty() && upcoming.front().time <= now) {
+    Arrival a = upcoming.pop();
+    ArrivalQueue &lane = lanes[a.fromLeft ? 1 : 0];
+    if ((int)lane.size() >= Config::Spawner::MAX_DEFERRED_PER_LANE) {
+      stats.balked++;
+      continue;
+    }
+    lane.push(a);
+  }
+}
+
+void DemandScheduler::requestArrival() {
+  Arrival a = makeArrival(now);
+  lanes[a.fromLeft ? 1 : 0].push(a);
+}
+
+Arrival DemandScheduler::admit(bool fromLeft) {
+  Arrival a = lanes[fromLeft ? 1 : 0].pop();
+  stats.admitted++;
+  stats.totalDelay += now - a.time;
+  return a;
+}
+
+Arrival DemandScheduler::popNext() {
+  if (!upcoming.empty())
+    return upcoming.pop();
+  return sampleNext();
+}
+
+void DemandScheduler::fork(Fork &out) const {
+  out.profile = profile;
+  out.rng = rng;
+  out.now = now;
+  out.lastSampleTime = lastSampleTime;
+  std::span<const Arrival> pending = upcoming.view();
+  out.upcoming.assign(pending.begin(), pending.end());
+}
+
+void DemandScheduler::restore(const Fork &fork) {
+  profile = fork.profile;
+  rng = fork.rng;
+  now = fork.now;
+  lastSampleTime = fork.lastSampleTime;
+  trace.reset();
+  traceStarted = false;
+  upcoming.clear();
+  for (const Arrival &a : fork.upcoming)
+    upcoming.push(a);
+  for (ArrivalQueue &lane : lanes)
+    lane.clear();
+  stats = Stats{};
+}
+
+// --- ArrivalQueue ---
+
+Arrival DemandScheduler::ArrivalQueue::pop() {
+  Arrival a = items[head++];
+
+  if (head == items.size()) {
+    // Drained: rewind without giving the capacity back
+    items.clear();
+    head = 0;
+  } else if (head >= 256 && head * 2 >= items.size()) {
+    // Mostly consumed: slide the live tail to the front (no reallocation)
+    items.erase(items.begin(), items.begin() + (std::ptrdiff_t)head);
+    head = 0;
+  }
+  return a;
+}
@@ -0,0 +1,445 @@
+#include "systems/DiscreteEventSimulator.hpp"
+#include "config.hpp"
+#include "core/Logger.hpp"
+#include "raymath.h"
+#include "systems/PathPlanner.hpp"
+#include "systems/TraceReader.hpp"
+#include "systems/TrafficPolicy.hpp"
+#include <algorithm>
+#include <cmath>
+#include <format>
+#include <limits>
+
+/**
+ * @file DiscreteEventSimulator.cpp
+ * @brief Implementation of the discrete-event capacity model.
+ */
+
+DiscreteEventSimulator::DiscreteEventSimulator(const std::vector<std::unique_ptr<Module>> &modules,
+                                               const DesConfig &config)
+    : config(config), rng(config.seed), arrivalRng(config.seed ^ 0xD1B54A32D192ED03ull),
+      demand(config.seed ^ 0x9E3779B97F4A7C15ull) {
+  demand.setProfile(config.demand);
+  if (!config.tracePath.empty())
+    demand.setTrace(std::make_unique<TraceReader>(config.tracePath));
+  std::vector<const Module *> layout;
+  layout.reserve(modules.size());
+  for (const auto &mod : modules)
+    layout.push_back(mod.get());
+  buildModel(layout);
+}
+
+void DiscreteEventSimulator::rebuild(std::span<const Module *const> modules) {
+  facilities.clear();
+  hasSpawn[0] = hasSpawn[1] = false;
+  passThroughTime = 0.0f;
+  parkingSpotTotal = 0;
+  chargingSpotTotal = 0;
+  buildModel(modules);
+}
+
+void DiscreteEventSimulator::buildModel(std::span<const Module *const> modules) {
+  // 1. Road extents and spawn points (mirrors TrafficSystem::spawnCar)
+  const Module *leftRoad = nullptr;
+  const Module *rightRoad = nullptr;
+  double minRoadX = std::numeric_limits<double>::max();
+  double maxRoadX = std::numeric_limits<double>::lowest();
+
+  for (const Module *mod : modules) {
+    if (auto *r = dynamic_cast<const NormalRoad *>(mod)) {
+      double x = r->worldPosition.x();
+      double w = r->getWidth();
+      if (x < minRoadX) {
+        minRoadX = x;
+        leftRoad = r;
+      }
+      if (x + w > maxRoadX) {
+        maxRoadX = x + w;
+        rightRoad = r;
+      }
+    }
+  }
+
+  float pixelsPerMeter = static_cast<float>(Config::ART_PIXELS_PER_METER);
+  if (leftRoad) {
+    spawnPoint[1] = leftRoad->worldPosition + Vector2{0.0f, (float)Config::LANE_OFFSET_DOWN / pixelsPerMeter};
+    hasSpawn[1] = true;
+  }
+  if (rightRoad) {
+    spawnPoint[0] =
+        rightRoad->worldPosition + Vector2{rightRoad->getWidth(), (float)Config::LANE_OFFSET_UP / pixelsPerMeter};
+    hasSpawn[0] = true;
+  }
+  if (leftRoad && rightRoad) {
+    passThroughTime = (float)(((maxRoadX + 2.0) - (minRoadX - 2.0)) / Config::CarAI::MAX_SPEED);
+  }
+
+  // 2. Facilities, with every spot's travel times taken from the live PathPlanner paths
+  for (const Module *mod : modules) {
+    ModuleType type = mod->getType();
+    if (!TrafficPolicy::IsParking(type) && !TrafficPolicy::IsCharging(type))
+      continue;
+
+    SimFacility fac{type, mod->worldPosition, {}, {}};
+    fac.closed = mod->isClosed();
+    fac.spots.reserve(mod->getSpotCount());
+
+    for (int i = 0; i < (int)mod->getSpotCount(); ++i) {
+      Spot spot = mod->getSpot(i);
+      WorldCoord spotPos = mod->worldPosition + spot.localPosition;
+
+      SimSpot sim{};
+      sim.price = spot.price;
+
+      for (int fromLeft = 0; fromLeft < 2; ++fromLeft) {
+        if (!hasSpawn[fromLeft])
+          continue;
+        auto path = PathPlanner::GeneratePath(spawnPoint[fromLeft], fromLeft == 1, mod, spot);
+        sim.entryTime[fromLeft] = PathPlanner::EstimateTravelTime(spawnPoint[fromLeft], path);
+      }
+
+      for (int exitRight = 0; exitRight < 2; ++exitRight) {
+        double finalX = exitRight ? (maxRoadX + 2.0) : (minRoadX - 2.0);
+        auto path = PathPlanner::GenerateExitPath(spotPos, mod, spot, exitRight == 1, finalX);
+        sim.exitTime[exitRight] = PathPlanner::EstimateTravelTime(spotPos, path);
+      }
+
+      // No ALIGNING time: the PARKING segment runs from straight behind the spot along its
+      // orientation, so the in-place turn at ALIGN_ROTATION_SPEED is negligible.
+
+      sim.freeSlot = (int)fac.freeSpots.size();
+      fac.freeSpots.push_back(i);
+      fac.spots.push_back(sim);
+    }
+
+    if (TrafficPolicy::IsCharging(type))
+      chargingSpotTotal += (int)fac.spots.size();
+    else
+      parkingSpotTotal += (int)fac.spots.size();
+
+    facilities.push_back(std::move(fac));
+  }
+
+  Logger::Info("DES: model built with {} facilities ({} parking / {} charging spots)", facilities.size(),
+               parkingSpotTotal, chargingSpotTotal);
+}
+
+DesReport DiscreteEventSimulator::run() {
+  double start = now;
+  end = now + config.horizonSeconds;
+  nextSampleTime = now;
+  if (config.facilityCurves)
+    report.facilityCurves.resize(facilities.size());
+
+  if (hasSpawn[0] || hasSpawn[1]) {
+    nextArrival = demand.popNext();
+    if (!std::isinf(nextArrival.time))
+      schedule(nextArrival.time, EventKind::Arrival, -1);
+  }
+
+  while (!queue.empty() && queue.top().time <= end) {
+    Event e = queue.top();
+    queue.pop();
+    advanceClock(e.time);
+    report.eventsProcessed++;
+
+    switch (e.kind) {
+    case EventKind::Arrival:
+      handleArrival();
+      break;
+    case EventKind::ReachSpot:
+      handleReachSpot(e.car);
+      break;
+    case EventKind::LeaveSpot:
+      handleLeaveSpot(e.car);
+      break;
+    case EventKind::LeaveMap:
+      handleLeaveMap(e.car);
+      break;
+    }
+  }
+  advanceClock(end);
+
+  // Aggregate
+  double horizon = std::max(end - start, 1e-9);
+  int totalSpots = parkingSpotTotal + chargingSpotTotal;
+  report.simulatedSeconds = config.horizonSeconds;
+  report.parkingSpots = parkingSpotTotal;
+  report.chargingSpots = chargingSpotTotal;
+  if (parkingSpotTotal > 0)
+    report.meanParkingOccupancy = occupiedParkingSeconds / (horizon * parkingSpotTotal);
+  if (chargingSpotTotal > 0)
+    report.meanChargingOccupancy = occupiedChargingSeconds / (horizon * chargingSpotTotal);
+  if (totalSpots > 0)
+    report.meanOccupancy = (occupiedParkingSeconds + occupiedChargingSeconds) / (horizon * totalSpots);
+  if (dwellCount > 0)
+    report.meanDwellSeconds = dwellSecondsTotal / (double)dwellCount;
+
+  return report;
+}
+
+void DiscreteEventSimulator::restart(const DesStart &start, uint64_t replication) {
+  queue = {};
+  nextSequence = 0;
+  cars.clear();
+  freeCars.clear();
+  occupiedParking = 0;
+  occupiedCharging = 0;
+  report = DesReport{};
+  occupiedParkingSeconds = 0.0;
+  occupiedChargingSeconds = 0.0;
+  dwellSecondsTotal = 0.0;
+  dwellCount = 0;
+
+  for (SimFacility &fac : facilities) {
+    fac.freeSpots.clear();
+    fac.occupied = 0;
+    for (int i = 0; i < (int)fac.spots.size(); ++i) {
+      fac.spots[i].state = SpotState::FREE;
+      fac.spots[i].freeSlot = i;
+      fac.freeSpots.push_back(i);
+    }
+  }
+
+  demand.restore(start.demand);
+  rng.seed(config.seed + replication);
+  arrivalRng.seed((config.seed + replication) ^ 0xD1B54A32D192ED03ull);
+  if (replication > 0)
+    demand.reseed((config.seed + replication) ^ 0x9E3779B97F4A7C15ull);
+  now = start.demand.now;
+
+  for (const DesStart::Hold &hold : start.holds) {
+    if (hold.facility < 0 || hold.facility >= (int)facilities.size())
+      continue;
+    SimFacility &fac = facilities[hold.facility];
+    if (hold.spot < 0 || hold.spot >= (int)fac.spots.size() || fac.spots[hold.spot].freeSlot == -1)
+      continue;
+
+    int id = allocateCar();
+    SimCar &car = cars[id];
+    car.type = hold.type;
+    car.priority = hold.priority;
+    car.enteredFromLeft = hold.enteredFromLeft;
+    car.battery = hold.battery;
+    car.facility = hold.facility;
+    car.spot = hold.spot;
+    takeSpot(fac, hold.spot, SpotState::RESERVED);
+
+    if (!hold.parked) {
+      float entry = fac.spots[hold.spot].entryTime[car.enteredFromLeft ? 1 : 0];
+      schedule(now + std::max(0.0f, entry - hold.seconds), EventKind::ReachSpot, id);
+      continue;
+    }
+
+    occupy(id);
+    double stay = hold.seconds;
+    if (stay < 0.0) {
+      // Charging: the hazard is memoryless in the battery level, so sample from where it is now
+      float exponential = std::exponential_distribution<float>(1.0f)(rng);
+      float leaveAt = TrafficPolicy::SampleChargingExitLevel(car.battery, exponential);
+      stay = std::max(0.0f, leaveAt - car.battery) / Config::CHARGING_RATE;
+    }
+    schedule(now + stay, EventKind::LeaveSpot, id);
+  }
+}
+
+void DiscreteEventSimulator::schedule(double time, EventKind kind, int car) {
+  queue.push(Event{time, nextSequence++, kind, car});
+}
+
+void DiscreteEventSimulator::advanceClock(double time) {
+  // State is piecewise constant between events: integrate it and emit any curve samples we pass
+  int totalSpots = parkingSpotTotal + chargingSpotTotal;
+  float occupancy = totalSpots > 0 ? (float)(occupiedParking + occupiedCharging) / (float)totalSpots : 0.0f;
+
+  while (nextSampleTime <= time && nextSampleTime <= end) {
+    report.occupancyCurve.push_back(occupancy);
+    if (config.facilityCurves) {
+      for (size_t i = 0; i < facilities.size(); ++i) {
+        const SimFacility &fac = facilities[i];
+        report.facilityCurves[i].push_back(fac.spots.empty() ? 0.0f : (float)fac.occupied / (float)fac.spots.size());
+      }
+    }
+    nextSampleTime += config.sampleInterval;
+  }
+
+  double dt = time - now;
+  occupiedParkingSeconds += occupiedParking * dt;
+  occupiedChargingSeconds += occupiedCharging * dt;
+  now = time;
+}
+
+void DiscreteEventSimulator::handleArrival() {
+  Arrival arrival = nextArrival;
+
+  // Chain the next arrival (an "Off" profile yields infinity and ends the stream)
+  nextArrival = demand.popNext();
+  if (!std::isinf(nextArrival.time))
+    schedule(nextArrival.time, EventKind::Arrival, -1);
+
+  report.arrivals++;
+
+  int id = allocateCar();
+  SimCar &car = cars[id];
+  car.enteredFromLeft = arrival.fromLeft;
+  if (!hasSpawn[car.enteredFromLeft ? 1 : 0])
+    car.enteredFromLeft = !car.enteredFromLeft;
+  car.type = arrival.type;
+  car.priority = arrival.priority;
+  car.dwell = arrival.dwell;
+
+  // Both draws are made for every arrival, so the stream stays in step whatever the layout
+  float battery = (float)std::uniform_int_distribution<int>(10, 90)(arrivalRng);
+  float chargingDraw = std::uniform_real_distribution<float>(0.0f, 1.0f)(arrivalRng);
+  car.battery = car.type == Car::CarType::ELECTRIC ? (arrival.battery >= 0.0f ? arrival.battery : battery) : 0.0f;
+
+  // Facility choice (same rules as TrafficSystem's CarSpawnedEvent handler)
+  bool seekCharging = TrafficPolicy::ShouldSeekCharging(car.type, car.battery, chargingDraw);
+
+  bool anyAccepting = false;
+  for (const auto &fac : facilities) {
+    if (!fac.closed && TrafficPolicy::Accepts(fac.type, car.type, seekCharging)) {
+      anyAccepting = true;
+      break;
+    }
+  }
+  if (!anyAccepting)
+    seekCharging = false; // No chargers on the map: park instead
+
+  // One random free spot per accepting facility competes
+  const WorldCoord &spawnPos = spawnPoint[car.enteredFromLeft ? 1 : 0];
+  offers.clear();
+  for (int i = 0; i < (int)facilities.size(); ++i) {
+    const SimFacility &fac = facilities[i];
+    if (fac.closed || !TrafficPolicy::Accepts(fac.type, car.type, seekCharging) || fac.freeSpots.empty())
+      continue;
+
+    int pick = fac.freeSpots[std::uniform_int_distribution<int>(0, (int)fac.freeSpots.size() - 1)(rng)];
+    offers.push_back({i, pick, WorldCoord::Distance(spawnPos, fac.position), fac.spots[pick].price});
+  }
+
+  int choice = TrafficPolicy::ChooseOffer(offers, car.priority);
+
+  if (choice == -1) {
+    report.passedThrough++;
+    schedule(now + passThroughTime, EventKind::LeaveMap, id);
+    return;
+  }
+
+  car.facility = offers[choice].facility;
+  car.spot = offers[choice].spot;
+
+  SimFacility &fac = facilities[car.facility];
+  takeSpot(fac, car.spot, SpotState::RESERVED);
+  schedule(now + fac.spots[car.spot].entryTime[car.enteredFromLeft ? 1 : 0], EventKind::ReachSpot, id);
+}
+
+void DiscreteEventSimulator::occupy(int id) {
+  SimCar &car = cars[id];
+  SimFacility &fac = facilities[car.facility];
+
+  fac.spots[car.spot].state = SpotState::OCCUPIED;
+  fac.occupied++;
+  if (TrafficPolicy::IsCharging(fac.type))
+    occupiedCharging++;
+  else
+    occupiedParking++;
+  car.parkedAt = now;
+
+  int totalSpots = parkingSpotTotal + chargingSpotTotal;
+  report.peakOccupancy = std::max(report.peakOccupancy, (double)(occupiedParking + occupiedCharging) / totalSpots);
+}
+
+void DiscreteEventSimulator::handleReachSpot(int id) {
+  occupy(id);
+  SimCar &car = cars[id];
+  const SimFacility &fac = facilities[car.facility];
+
+  // Time spent PARKED before the car starts its exit
+  double stay = 0.0;
+  if (car.dwell >= 0.0f) {
+    // Replayed from a trace: the recorded stay wins over the charging hazard
+    stay = car.dwell;
+    if (TrafficPolicy::IsCharging(fac.type) && car.type == Car::CarType::ELECTRIC) {
+      car.battery = std::min(100.0f, car.battery + Config::CHARGING_RATE * car.dwell);
+      report.chargingVisits++;
+    } else {
+      report.parkedVisits++;
+    }
+  } else if (TrafficPolicy::IsCharging(fac.type) && car.type == Car::CarType::ELECTRIC) {
+    float exponential = std::exponential_distribution<float>(1.0f)(rng);
+    float leaveAt = TrafficPolicy::SampleChargingExitLevel(car.battery, exponential);
+    stay = std::max(0.0f, leaveAt - car.battery) / Config::CHARGING_RATE;
+    car.battery = leaveAt;
+    report.chargingVisits++;
+  } else {
+    // Car::updateWithNeighbors draws the timer in tenths of a second
+    int tenths = std::uniform_int_distribution<int>((int)(Config::PARKING_MIN_TIME * 10),
+                                                    (int)(Config::PARKING_MAX_TIME * 10))(rng);
+    stay = tenths / 10.0;
+    report.parkedVisits++;
+  }
+
+  schedule(now + stay, EventKind::LeaveSpot, id);
+}
+
+void DiscreteEventSimulator::handleLeaveSpot(int id) {
+  SimCar &car = cars[id];
+  SimFacility &fac = facilities[car.facility];
+
+  fac.occupied--;
+  if (TrafficPolicy::IsCharging(fac.type))
+    occupiedCharging--;
+  else
+    occupiedParking--;
+  releaseSpot(fac, car.spot);
+
+  dwellSecondsTotal += now - car.parkedAt;
+  dwellCount++;
+
+  bool exitRight = TrafficPolicy::ExitRight(car.priority, car.enteredFromLeft, uniform());
+  schedule(now + fac.spots[car.spot].exitTime[exitRight ? 1 : 0], EventKind::LeaveMap, id);
+}
+
+void DiscreteEventSimulator::handleLeaveMap(int id) { freeCars.push_back(id); }
+
+int DiscreteEventSimulator::allocateCar() {
+  if (!freeCars.empty()) {
+    int id = freeCars.back();
+    freeCars.pop_back();
+    cars[id] = SimCar{};
+    return id;
+  }
+  cars.emplace_back();
+  return (int)cars.size() - 1;
+}
+
+void DiscreteEventSimulator::takeSpot(SimFacility &fac, int spot, SpotState state) {
+  // Swap-remove from the free list
+  int slot = fac.spots[spot].freeSlot;
+  int last = fac.freeSpots.back();
+  fac.freeSpots[slot] = last;
+  fac.spots[last].freeSlot = slot;
+  fac.freeSpots.pop_back();
+
+  fac.spots[spot].freeSlot = -1;
+  fac.spots[spot].state = state;
+}
+
+void DiscreteEventSimulator::releaseSpot(SimFacility &fac, int spot) {
+  fac.spots[spot].state = SpotState::FREE;
+  fac.spots[spot].freeSlot = (int)fac.freeSpots.size();
+  fac.freeSpots.push_back(spot);
+}
+
+std::string DesReport::format() const {
+  std::string out;
+  out += std::format("Simulated {:.1f} h in {} events\n", simulatedSeconds / 3600.0, eventsProcessed);
+  out += std::format("Arrivals: {} (parked {}, charged {}, passed through {})\n", arrivals, parkedVisits,
+                     chargingVisits, passedThrough);
+  out += std::format("Occupancy: mean {:.1f}% (parking {:.1f}%, charging {:.1f}%), peak {:.1f}%\n",
+                     meanOccupancy * 100.0, meanParkingOccupancy * 100.0, meanChargingOccupancy * 100.0,
+                     peakOccupancy * 100.0);
+  out += std::format("Mean dwell: {:.1f} s", meanDwellSeconds);
+  return out;
+}
@@ -0,0 +1,275 @@
+#include "systems/ForecastService.hpp"
+#include "config.hpp"
+#include "core/EntityManager.hpp"
+#include "core/FrameArena.hpp"
+#include "core/Logger.hpp"
+#include "core/MemoryStats.hpp"
+#include "core/SystemScheduler.hpp"
+#include "events/GameEvents.hpp"
+#include "systems/TrafficSystem.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+/**
+ * @file ForecastService.cpp
+ * @brief Live state capture, the forecaster thread and forecast publication.
+ */
+
+size_t OccupancyForecast::capacity() const {
+  size_t total = overall.capacity() + facilities.capacity() + curves.capacity();
+  for (const auto &curve : curves)
+    total += curve.capacity();
+  return total;
+}
+
+static DesConfig ForecastConfig(const TrafficSystem &trafficSystem) {
+  DesConfig config;
+  config.demand = trafficSystem.getDemand().getProfile();
+  config.horizonSeconds = Config::Forecast::HORIZON;
+  config.sampleInterval = Config::Forecast::SAMPLE_INTERVAL;
+  config.facilityCurves = true;
+  return config;
+}
+
+ForecastService::ForecastService(std::shared_ptr<EventBus> bus, const EntityManager &em, const TrafficSystem &traffic)
+    : eventBus(std::move(bus)), entityManager(em), trafficSystem(traffic),
+      model(em.getModules(), ForecastConfig(traffic)) {
+  indexFacilities();
+  modelFacilities = facilities;
+  eventTokens.push_back(eventBus->subscribe<MapEditedEvent>([this](const MapEditedEvent &) { onMapEdited(); }));
+
+  thread = std::thread([this]() { forecasterLoop(); });
+}
+
+ForecastService::~ForecastService() {
+  eventTokens.clear();
+  {
+    std::lock_guard lock(mutex);
+    stopping = true;
+  }
+  wake.notify_all();
+  thread.join();
+}
+
+void ForecastService::indexFacilities() {
+  facilities.clear();
+  facilityIndex.clear();
+  for (const auto &mod : entityManager.getModules()) {
+    ModuleType type = mod->getType();
+    if (!TrafficPolicy::IsParking(type) && !TrafficPolicy::IsCharging(type))
+      continue;
+    facilityIndex[mod.get()] = (int)facilities.size();
+    facilities.push_back(mod.get());
+  }
+}
+
+void ForecastService::onMapEdited() {
+  // The forecaster keeps its own facility list and rebuilds from the next capture
+  layoutGeneration++;
+  indexFacilities();
+}
+
+void ForecastService::schedule(SystemScheduler &scheduler) {
+  // Writes HUD: the published forecast lands in the dashboard's cache
+  scheduler.add({"forecast", SystemScheduler::Stage::Bookkeeping,
+                 SystemScheduler::CARS | SystemScheduler::FACILITIES | SystemScheduler::DEMAND, SystemScheduler::HUD,
+                 Config::Scheduler::FORECAST_RATE, [this](double) { capture(); }});
+}
+
+void ForecastService::capture() {
+  auto wallNow = std::chrono::steady_clock::now();
+  bool fresh = false;
+  bool offered = false;
+  {
+    std::unique_lock lock(mutex, std::try_to_lock);
+    if (!lock.owns_lock())
+      return; // The forecaster is exchanging buffers; the next run will catch up
+
+    if (outboxReady) {
+      fresh = outboxGeneration == layoutGeneration; // Else its curves belong to an older facility list
+      if (fresh)
+        std::swap(latest, outbox);
+      outboxReady = false;
+    }
+
+    std::chrono::duration<double> sinceLast = wallNow - lastCapture;
+    if (!busy && sinceLast.count() >= Config::Forecast::MIN_PERIOD) {
+      auto inboxCapacity = [this]() {
+        return inbox.modules.capacity() + inbox.start.demand.upcoming.capacity() + inbox.start.holds.capacity();
+      };
+      size_t capacity = inboxCapacity();
+      inbox.generation = layoutGeneration;
+      inbox.modules.clear();
+      for (const auto &mod : entityManager.getModules())
+        inbox.modules.push_back(mod.get());
+      fillStart(inbox.start);
+      if (inboxCapacity() != capacity)
+        MemoryStats::markTickEventful(); // The buffers reached a new high
+      inboxReady = true;
+      busy = true;
+      offered = true;
+      lastCapture = wallNow;
+    }
+  }
+  if (offered)
+    wake.notify_one();
+
+  // Score the horizon predictions whose time has come
+  double now = trafficSystem.getDemand().getTime();
+  if (!checks.empty() && checks.front().due <= now) {
+    float live = liveOccupancy();
+    auto due = checks.begin();
+    for (; due != checks.end() && due->due <= now; ++due) {
+      absoluteError += std::fabs(due->predicted - live);
+      checked++;
+    }
+    checks.erase(checks.begin(), due); // A few dozen at most, and it keeps the capacity
+  }
+
+  if (fresh) {
+    published++;
+    computeMillis += latest.computeMillis;
+    if (!latest.overall.empty()) {
+      if (checks.size() == checks.capacity())
+        MemoryStats::markTickEventful(); // Grows to a new high
+      checks.push_back({latest.takenAt + (double)(latest.overall.size() - 1) * latest.sampleInterval,
+                        latest.overall.back()});
+    }
+    eventBus->publish(OccupancyForecastEvent{&latest});
+  }
+}
+
+void ForecastService::fillStart(DesStart &start) const {
+  trafficSystem.getDemand().fork(start.demand);
+  start.holds.clear();
+
+  for (const auto &carPtr : entityManager.getCars()) {
+    const Car &car = *carPtr;
+    Car::CarState state = car.getState();
+    if (state == Car::CarState::EXITING)
+      continue; // Its spot is free again
+
+    auto it = facilityIndex.find(car.getParkedFacility());
+    if (it == facilityIndex.end() || car.getParkedSpotIndex() == -1)
+      continue; // Passing through
+
+    DesStart::Hold hold;
+    hold.facility = it->second;
+    hold.spot = car.getParkedSpotIndex();
+    hold.parked = state == Car::CarState::PARKED;
+    hold.type = car.getType();
+    hold.priority = car.getPriority();
+    hold.enteredFromLeft = car.getEnteredFromLeft();
+    hold.battery = car.getBatteryLevel();
+
+    if (state == Car::CarState::ALIGNING) {
+      hold.seconds = std::numeric_limits<float>::max(); // At the spot, turning in
+    } else if (state == Car::CarState::DRIVING) {
+      const TripTelemetry::Stamps &trip = car.getTrip();
+      hold.seconds = trip.reached(TripMilestone::PathAssigned)
+                         ? trip.clock - trip.at[(int)TripMilestone::PathAssigned]
+                         : 0.0f;
+    } else if (TrafficPolicy::IsCharging(facilities[hold.facility]->getType()) &&
+               car.getType() == Car::CarType::ELECTRIC && !car.hasParkingDuration()) {
+      hold.seconds = -1.0f; // Leaves by the charging hazard
+    } else {
+      hold.seconds = std::max(0.0f, car.getParkingTimer());
+    }
+    start.holds.push_back(hold);
+  }
+}
+
+float ForecastService::liveOccupancy() const {
+  int total = 0;
+  int occupied = 0;
+  for (const Module *mod : facilities) {
+    auto counts = mod->getSpotCounts();
+    total += counts.free + counts.reserved + counts.occupied;
+    occupied += counts.occupied;
+  }
+  return total > 0 ? (float)occupied / (float)total : 0.0f;
+}
+
+void ForecastService::forecasterLoop() {
+  while (true) {
+    {
+      std::unique_lock lock(mutex);
+      wake.wait(lock, [this]() { return stopping || inboxReady; });
+      if (stopping)
+        return;
+      std::swap(inbox, work);
+      inboxReady = false;
+    }
+
+    forecast(work, result);
+
+    {
+      std::lock_guard lock(mutex);
+      std::swap(outbox, result);
+      outboxGeneration = work.generation;
+      outboxReady = true;
+      busy = false;
+    }
+  }
+}
+
+void ForecastService::forecast(const Capture &capture, OccupancyForecast &out) {
+  auto began = std::chrono::steady_clock::now();
+
+  if (capture.generation != modelGeneration) {
+    model.rebuild(capture.modules);
+    FrameArena::Get().reset(); // The paths were only needed to time them
+    modelFacilities.clear();
+    for (const Module *mod : capture.modules)
+      if (TrafficPolicy::IsParking(mod->getType()) || TrafficPolicy::IsCharging(mod->getType()))
+        modelFacilities.push_back(mod);
+    modelGeneration = capture.generation;
+  }
+
+  const DesStart &start = capture.start;
+  out.takenAt = start.demand.now;
+  out.sampleInterval = Config::Forecast::SAMPLE_INTERVAL;
+  out.facilities = modelFacilities;
+  out.overall.clear();
+  out.curves.resize(modelFacilities.size());
+  for (auto &curve : out.curves)
+    curve.clear();
+
+  auto accumulate = [](std::vector<float> &sum, const std::vector<float> &run) {
+    if (sum.size() < run.size())
+      sum.resize(run.size(), 0.0f);
+    for (size_t i = 0; i < run.size(); ++i)
+      sum[i] += run[i];
+  };
+
+  for (int r = 0; r < Config::Forecast::REPLICATIONS; ++r) {
+    model.restart(start, (uint64_t)r);
+    DesReport run = model.run();
+    accumulate(out.overall, run.occupancyCurve);
+    for (size_t f = 0; f < run.facilityCurves.size() && f < out.curves.size(); ++f)
+      accumulate(out.curves[f], run.facilityCurves[f]);
+  }
+
+  const float scale = 1.0f / (float)Config::Forecast::REPLICATIONS;
+  for (float &v : out.overall)
+    v *= scale;
+  for (auto &curve : out.curves)
+    for (float &v : curve)
+      v *= scale;
+
+  out.computeMillis =
+      std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - began).count();
+}
+
+void ForecastService::report() const {
+  if (published == 0) {
+    Logger::Info("Forecast: none published");
+    return;
+  }
+  Logger::Info("Forecast: {} published, mean {:.2f} ms each ({} DES runs of {:.0f} s)", published,
+               computeMillis / (double)published, Config::Forecast::REPLICATIONS, Config::Forecast::HORIZON);
+  if (checked > 0)
+    Logger::Info("Forecast: +{:.0f} min occupancy off by {:.1f} points on average ({} checked)",
+                 Config::Forecast::HORIZON / 60.0, absoluteError / (double)checked * 100.0, checked);
+}
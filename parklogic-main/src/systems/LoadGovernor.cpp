@@ -0,0 +1,122 @@
+#include "systems/LoadGovernor.hpp"
+#include "config.hpp"
+#include "core/Logger.hpp"
+#include <algorithm>
+
+/**
+ * @file LoadGovernor.cpp
+ * @brief Load windows and stage transitions.
+ */
+
+LoadGovernor::LoadGovernor(std::shared_ptr<EventBus> bus) : eventBus(std::move(bus)) {
+  eventTokens.push_back(eventBus->subscribe<SimulationSpeedChangedEvent>(
+      [this](const SimulationSpeedChangedEvent &e) { requestedSpeed = e.speedMultiplier; }));
+  eventTokens.push_back(eventBus->subscribe<CameraViewEvent>([this](const CameraViewEvent &) { viewKnown = true; }));
+}
+
+void LoadGovernor::record(double dt, double tickSeconds) {
+  windowSeconds += tickSeconds;
+  windowBudget += dt / std::max(requestedSpeed * speedFactor, 1e-6);
+  if (++windowTicks < Config::Governor::WINDOW_TICKS)
+    return;
+
+  load = windowBudget > 0.0 ? windowSeconds / windowBudget : 0.0;
+  windowTicks = 0;
+  windowSeconds = 0.0;
+  windowBudget = 0.0;
+
+  GovernorStage before = stage;
+  double factorBefore = speedFactor;
+  if (load > Config::Governor::HIGH_LOAD) {
+    calmWindows = 0;
+    if (++hotWindows >= Config::Governor::ESCALATE_WINDOWS) {
+      hotWindows = 0;
+      escalate();
+    }
+  } else if (load < Config::Governor::LOW_LOAD) {
+    hotWindows = 0;
+    if (++calmWindows >= Config::Governor::RELAX_WINDOWS) {
+      calmWindows = 0;
+      relax();
+    }
+  } else {
+    hotWindows = 0;
+    calmWindows = 0;
+  }
+  windowsAt[(size_t)stage]++;
+
+  if (stage != before || speedFactor != factorBefore) {
+    Logger::Info("LoadGovernor: {} -> {} (load {:.0f}%, speed factor {:.3f})", StageName(before), StageName(stage),
+                 load * 100.0, speedFactor);
+  }
+  eventBus->publish(LoadGovernorEvent{stage, speedFactor, load});
+}
+
+void LoadGovernor::escalate() {
+  switch (stage) {
+  case GovernorStage::Normal:
+    if (viewKnown) {
+      stage = GovernorStage::Demote;
+      break;
+    }
+    [[fallthrough]]; // Without a view no car is distant, so demoting would shed nothing
+  case GovernorStage::Demote:
+    stage = GovernorStage::Slow;
+    speedFactor = 0.5;
+    break;
+  case GovernorStage::Slow:
+    if (speedFactor * 0.5 >= Config::Governor::MIN_SPEED_FACTOR)
+      speedFactor *= 0.5;
+    else
+      stage = GovernorStage::Backpressure;
+    break;
+  case GovernorStage::Backpressure:
+    return; // Nothing left to shed
+  }
+  escalations++;
+}
+
+void LoadGovernor::relax() {
+  switch (stage) {
+  case GovernorStage::Normal:
+    break;
+  case GovernorStage::Demote:
+    stage = GovernorStage::Normal;
+    break;
+  case GovernorStage::Slow:
+    speedFactor *= 2.0;
+    if (speedFactor >= 1.0) {
+      speedFactor = 1.0;
+      stage = viewKnown ? GovernorStage::Demote : GovernorStage::Normal;
+    }
+    break;
+  case GovernorStage::Backpressure:
+    stage = GovernorStage::Slow;
+    break;
+  }
+}
+
+const char *LoadGovernor::StageName(GovernorStage stage) {
+  switch (stage) {
+  case GovernorStage::Normal:
+    return "normal";
+  case GovernorStage::Demote:
+    return "demote";
+  case GovernorStage::Slow:
+    return "slow";
+  case GovernorStage::Backpressure:
+    return "backpressure";
+  default:
+    return "?";
+  }
+}
+
+void LoadGovernor::report() const {
+  uint64_t windows = 0;
+  for (uint64_t n : windowsAt)
+    windows += n;
+  if (windows == 0)
+    return;
+  Logger::Info("LoadGovernor: {} windows, {} escalations; normal {} / demote {} / slow {} / backpressure {}", windows,
+               escalations, windowsAt[0], windowsAt[1], windowsAt[2], windowsAt[3]);
+}
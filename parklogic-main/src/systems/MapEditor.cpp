@@ -0,0 +1,258 @@
+#include "systems/MapEditor.hpp"
+#include "core/EntityManager.hpp"
+#include "core/Logger.hpp"
+#include "core/MemoryStats.hpp"
+#include "systems/TrafficPolicy.hpp"
+#include "systems/TrafficSystem.hpp"
+#include "raymath.h"
+#include <algorithm>
+#include <chrono>
+#include <format>
+#include <iterator>
+
+/**
+ * @file MapEditor.cpp
+ * @brief Facility placement checks and the car hand-over of runtime map edits.
+ */
+
+namespace {
+/// Facilities built side by side touch; only overlaps deeper than this (meters) reject an edit.
+constexpr double OVERLAP_TOLERANCE = 0.01;
+
+constexpr ModuleType FACILITY_TYPES[] = {ModuleType::SMALL_PARKING, ModuleType::LARGE_PARKING,
+                                         ModuleType::SMALL_CHARGING, ModuleType::LARGE_CHARGING};
+constexpr const char *FACILITY_NAMES[] = {"small-parking", "large-parking", "small-charging", "large-charging"};
+} // namespace
+
+MapEditor::MapEditor(std::shared_ptr<EventBus> bus, EntityManager &em, TrafficSystem &traffic)
+    : eventBus(std::move(bus)), entityManager(em), trafficSystem(traffic) {
+  eventTokens.push_back(eventBus->subscribe<EditMapEvent>([this](const EditMapEvent &e) { apply(e); }));
+}
+
+void MapEditor::apply(const EditMapEvent &e) {
+  auto began = std::chrono::steady_clock::now();
+  MemoryStats::markTickEventful(); // Like a spawn: the edit may allocate, and so may its reply
+  ModuleType type = (ModuleType)e.type;
+  bool isFacilityType = TrafficPolicy::IsParking(type) || TrafficPolicy::IsCharging(type);
+  bool done = false;
+
+  if ((e.edit == MapEdit::Insert || e.edit == MapEdit::Convert) && !isFacilityType) {
+    reject(std::format("module type {} is not a facility", e.type));
+  } else if (e.edit == MapEdit::Insert) {
+    done = insert(e.target, e.top, type);
+  } else if (Module *facility = facilityAt(e.target); !facility) {
+    reject(std::format("there is no facility f{}", e.target));
+  } else if (e.edit == MapEdit::Remove || e.edit == MapEdit::Convert) {
+    done = replace(facility, e.edit == MapEdit::Convert, type);
+  } else {
+    done = setClosed(facility, e.edit == MapEdit::Close);
+  }
+
+  if (!done) {
+    rejected++;
+    return;
+  }
+  double millis = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - began).count();
+  applied++;
+  editMillis += millis;
+  worstMillis = std::max(worstMillis, millis);
+  Logger::Info("MapEditor: edit applied in {:.2f} ms", millis);
+}
+
+bool MapEditor::insert(int entrance, bool top, ModuleType type) {
+  const char *side = top ? "top" : "bottom";
+  Module *road = entranceAt(entrance);
+  if (!road) {
+    return reject(std::format("there is no entrance road e{}", entrance));
+  }
+  for (const auto &mod : entityManager.getModules()) {
+    if (mod->getParent() == road && mod->isUp() == top) {
+      return reject(std::format("the {} side of e{} is taken", side, entrance));
+    }
+  }
+
+  std::unique_ptr<Module> facility = Build(*road, top, type);
+  if (!facility) {
+    return reject(std::format("e{} has no {} entrance", entrance, side));
+  }
+  if (!fits(*facility, nullptr)) {
+    return reject(std::format("a {} does not fit on the {} side of e{}", FacilityTypeName(type), side, entrance));
+  }
+
+  const Module *added = facility.get();
+  entityManager.addModule(std::move(facility));
+  Logger::Info("MapEditor: inserted f{} ({}) on the {} side of e{}", added->getFacilityId(), FacilityTypeName(type),
+               side, entrance);
+  eventBus->publish(MapEditedEvent{MapEdit::Insert, added, nullptr});
+  return true;
+}
+
+bool MapEditor::replace(Module *facility, bool convert, ModuleType type) {
+  const int number = facility->getFacilityId();
+  const char *oldName = FacilityTypeName(facility->getType());
+  std::unique_ptr<Module> built;
+  if (convert) {
+    Module *road = facility->getParent();
+    if (road)
+      built = Build(*road, facility->isUp(), type);
+    if (!built || !fits(*built, facility)) {
+      return reject(std::format("a {} does not fit where f{} is", FacilityTypeName(type), number));
+    }
+    built->setClosed(facility->isClosed());
+    built->setFacilityId(facility->getFacilityId());
+  }
+
+  // Out of the list first, so the replanned cars below cannot pick it again
+  std::unique_ptr<Module> old = entityManager.removeModule(facility);
+
+  std::vector<Car *> redirected;
+  int sentOut = 0;
+  for (const auto &carPtr : entityManager.getCars()) {
+    Car *car = carPtr.get();
+    if (car->getParkedFacility() != old.get())
+      continue;
+
+    Car::CarState state = car->getState();
+    if (state == Car::CarState::DRIVING && !car->getTrip().reached(TripMilestone::GateEntry)) {
+      redirected.push_back(car);
+    } else if (state != Car::CarState::EXITING) {
+      trafficSystem.evacuate(car); // Paths are planned through the old module while it still exists
+      sentOut++;
+    }
+    car->setParkingContext(nullptr, Spot{}, -1); // Exiting cars steer without its flow field
+  }
+
+  const Module *added = built.get();
+  if (built)
+    entityManager.addModule(std::move(built));
+  for (Car *car : redirected) {
+    trafficSystem.assignDestination(car);
+  }
+  replanned += redirected.size();
+  evacuated += (uint64_t)sentOut;
+
+  if (convert)
+    Logger::Info("MapEditor: converted f{} from {} to {}; {} cars replanned, {} sent out", number, oldName,
+                 FacilityTypeName(type), redirected.size(), sentOut);
+  else
+    Logger::Info("MapEditor: removed f{} ({}); {} cars replanned, {} sent out", number, oldName, redirected.size(),
+                 sentOut);
+  eventBus->publish(MapEditedEvent{convert ? MapEdit::Convert : MapEdit::Remove, added, old.get()});
+  retired.push_back(std::move(old)); // The forecaster may still be building its model from it
+  return true;
+}
+
+bool MapEditor::setClosed(Module *facility, bool closed) {
+  const int number = facility->getFacilityId();
+  if (facility->isClosed() == closed) {
+    return reject(std::format("f{} is already {}", number, closed ? "closed" : "open"));
+  }
+  facility->setClosed(closed);
+  Logger::Info("MapEditor: {} f{} ({})", closed ? "closed" : "reopened", number, FacilityTypeName(facility->getType()));
+  eventBus->publish(MapEditedEvent{closed ? MapEdit::Close : MapEdit::Reopen, facility, nullptr});
+  return true;
+}
+
+Module *MapEditor::facilityAt(int id) const {
+  for (const auto &mod : entityManager.getModules()) {
+    if (mod->getSpotCount() > 0 && mod->getFacilityId() == id)
+      return mod.get();
+  }
+  return nullptr;
+}
+
+bool MapEditor::reject(std::string reason) {
+  Logger::Warn("MapEditor: {}", reason);
+  eventBus->publish(MapEditRejectedEvent{std::move(reason)});
+  return false;
+}
+
+Module *MapEditor::entranceAt(int number) const {
+  for (const auto &mod : entityManager.getModules()) {
+    if (IsEntrance(*mod) && number-- == 0)
+      return mod.get();
+  }
+  return nullptr;
+}
+
+std::unique_ptr<Module> MapEditor::Build(Module &road, bool top, ModuleType type) {
+  // Same placement as WorldGenerator: the facility's attachment point on the road's matching one
+  Vector2 normal = top ? Vector2{0, -1} : Vector2{0, 1};
+  const AttachmentPoint *roadAtt = road.getAttachmentPointByNormal(normal);
+  if (!roadAtt)
+    return nullptr;
+
+  std::unique_ptr<Module> facility;
+  switch (type) {
+  case ModuleType::SMALL_PARKING:
+    facility = std::make_unique<SmallParking>(top);
+    break;
+  case ModuleType::LARGE_PARKING:
+    facility = std::make_unique<LargeParking>(top);
+    break;
+  case ModuleType::SMALL_CHARGING:
+    facility = std::make_unique<SmallChargingStation>(top);
+    break;
+  case ModuleType::LARGE_CHARGING:
+    facility = std::make_unique<LargeChargingStation>(top);
+    break;
+  default:
+    return nullptr;
+  }
+
+  const AttachmentPoint *facAtt = facility->getAttachmentPointByNormal(Vector2Scale(normal, -1.0f));
+  facility->worldPosition = road.worldPosition + Vector2Subtract(roadAtt->position, facAtt->position);
+  facility->setParent(&road);
+  return facility;
+}
+
+bool MapEditor::fits(const Module &facility, const Module *ignore) const {
+  double left = facility.worldPosition.x();
+  double top = facility.worldPosition.y();
+  double right = left + facility.getWidth();
+  double bottom = top + facility.getHeight();
+
+  if (const World *world = entityManager.getWorld()) {
+    if (left < -OVERLAP_TOLERANCE || top < -OVERLAP_TOLERANCE || right > world->getWidth() + OVERLAP_TOLERANCE ||
+        bottom > world->getHeight() + OVERLAP_TOLERANCE)
+      return false;
+  }
+
+  for (const auto &mod : entityManager.getModules()) {
+    if (mod.get() == ignore || mod->getSpotCount() == 0)
+      continue;
+    double otherLeft = mod->worldPosition.x();
+    double otherTop = mod->worldPosition.y();
+    if (left < otherLeft + mod->getWidth() - OVERLAP_TOLERANCE && otherLeft < right - OVERLAP_TOLERANCE &&
+        top < otherTop + mod->getHeight() - OVERLAP_TOLERANCE && otherTop < bottom - OVERLAP_TOLERANCE)
+      return false;
+  }
+  return true;
+}
+
+bool MapEditor::IsEntrance(const Module &module) {
+  return module.getSpotCount() == 0 &&
+         (module.getAttachmentPointByNormal({0, -1}) || module.getAttachmentPointByNormal({0, 1}));
+}
+
+bool MapEditor::ParseFacilityType(std::string_view name, ModuleType &type) {
+  auto it = std::find(std::begin(FACILITY_NAMES), std::end(FACILITY_NAMES), name);
+  if (it == std::end(FACILITY_NAMES))
+    return false;
+  type = FACILITY_TYPES[it - std::begin(FACILITY_NAMES)];
+  return true;
+}
+
+const char *MapEditor::FacilityTypeName(ModuleType type) {
+  auto it = std::find(std::begin(FACILITY_TYPES), std::end(FACILITY_TYPES), type);
+  return it != std::end(FACILITY_TYPES) ? FACILITY_NAMES[it - std::begin(FACILITY_TYPES)] : "road";
+}
+
+void MapEditor::report() const {
+  if (applied == 0 && rejected == 0)
+    return;
+  Logger::Info("MapEditor: {} edits applied ({:.2f} ms mean, {:.2f} ms worst), {} rejected; {} cars replanned, "
+               "{} sent out",
+               applied, applied > 0 ? editMillis / (double)applied : 0.0, worstMillis, rejected, replanned,
+               evacuated);
+}
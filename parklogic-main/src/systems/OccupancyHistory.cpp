@@ -0,0 +1,215 @@
+#include "systems/OccupancyHistory.hpp"
+#include "config.hpp"
+#include "core/EntityManager.hpp"
+#include "core/Logger.hpp"
+#include "core/SystemScheduler.hpp"
+#include "systems/TrafficPolicy.hpp"
+#include "systems/TrafficSystem.hpp"
+#include <algorithm>
+
+/**
+ * @file OccupancyHistory.cpp
+ * @brief Sampling, roll-ups and lock-free reads of the occupancy history.
+ */
+
+namespace {
+/// Inputs that close a bucket of each level: samples per second, seconds per minute, minutes per quarter hour.
+constexpr int INPUTS_PER_BUCKET[OccupancyHistory::LEVELS] = {Config::History::SAMPLE_RATE, 60, 15};
+} // namespace
+
+OccupancyHistory::OccupancyHistory(std::shared_ptr<EventBus> bus, const EntityManager &em,
+                                   const TrafficSystem &traffic)
+    : eventBus(std::move(bus)), entityManager(em), trafficSystem(traffic) {
+  for (const auto &mod : entityManager.getModules()) {
+    ModuleType type = mod->getType();
+    if (!TrafficPolicy::IsParking(type) && !TrafficPolicy::IsCharging(type))
+      continue;
+    facilities.push_back(mod.get());
+    facilityRows[mod.get()] = (int)facilities.size(); // Row 0 is the map
+  }
+  rows = (int)facilities.size() + 1;
+
+  size_t series = (size_t)rows * CHANNELS;
+  values.assign(series, 0.0f);
+  for (Ring &ring : rings) {
+    ring.slots.assign((size_t)Config::History::CAPACITY * series, Bucket{});
+    ring.open.assign(series, Accumulator{});
+  }
+  Logger::Info("OccupancyHistory: {} series, {:.0f} KB", series, (double)getMemoryBytes() / 1024.0);
+
+  eventTokens.push_back(
+      eventBus->subscribe<MapEditedEvent>([this](const MapEditedEvent &e) { onMapEdited(e); }));
+}
+
+void OccupancyHistory::onMapEdited(const MapEditedEvent &e) {
+  int row = -1;
+  if (auto it = facilityRows.find(e.replaced); e.replaced && it != facilityRows.end()) {
+    row = it->second;
+    facilities[row - 1] = nullptr;
+    facilityRows.erase(it);
+  }
+  if (!e.module || e.edit == MapEdit::Close || e.edit == MapEdit::Reopen)
+    return;
+
+  if (row == -1) {
+    auto vacant = std::find(facilities.begin(), facilities.end(), nullptr);
+    if (vacant == facilities.end()) {
+      Logger::Warn("OccupancyHistory: no vacant row; the new facility only counts towards the map row");
+      return;
+    }
+    row = (int)(vacant - facilities.begin()) + 1;
+  }
+  facilities[row - 1] = e.module;
+  facilityRows[e.module] = row;
+}
+
+void OccupancyHistory::schedule(SystemScheduler &scheduler) {
+  // Writes HUD: its rings feed the dashboard
+  scheduler.add({"history", SystemScheduler::Stage::Bookkeeping,
+                 SystemScheduler::CARS | SystemScheduler::FACILITIES | SystemScheduler::DEMAND, SystemScheduler::HUD,
+                 Config::History::SAMPLE_RATE, [this](double) { sample(); }});
+}
+
+int OccupancyHistory::rowOf(const Module *module) const {
+  auto it = facilityRows.find(module);
+  return it != facilityRows.end() ? it->second : -1;
+}
+
+void OccupancyHistory::sample() {
+  std::fill(values.begin(), values.end(), 0.0f);
+  auto at = [&](int row, Channel channel) -> float & { return values[(size_t)row * CHANNELS + (size_t)channel]; };
+
+  // Cars past a gate that have not reached their spot yet
+  for (const auto &car : entityManager.getCars()) {
+    const TripTelemetry::Stamps &trip = car->getTrip();
+    if (car->getState() != Car::CarState::DRIVING || !trip.reached(TripMilestone::GateEntry) ||
+        trip.reached(TripMilestone::SpotArrival))
+      continue;
+    int row = rowOf(car->getParkedFacility());
+    if (row > 0)
+      at(row, Channel::Queue) += 1.0f;
+  }
+
+  int totalSpots = 0;
+  int occupied = 0;
+  float priceSum = 0.0f;
+  int facilityCount = 0;
+  for (const auto &mod : entityManager.getModules()) {
+    ModuleType type = mod->getType();
+    if (!TrafficPolicy::IsParking(type) && !TrafficPolicy::IsCharging(type))
+      continue;
+    Module::SpotCounts counts = mod->getSpotCounts();
+    int spots = counts.free + counts.reserved + counts.occupied;
+    int row = rowOf(mod.get()); // -1 for a facility inserted with no row left
+    if (row > 0) {
+      at(row, Channel::Occupancy) = spots > 0 ? (float)counts.occupied / (float)spots : 0.0f;
+      at(row, Channel::Reserved) = (float)counts.reserved;
+      at(row, Channel::Price) = mod->getPriceMultiplier();
+    }
+
+    totalSpots += spots;
+    occupied += counts.occupied;
+    priceSum += mod->getPriceMultiplier();
+    facilityCount++;
+    at(MAP_ROW, Channel::Reserved) += (float)counts.reserved;
+  }
+  const DemandScheduler &demand = trafficSystem.getDemand();
+  at(MAP_ROW, Channel::Occupancy) = totalSpots > 0 ? (float)occupied / (float)totalSpots : 0.0f;
+  at(MAP_ROW, Channel::Price) = facilityCount > 0 ? priceSum / (float)facilityCount : 0.0f;
+  at(MAP_ROW, Channel::Queue) = (float)(demand.getWaiting(true) + demand.getWaiting(false));
+
+  for (size_t s = 0; s < values.size(); ++s)
+    add(0, s, values[s], values[s], values[s]);
+  if (++rings[0].inputs == INPUTS_PER_BUCKET[0])
+    close(0);
+}
+
+void OccupancyHistory::add(int level, size_t index, float min, float max, float mean) {
+  Accumulator &acc = rings[level].open[index];
+  if (acc.count == 0) {
+    acc.min = min;
+    acc.max = max;
+  } else {
+    acc.min = std::min(acc.min, min);
+    acc.max = std::max(acc.max, max);
+  }
+  acc.sum += mean;
+  acc.count++;
+}
+
+void OccupancyHistory::close(int level) {
+  Ring &ring = rings[level];
+  const size_t series = ring.open.size();
+
+  // Fill the slot past the newest bucket, then publish it
+  uint64_t head = ring.head.load(std::memory_order_relaxed);
+  Bucket *slot = &ring.slots[(size_t)(head % Config::History::CAPACITY) * series];
+  for (size_t s = 0; s < series; ++s) {
+    Accumulator &acc = ring.open[s];
+    slot[s] = {acc.min, acc.max, acc.count > 0 ? (float)(acc.sum / acc.count) : 0.0f};
+    if (level + 1 < LEVELS)
+      add(level + 1, s, slot[s].min, slot[s].max, slot[s].mean);
+    acc = Accumulator{};
+  }
+  ring.head.store(head + 1, std::memory_order_release);
+  ring.inputs = 0;
+
+  if (level + 1 < LEVELS && ++rings[level + 1].inputs == INPUTS_PER_BUCKET[level + 1])
+    close(level + 1);
+}
+
+size_t OccupancyHistory::read(Level level, int row, Channel channel, std::span<Bucket> out) const {
+  if (row < 0 || row >= rows)
+    return 0;
+  const Ring &ring = rings[(int)level];
+  const size_t series = (size_t)rows * CHANNELS;
+  const size_t index = (size_t)row * CHANNELS + (size_t)channel;
+  const uint64_t capacity = Config::History::CAPACITY;
+
+  while (true) {
+    uint64_t end = ring.head.load(std::memory_order_acquire);
+    uint64_t count = std::min<uint64_t>({(uint64_t)out.size(), end, capacity - 1});
+    uint64_t first = end - count;
+    for (uint64_t i = 0; i < count; ++i)
+      out[i] = ring.slots[(size_t)((first + i) % capacity) * series + index];
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    // The writer may be filling bucket `now`, whose slot held bucket now - capacity
+    uint64_t now = ring.head.load(std::memory_order_relaxed);
+    if (now - first < capacity)
+      return (size_t)count;
+  }
+}
+
+size_t OccupancyHistory::getMemoryBytes() const {
+  size_t bytes = values.size() * sizeof(float);
+  for (const Ring &ring : rings)
+    bytes += ring.slots.size() * sizeof(Bucket) + ring.open.size() * sizeof(Accumulator);
+  return bytes;
+}
+
+double OccupancyHistory::BucketSeconds(Level level) {
+  switch (level) {
+  case Level::Second:
+    return 1.0;
+  case Level::Minute:
+    return 60.0;
+  case Level::Quarter:
+    return 900.0;
+  default:
+    return 0.0;
+  }
+}
+
+const char *OccupancyHistory::LevelName(Level level) {
+  switch (level) {
+  case Level::Second:
+    return "1 s";
+  case Level::Minute:
+    return "1 min";
+  case Level::Quarter:
+    return "15 min";
+  default:
+    return "?";
+  }
+}
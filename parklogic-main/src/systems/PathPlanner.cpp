@@ -1,5 +1,8 @@
 #include "systems/PathPlanner.hpp"
 #include "config.hpp"
+#include "core/FrameArena.hpp"
+#include "core/MemoryStats.hpp"
+#include "entities/map/FlowField.hpp"
 #include "raymath.h"
 #include <cmath>
 
@@ -17,25 +20,29 @@
 // This is where the vertical access road meets the horizontal main road.
 static constexpr float ROAD_TJUNCTION_CENTER_X = 142.0f;
 
-// The horizontal distance from the T-junction center to the Entry/Exit lanes (in art pixels).
-// The total separation between the two vertical lanes is 36 pixels (18 * 2).
-static constexpr float ENTRANCE_LANE_OFFSET_X = 18.0f;
-
 // Helper to convert art pixels to meters
 static float P2M(float artPixels) { return artPixels / static_cast<float>(Config::ART_PIXELS_PER_METER); }
 
-std::vector<Waypoint> PathPlanner::GeneratePath(const Car *car, const Module *targetFac, const Spot &targetSpot) {
-  std::vector<Waypoint> path;
+std::pmr::vector<Waypoint> PathPlanner::GeneratePath(const Car *car, const Module *targetFac,
+                                                      const Spot &targetSpot) {
+  return GeneratePath(car->getPosition(), car->getVelocity().x > 0, targetFac, targetSpot);
+}
+
+std::pmr::vector<Waypoint> PathPlanner::GeneratePath(const WorldCoord &startPos, bool movingRight, const Module *targetFac,
+                                                      const Spot &targetSpot) {
+  ProfileZoneScope zone(ProfileZone::PathPlanning);
+  std::pmr::vector<Waypoint> path(FrameArena::Get().resource());
+  path.reserve(32);
 
   // 1. Determine Horizontal Lane on the Main Road
-  Lane mainRoadLane = (car->getVelocity().x > 0) ? Lane::DOWN : Lane::UP;
+  Lane mainRoadLane = movingRight ? Lane::DOWN : Lane::UP;
 
   // 2. Determine Facility Orientation and Entry Side
   bool isUpFacility = targetFac->isUp();
   bool useRightSideEntry = isUpFacility; // Up -> Right, Down -> Left
 
   // Track current position for segment generation
-  Vector2 currentPos = car->getPosition();
+  WorldCoord currentPos = startPos;
 
   // 3. Waypoint 1: Road Entry Point
   // Phase: APPROACH
@@ -49,7 +56,7 @@ std::vector<Waypoint> PathPlanner::GeneratePath(const Car *car, const Module *ta
   // Split the Approach:
   // If the distance to the entry is long (> 40m), drive in HIGHWAY mode first.
   // Then switch to APPROACH mode for the last 30m (where braking might occur).
-  float distToEntry = Vector2Distance(currentPos, wpEntry.position);
+  float distToEntry = WorldCoord::Distance(currentPos, wpEntry.position);
   float approachDist = Config::CarAI::TURN_SLOWDOWN_DIST + 5.0f; // e.g. 35m
 
   if (distToEntry > approachDist + 10.0f) {
@@ -59,7 +66,7 @@ std::vector<Waypoint> PathPlanner::GeneratePath(const Car *car, const Module *ta
     // Actually, we want the point at (dist - approachDist)
 
     float t = 1.0f - (approachDist / distToEntry);
-    Vector2 prePos = Vector2Lerp(currentPos, wpEntry.position, t);
+    WorldCoord prePos = WorldCoord::Lerp(currentPos, wpEntry.position, t);
 
     // Target: Pre-Approach Point
     // Phase: HIGHWAY
@@ -85,14 +92,17 @@ std::vector<Waypoint> PathPlanner::GeneratePath(const Car *car, const Module *ta
   // Phase: ACCESS
   Waypoint wpGate = CalculateFacilityEntry(targetFac, useRightSideEntry);
   wpGate.entryAngle = wpEntry.entryAngle; // Vertical
+  wpGate.id = Waypoint::GATE_ID;
 
   AddSegment(path, currentPos, wpGate, Config::CarAI::Phases::ACCESS);
   currentPos = wpGate.position;
 
   // 5. Waypoint 3: Alignment Point
-  // Phase: MANEUVER
+  // Phase: MANEUVER, steered by the facility's flow field up to the spot's row
   Waypoint wpAlign = CalculateAlignmentPoint(targetFac, targetSpot);
   wpAlign.entryAngle = targetSpot.orientation;
+  if (const FlowField *field = targetFac->getFlowField())
+    wpAlign.flowGoal = field->rowGoal(targetSpot.id);
 
   AddSegment(path, currentPos, wpAlign, Config::CarAI::Phases::MANEUVER);
   currentPos = wpAlign.position;
@@ -107,86 +117,42 @@ std::vector<Waypoint> PathPlanner::GeneratePath(const Car *car, const Module *ta
 }
 
 Waypoint PathPlanner::CalculateRoadEntry(const Module *road, Lane roadLane, bool useRightSideEntry) {
-  Vector2 roadWorldPos = road->worldPosition;
   float xCenter = P2M(ROAD_TJUNCTION_CENTER_X);
-  float xOffset = useRightSideEntry ? P2M(ENTRANCE_LANE_OFFSET_X) : -P2M(ENTRANCE_LANE_OFFSET_X);
+  float xOffset = useRightSideEntry ? P2M(Config::ENTRANCE_LANE_OFFSET) : -P2M(Config::ENTRANCE_LANE_OFFSET);
   float yOffset = (roadLane == Lane::DOWN) ? P2M(Config::LANE_OFFSET_DOWN) : P2M(Config::LANE_OFFSET_UP);
 
   // Default tolerance/speed overridden by AddSegment
-  return Waypoint(Vector2Add(roadWorldPos, {xCenter + xOffset, yOffset}));
+  return Waypoint(road->worldPosition + Vector2{xCenter + xOffset, yOffset});
 }
 
 Waypoint PathPlanner::CalculateFacilityEntry(const Module *facility, bool useRightSideEntry) {
-  // Determine Horizontal Center from Local Waypoint or Module Width
-  float xBase = facility->getWidth() / 2.0f;
-  std::vector<Waypoint> localWps = facility->getLocalWaypoints();
-  if (!localWps.empty()) {
-    xBase = localWps[0].position.x;
-  }
-
-  // Horizontal Offset for Lane (Left/Right entry)
-  float xOffset = useRightSideEntry ? P2M(ENTRANCE_LANE_OFFSET_X) : -P2M(ENTRANCE_LANE_OFFSET_X);
-  float finalX = facility->worldPosition.x + xBase + xOffset;
-
-  // Determine Depth based on Config and Type
-  ModuleType type = facility->getType();
-  float depth = Config::CarAI::GateDepth::GENERIC;
-
-  switch (type) {
-  case ModuleType::SMALL_PARKING:
-    depth = Config::CarAI::GateDepth::SMALL_PARKING;
-    break;
-  case ModuleType::LARGE_PARKING:
-    depth = Config::CarAI::GateDepth::LARGE_PARKING;
-    break;
-  case ModuleType::SMALL_CHARGING:
-    depth = Config::CarAI::GateDepth::SMALL_CHARGING;
-    break;
-  case ModuleType::LARGE_CHARGING:
-    depth = Config::CarAI::GateDepth::LARGE_CHARGING;
-    break;
-  default:
-    break;
-  }
-
-  // Calculate Vertical Position relative to Physical Entrance Edge
-  // Up Facility: Top-Left at WorldPos. Entrance is at Bottom (WorldPos.y + Height).
-  // Driving IN means moving Up (-Y).
-  // Final Y = (WorldPos.y + Height) - Depth
-
-  // Down Facility: Top-Left at WorldPos. Entrance is at Top (WorldPos.y).
-  // Driving IN means moving Down (+Y).
-  // Final Y = WorldPos.y + Depth
-
-  float finalY = 0.0f;
-  if (facility->isUp()) {
-    finalY = (facility->worldPosition.y + facility->getHeight()) - depth;
-  } else {
-    finalY = facility->worldPosition.y + depth;
-  }
-
-  return Waypoint({finalX, finalY});
+  // Lane offset from the entrance axis and depth past the entrance edge come from the template
+  return Waypoint(facility->worldPosition + facility->getTemplate().gatePosition(useRightSideEntry));
 }
 
 Waypoint PathPlanner::CalculateAlignmentPoint(const Module *facility, const Spot &spot) {
-  Vector2 spotGlobal = Vector2Add(facility->worldPosition, spot.localPosition);
   float backAngle = spot.orientation + PI;
-  float dist = 8.0f;
+  float dist = Config::CarAI::ALIGN_DISTANCE;
   Vector2 offset = {cosf(backAngle) * dist, sinf(backAngle) * dist};
-  Vector2 alignPos = Vector2Add(spotGlobal, offset);
 
-  return Waypoint(alignPos);
+  return Waypoint(facility->worldPosition + Vector2Add(spot.localPosition, offset));
 }
 
 Waypoint PathPlanner::CalculateSpotPoint(const Module *facility, const Spot &spot) {
-  Vector2 spotGlobal = Vector2Add(facility->worldPosition, spot.localPosition);
-  return Waypoint(spotGlobal, 0.2f, spot.id, spot.orientation, true);
+  return Waypoint(facility->worldPosition + spot.localPosition, 0.2f, spot.id, spot.orientation, true);
+}
+
+std::pmr::vector<Waypoint> PathPlanner::GenerateExitPath(const Car *car, const Module *currentFac,
+                                                         const Spot &currentSpot, bool exitRight, double finalX) {
+  return GenerateExitPath(car->getPosition(), currentFac, currentSpot, exitRight, finalX);
 }
 
-std::vector<Waypoint> PathPlanner::GenerateExitPath(const Car *car, const Module *currentFac, const Spot &currentSpot,
-                                                    bool exitRight, float finalX) {
-  std::vector<Waypoint> path;
-  Vector2 currentPos = car->getPosition();
+std::pmr::vector<Waypoint> PathPlanner::GenerateExitPath(const WorldCoord &startPos, const Module *currentFac,
+                                                         const Spot &currentSpot, bool exitRight, double finalX) {
+  ProfileZoneScope zone(ProfileZone::PathPlanning);
+  std::pmr::vector<Waypoint> path(FrameArena::Get().resource());
+  path.reserve(32);
+  WorldCoord currentPos = startPos;
 
   // 1. Waypoint 1: Alignment Point (Reverse)
   // Phase: MANEUVER
@@ -202,6 +168,8 @@ std::vector<Waypoint> PathPlanner::GenerateExitPath(const Car *car, const Module
 
   Waypoint wpGate = CalculateFacilityEntry(currentFac, useRightSideExit);
   wpGate.entryAngle = isUpFac ? PI / 2.0f : -PI / 2.0f;
+  if (currentFac->getFlowField())
+    wpGate.flowGoal = FlowField::EXIT;
 
   AddSegment(path, currentPos, wpGate, Config::CarAI::Phases::ACCESS);
   currentPos = wpGate.position;
@@ -222,36 +190,37 @@ std::vector<Waypoint> PathPlanner::GenerateExitPath(const Car *car, const Module
 
   // 4. Waypoint 4: Map Edge Exit
   // Phase: HIGHWAY (Crucial change: High density correction over long distance)
-  float yPos = 0.0f;
+  double yPos = 0.0;
   if (parentRoad) {
     float laneOffset = (exitRight) ? P2M(Config::LANE_OFFSET_DOWN) : P2M(Config::LANE_OFFSET_UP);
-    yPos = parentRoad->worldPosition.y + laneOffset;
+    yPos = parentRoad->worldPosition.y() + laneOffset;
   } else {
-    yPos = car->getPosition().y;
+    yPos = startPos.y();
   }
 
-  Waypoint wpEdge({finalX, yPos}, 1.0f, -1, 0.0f, true);
+  Waypoint wpEdge(WorldCoord::FromMeters(finalX, yPos), 1.0f, -1, 0.0f, true);
 
   AddSegment(path, currentPos, wpEdge, Config::CarAI::Phases::HIGHWAY);
 
   return path;
 }
 
-void PathPlanner::AddSegment(std::vector<Waypoint> &path, Vector2 startPos, Waypoint target,
+void PathPlanner::AddSegment(std::pmr::vector<Waypoint> &path, const WorldCoord &startPos, Waypoint target,
                              const Config::CarAI::AIPhase &phase) {
   // 1. Calculate Segment distance
-  float dist = Vector2Distance(startPos, target.position);
+  float dist = WorldCoord::Distance(startPos, target.position);
 
   // 2. Determine number of correction points
   // If step is 15m and dist is 45m -> 3 steps -> 2 intermediate points?
   // count = floor(dist / step)
 
-  if (phase.correctionStep > 0.0f && dist > phase.correctionStep) {
+  // Field-steered segments need none: the field supplies the heading everywhere along them
+  if (target.flowGoal < 0 && phase.correctionStep > 0.0f && dist > phase.correctionStep) {
     int steps = std::max(1, (int)(dist / phase.correctionStep));
 
     for (int k = 1; k < steps; ++k) {
       float t = (float)k / (float)steps;
-      Vector2 newPos = Vector2Lerp(startPos, target.position, t);
+      WorldCoord newPos = WorldCoord::Lerp(startPos, target.position, t);
 
       Waypoint wpCorr = target; // Inherit target properties (angle/ID potentially)
       wpCorr.position = newPos;
@@ -272,3 +241,15 @@ void PathPlanner::AddSegment(std::vector<Waypoint> &path, Vector2 startPos, Wayp
 
   path.push_back(target);
 }
+
+float PathPlanner::EstimateTravelTime(const WorldCoord &startPos, std::span<const Waypoint> path) {
+  float seconds = 0.0f;
+  WorldCoord currentPos = startPos;
+
+  for (const Waypoint &wp : path) {
+    float speed = Config::CarAI::MAX_SPEED * std::max(wp.speedLimitFactor, 0.05f);
+    seconds += WorldCoord::Distance(currentPos, wp.position) / speed;
+    currentPos = wp.position;
+  }
+  return seconds;
+}
@@ -0,0 +1,164 @@
+#include "systems/RenderBenchmark.hpp"
+#include "config.hpp"
+#include "core/EntityManager.hpp"
+#include "core/FrameArena.hpp"
+#include "core/Logger.hpp"
+#include "core/MemoryStats.hpp"
+#include "core/Window.hpp"
+#include "events/GameEvents.hpp"
+#include "scenes/GameScene.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+/**
+ * @file RenderBenchmark.cpp
+ * @brief Camera script, frame loop and report of the render benchmark.
+ */
+
+void RenderBenchmark::Totals::add(const RenderStats::Frame &frame, const MemoryStats::Report &frameAllocations) {
+  frameMillis.push_back(frame.millis);
+  allocations.add(frameAllocations);
+  for (size_t i = 0; i < RenderStats::PassCount; ++i) {
+    passes[i].millis += frame.passes[i].millis;
+    passes[i].drawCalls += frame.passes[i].drawCalls;
+    passes[i].textureBinds += frame.passes[i].textureBinds;
+    peakDrawCalls[i] = std::max(peakDrawCalls[i], frame.passes[i].drawCalls);
+  }
+}
+
+RenderBenchmark::RenderBenchmark(const LaunchOptions &launchOptions) : options(launchOptions) {
+  // An unpaced warm-up looks like an overloaded tick to the governor, and shed work would change the scene
+  options.governor = false;
+
+  eventBus = std::make_shared<EventBus>();
+  eventTokens.push_back(eventBus->subscribe<WorldBoundsEvent>([this](const WorldBoundsEvent &e) {
+    worldWidth = e.width;
+    worldHeight = e.height;
+  }));
+
+  window = std::make_unique<Window>(eventBus, true);
+  RenderStats::Enable();
+
+  scene = std::make_unique<GameScene>(eventBus, options.map, options);
+  scene->load();
+}
+
+RenderBenchmark::~RenderBenchmark() {
+  if (scene)
+    scene->unload();
+  scene.reset(); // Its textures go before the GL context
+  eventTokens.clear();
+  window.reset();
+}
+
+std::vector<RenderBenchmark::Segment> RenderBenchmark::script() const {
+  auto at = [](double x, double y) { return WorldCoord::FromMeters(x, y); };
+  const double w = worldWidth;
+  const double h = worldHeight;
+  WorldCoord center = at(w / 2.0, h / 2.0);
+
+  return {
+      {"zoom in", center, center, Config::MIN_ZOOM, Config::MAX_ZOOM},
+      {"zoom out", center, center, Config::MAX_ZOOM, Config::MIN_ZOOM},
+      {"pan x", at(0.0, h / 2.0), at(w, h / 2.0), 1.0f, 1.0f},
+      {"pan y", at(w / 2.0, 0.0), at(w / 2.0, h), 1.0f, 1.0f},
+      {"pan close", at(0.0, 0.0), at(w, h), 4.0f, 4.0f},
+      {"pan wide", at(w, 0.0), at(0.0, h), 0.25f, 0.25f},
+  };
+}
+
+void RenderBenchmark::warmUp() {
+  const double dt = Config::FIXED_DELTA_TIME;
+  const uint64_t ticks = (uint64_t)(Config::RenderBench::WARMUP_SECONDS / dt);
+  auto start = std::chrono::steady_clock::now();
+  for (uint64_t tick = 0; tick < ticks; ++tick) {
+    MemoryStats::beginTick();
+    scene->update(dt);
+    FrameArena::Get().reset();
+    MemoryStats::endTick();
+  }
+  double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  Logger::Info("RenderBench: {:.0f} simulated s of warm-up in {:.1f} s wall, {} cars on the map",
+               Config::RenderBench::WARMUP_SECONDS, wallSeconds, scene->getEntityManager()->getCars().size());
+  if constexpr (MemoryStats::Enabled) {
+    Logger::Info("RenderBench: warm-up ticks {}", MemoryStats::FormatReport(MemoryStats::getTickTotals()));
+  }
+}
+
+void RenderBenchmark::renderSegment(const Segment &segment, Totals &segmentTotals, Totals &scriptTotals) {
+  const int frames = Config::RenderBench::SEGMENT_FRAMES;
+  for (int i = 0; i < frames; ++i) {
+    // Positions move linearly, zoom geometrically (even steps on the wheel)
+    double t = frames > 1 ? (double)i / (double)(frames - 1) : 0.0;
+    WorldCoord target = WorldCoord::FromMeters(segment.from.x() + (segment.to.x() - segment.from.x()) * t,
+                                               segment.from.y() + (segment.to.y() - segment.from.y()) * t);
+    float zoom = segment.zoomFrom * std::pow(segment.zoomTo / segment.zoomFrom, (float)t);
+    eventBus->publish(SetCameraViewEvent{target, zoom});
+
+    MemoryStats::beginFrame();
+    RenderStats::beginFrame();
+    {
+      ProfileZoneScope zone(ProfileZone::Rendering);
+      window->beginDrawing();
+      scene->draw();
+      window->endDrawing();
+    }
+    const RenderStats::Frame &frame = RenderStats::endFrame();
+    MemoryStats::endFrame();
+
+    segmentTotals.add(frame, MemoryStats::getLastFrame());
+    scriptTotals.add(frame, MemoryStats::getLastFrame());
+  }
+}
+
+void RenderBenchmark::run() {
+  warmUp();
+
+  std::vector<Segment> segments = script();
+  Logger::Info("RenderBench: {} segments of {} frames over a {:.0f} x {:.0f} m map", segments.size(),
+               Config::RenderBench::SEGMENT_FRAMES, worldWidth, worldHeight);
+
+  Totals scriptTotals;
+  for (const Segment &segment : segments) {
+    Totals segmentTotals;
+    renderSegment(segment, segmentTotals, scriptTotals);
+    Report(segment.name, segmentTotals);
+  }
+
+  Report("all", scriptTotals);
+  double frames = (double)std::max<size_t>(1, scriptTotals.frameMillis.size());
+  for (size_t i = 0; i < RenderStats::PassCount; ++i) {
+    const RenderStats::PassCounters &pass = scriptTotals.passes[i];
+    Logger::Info("RenderBench: pass {}: {:.3f} ms, {:.1f} draw calls ({} max), {:.1f} texture binds per frame",
+                 RenderStats::PassName((RenderPass)i), pass.millis / frames, pass.drawCalls / frames,
+                 scriptTotals.peakDrawCalls[i], pass.textureBinds / frames);
+  }
+}
+
+void RenderBenchmark::Report(const char *name, Totals &totals) {
+  std::vector<double> &millis = totals.frameMillis;
+  if (millis.empty())
+    return;
+  std::sort(millis.begin(), millis.end());
+  auto percentile = [&](double p) { return millis[(size_t)std::ceil(p / 100.0 * (double)millis.size()) - 1]; };
+
+  double frames = (double)millis.size();
+  double sum = 0.0;
+  uint64_t drawCalls = 0;
+  uint64_t textureBinds = 0;
+  for (double ms : millis)
+    sum += ms;
+  for (const RenderStats::PassCounters &pass : totals.passes) {
+    drawCalls += pass.drawCalls;
+    textureBinds += pass.textureBinds;
+  }
+
+  Logger::Info("RenderBench: {}: {} frames, {:.2f} ms mean, {:.2f} p50, {:.2f} p99, {:.2f} max; {:.1f} draw calls, "
+               "{:.1f} texture binds per frame",
+               name, millis.size(), sum / frames, percentile(50.0), percentile(99.0), millis.back(),
+               (double)drawCalls / frames, (double)textureBinds / frames);
+  if constexpr (MemoryStats::Enabled) {
+    Logger::Info("RenderBench: {}: {}", name, MemoryStats::FormatReport(totals.allocations));
+  }
+}
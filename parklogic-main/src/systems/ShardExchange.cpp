@@ -0,0 +1,62 @@
+#include "systems/ShardExchange.hpp"
+#include <new>
+#include <string>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+/**
+ * @file ShardExchange.cpp
+ * @brief Layout and initialization of the shard segment.
+ */
+
+namespace {
+
+size_t alignUp(size_t offset) { return (offset + 63) & ~(size_t)63; }
+
+} // namespace
+
+ShardExchange::ShardExchange(int shards, size_t spots) : shardCount(shards), spotCount(spots) {
+  size_t statusOffset = alignUp(sizeof(Header));
+  size_t seamOffset = alignUp(statusOffset + sizeof(ShardStatus) * shardCount);
+  size_t spotOffset = alignUp(seamOffset + sizeof(Seam) * (shardCount - 1));
+  size_t size = spotOffset + spotCount;
+
+#ifdef _WIN32
+  std::string name = "/parklogic-shards";
+#else
+  std::string name = "/parklogic-shards-" + std::to_string(::getpid());
+#endif
+  memory = std::make_unique<SharedMemory>(name, size);
+
+  auto *base = static_cast<std::byte *>(memory->data());
+  header = new (base) Header();
+  statuses = new (base + statusOffset) ShardStatus[shardCount];
+  seams = reinterpret_cast<Seam *>(base + seamOffset);
+  for (int i = 0; i < shardCount - 1; ++i) {
+    new (&seams[i]) Seam();
+  }
+  spotStates = reinterpret_cast<std::atomic<uint8_t> *>(base + spotOffset);
+  for (size_t i = 0; i < spotCount; ++i) {
+    new (&spotStates[i]) std::atomic<uint8_t>(0);
+  }
+}
+
+MigrationRing &ShardExchange::migrations(int from, int to) const {
+  return to > from ? seams[from].migrations[0] : seams[to].migrations[1];
+}
+
+GhostRing &ShardExchange::ghosts(int from, int to) const {
+  return to > from ? seams[from].ghosts[0] : seams[to].ghosts[1];
+}
+
+void ShardExchange::bindSpotStates(const std::vector<std::unique_ptr<Module>> &modules) const {
+  size_t offset = 0;
+  for (const auto &mod : modules) {
+    if (mod->getSpotCount() == 0 || offset + mod->getSpotCount() > spotCount)
+      continue;
+    mod->bindSpotStates(spotStates + offset);
+    offset += mod->getSpotCount();
+  }
+}
@@ -0,0 +1,86 @@
+#include "systems/ShardPlan.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+/**
+ * @file ShardPlan.cpp
+ * @brief Seam placement for sharded runs.
+ */
+
+int ShardPlan::shardOf(double x) const { return (int)(std::upper_bound(seams.begin(), seams.end(), x) - seams.begin()); }
+
+double ShardPlan::lower(int shard) const {
+  return shard == 0 ? -std::numeric_limits<double>::infinity() : seams[shard - 1];
+}
+
+double ShardPlan::upper(int shard) const {
+  return shard == (int)seams.size() ? std::numeric_limits<double>::infinity() : seams[shard];
+}
+
+ShardPlan ShardPlan::Compute(const std::vector<std::unique_ptr<Module>> &modules, int shards) {
+  struct Facility {
+    double from;
+    double to;
+    int spots;
+  };
+  std::vector<Facility> facilities;
+  std::vector<double> edges;
+  double minX = std::numeric_limits<double>::max();
+  double maxX = std::numeric_limits<double>::lowest();
+  int totalSpots = 0;
+
+  for (const auto &mod : modules) {
+    double x = mod->worldPosition.x();
+    edges.push_back(x);
+    edges.push_back(x + mod->getWidth());
+    minX = std::min(minX, x);
+    maxX = std::max(maxX, x + mod->getWidth());
+
+    if (mod->getSpotCount() > 0) {
+      facilities.push_back({x, x + mod->getWidth(), (int)mod->getSpotCount()});
+      totalSpots += (int)mod->getSpotCount();
+    }
+  }
+
+  // Candidates: interior module edges
+  static constexpr double EPSILON = 0.01;
+  std::sort(edges.begin(), edges.end());
+  edges.erase(std::unique(edges.begin(), edges.end(), [](double a, double b) { return std::abs(a - b) < EPSILON; }),
+              edges.end());
+  std::erase_if(edges, [&](double e) { return e <= minX + EPSILON || e >= maxX - EPSILON; });
+
+  // Spots left of an edge, each facility's spots spread evenly over its width
+  auto spotsLeftOf = [&](double edge) {
+    double n = 0.0;
+    for (const Facility &f : facilities) {
+      n += (double)f.spots * std::clamp((edge - f.from) / (f.to - f.from), 0.0, 1.0);
+    }
+    return n;
+  };
+  // Cutting through a facility works (hand-overs carry the parking context) but makes manoeuvring
+  // cars cross the seam back and forth, so it costs as much as a quarter strip of imbalance
+  double cutPenalty = 0.25 * (double)totalSpots / (double)shards;
+  auto cost = [&](double edge, double target) {
+    bool cuts = std::any_of(facilities.begin(), facilities.end(), [edge](const Facility &f) {
+      return edge > f.from + EPSILON && edge < f.to - EPSILON;
+    });
+    return std::abs(spotsLeftOf(edge) - target) + (cuts ? cutPenalty : 0.0);
+  };
+
+  ShardPlan plan;
+  size_t next = 0; // Seams must strictly increase
+  for (int k = 1; k < shards && next < edges.size(); ++k) {
+    double target = (double)totalSpots * (double)k / (double)shards;
+    // Leave enough edges for the remaining seams
+    size_t last = std::max(next, edges.size() - std::min(edges.size(), (size_t)(shards - k)));
+    size_t best = next;
+    for (size_t i = next; i <= last; ++i) {
+      if (cost(edges[i], target) < cost(edges[best], target))
+        best = i;
+    }
+    plan.seams.push_back(edges[best]);
+    next = best + 1;
+  }
+  return plan;
+}
@@ -0,0 +1,232 @@
+#include "systems/ShardWorker.hpp"
+#include "config.hpp"
+#include "core/FrameArena.hpp"
+#include "core/Logger.hpp"
+#include "core/MemoryStats.hpp"
+#include "events/GameEvents.hpp"
+#include <chrono>
+#include <thread>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+/**
+ * @file ShardWorker.cpp
+ * @brief Lockstep tick loop and seam traffic of one shard.
+ */
+
+ShardWorker::ShardWorker(int shardIndex, const ShardPlan &plan, const ShardExchange &shardExchange,
+                         GeneratedMap map, const LaunchOptions &options)
+    : shard(shardIndex), exchange(shardExchange), lowerX(plan.lower(shardIndex)), upperX(plan.upper(shardIndex)) {
+#ifdef __linux__
+  // One core per shard; everything below is then first touched (and placed) on that core's node
+  unsigned cores = std::thread::hardware_concurrency();
+  if (cores > 0) {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(shard % cores, &cpus);
+    sched_setaffinity(0, sizeof(cpus), &cpus);
+  }
+#endif
+
+  if (shard > 0)
+    neighbours[0] = shard - 1;
+  if (shard < plan.shardCount() - 1)
+    neighbours[1] = shard + 1;
+
+  // Forked shards share the parent's generator state; give each its own streams
+  const uint64_t shardSeed = options.seed * 7919 + (uint64_t)shard;
+  SetRandomSeed((unsigned int)shardSeed);
+
+  eventBus = std::make_shared<EventBus>();
+  entityManager = std::make_unique<EntityManager>(eventBus);
+  trafficSystem = std::make_unique<TrafficSystem>(eventBus, *entityManager, shardSeed);
+  trafficSystem->setEntrySides(shard == 0, shard == plan.shardCount() - 1);
+  watchdog = std::make_unique<StuckWatchdog>(eventBus, *entityManager);
+  entityManager->schedule(scheduler);
+  trafficSystem->schedule(scheduler);
+  watchdog->schedule(scheduler);
+  entityManager->setCarIdSequence((uint32_t)shard + 1, (uint32_t)plan.shardCount());
+
+  entityManager->setWorld(std::move(map.world));
+  for (auto &mod : map.modules) {
+    entityManager->addModule(std::move(mod));
+  }
+
+  const auto &modules = entityManager->getModules();
+  for (int i = 0; i < (int)modules.size(); ++i) {
+    const Module *mod = modules[i].get();
+    if (mod->getSpotCount() == 0)
+      continue;
+    facilityIndices[mod] = i;
+    double center = mod->worldPosition.x() + mod->getWidth() * 0.5;
+    if (center >= lowerX && center < upperX)
+      ownedFacilities.push_back(mod);
+  }
+
+  eventTokens.push_back(eventBus->subscribe<CarSpawnedEvent>([this](const CarSpawnedEvent &) { spawned++; }));
+
+  if (!options.trace.empty())
+    eventBus->publish(LoadDemandTraceEvent{options.trace});
+  eventBus->publish(SetAutoSpawnLevelEvent{options.spawnLevel});
+
+  Logger::Info("Shard {}: x in [{}, {}), {} facilities", shard, lowerX, upperX, ownedFacilities.size());
+}
+
+ShardWorker::~ShardWorker() {
+  eventTokens.clear();
+  entityManager->setGhosts({});
+  watchdog->report();
+  watchdog.reset();
+  trafficSystem.reset();
+  entityManager.reset();
+}
+
+void ShardWorker::run(uint64_t horizonTicks, const std::atomic<bool> &stopSignal) {
+  using Clock = std::chrono::steady_clock;
+  const double dt = Config::FIXED_DELTA_TIME;
+  ShardStatus &status = exchange.status(shard);
+
+  for (uint64_t tick = 1; tick <= horizonTicks; ++tick) {
+    if (!waitForNeighbours(tick, stopSignal))
+      break;
+
+    auto start = Clock::now();
+    MemoryStats::beginTick();
+    receive(tick);
+    scheduler.tick(dt);
+    eventBus->publish(GameUpdateEvent{dt});
+    send(tick);
+
+    for (const Module *facility : ownedFacilities) {
+      occupiedSpotSeconds += facility->getSpotCounts().occupied * dt;
+    }
+    FrameArena::Get().reset();
+    MemoryStats::endTick();
+    busySeconds += std::chrono::duration<double>(Clock::now() - start).count();
+
+    uint32_t parked = 0;
+    for (const auto &car : entityManager->getCars()) {
+      parked += car->getState() == Car::CarState::PARKED;
+    }
+    status.cars.store((uint32_t)entityManager->getCars().size(), std::memory_order_relaxed);
+    status.parked.store(parked, std::memory_order_relaxed);
+    status.spawned.store(spawned, std::memory_order_relaxed);
+    status.migratedOut.store(migratedOut, std::memory_order_relaxed);
+    status.ghostsSent.store(ghostsSent, std::memory_order_relaxed);
+    status.ghostsDropped.store(ghostsDropped, std::memory_order_relaxed);
+    status.occupiedSpotSeconds.store(occupiedSpotSeconds, std::memory_order_relaxed);
+    status.busySeconds.store(busySeconds, std::memory_order_relaxed);
+    status.tickAllocations.store(MemoryStats::getTickTotals().allocations, std::memory_order_relaxed);
+    status.tickAllocationBytes.store(MemoryStats::getTickTotals().bytes, std::memory_order_relaxed);
+    status.completedTick.store(tick, std::memory_order_release); // Publishes this tick's rings
+  }
+
+  status.finished.store(true, std::memory_order_release);
+}
+
+bool ShardWorker::waitForNeighbours(uint64_t tick, const std::atomic<bool> &stopSignal) const {
+  for (int n : neighbours) {
+    if (n < 0)
+      continue;
+
+    const ShardStatus &other = exchange.status(n);
+    while (other.completedTick.load(std::memory_order_acquire) + 1 < tick) {
+      // A neighbour that stopped early never catches up
+      if (stopSignal || exchange.stopRequested() || other.finished.load(std::memory_order_acquire))
+        return false;
+      std::this_thread::yield();
+    }
+  }
+  return true;
+}
+
+void ShardWorker::receive(uint64_t tick) {
+  const auto &modules = entityManager->getModules();
+  ghostCount = 0;
+
+  for (int n : neighbours) {
+    if (n < 0)
+      continue;
+
+    // Hand-overs from the previous tick (a neighbour one tick ahead may already have pushed newer ones)
+    MigrationRing &migrations = exchange.migrations(n, shard);
+    while (const MigrationRecord *record = migrations.front()) {
+      if (record->tick >= tick)
+        break;
+      int index = record->car.facilityIndex;
+      const Module *facility = (index >= 0 && index < (int)modules.size()) ? modules[index].get() : nullptr;
+      entityManager->addCar(Car::FromMigrationState(record->car, facility));
+      migrations.pop();
+    }
+
+    GhostRing &ghosts = exchange.ghosts(n, shard);
+    while (const GhostRecord *record = ghosts.front()) {
+      if (record->tick >= tick)
+        break;
+      if (record->tick + 1 == tick) {
+        if (ghostCount == ghostPool.size()) {
+          MemoryStats::markTickEventful();
+          ghostPool.push_back(std::make_unique<Car>(record->position, nullptr, record->velocity,
+                                                    Car::CarType::COMBUSTION));
+        }
+        Car &ghost = *ghostPool[ghostCount++];
+        ghost.setId(record->id);
+        ghost.setPose(record->position, record->velocity, record->rotation);
+        ghost.setState((Car::CarState)record->state);
+      }
+      ghosts.pop();
+    }
+  }
+
+  entityManager->setGhosts({ghostPool.data(), ghostCount});
+}
+
+void ShardWorker::send(uint64_t tick) {
+  std::pmr::vector<Car *> leaving(FrameArena::Get().resource());
+
+  for (const auto &car : entityManager->getCars()) {
+    double x = car->getPosition().x();
+    int target = x < lowerX ? neighbours[0] : (x >= upperX ? neighbours[1] : -1);
+
+    if (target >= 0) {
+      MigrationRecord record{tick, car->saveMigrationState(facilityIndex(car->getParkedFacility()))};
+      // A full ring keeps the car here for another tick; it is handed over on the next try
+      if (exchange.migrations(shard, target).tryPush(record)) {
+        leaving.push_back(car.get());
+        migratedOut++;
+        continue;
+      }
+    }
+
+    if (car->getState() == Car::CarState::PARKED)
+      continue; // Avoidance ignores parked cars
+    for (int side = 0; side < 2; ++side) {
+      int n = neighbours[side];
+      bool nearSeam = side == 0 ? x < lowerX + Config::Shard::GHOST_MARGIN : x >= upperX - Config::Shard::GHOST_MARGIN;
+      if (n < 0 || !nearSeam)
+        continue;
+
+      GhostRecord ghost{tick,
+                        car->getId(),
+                        (uint8_t)car->getState(),
+                        car->getPosition(),
+                        car->getVelocity(),
+                        car->getRotation()};
+      if (exchange.ghosts(shard, n).tryPush(ghost))
+        ghostsSent++;
+      else
+        ghostsDropped++;
+    }
+  }
+
+  for (Car *car : leaving) {
+    entityManager->removeCar(car);
+  }
+}
+
+int ShardWorker::facilityIndex(const Module *facility) const {
+  auto it = facilityIndices.find(facility);
+  return it != facilityIndices.end() ? it->second : -1;
+}
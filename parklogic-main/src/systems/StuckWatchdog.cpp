@@ -0,0 +1,150 @@
+#include "systems/StuckWatchdog.hpp"
+#include "config.hpp"
+#include "core/EntityManager.hpp"
+#include "core/FrameArena.hpp"
+#include "core/Logger.hpp"
+#include "core/MemoryStats.hpp"
+#include "core/SystemScheduler.hpp"
+#include "events/GameEvents.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+/**
+ * @file StuckWatchdog.cpp
+ * @brief Stalled-car clustering and recovery.
+ */
+
+namespace {
+struct Stalled {
+  uint64_t cell; ///< Column in the high half, row in the low half.
+  Car *car;
+};
+
+uint64_t CellKey(int64_t col, int64_t row) { return ((uint64_t)(uint32_t)col << 32) | (uint32_t)row; }
+
+int64_t CellOf(double meters) { return (int64_t)std::floor(meters / Config::Watchdog::CLUSTER_RADIUS); }
+
+/// Longer stall first, then lower id: the car a cluster is resolved through.
+bool Precedes(const Car *a, const Car *b) {
+  float stallA = a->getStalledSeconds();
+  float stallB = b->getStalledSeconds();
+  return stallA != stallB ? stallA > stallB : a->getId() < b->getId();
+}
+} // namespace
+
+StuckWatchdog::StuckWatchdog(std::shared_ptr<EventBus> bus, EntityManager &em)
+    : eventBus(std::move(bus)), entityManager(em) {}
+
+void StuckWatchdog::schedule(SystemScheduler &scheduler) {
+  scheduler.add({"traffic.watchdog", SystemScheduler::Stage::Traffic, 0,
+                 SystemScheduler::CARS | SystemScheduler::FACILITIES, Config::Scheduler::WATCHDOG_RATE,
+                 [this](double) { sweep(); }});
+}
+
+void StuckWatchdog::sweep() {
+  ProfileZoneScope zone(ProfileZone::TrafficHandler);
+  std::pmr::memory_resource *arena = FrameArena::Get().resource();
+
+  std::pmr::vector<Stalled> stalled(arena);
+  for (const auto &carPtr : entityManager.getCars()) {
+    Car *car = carPtr.get();
+    Car::CarState state = car->getState();
+    if ((state != Car::CarState::DRIVING && state != Car::CarState::EXITING) ||
+        car->getStalledSeconds() < Config::Watchdog::STALL_SECONDS)
+      continue;
+    const WorldCoord &pos = car->getPosition();
+    stalled.push_back({CellKey(CellOf(pos.x()), CellOf(pos.y())), car});
+  }
+  if (stalled.empty())
+    return;
+  sweepsWithStalls++;
+
+  // Cell index: sorted by cell, each cell's cars found by binary search
+  std::sort(stalled.begin(), stalled.end(), [](const Stalled &a, const Stalled &b) {
+    return a.cell != b.cell ? a.cell < b.cell : a.car->getId() < b.car->getId();
+  });
+
+  std::pmr::vector<int> parent(stalled.size(), arena);
+  std::iota(parent.begin(), parent.end(), 0);
+  auto find = [&](int i) {
+    while (parent[i] != i) {
+      parent[i] = parent[parent[i]];
+      i = parent[i];
+    }
+    return i;
+  };
+
+  const float radius = Config::Watchdog::CLUSTER_RADIUS;
+  for (int i = 0; i < (int)stalled.size(); ++i) {
+    const WorldCoord &pos = stalled[i].car->getPosition();
+    int64_t col = CellOf(pos.x());
+    int64_t row = CellOf(pos.y());
+    for (int64_t dc = -1; dc <= 1; ++dc) {
+      for (int64_t dr = -1; dr <= 1; ++dr) {
+        uint64_t key = CellKey(col + dc, row + dr);
+        auto first = std::lower_bound(stalled.begin(), stalled.end(), key,
+                                      [](const Stalled &s, uint64_t k) { return s.cell < k; });
+        for (auto it = first; it != stalled.end() && it->cell == key; ++it) {
+          int j = (int)(it - stalled.begin());
+          if (j > i && WorldCoord::Distance(pos, it->car->getPosition()) <= radius)
+            parent[find(j)] = find(i);
+        }
+      }
+    }
+  }
+
+  // Per cluster root: its leading car, size and whether someone already has the right of way
+  std::pmr::vector<int> leader(stalled.size(), -1, arena);
+  std::pmr::vector<int> members(stalled.size(), 0, arena);
+  std::pmr::vector<char> yielding(stalled.size(), 0, arena);
+  for (int i = 0; i < (int)stalled.size(); ++i) {
+    int root = find(i);
+    members[root]++;
+    yielding[root] |= stalled[i].car->hasRightOfWay() ? 1 : 0;
+    if (leader[root] == -1 || Precedes(stalled[i].car, stalled[leader[root]].car))
+      leader[root] = i;
+  }
+
+  std::pmr::vector<Car *> toRemove(arena);
+  bool intervened = false;
+  for (int root = 0; root < (int)stalled.size(); ++root) {
+    if (leader[root] == -1)
+      continue;
+    largestCluster = std::max(largestCluster, (size_t)members[root]);
+    Car *car = stalled[leader[root]].car;
+
+    if (car->getStalledSeconds() >= Config::Watchdog::DESPAWN_SECONDS) {
+      Logger::Warn("StuckWatchdog: removing car {} after {:.0f} s without progress ({} stalled in its cluster)",
+                   car->getId(), car->getStalledSeconds(), members[root]);
+      toRemove.push_back(car);
+    } else if (!yielding[root]) {
+      car->grantRightOfWay(Config::Watchdog::RIGHT_OF_WAY);
+      rightOfWays++;
+      intervened = true;
+    }
+  }
+
+  for (Car *car : toRemove) {
+    // A car still on its way in holds a reservation nobody else can take
+    Module *fac = const_cast<Module *>(car->getParkedFacility());
+    int idx = car->getParkedSpotIndex();
+    if (car->getState() == Car::CarState::DRIVING && fac && idx != -1 &&
+        fac->getSpot(idx).state == SpotState::RESERVED)
+      fac->setSpotState(idx, SpotState::FREE);
+    car->stampTrip(TripMilestone::Removed); // Ends the trip in the report without timing the stall as a metric
+    entityManager.removeCar(car);
+    removed++;
+    intervened = true;
+  }
+
+  if (intervened)
+    eventBus->publish(StuckVehiclesEvent{rightOfWays, removed});
+}
+
+void StuckWatchdog::report() const {
+  if (sweepsWithStalls == 0)
+    return;
+  Logger::Info("StuckWatchdog: stalls in {} sweeps, largest cluster {}; {} right-of-way grants, {} cars removed",
+               sweepsWithStalls, largestCluster, rightOfWays, removed);
+}
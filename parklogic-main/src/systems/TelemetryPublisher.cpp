@@ -0,0 +1,149 @@
+#include "systems/TelemetryPublisher.hpp"
+#include "core/EntityManager.hpp"
+#include "core/Logger.hpp"
+#include "entities/Car.hpp"
+#include "entities/map/Modules.hpp"
+#include "raymath.h"
+#include "systems/LoadGovernor.hpp"
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+#ifdef _WIN32
+// windows.h clashes with raylib (Rectangle, DrawText, ...), so declare the one function needed
+extern "C" __declspec(dllimport) unsigned long __stdcall GetCurrentProcessId();
+static uint32_t CurrentPid() { return (uint32_t)GetCurrentProcessId(); }
+#else
+#include <unistd.h>
+static uint32_t CurrentPid() { return (uint32_t)::getpid(); }
+#endif
+
+/**
+ * @file TelemetryPublisher.cpp
+ * @brief Implementation of the shared memory telemetry writer.
+ */
+
+using namespace TelemetryLayout;
+
+static bool IsFacility(ModuleType type) {
+  return type == ModuleType::SMALL_PARKING || type == ModuleType::LARGE_PARKING ||
+         type == ModuleType::SMALL_CHARGING || type == ModuleType::LARGE_CHARGING;
+}
+
+TelemetryPublisher::TelemetryPublisher(const std::string &name, const EntityManager &em, double tickSeconds)
+    : memory(name, sizeof(Region)), region(new (memory.data()) Region), entityManager(em) {
+  RegionHeader &header = region->header;
+  header.version = VERSION;
+  header.headerBytes = sizeof(RegionHeader);
+  header.slotBytes = sizeof(Slot);
+  header.slotCount = SLOT_COUNT;
+  header.maxCars = MAX_CARS;
+  header.maxFacilities = MAX_FACILITIES;
+  header.tickSeconds = (float)tickSeconds;
+  header.writerPid = CurrentPid();
+  header.latest.store(0, std::memory_order_relaxed);
+
+  // Magic last: readers treat the region as ready once it matches
+  std::atomic_thread_fence(std::memory_order_release);
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+
+  facilities.reserve(MAX_FACILITIES);
+  Logger::Info("TelemetryPublisher: Publishing {} ({} KB)", memory.getName(), sizeof(Region) / 1024);
+}
+
+int TelemetryPublisher::facilityIndex(const Module *module) const {
+  if (!module)
+    return -1;
+  auto it = std::find(facilities.begin(), facilities.end(), module);
+  return it == facilities.end() ? -1 : (int)(it - facilities.begin());
+}
+
+void TelemetryPublisher::publish(double dt, double tickMicros) {
+  tick++;
+  simSeconds += dt;
+
+  uint32_t next = (region->header.latest.load(std::memory_order_relaxed) + 1) % SLOT_COUNT;
+  Slot &slot = region->slots[next];
+
+  // Seqlock: odd while writing. Readers of this slot started at least a tick ago and will retry.
+  uint64_t sequence = slot.sequence.load(std::memory_order_relaxed);
+  slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  fill(slot, tickMicros);
+
+  slot.sequence.store(sequence + 2, std::memory_order_release);
+  region->header.latest.store(next, std::memory_order_release);
+}
+
+void TelemetryPublisher::fill(Slot &slot, double tickMicros) {
+  TickStats &stats = slot.stats;
+  std::memset(&stats, 0, sizeof(stats));
+  stats.tick = tick;
+  stats.simSeconds = simSeconds;
+  stats.tickMicros = tickMicros;
+  stats.governorStage = (uint8_t)(governor ? governor->getStage() : GovernorStage::Normal);
+  stats.demotedCars = (uint16_t)std::min(entityManager.getDemotedCount(), 65535);
+  stats.speedFactor = governor ? (float)governor->getSpeedFactor() : 1.0f;
+
+  // Facilities first so cars can reference them by index
+  facilities.clear();
+  int totalSpots = 0;
+  int occupiedSpots = 0;
+  for (const auto &module : entityManager.getModules()) {
+    if (!IsFacility(module->getType()) || facilities.size() >= MAX_FACILITIES)
+      continue;
+
+    FacilityRecord &record = slot.facilities[facilities.size()];
+    facilities.push_back(module.get());
+
+    Module::SpotCounts counts = module->getSpotCounts();
+    size_t spotCount = module->getSpotCount();
+    float priceSum = 0.0f;
+    for (size_t i = 0; i < spotCount; ++i) {
+      priceSum += module->getSpot((int)i).price;
+    }
+
+    record = FacilityRecord{};
+    record.x = (float)module->worldPosition.x();
+    record.y = (float)module->worldPosition.y();
+    record.priceMultiplier = module->getPriceMultiplier();
+    record.meanSpotPrice = spotCount > 0 ? priceSum / (float)spotCount : 0.0f;
+    record.spotCount = (uint16_t)spotCount;
+    record.freeSpots = (uint16_t)counts.free;
+    record.reservedSpots = (uint16_t)counts.reserved;
+    record.occupiedSpots = (uint16_t)counts.occupied;
+    record.type = (uint8_t)module->getType();
+
+    totalSpots += (int)spotCount;
+    occupiedSpots += counts.occupied;
+  }
+  stats.facilityCount = (uint32_t)facilities.size();
+  stats.occupancy = totalSpots > 0 ? (float)occupiedSpots / (float)totalSpots : 0.0f;
+
+  const auto &cars = entityManager.getCars();
+  stats.carCount = (uint32_t)cars.size();
+  stats.carsDropped = stats.carCount - std::min<uint32_t>(stats.carCount, MAX_CARS);
+
+  for (uint32_t i = 0; i < stats.carCount; ++i) {
+    const Car &car = *cars[i];
+    stats.carsByState[(size_t)car.getState()]++;
+    if (i >= MAX_CARS)
+      continue;
+
+    CarRecord &record = slot.cars[i];
+    int facility = facilityIndex(car.getParkedFacility());
+    record.id = car.getId();
+    record.x = (float)car.getPosition().x();
+    record.y = (float)car.getPosition().y();
+    record.rotation = car.getRotation();
+    record.speed = Vector2Length(car.getVelocity());
+    record.battery = car.getBatteryLevel();
+    record.state = (uint8_t)car.getState();
+    record.type = (uint8_t)car.getType();
+    record.priority = (uint8_t)car.getPriority();
+    record.flags = car.getEnteredFromLeft() ? 1 : 0;
+    record.facility = (int16_t)facility;
+    record.spot = (int16_t)(facility >= 0 ? car.getParkedSpotIndex() : -1);
+  }
+}
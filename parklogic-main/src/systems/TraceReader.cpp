@@ -0,0 +1,244 @@
+#include "systems/TraceReader.hpp"
+#include "core/Logger.hpp"
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string_view>
+
+/**
+ * @file TraceReader.cpp
+ * @brief CSV and binary gate log parsing.
+ */
+
+namespace {
+
+constexpr char BINARY_MAGIC[8] = {'P', 'L', 'T', 'R', 'A', 'C', 'E', '1'};
+constexpr size_t BINARY_RECORD_SIZE = 24;
+constexpr uint32_t FLAG_ELECTRIC = 1u;
+constexpr int MAX_MALFORMED_WARNINGS = 5;
+
+/**
+ * @brief On-disk binary record (little-endian, 24 bytes).
+ */
+struct BinaryRecord {
+  double time;
+  float dwell;
+  float battery;
+  uint32_t flags;
+  uint32_t reserved;
+};
+static_assert(sizeof(BinaryRecord) == BINARY_RECORD_SIZE, "Binary trace record layout changed");
+
+std::string_view trim(std::string_view s) {
+  while (!s.empty() && (s.front() == ' ' || s.front() == '\t' || s.front() == '"'))
+    s.remove_prefix(1);
+  while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '"' || s.back() == '\r'))
+    s.remove_suffix(1);
+  return s;
+}
+
+bool parseDouble(std::string_view s, double &out) {
+  auto [ptr, ec] = std::from_chars(s.data(), s.data() + s.size(), out);
+  return ec == std::errc() && ptr == s.data() + s.size();
+}
+
+bool parseDigits(std::string_view s, size_t pos, size_t count, int &out) {
+  if (pos + count > s.size())
+    return false;
+  auto [ptr, ec] = std::from_chars(s.data() + pos, s.data() + pos + count, out);
+  return ec == std::errc() && ptr == s.data() + pos + count;
+}
+
+/**
+ * @brief Days since 1970-01-01 of a proleptic Gregorian date (H. Hinnant's days_from_civil).
+ */
+int64_t daysFromCivil(int y, int m, int d) {
+  y -= m <= 2;
+  const int64_t era = (y >= 0 ? y : y - 399) / 400;
+  const int64_t yoe = y - era * 400;
+  const int64_t doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+  const int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + doe - 719468;
+}
+
+/**
+ * @brief Seconds or `YYYY-MM-DD[T ]HH:MM:SS[.fff][Z]` (read as UTC).
+ */
+bool parseTimestamp(std::string_view s, double &out) {
+  if (parseDouble(s, out))
+    return true;
+
+  int y, mo, d, h, mi, sec;
+  if (s.size() < 19 || s[4] != '-' || s[7] != '-' || (s[10] != 'T' && s[10] != ' ') || s[13] != ':' ||
+      s[16] != ':')
+    return false;
+  if (!parseDigits(s, 0, 4, y) || !parseDigits(s, 5, 2, mo) || !parseDigits(s, 8, 2, d) ||
+      !parseDigits(s, 11, 2, h) || !parseDigits(s, 14, 2, mi) || !parseDigits(s, 17, 2, sec))
+    return false;
+  if (mo < 1 || mo > 12 || d < 1 || d > 31 || h > 23 || mi > 59 || sec > 60)
+    return false;
+
+  double fraction = 0.0;
+  std::string_view rest = s.substr(19);
+  if (!rest.empty() && rest.back() == 'Z')
+    rest.remove_suffix(1);
+  if (!rest.empty()) {
+    // Only a fractional second may follow (no UTC offsets: logs are expected in one zone)
+    if (rest.front() != '.' || !parseDouble(rest, fraction))
+      return false;
+  }
+
+  out = (double)daysFromCivil(y, mo, d) * 86400.0 + h * 3600.0 + mi * 60.0 + sec + fraction;
+  return true;
+}
+
+bool isElectricClass(std::string_view s) {
+  auto lower = [](char c) { return (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c; };
+  auto equals = [&](std::string_view word) {
+    if (s.size() != word.size())
+      return false;
+    for (size_t i = 0; i < s.size(); ++i) {
+      if (lower(s[i]) != word[i])
+        return false;
+    }
+    return true;
+  };
+  return equals("ev") || equals("electric") || equals("bev") || equals("phev");
+}
+
+} // namespace
+
+TraceReader::TraceReader(const std::string &path) : path(path), file(path) {
+  if (file.size() >= sizeof(BINARY_MAGIC) && std::memcmp(file.data(), BINARY_MAGIC, sizeof(BINARY_MAGIC)) == 0) {
+    binary = true;
+    offset = sizeof(BINARY_MAGIC);
+    if ((file.size() - offset) % BINARY_RECORD_SIZE != 0)
+      throw std::runtime_error("TraceReader: truncated binary trace " + path);
+  }
+  Logger::Info("TraceReader: opened {} ({} format, {} MB)", path, binary ? "binary" : "CSV",
+               file.size() / (1024 * 1024));
+}
+
+bool TraceReader::next(TraceRecord &out) {
+  bool ok = binary ? nextBinary(out) : nextCsv(out);
+  if (!ok)
+    return false;
+
+  // Gate logs from several lanes can interleave slightly out of order
+  if (out.time < lastTime) {
+    out.time = lastTime;
+    reordered++;
+  }
+  lastTime = out.time;
+  recordsRead++;
+
+  file.releaseBefore(offset);
+  return true;
+}
+
+bool TraceReader::nextBinary(TraceRecord &out) {
+  if (offset + BINARY_RECORD_SIZE > file.size())
+    return false;
+
+  BinaryRecord rec;
+  std::memcpy(&rec, file.data() + offset, BINARY_RECORD_SIZE);
+  offset += BINARY_RECORD_SIZE;
+
+  out.time = rec.time;
+  out.type = (rec.flags & FLAG_ELECTRIC) ? Car::CarType::ELECTRIC : Car::CarType::COMBUSTION;
+  out.dwell = rec.dwell;
+  out.battery = rec.battery;
+  return true;
+}
+
+bool TraceReader::nextCsv(TraceRecord &out) {
+  const char *data = file.data();
+  size_t size = file.size();
+
+  while (offset < size) {
+    const char *begin = data + offset;
+    const char *newline = static_cast<const char *>(std::memchr(begin, '\n', size - offset));
+    const char *end = newline ? newline : data + size;
+    offset = (size_t)(end - data) + (newline ? 1 : 0);
+
+    std::string_view line = trim(std::string_view(begin, (size_t)(end - begin)));
+    if (line.empty() || line.front() == '#')
+      continue;
+
+    bool first = firstLine;
+    firstLine = false;
+    if (parseCsvLine(line.data(), line.data() + line.size(), out))
+      return true;
+
+    // A first line that does not parse is the column header
+    if (first)
+      continue;
+
+    malformed++;
+    if (malformed <= MAX_MALFORMED_WARNINGS) {
+      Logger::Warn("TraceReader: skipping malformed line '{}'", std::string(line.substr(0, 80)));
+    }
+  }
+  return false;
+}
+
+bool TraceReader::parseCsvLine(const char *begin, const char *end, TraceRecord &out) {
+  std::string_view fields[4];
+  int count = 0;
+
+  std::string_view rest(begin, (size_t)(end - begin));
+  while (count < 4) {
+    size_t comma = rest.find(',');
+    fields[count++] = trim(rest.substr(0, comma));
+    if (comma == std::string_view::npos)
+      break;
+    rest.remove_prefix(comma + 1);
+  }
+  if (count < 2)
+    return false;
+
+  TraceRecord rec;
+  if (!parseTimestamp(fields[0], rec.time))
+    return false;
+  rec.type = isElectricClass(fields[1]) ? Car::CarType::ELECTRIC : Car::CarType::COMBUSTION;
+
+  double value;
+  if (count > 2 && !fields[2].empty()) {
+    if (!parseDouble(fields[2], value) || value < 0.0)
+      return false;
+    rec.dwell = (float)value;
+  }
+  if (count > 3 && !fields[3].empty()) {
+    if (!parseDouble(fields[3], value))
+      return false;
+    if (value < 0.0 || value > 100.0)
+      return false; // Percent, like Car::batteryLevel
+    rec.battery = (float)value;
+  }
+
+  out = rec;
+  return true;
+}
+
+uint64_t TraceReader::ConvertToBinary(const std::string &inputPath, const std::string &outputPath) {
+  TraceReader reader(inputPath);
+
+  std::ofstream output(outputPath, std::ios::binary | std::ios::trunc);
+  if (!output)
+    throw std::runtime_error("TraceReader: cannot write " + outputPath);
+  output.write(BINARY_MAGIC, sizeof(BINARY_MAGIC));
+
+  TraceRecord rec;
+  while (reader.next(rec)) {
+    BinaryRecord out{rec.time, rec.dwell, rec.battery, rec.type == Car::CarType::ELECTRIC ? FLAG_ELECTRIC : 0u, 0u};
+    output.write(reinterpret_cast<const char *>(&out), sizeof(out));
+  }
+
+  if (!output)
+    throw std::runtime_error("TraceReader: write failed for " + outputPath);
+
+  Logger::Info("TraceReader: wrote {} records to {} ({} malformed lines skipped, {} reordered)",
+               reader.getRecordsRead(), outputPath, reader.getMalformed(), reader.getReordered());
+  return reader.getRecordsRead();
+}
@@ -0,0 +1,87 @@
+#include "systems/TrafficPolicy.hpp"
+#include "config.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+/**
+ * @file TrafficPolicy.cpp
+ * @brief Implementation of the shared driver decision rules.
+ */
+
+namespace TrafficPolicy {
+
+// Peak leave rate (1/s) reached at BATTERY_FORCE_EXIT_THRESHOLD
+static constexpr float CHARGING_EXIT_PEAK_HAZARD = 0.5f;
+
+bool ShouldSeekCharging(Car::CarType type, float battery, float roll) {
+  if (type != Car::CarType::ELECTRIC)
+    return false;
+
+  if (battery < Config::BATTERY_LOW_THRESHOLD)
+    return true;
+  if (battery > Config::BATTERY_HIGH_THRESHOLD)
+    return false;
+
+  // Weighted Random: Higher battery -> Lower chance to charge
+  float t = (battery - Config::BATTERY_LOW_THRESHOLD) / (Config::BATTERY_HIGH_THRESHOLD - Config::BATTERY_LOW_THRESHOLD);
+  return roll >= t;
+}
+
+bool Accepts(ModuleType facility, Car::CarType type, bool seekCharging) {
+  if (type == Car::CarType::ELECTRIC && seekCharging)
+    return IsCharging(facility);
+  return IsParking(facility);
+}
+
+int ChooseOffer(std::span<const FacilityOffer> offers, Car::Priority priority) {
+  int best = -1;
+  float bestMetric = std::numeric_limits<float>::max();
+
+  for (int i = 0; i < (int)offers.size(); ++i) {
+    float metric = (priority == Car::Priority::PRIORITY_DISTANCE) ? offers[i].distance : offers[i].price;
+    if (metric < bestMetric) {
+      bestMetric = metric;
+      best = i;
+    }
+  }
+  return best;
+}
+
+float ChargingExitHazard(float battery) {
+  if (battery > Config::BATTERY_FORCE_EXIT_THRESHOLD)
+    return std::numeric_limits<float>::infinity();
+  if (battery <= Config::BATTERY_EXIT_THRESHOLD)
+    return 0.0f;
+
+  float range = Config::BATTERY_FORCE_EXIT_THRESHOLD - Config::BATTERY_EXIT_THRESHOLD;
+  float excess = battery - Config::BATTERY_EXIT_THRESHOLD;
+  return CHARGING_EXIT_PEAK_HAZARD * (excess / range);
+}
+
+bool ShouldLeaveCharger(float battery, float dt, float roll) {
+  if (battery > Config::BATTERY_FORCE_EXIT_THRESHOLD)
+    return true;
+  return roll < ChargingExitHazard(battery) * dt;
+}
+
+float SampleChargingExitLevel(float battery, float exponentialDraw) {
+  // With the battery rising at CHARGING_RATE, the hazard is linear in the excess x over the exit
+  // threshold: h(x) = k * x per second, so the cumulative hazard is k * x^2 / (2 * CHARGING_RATE).
+  // Setting H(x) - H(x0) = E and solving for x gives the departure level.
+  float range = Config::BATTERY_FORCE_EXIT_THRESHOLD - Config::BATTERY_EXIT_THRESHOLD;
+  float k = CHARGING_EXIT_PEAK_HAZARD / range;
+
+  float x0 = std::max(0.0f, battery - Config::BATTERY_EXIT_THRESHOLD);
+  float x = std::sqrt(x0 * x0 + 2.0f * Config::CHARGING_RATE * exponentialDraw / k);
+
+  return std::min(Config::BATTERY_EXIT_THRESHOLD + x, Config::BATTERY_FORCE_EXIT_THRESHOLD);
+}
+
+bool ExitRight(Car::Priority priority, bool enteredFromLeft, float roll) {
+  if (priority == Car::Priority::PRIORITY_DISTANCE)
+    return !enteredFromLeft;
+  return roll >= 0.5f;
+}
+
+} // namespace TrafficPolicy
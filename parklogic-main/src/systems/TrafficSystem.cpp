@@ -1,497 +1,422 @@
 #include "systems/TrafficSystem.hpp"
 #include "config.hpp" // Added for lane offsets
+#include "core/FrameArena.hpp"
 #include "core/Logger.hpp"
+#include "core/MemoryStats.hpp"
+#include "core/SystemScheduler.hpp"
 #include "entities/map/Modules.hpp"
 #include "events/GameEvents.hpp"
 #include "systems/PathPlanner.hpp"
+#include "systems/TraceReader.hpp"
+#include "systems/TrafficPolicy.hpp"
 
 #include "entities/Car.hpp"
 #include "raymath.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
 
 /**
  * @file TrafficSystem.cpp
  * @brief Implementation of the Traffic System.
  */
 
-TrafficSystem::TrafficSystem(std::shared_ptr<EventBus> bus, const EntityManager &em)
-    : eventBus(bus), entityManager(em) {
+TrafficSystem::TrafficSystem(std::shared_ptr<EventBus> bus, const EntityManager &em, uint64_t demandSeed)
+    : eventBus(bus), entityManager(em), demand(demandSeed) {
+
+  // Backpressure caps the population at its size when the governor reached that stage
+  eventTokens.push_back(eventBus->subscribe<LoadGovernorEvent>([this](const LoadGovernorEvent &e) {
+    bool engaged = e.stage == GovernorStage::Backpressure;
+    if (engaged && carLimit == 0) {
+      carLimit = std::max<size_t>(1, entityManager.getCars().size());
+      Logger::Info("TrafficSystem: backpressure, arrivals wait above {} cars", carLimit);
+    } else if (!engaged && carLimit != 0) {
+      carLimit = 0;
+      Logger::Info("TrafficSystem: backpressure released");
+    }
+  }));
 
   // Cycle Auto Spawn Level
   eventTokens.push_back(eventBus->subscribe<CycleAutoSpawnLevelEvent>([this](const CycleAutoSpawnLevelEvent &) {
-    currentSpawnLevel++;
-    if (currentSpawnLevel > 5)
-      currentSpawnLevel = 0; // 0 to 5
+    setSpawnLevel(currentSpawnLevel >= 5 ? 0 : currentSpawnLevel + 1); // 0 to 5
+  }));
+
+  // Set Auto Spawn Level directly (control socket, headless runs)
+  eventTokens.push_back(eventBus->subscribe<SetAutoSpawnLevelEvent>(
+      [this](const SetAutoSpawnLevelEvent &e) { setSpawnLevel(std::clamp(e.level, 0, 5)); }));
+
+  // Replay a recorded gate log instead of the profile's arrival process
+  eventTokens.push_back(eventBus->subscribe<LoadDemandTraceEvent>([this](const LoadDemandTraceEvent &e) {
+    try {
+      demand.setTrace(std::make_unique<TraceReader>(e.path));
+      Logger::Info("TrafficSystem: Replaying demand trace {}", e.path);
+    } catch (const std::exception &ex) {
+      Logger::Error("TrafficSystem: Cannot load demand trace: {}", ex.what());
+    }
+  }));
 
-    Logger::Info("TrafficSystem: Auto-Spawn Level set to {}", currentSpawnLevel);
-    eventBus->publish(AutoSpawnLevelChangedEvent{currentSpawnLevel});
+  // Cycle Demand Profile (Fixed -> Commuter -> Stress)
+  eventTokens.push_back(eventBus->subscribe<CycleDemandProfileEvent>([this](const CycleDemandProfileEvent &) {
+    demandProfileIndex = (demandProfileIndex + 1) % 3;
+    applyDemandProfile();
+
+    // Report the selected mode even while auto-spawn is off (the active profile is then "Off")
+    static constexpr const char *names[] = {"Fixed", "Commuter", "Stress"};
+    Logger::Info("TrafficSystem: Demand profile set to {}", names[demandProfileIndex]);
+    eventBus->publish(DemandProfileChangedEvent{names[demandProfileIndex]});
   }));
 
-  // 1. Handle Spawn Request -> Find Position -> Publish CreateCarEvent
+  // 1. Handle Spawn Request -> queue an extra arrival; it enters with the next free lane slot
   eventTokens.push_back(eventBus->subscribe<SpawnCarRequestEvent>([this](const SpawnCarRequestEvent &) {
     Logger::Info("TrafficSystem: Processing Spawn Request...");
+    demand.requestArrival();
+  }));
 
-    const auto &modules = entityManager.getModules();
-    if (modules.empty())
-      return;
-
-    // Find Leftmost and Rightmost Roads
-    const Module *leftRoad = nullptr;
-    const Module *rightRoad = nullptr;
-    float minX = std::numeric_limits<float>::max();
-    float maxRightX = std::numeric_limits<float>::lowest();
-
-    for (const auto &mod : modules) {
-      // We assume external roads are NormalRoads
-      if (auto *r = dynamic_cast<NormalRoad *>(mod.get())) {
-        float x = r->worldPosition.x;
-        float w = r->getWidth();
-
-        if (x < minX) {
-          minX = x;
-          leftRoad = r;
-        }
+  // 2. Handle Car Spawned -> Calculate Path -> Publish AssignPathEvent
+  eventTokens.push_back(
+      eventBus->subscribe<CarSpawnedEvent>([this](const CarSpawnedEvent &e) { assignDestination(e.car); }));
+}
+
+TrafficSystem::~TrafficSystem() { eventTokens.clear(); }
+
+void TrafficSystem::assignDestination(Car *car) {
+  ProfileZoneScope zone(ProfileZone::TrafficHandler);
+
+  std::pmr::vector<Module *> facilities(FrameArena::Get().resource());
+  const auto &modules = entityManager.getModules();
+  facilities.reserve(modules.size());
+
+  Car::CarType type = car->getType();
+  float battery = car->getBatteryLevel();
+
+  bool seekCharging = TrafficPolicy::ShouldSeekCharging(type, battery, (float)GetRandomValue(0, 100) / 100.0f);
+
+  // Filter Facilities
+  for (const auto &mod : modules) {
+    if (!mod->isClosed() && TrafficPolicy::Accepts(mod->getType(), type, seekCharging)) {
+      facilities.push_back(mod.get());
+    }
+  }
 
-        if (x + w > maxRightX) {
-          maxRightX = x + w;
-          rightRoad = r;
+  if (facilities.empty()) {
+    Logger::Warn("TrafficSystem: No suitable facilities found for Car Type {} (SeekCharging: {}).", (int)type,
+                 seekCharging);
+    // Fallback: an EV that wanted to charge but has no charging stations on the map parks instead
+    if (seekCharging) {
+      for (const auto &mod : modules) {
+        if (!mod->isClosed() && TrafficPolicy::IsParking(mod->getType())) {
+          facilities.push_back(mod.get());
         }
       }
     }
 
-    if (!leftRoad && !rightRoad) {
-      Logger::Error("TrafficSystem: No roads found to spawn cars.");
-      return;
-    }
+    // Nothing open at all (e.g. every facility removed or closed at runtime): pass through
+    if (facilities.empty())
+      Logger::Warn("TrafficSystem: Absolutely no facilities found.");
+  }
 
-    // Randomly choose side
-    bool spawnLeft = (GetRandomValue(0, 1) == 0);
+  Car::Priority priority = car->getPriority();
+  WorldCoord carPos = car->getPosition();
 
-    // If one side is missing, force the other
-    if (!leftRoad)
-      spawnLeft = false;
-    if (!rightRoad)
-      spawnLeft = true;
+  Logger::Info("TrafficSystem: Selecting facility for Car (Pri: {})", (int)priority);
 
-    Vector2 spawnPos = {0, 0};
-    Vector2 spawnVel = {0, 0};
-    float speed = 15.0f; // Initial speed (matches max speed roughly)
+  // One random free spot per facility competes. Comparing random spots instead of every spot
+  // minimizes facility interaction; in-facility price variance is small ($0.5) next to the
+  // difference between facilities ($10 vs $2), so finding the right FACILITY is what matters.
+  std::pmr::vector<FacilityOffer> offers(FrameArena::Get().resource());
+  offers.reserve(facilities.size());
+  for (int i = 0; i < (int)facilities.size(); ++i) {
+    Module *fac = facilities[i];
+    int idx = fac->getRandomSpotIndex();
+    if (idx == -1)
+      continue; // Full
 
-    float pixelsPerMeter = static_cast<float>(Config::ART_PIXELS_PER_METER);
+    offers.push_back({i, idx, WorldCoord::Distance(carPos, fac->worldPosition), fac->getSpotPrice(idx)});
+  }
 
-    if (spawnLeft) {
-      // Spawn Left -> Drive Right
-      float laneOffset = (float)Config::LANE_OFFSET_DOWN / pixelsPerMeter;
+  int choice = TrafficPolicy::ChooseOffer(offers, priority);
+  Module *targetFac = (choice != -1) ? facilities[offers[choice].facility] : nullptr;
 
-      // Note: road->worldPosition is Top-Left of the module in World Coordinates.
-      // Lane offset is usually relative to the top of the road asset.
+  // --- New Spot-Based Pathfinding (via PathPlanner) ---
 
-      spawnPos.x = leftRoad->worldPosition.x;
-      spawnPos.y = leftRoad->worldPosition.y + laneOffset;
+  // 1. Determine Spot
+  int spotIndex = (choice != -1) ? offers[choice].spot : -1;
 
-      spawnVel = {speed, 0};
-      Logger::Info("Spawning Car LEFT at ({}, {})", spawnPos.x, spawnPos.y);
+  // Reserve the spot immediately. It can only be gone already when spot states are shared with
+  // other shard processes; the car then passes through like on a full map.
+  if (spotIndex != -1 && targetFac && !targetFac->tryReserveSpot(spotIndex)) {
+    Logger::Info("TrafficSystem: Spot taken by another shard.");
+    spotIndex = -1;
+  }
 
-    } else {
-      // Spawn Right -> Drive Left
-      float laneOffset = (float)Config::LANE_OFFSET_UP / pixelsPerMeter;
+  // Handle "Through Traffic" (No spots available)
+  if (spotIndex == -1 || !targetFac) {
+    Logger::Info("TrafficSystem: Facility full (Free: 0). Car passing through.");
 
-      spawnPos.x = rightRoad->worldPosition.x + rightRoad->getWidth();
-      spawnPos.y = rightRoad->worldPosition.y + laneOffset;
+    auto [minRoadX, maxRoadX] = roadExtent();
 
-      spawnVel = {-speed, 0};
-    }
-    // Random Car Type
-    // 50% Combustion, 50% Electric
-    int carType = (GetRandomValue(0, 1) == 0) ? 0 : 1;
+    // Determine direction based on velocity
+    bool movingRight = car->getVelocity().x > 0;
 
-    // Random Priority
-    // 50% Price, 50% Distance
-    int priority = (GetRandomValue(0, 1) == 0) ? 0 : 1;
+    // Target beyond map edge
+    double finalX = movingRight ? (maxRoadX + 2.0) : (minRoadX - 2.0);
+    double yPos = car->getPosition().y(); // Maintain current lane Y
 
-    // Entry Side is determined by spawnLeft
-    // spawnLeft means coming FROM Left (driving Right?)
-    // Logic: if spawnLeft is true, spawnPos is on leftRoad. Velocity is positive X (Right).
-    // So it entered from LEFT.
-    bool enteredFromLeft = spawnLeft;
+    // Create direct exit path
+    std::pmr::vector<Waypoint> exitPath(FrameArena::Get().resource());
+    exitPath.push_back(Waypoint(WorldCoord::FromMeters(finalX, yPos), 1.0f, -1, 0.0f, true));
 
-    eventBus->publish(CreateCarEvent{spawnPos, spawnVel, carType, priority, enteredFromLeft});
-  }));
+    car->setPath(exitPath);
+    car->setState(Car::CarState::EXITING);
 
-  // 2. Handle Car Spawned -> Calculate Path -> Publish AssignPathEvent
-  eventTokens.push_back(eventBus->subscribe<CarSpawnedEvent>([this](const CarSpawnedEvent &e) {
-    // Logger::Info("TrafficSystem: Calculating path for new car...");
-
-    std::vector<Module *> facilities;
-    const auto &modules = entityManager.getModules();
-
-    Car::CarType type = e.car->getType();
-    float battery = e.car->getBatteryLevel();
-
-    bool seekCharging = false;
-
-    if (type == Car::CarType::ELECTRIC) {
-      if (battery < Config::BATTERY_LOW_THRESHOLD) {
-        seekCharging = true;
-      } else if (battery > Config::BATTERY_HIGH_THRESHOLD) {
-        seekCharging = false;
-      } else {
-        // Weighted Random: Higher battery -> Lower chance to charge
-        // Normalize battery between Low (30) and High (70): 0.0 to 1.0
-        float t = (battery - Config::BATTERY_LOW_THRESHOLD) /
-                  (Config::BATTERY_HIGH_THRESHOLD - Config::BATTERY_LOW_THRESHOLD);
-        // Probability to park (not charge) increases with battery
-        if ((float)GetRandomValue(0, 100) / 100.0f < t) {
-          seekCharging = false;
-        } else {
-          seekCharging = true;
-        }
-      }
-    }
+    eventBus->publish(AssignPathEvent{car, std::move(exitPath)});
+    return;
+  }
 
-    // Filter Facilities
-    for (const auto &mod : modules) {
-      if (type == Car::CarType::COMBUSTION) {
-        // Combustion: Parking Only
-        if (dynamic_cast<SmallParking *>(mod.get()) || dynamic_cast<LargeParking *>(mod.get())) {
-          facilities.push_back(mod.get());
-        }
-      } else {
-        // Electric
-        if (seekCharging) {
-          if (dynamic_cast<SmallChargingStation *>(mod.get()) || dynamic_cast<LargeChargingStation *>(mod.get())) {
-            facilities.push_back(mod.get());
-          }
-        } else {
-          if (dynamic_cast<SmallParking *>(mod.get()) || dynamic_cast<LargeParking *>(mod.get())) {
-            facilities.push_back(mod.get());
-          }
-        }
-      }
-    }
+  // Log Reservation
+  auto counts = targetFac->getSpotCounts();
+  Logger::Info("TrafficSystem: Spot Reserved. Facility Status: [Free: {}, Reserved: {}, Occupied: {}]", counts.free,
+               counts.reserved, counts.occupied);
 
-    if (facilities.empty()) {
-      Logger::Warn("TrafficSystem: No suitable facilities found for Car Type {} (SeekCharging: {}).", (int)type,
-                   seekCharging);
-      // Fallback: If electric wanted to charge but can't, try parking?
-      // Or just leave.
-      // Try fallback to parking if charging failed
-      if (find_if(facilities.begin(), facilities.end(), [](Module *) { return true; }) == facilities.end() &&
-          seekCharging) {
-        for (const auto &mod : modules) {
-          if (dynamic_cast<SmallParking *>(mod.get()) || dynamic_cast<LargeParking *>(mod.get())) {
-            facilities.push_back(mod.get());
-          }
-        }
-      }
+  Spot spot = targetFac->getSpot(spotIndex);
 
-      if (facilities.empty()) {
-        Logger::Error("TrafficSystem: Absolutely no facilities found.");
-        return;
-      }
-    }
+  // 2. Generate Path
+  std::pmr::vector<Waypoint> path = PathPlanner::GeneratePath(car, targetFac, spot);
 
-    if (facilities.empty()) {
-      Logger::Error("TrafficSystem: No suitable facilities found.");
-      return;
-    }
+  // Store context in Car so it knows where it is when it wants to leave
+  car->setParkingContext(targetFac, spot, spotIndex);
 
-    Module *targetFac = nullptr;
-    int bestSpotIndex = -1;
-    float bestMetric = std::numeric_limits<float>::max(); // Price or Distance
-
-    Car::Priority priority = e.car->getPriority();
-    Vector2 carPos = e.car->getPosition();
-
-    Logger::Info("TrafficSystem: Selecting facility for Car (Pri: {})", (int)priority);
-
-    if (priority == Car::Priority::PRIORITY_DISTANCE) {
-      // Closest Facility with Available Spots
-      for (auto *fac : facilities) {
-        // Check if full
-        if (fac->getSpotCounts().free == 0)
-          continue;
-
-        // Metric: Distance (Manhattan or Euclidean? Euclidean is fine)
-        // Use WorldPosition X primarily? User said: "closest facility to the entrace... that's also available"
-        // e.car->getPosition() is the spawn point right now.
-        float dist = Vector2Distance(carPos, fac->worldPosition);
-
-        if (dist < bestMetric) {
-          // Check if actually has valid spot index
-          int idx = fac->getRandomSpotIndex(); // Random valid spot in this facility
-          if (idx != -1) {
-            bestMetric = dist;
-            targetFac = fac;
-            bestSpotIndex = idx;
-          }
-        }
-      }
-    } else {
-      // Price Priority: Cheapest Spot globally
-      // Revised Approach for Price:
-      // 1. Iterate all facilities.
-      // 2. For each facility, try to find a free spot.
-      // 3. Finding the cheapest FACILITY is 90% of the battle.
-      //    We compare one random available spot from each facility.
-
-      // Revised Approach for Price:
-      // 1. Iterate all facilities.
-      // 2. For each facility, try to find a free spot.
-      // 3. Since we can't iterate all spots easily, let's trust `getRandomSpotIndex`.
-      //    It returns a random FREE spot.
-      //    We compare the price of these candidates.
-      //    This minimizes facilities interaction but might miss a slightly cheaper spot IN the same facility.
-      //    But variance is small ($0.5). Facility diff is Large ($10 vs $2).
-      //    So finding cheapest FACILITY is 90% of the battle.
-
-      for (auto *fac : facilities) {
-        int idx = fac->getRandomSpotIndex();
-        if (idx == -1)
-          continue; // Full
+  // Publish Path Assignment
+  eventBus->publish(AssignPathEvent{car, std::move(path)});
+}
 
-        Spot s = fac->getSpot(idx);
-        if (s.price < bestMetric) {
-          bestMetric = s.price;
-          targetFac = fac;
-          bestSpotIndex = idx;
-        }
-      }
-    }
+void TrafficSystem::schedule(SystemScheduler &scheduler) {
+  using S = SystemScheduler;
+  scheduler.add({"traffic.spawn", S::Stage::Traffic, 0, S::DEMAND | S::CARS | S::FACILITIES,
+                 Config::Scheduler::SPAWN_RATE, [this](double dt) { admitArrivals(dt); }});
+  scheduler.add({"traffic.lifecycle", S::Stage::Traffic, 0, S::CARS | S::FACILITIES, Config::TICK_RATE,
+                 [this](double) { updateLifecycle(); }});
+  scheduler.add({"traffic.parked", S::Stage::Traffic, 0, S::CARS | S::FACILITIES, Config::Scheduler::PARKED_RATE,
+                 [this](double dt) { updateParkedCars(dt); }});
+}
+
+void TrafficSystem::admitArrivals(double dt) {
+  ProfileZoneScope zone(ProfileZone::TrafficHandler);
+
+  // Demand: move due arrivals into the lane queues, then admit while the entry lanes have room
+  demand.advance(dt);
+
+  if (!demand.hasWaiting(true) && !demand.hasWaiting(false))
+    return;
 
-    if (!targetFac || bestSpotIndex == -1) {
-      // Fallback: Random
-      if (!facilities.empty()) {
-        targetFac = facilities[GetRandomValue(0, (int)facilities.size() - 1)];
-        bestSpotIndex = targetFac->getRandomSpotIndex();
+  SpawnPoints spawn = findSpawnPoints();
+  for (int side = 0; side < 2; ++side) {
+    bool fromLeft = (side == 1);
+    // Without a road on this side the arrivals take the other one (like the old spawner)
+    int lane = spawn.has[side] ? side : 1 - side;
+    if (!spawn.has[lane])
+      break;
+
+    // Another shard owns this entry and draws its own arrivals for it
+    if (!entryEnabled[lane]) {
+      while (demand.hasWaiting(fromLeft)) {
+        demand.admit(fromLeft);
       }
+      continue;
     }
 
-    // --- New Spot-Based Pathfinding (via PathPlanner) ---
-
-    // 1. Determine Spot
-    int spotIndex = bestSpotIndex;
-    // If still -1, try one more time
-    if (targetFac && spotIndex == -1)
-      spotIndex = targetFac->getRandomSpotIndex();
-
-    // Handle "Through Traffic" (No spots available)
-    if (spotIndex == -1 || !targetFac) {
-      Logger::Info("TrafficSystem: Facility full (Free: 0). Car passing through.");
-
-      // Calculate Map Bounds (Duplicated logic for now, or could act as if exiting)
-      float minRoadX = std::numeric_limits<float>::max();
-      float maxRoadX = std::numeric_limits<float>::lowest();
-      const auto &mods = entityManager.getModules();
-      for (const auto &mod : mods) {
-        if (auto *r = dynamic_cast<NormalRoad *>(mod.get())) {
-          float x = r->worldPosition.x;
-          float w = r->getWidth();
-          if (x < minRoadX)
-            minRoadX = x;
-          if (x + w > maxRoadX)
-            maxRoadX = x + w;
-        }
-      }
-      if (minRoadX == std::numeric_limits<float>::max())
-        minRoadX = 0;
-      if (maxRoadX == std::numeric_limits<float>::lowest())
-        maxRoadX = 100;
+    while (demand.hasWaiting(fromLeft) && isLaneClear(spawn.pos[lane]) &&
+           (carLimit == 0 || entityManager.getCars().size() < carLimit)) {
+      Arrival arrival = demand.admit(fromLeft);
+      arrival.fromLeft = (lane == 1);
+      spawnCar(arrival, spawn.pos[lane]);
+    }
+  }
+}
 
-      // Determine direction based on velocity
-      bool movingRight = e.car->getVelocity().x > 0;
+void TrafficSystem::updateLifecycle() {
+  ProfileZoneScope zone(ProfileZone::TrafficHandler);
 
-      // Target beyond map edge
-      float finalX = movingRight ? (maxRoadX + 2.0f) : (minRoadX - 2.0f);
-      float yPos = e.car->getPosition().y; // Maintain current lane Y
+  // List of cars to remove (pointers), tick-scoped scratch
+  std::pmr::vector<Car *> carsToRemove(FrameArena::Get().resource());
 
-      // Create direct exit path
-      std::vector<Waypoint> exitPath;
-      exitPath.push_back(Waypoint({finalX, yPos}, 1.0f, -1, 0.0f, true));
+  for (const auto &carPtr : entityManager.getCars()) {
+    Car *car = carPtr.get();
+    if (!car)
+      continue;
 
-      e.car->setPath(exitPath);
-      e.car->setState(Car::CarState::EXITING);
+    // Check for Arrival (Transition RESERVED -> OCCUPIED)
+    if (car->getState() == Car::CarState::ALIGNING || car->getState() == Car::CarState::PARKED) {
+      Module *fac = const_cast<Module *>(car->getParkedFacility());
+      int idx = car->getParkedSpotIndex();
+      if (fac && idx != -1) {
+        Spot s = fac->getSpot(idx);
+        if (s.state == SpotState::RESERVED) {
+          fac->setSpotState(idx, SpotState::OCCUPIED);
+        }
+      }
+    }
 
-      eventBus->publish(AssignPathEvent{e.car, exitPath});
-      return;
+    // Check if finished exiting
+    if (car->getState() == Car::CarState::EXITING && car->hasArrived()) {
+      carsToRemove.push_back(car);
     }
+  }
 
-    // Reserve the spot immediately
-    targetFac->setSpotState(spotIndex, SpotState::RESERVED);
+  for (Car *c : carsToRemove) {
+    c->stampTrip(TripMilestone::Despawn);
+    const_cast<EntityManager &>(entityManager).removeCar(c);
+  }
+}
 
-    // Log Reservation
-    auto counts = targetFac->getSpotCounts();
-    Logger::Info("TrafficSystem: Spot Reserved. Facility Status: [Free: {}, Reserved: {}, Occupied: {}]", counts.free,
-                 counts.reserved, counts.occupied);
+void TrafficSystem::updateParkedCars(double dt) {
+  ProfileZoneScope zone(ProfileZone::TrafficHandler);
 
-    Spot spot = targetFac->getSpot(spotIndex);
+  // Calculate World Road Boundaries
+  auto [minRoadX, maxRoadX] = roadExtent();
 
-    // 2. Generate Path
-    std::vector<Waypoint> path = PathPlanner::GeneratePath(e.car, targetFac, spot);
+  for (const auto &carPtr : entityManager.getCars()) {
+    Car *car = carPtr.get();
+    if (!car || car->getState() != Car::CarState::PARKED)
+      continue;
 
-    // Store context in Car so it knows where it is when it wants to leave
-    e.car->setParkingContext(targetFac, spot, spotIndex);
+    // Handle Parked Logic (Charging vs Waiting)
+    bool shouldExit = false;
+    Module *fac = const_cast<Module *>(car->getParkedFacility());
 
-    // Publish Path Assignment
-    eventBus->publish(AssignPathEvent{e.car, path});
-  }));
+    bool isChargingSpot = fac && TrafficPolicy::IsCharging(fac->getType());
 
-  // 3. Handle Game Update
-  eventTokens.push_back(eventBus->subscribe<GameUpdateEvent>([this](const GameUpdateEvent &e) {
-    // Auto-Spawn Logic
-    if (currentSpawnLevel > 0) {
-      spawnTimer += (float)e.dt;
-      float interval = Config::Spawner::SPAWN_RATES[currentSpawnLevel];
-      if (spawnTimer >= interval) {
-        spawnTimer =
-            0.0f; // Reset or subtract? Subtract to keep cadence? Reset logic is simpler for 'interval' changes.
-        // Let's subtract to avoid drift, but since interval can change, reset might be safer if level changes.
-        // Given the requirement, simple reset is fine.
-        // Actually, if we change levels, timer should probably reset or be clamped.
-        spawnCar();
+    if (isChargingSpot && car->getType() == Car::CarType::ELECTRIC) {
+      car->charge(Config::CHARGING_RATE * (float)dt);
+      // A replayed dwell overrides the charging hazard
+      shouldExit = car->hasParkingDuration()
+                       ? car->isReadyToLeave()
+                       : TrafficPolicy::ShouldLeaveCharger(car->getBatteryLevel(), (float)dt,
+                                                           (float)GetRandomValue(0, 10000) / 10000.0f);
+    } else {
+      if (car->isReadyToLeave()) {
+        shouldExit = true;
       }
     }
 
-    // We use getCars() directly
-    const auto &cars = entityManager.getCars();
-
-    // List of cars to remove (pointers)
-    std::vector<Car *> carsToRemove;
-
-    // Calculate World Road Boundaries
-    float minRoadX = std::numeric_limits<float>::max();
-    float maxRoadX = std::numeric_limits<float>::lowest();
-
-    const auto &modules = entityManager.getModules();
-    for (const auto &mod : modules) {
-      if (auto *r = dynamic_cast<NormalRoad *>(mod.get())) {
-        float x = r->worldPosition.x;
-        float w = r->getWidth();
-        if (x < minRoadX)
-          minRoadX = x;
-        if (x + w > maxRoadX)
-          maxRoadX = x + w;
-      }
-    }
+    // Check if ready to leave parking
+    if (shouldExit) {
+      MemoryStats::markTickEventful();
+      Logger::Info("TrafficSystem: Car exiting.");
 
-    if (minRoadX == std::numeric_limits<float>::max())
-      minRoadX = 0;
-    if (maxRoadX == std::numeric_limits<float>::lowest())
-      maxRoadX = 100;
+      Module *currentFac = const_cast<Module *>(car->getParkedFacility());
+      Spot currentSpot = car->getParkedSpot();
+      int idx = car->getParkedSpotIndex();
 
-    for (const auto &carPtr : cars) {
-      Car *car = carPtr.get();
-      if (!car)
+      if (!currentFac) {
+        car->setState(Car::CarState::DRIVING);
         continue;
-
-      // Check for Arrival (Transition RESERVED -> OCCUPIED)
-      if (car->getState() == Car::CarState::ALIGNING || car->getState() == Car::CarState::PARKED) {
-        Module *fac = const_cast<Module *>(car->getParkedFacility());
-        int idx = car->getParkedSpotIndex();
-        if (fac && idx != -1) {
-          Spot s = fac->getSpot(idx);
-          if (s.state == SpotState::RESERVED) {
-            fac->setSpotState(idx, SpotState::OCCUPIED);
-            // auto counts = fac->getSpotCounts();
-            // Logger::Info("TrafficSystem: Spot Occupied.");
-          }
-        }
       }
 
-      // Handle Parked Logic (Charging vs Waiting)
-      bool shouldExit = false;
-
-      if (car->getState() == Car::CarState::PARKED) {
-        Module *fac = const_cast<Module *>(car->getParkedFacility());
-
-        bool isChargingSpot = false;
-        if (dynamic_cast<SmallChargingStation *>(fac) || dynamic_cast<LargeChargingStation *>(fac)) {
-          isChargingSpot = true;
-        }
-
-        if (isChargingSpot && car->getType() == Car::CarType::ELECTRIC) {
-          car->charge(Config::CHARGING_RATE * (float)e.dt);
-          float bat = car->getBatteryLevel();
-
-          if (bat > Config::BATTERY_FORCE_EXIT_THRESHOLD) {
-            shouldExit = true;
-          } else if (bat > Config::BATTERY_EXIT_THRESHOLD) {
-            float range = Config::BATTERY_FORCE_EXIT_THRESHOLD - Config::BATTERY_EXIT_THRESHOLD;
-            float excess = bat - Config::BATTERY_EXIT_THRESHOLD;
-            float probability = 0.5f * (excess / range) * (float)e.dt;
-            if ((float)GetRandomValue(0, 10000) / 10000.0f < probability) {
-              shouldExit = true;
-            }
-          }
-        } else {
-          if (car->isReadyToLeave()) {
-            shouldExit = true;
-          }
-        }
+      if (idx != -1) {
+        currentFac->setSpotState(idx, SpotState::FREE);
       }
 
-      // Check if ready to leave parking
-      if (shouldExit) {
-        // ... (Existing Exit Logic) ...
-        Logger::Info("TrafficSystem: Car exiting.");
+      bool exitRight = TrafficPolicy::ExitRight(car->getPriority(), car->getEnteredFromLeft(),
+                                                (float)GetRandomValue(0, 1) * 0.5f);
 
-        Module *currentFac = const_cast<Module *>(car->getParkedFacility());
-        Spot currentSpot = car->getParkedSpot();
-        int idx = car->getParkedSpotIndex();
+      double finalX = exitRight ? (maxRoadX + 2.0) : (minRoadX - 2.0);
+      std::pmr::vector<Waypoint> path = PathPlanner::GenerateExitPath(car, currentFac, currentSpot, exitRight, finalX);
 
-        if (!currentFac) {
-          car->setState(Car::CarState::DRIVING);
-          continue;
-        }
+      car->setPath(path);
+      car->setState(Car::CarState::EXITING);
+      car->stampTrip(TripMilestone::ExitStart);
+    }
+  }
+}
 
-        if (idx != -1) {
-          currentFac->setSpotState(idx, SpotState::FREE);
-        }
+void TrafficSystem::evacuate(Car *car) {
+  Module *fac = const_cast<Module *>(car->getParkedFacility());
+  if (!fac)
+    return;
 
-        bool exitRight = false;
-        if (car->getPriority() == Car::Priority::PRIORITY_DISTANCE) {
-          exitRight = !car->getEnteredFromLeft();
-        } else {
-          exitRight = (GetRandomValue(0, 1) == 1);
-        }
+  int idx = car->getParkedSpotIndex();
+  if (idx != -1 && car->getState() != Car::CarState::EXITING)
+    fac->setSpotState(idx, SpotState::FREE);
 
-        float finalX = exitRight ? (maxRoadX + 2.0f) : (minRoadX - 2.0f);
-        std::vector<Waypoint> path = PathPlanner::GenerateExitPath(car, currentFac, currentSpot, exitRight, finalX);
+  auto [minRoadX, maxRoadX] = roadExtent();
+  bool exitRight = TrafficPolicy::ExitRight(car->getPriority(), car->getEnteredFromLeft(),
+                                            (float)GetRandomValue(0, 1) * 0.5f);
+  double finalX = exitRight ? (maxRoadX + 2.0) : (minRoadX - 2.0);
+  std::pmr::vector<Waypoint> path =
+      PathPlanner::GenerateExitPath(car, fac, car->getParkedSpot(), exitRight, finalX);
 
-        car->setPath(path);
-        car->setState(Car::CarState::EXITING);
-      }
+  car->setPath(path);
+  car->setState(Car::CarState::EXITING);
+  car->stampTrip(TripMilestone::ExitStart);
+}
 
-      // Check if finished exiting
-      if (car->getState() == Car::CarState::EXITING && car->hasArrived()) {
-        carsToRemove.push_back(car);
-      }
+std::pair<double, double> TrafficSystem::roadExtent() const {
+  double minRoadX = std::numeric_limits<double>::max();
+  double maxRoadX = std::numeric_limits<double>::lowest();
+  for (const auto &mod : entityManager.getModules()) {
+    if (auto *r = dynamic_cast<NormalRoad *>(mod.get())) {
+      double x = r->worldPosition.x();
+      double w = r->getWidth();
+      if (x < minRoadX)
+        minRoadX = x;
+      if (x + w > maxRoadX)
+        maxRoadX = x + w;
     }
+  }
 
-    for (Car *c : carsToRemove) {
-      const_cast<EntityManager &>(entityManager).removeCar(c);
-    }
-  }));
+  if (minRoadX == std::numeric_limits<double>::max())
+    minRoadX = 0;
+  if (maxRoadX == std::numeric_limits<double>::lowest())
+    maxRoadX = 100;
+  return {minRoadX, maxRoadX};
 }
 
-TrafficSystem::~TrafficSystem() { eventTokens.clear(); }
+void TrafficSystem::setEntrySides(bool left, bool right) {
+  entryEnabled[1] = left;
+  entryEnabled[0] = right;
+}
 
-void TrafficSystem::spawnCar() {
-  Logger::Info("TrafficSystem: Processing Spawn Logic...");
+void TrafficSystem::setSpawnLevel(int level) {
+  currentSpawnLevel = level;
+  applyDemandProfile();
 
-  const auto &modules = entityManager.getModules();
-  if (modules.empty())
+  Logger::Info("TrafficSystem: Auto-Spawn Level set to {}", currentSpawnLevel);
+  eventBus->publish(AutoSpawnLevelChangedEvent{currentSpawnLevel});
+}
+
+void TrafficSystem::applyDemandProfile() {
+  if (currentSpawnLevel == 0) {
+    demand.setProfile(DemandProfile{});
     return;
+  }
 
-  // Find Leftmost and Rightmost Roads
+  switch (demandProfileIndex) {
+  case 1:
+    demand.setProfile(DemandProfile::Commuter((float)currentSpawnLevel));
+    break;
+  case 2:
+    demand.setProfile(DemandProfile::Stress((float)currentSpawnLevel));
+    break;
+  default:
+    demand.setProfile(DemandProfile::FromSpawnLevel(currentSpawnLevel));
+    break;
+  }
+}
+
+TrafficSystem::SpawnPoints TrafficSystem::findSpawnPoints() const {
+  SpawnPoints points;
+
+  // Find Leftmost and Rightmost Roads (we assume external roads are NormalRoads)
   const Module *leftRoad = nullptr;
   const Module *rightRoad = nullptr;
-  float minX = std::numeric_limits<float>::max();
-  float maxRightX = std::numeric_limits<float>::lowest();
+  double minX = std::numeric_limits<double>::max();
+  double maxRightX = std::numeric_limits<double>::lowest();
 
-  for (const auto &mod : modules) {
+  for (const auto &mod : entityManager.getModules()) {
     if (auto *r = dynamic_cast<NormalRoad *>(mod.get())) {
-      float x = r->worldPosition.x;
-      float w = r->getWidth();
+      double x = r->worldPosition.x();
+      double w = r->getWidth();
 
       if (x < minX) {
         minX = x;
@@ -505,35 +430,39 @@ void TrafficSystem::spawnCar() {
     }
   }
 
-  if (!leftRoad && !rightRoad)
-    return;
-
-  bool spawnLeft = (GetRandomValue(0, 1) == 0);
-  if (!leftRoad)
-    spawnLeft = false;
-  if (!rightRoad)
-    spawnLeft = true;
-
-  Vector2 spawnPos = {0, 0};
-  Vector2 spawnVel = {0, 0};
-  float speed = 15.0f;
   float pixelsPerMeter = static_cast<float>(Config::ART_PIXELS_PER_METER);
 
-  if (spawnLeft) {
+  if (leftRoad) {
+    // Spawn Left -> Drive Right (lower lane)
     float laneOffset = (float)Config::LANE_OFFSET_DOWN / pixelsPerMeter;
-    spawnPos.x = leftRoad->worldPosition.x;
-    spawnPos.y = leftRoad->worldPosition.y + laneOffset;
-    spawnVel = {speed, 0};
-  } else {
+    points.has[1] = true;
+    points.pos[1] = leftRoad->worldPosition + Vector2{0.0f, laneOffset};
+  }
+  if (rightRoad) {
+    // Spawn Right -> Drive Left (upper lane)
     float laneOffset = (float)Config::LANE_OFFSET_UP / pixelsPerMeter;
-    spawnPos.x = rightRoad->worldPosition.x + rightRoad->getWidth();
-    spawnPos.y = rightRoad->worldPosition.y + laneOffset;
-    spawnVel = {-speed, 0};
+    points.has[0] = true;
+    points.pos[0] = rightRoad->worldPosition + Vector2{rightRoad->getWidth(), laneOffset};
   }
 
-  int carType = (GetRandomValue(0, 1) == 0) ? 0 : 1;
-  int priority = (GetRandomValue(0, 1) == 0) ? 0 : 1;
-  bool enteredFromLeft = spawnLeft;
+  return points;
+}
+
+bool TrafficSystem::isLaneClear(const WorldCoord &spawnPos) const {
+  for (const auto &car : entityManager.getCars()) {
+    Vector2 d = car->getPosition() - spawnPos;
+    if (std::abs(d.x) < Config::Spawner::LANE_CLEARANCE && std::abs(d.y) < Config::Spawner::LANE_HALF_WIDTH)
+      return false;
+  }
+  return true;
+}
+
+void TrafficSystem::spawnCar(const Arrival &arrival, const WorldCoord &spawnPos) {
+  MemoryStats::markTickEventful();
+
+  float speed = Config::CarAI::MAX_SPEED; // Initial speed (matches max speed)
+  Vector2 spawnVel = {arrival.fromLeft ? speed : -speed, 0};
 
-  eventBus->publish(CreateCarEvent{spawnPos, spawnVel, carType, priority, enteredFromLeft});
+  eventBus->publish(CreateCarEvent{spawnPos, spawnVel, (int)arrival.type, (int)arrival.priority, arrival.fromLeft,
+                                   arrival.battery, arrival.dwell});
 }
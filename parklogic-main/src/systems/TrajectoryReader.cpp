@@ -0,0 +1,200 @@
+#include "systems/TrajectoryReader.hpp"
+#include "core/Logger.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+/**
+ * @file TrajectoryReader.cpp
+ * @brief Implementation of the trajectory decoder.
+ */
+
+using namespace TrajectoryFormat;
+
+TrajectoryReader::TrajectoryReader(const std::string &path) : path(path), file(path) {
+  if (file.size() < sizeof(FileHeader))
+    throw std::runtime_error("TrajectoryReader: " + path + " is too small to be a recording");
+
+  std::memcpy(&header, file.data(), sizeof(header));
+  if (std::memcmp(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0)
+    throw std::runtime_error("TrajectoryReader: " + path + " is not a trajectory recording");
+  if (header.version != VERSION)
+    throw std::runtime_error("TrajectoryReader: unsupported recording version " + std::to_string(header.version));
+
+  loadIndex();
+  Logger::Info("TrajectoryReader: {} ({} ticks, {:.1f} min, {} chunks)", path, totalTicks, getDuration() / 60.0,
+               index.size());
+}
+
+MapConfig TrajectoryReader::getMapConfig() const {
+  MapConfig config;
+  config.smallParkingCount = header.smallParkingCount;
+  config.largeParkingCount = header.largeParkingCount;
+  config.smallChargingCount = header.smallChargingCount;
+  config.largeChargingCount = header.largeChargingCount;
+  config.seed = header.mapSeed;
+  return config;
+}
+
+void TrajectoryReader::loadIndex() {
+  IndexFooter footer{};
+  if (file.size() >= sizeof(FileHeader) + sizeof(IndexFooter)) {
+    std::memcpy(&footer, file.data() + file.size() - sizeof(footer), sizeof(footer));
+  }
+
+  bool valid = std::memcmp(footer.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) == 0 &&
+               footer.indexOffset + (uint64_t)footer.chunkCount * sizeof(IndexEntry) + sizeof(footer) == file.size();
+  if (!valid) {
+    Logger::Warn("TrajectoryReader: {} has no index (interrupted recording?), scanning chunks", path);
+    rebuildIndex();
+    return;
+  }
+
+  index.resize(footer.chunkCount);
+  std::memcpy(index.data(), file.data() + footer.indexOffset, footer.chunkCount * sizeof(IndexEntry));
+  totalTicks = footer.totalTicks;
+}
+
+void TrajectoryReader::rebuildIndex() {
+  size_t offset = sizeof(FileHeader);
+  while (offset + sizeof(ChunkHeader) <= file.size()) {
+    ChunkHeader chunkHeader;
+    std::memcpy(&chunkHeader, file.data() + offset, sizeof(chunkHeader));
+    if (chunkHeader.magic != CHUNK_MAGIC || offset + sizeof(chunkHeader) + chunkHeader.payloadBytes > file.size())
+      break; // Index/footer or a torn last chunk
+
+    index.push_back(IndexEntry{chunkHeader.firstTick, chunkHeader.tickCount, offset});
+    totalTicks = chunkHeader.firstTick + chunkHeader.tickCount;
+    offset += sizeof(chunkHeader) + chunkHeader.payloadBytes;
+  }
+}
+
+bool TrajectoryReader::readEntry(ByteReader &in, uint32_t previousId, QuantizedPose &out) {
+  out.id = previousId + in.varint();
+  out.x = UnZigZag(in.varint());
+  out.y = UnZigZag(in.varint());
+  out.rotation = (int32_t)in.varint();
+  out.state = in.byte();
+
+  std::string name = in.string();
+  if (in.failed)
+    return false;
+
+  auto it = textureIds.find(name);
+  if (it == textureIds.end()) {
+    it = textureIds.emplace(name, (uint16_t)textureNames.size()).first;
+    textureNames.push_back(name);
+  }
+  out.texture = it->second;
+  return true;
+}
+
+bool TrajectoryReader::beginChunk(size_t c) {
+  const IndexEntry &entry = index[c];
+  ChunkHeader chunkHeader;
+  std::memcpy(&chunkHeader, file.data() + entry.offset, sizeof(chunkHeader));
+
+  const uint8_t *payload = reinterpret_cast<const uint8_t *>(file.data() + entry.offset + sizeof(chunkHeader));
+  cursor = ByteReader{payload, payload + chunkHeader.payloadBytes};
+  chunk = c;
+  currentTick = entry.firstTick;
+  chunkEndTick = entry.firstTick + entry.tickCount;
+
+  // Keyframe
+  poses.clear();
+  uint32_t count = cursor.varint();
+  uint32_t previousId = 0;
+  for (uint32_t i = 0; i < count && !cursor.failed; ++i) {
+    QuantizedPose pose;
+    if (!readEntry(cursor, previousId, pose))
+      break;
+    previousId = pose.id;
+    poses.push_back(pose);
+  }
+  return !cursor.failed;
+}
+
+bool TrajectoryReader::decodeFrame() {
+  // New ids are delta coded against the last id of the previous tick, even if it is removed now
+  uint32_t previousId = poses.empty() ? 0 : poses.back().id;
+
+  // Removals (ids ascending; poses are sorted by id, so one merge pass compacts them out)
+  uint32_t removedCount = cursor.varint();
+  removedIds.clear();
+  uint32_t id = 0;
+  for (uint32_t i = 0; i < removedCount && !cursor.failed; ++i) {
+    id += cursor.varint();
+    removedIds.push_back(id);
+  }
+  if (!removedIds.empty()) {
+    size_t write = 0;
+    size_t r = 0;
+    for (size_t read = 0; read < poses.size(); ++read) {
+      while (r < removedIds.size() && removedIds[r] < poses[read].id)
+        ++r;
+      if (r < removedIds.size() && removedIds[r] == poses[read].id)
+        continue;
+      poses[write++] = poses[read];
+    }
+    poses.resize(write);
+  }
+
+  // Additions
+  uint32_t addedCount = cursor.varint();
+  added.clear();
+  for (uint32_t i = 0; i < addedCount && !cursor.failed; ++i) {
+    QuantizedPose pose;
+    if (!readEntry(cursor, previousId, pose))
+      break;
+    previousId = pose.id;
+    added.push_back(pose);
+  }
+
+  // Survivors: runs of unchanged cars, each followed by one changed car
+  size_t i = 0;
+  while (i < poses.size() && !cursor.failed) {
+    i += cursor.varint();
+    if (i >= poses.size())
+      break;
+
+    QuantizedPose &pose = poses[i++];
+    pose.x += UnZigZag(cursor.varint());
+    pose.y += UnZigZag(cursor.varint());
+    uint32_t rotation = cursor.varint();
+    pose.rotation = (pose.rotation + UnZigZag(rotation >> 1) + ROTATION_UNITS) % ROTATION_UNITS;
+    if (rotation & 1)
+      pose.state = cursor.byte();
+  }
+
+  poses.insert(poses.end(), added.begin(), added.end());
+  currentTick++;
+  return !cursor.failed;
+}
+
+bool TrajectoryReader::seek(uint32_t tick) {
+  if (index.empty() || totalTicks == 0)
+    return false;
+  tick = std::min(tick, totalTicks - 1);
+
+  bool forwardInChunk = positioned && tick >= currentTick && tick < chunkEndTick;
+  if (!forwardInChunk) {
+    // Last chunk starting at or before the tick
+    auto it = std::upper_bound(index.begin(), index.end(), tick,
+                               [](uint32_t t, const IndexEntry &e) { return t < e.firstTick; });
+    size_t c = (it == index.begin()) ? 0 : (size_t)(it - index.begin()) - 1;
+
+    positioned = beginChunk(c);
+    if (!positioned) {
+      Logger::Error("TrajectoryReader: corrupt keyframe in chunk {}", c);
+      return false;
+    }
+  }
+
+  while (currentTick < tick) {
+    if (!decodeFrame()) {
+      Logger::Error("TrajectoryReader: corrupt frame at tick {}", currentTick);
+      positioned = false;
+      return false;
+    }
+  }
+  return true;
+}
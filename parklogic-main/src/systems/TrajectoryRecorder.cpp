@@ -0,0 +1,210 @@
+#include "systems/TrajectoryRecorder.hpp"
+#include "config.hpp"
+#include "core/Logger.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+/**
+ * @file TrajectoryRecorder.cpp
+ * @brief Implementation of the trajectory encoder.
+ */
+
+using namespace TrajectoryFormat;
+
+TrajectoryRecorder::TrajectoryRecorder(const std::string &path, const MapConfig &map, double tickSeconds)
+    : path(path), out(path, std::ios::binary | std::ios::trunc),
+      ticksPerChunk(Config::Trajectory::TICKS_PER_CHUNK) {
+  if (!out)
+    throw std::runtime_error("TrajectoryRecorder: cannot create " + path);
+
+  FileHeader header{};
+  std::memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+  header.version = VERSION;
+  header.ticksPerChunk = ticksPerChunk;
+  header.tickSeconds = tickSeconds;
+  header.smallParkingCount = map.smallParkingCount;
+  header.largeParkingCount = map.largeParkingCount;
+  header.smallChargingCount = map.smallChargingCount;
+  header.largeChargingCount = map.largeChargingCount;
+  header.mapSeed = map.seed;
+
+  out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  bytesWritten = sizeof(header);
+  Logger::Info("TrajectoryRecorder: recording to {}", path);
+}
+
+TrajectoryRecorder::~TrajectoryRecorder() { finish(); }
+
+uint16_t TrajectoryRecorder::internTexture(const std::string &name) {
+  auto it = textureIds.find(name);
+  if (it != textureIds.end())
+    return it->second;
+
+  uint16_t id = (uint16_t)textureNames.size();
+  textureNames.push_back(name);
+  textureIds.emplace(name, id);
+  return id;
+}
+
+void TrajectoryRecorder::capture(const std::vector<std::unique_ptr<Car>> &cars) {
+  if (finished)
+    return;
+
+  current.clear();
+  for (const auto &car : cars) {
+    const WorldCoord &p = car->getPosition();
+    float degrees = std::fmod(car->getRotation(), 360.0f);
+    if (degrees < 0.0f)
+      degrees += 360.0f;
+
+    QuantizedPose pose;
+    pose.id = car->getId();
+    pose.x = (int32_t)std::lround(p.x() * POSITION_SCALE);
+    pose.y = (int32_t)std::lround(p.y() * POSITION_SCALE);
+    pose.rotation = (int32_t)std::lround(degrees * ROTATION_SCALE) % ROTATION_UNITS;
+    pose.state = (uint8_t)car->getState();
+    pose.texture = internTexture(car->getTextureName());
+    current.push_back(pose);
+  }
+
+  // EntityManager keeps cars in spawn (= id) order; sort only if that ever changes
+  auto byId = [](const QuantizedPose &a, const QuantizedPose &b) { return a.id < b.id; };
+  if (!std::is_sorted(current.begin(), current.end(), byId))
+    std::sort(current.begin(), current.end(), byId);
+
+  if (ticksInChunk == 0) {
+    // Keyframe
+    chunkFirstTick = tick;
+    PutVarint(payload, (uint32_t)current.size());
+    uint32_t previousId = 0;
+    for (const QuantizedPose &pose : current) {
+      writeEntry(pose, previousId);
+      previousId = pose.id;
+    }
+  } else {
+    encodeDelta();
+  }
+
+  previous.swap(current);
+  tick++;
+  if (++ticksInChunk == ticksPerChunk)
+    flushChunk();
+}
+
+void TrajectoryRecorder::writeEntry(const QuantizedPose &pose, uint32_t previousId) {
+  PutVarint(payload, pose.id - previousId);
+  PutVarint(payload, ZigZag(pose.x));
+  PutVarint(payload, ZigZag(pose.y));
+  PutVarint(payload, (uint32_t)pose.rotation);
+  payload.push_back(pose.state);
+
+  const std::string &name = textureNames[pose.texture];
+  PutVarint(payload, (uint32_t)name.size());
+  payload.insert(payload.end(), name.begin(), name.end());
+}
+
+void TrajectoryRecorder::encodeDelta() {
+  // Both lists are sorted by id: one merge pass finds removed, added and surviving cars.
+  // Pass 1: removals
+  removedIds.clear();
+  size_t c = 0;
+  for (const QuantizedPose &p : previous) {
+    while (c < current.size() && current[c].id < p.id)
+      ++c;
+    if (c == current.size() || current[c].id != p.id)
+      removedIds.push_back(p.id);
+  }
+  PutVarint(payload, (uint32_t)removedIds.size());
+  uint32_t previousId = 0;
+  for (uint32_t id : removedIds) {
+    PutVarint(payload, id - previousId);
+    previousId = id;
+  }
+
+  // Pass 2: additions (ids only grow, so they all sort after the survivors)
+  uint32_t lastPreviousId = previous.empty() ? 0 : previous.back().id;
+  size_t firstAdded = current.size();
+  for (size_t i = 0; i < current.size(); ++i) {
+    if (current[i].id > lastPreviousId) {
+      firstAdded = i;
+      break;
+    }
+  }
+  PutVarint(payload, (uint32_t)(current.size() - firstAdded));
+  previousId = lastPreviousId;
+  for (size_t i = firstAdded; i < current.size(); ++i) {
+    writeEntry(current[i], previousId);
+    previousId = current[i].id;
+  }
+
+  // Pass 3: survivors, as runs of unchanged cars followed by one changed car
+  uint32_t unchanged = 0;
+  size_t p = 0;
+  for (size_t i = 0; i < firstAdded; ++i) {
+    const QuantizedPose &cur = current[i];
+    while (previous[p].id < cur.id)
+      ++p;
+    const QuantizedPose &old = previous[p];
+
+    int32_t dx = cur.x - old.x;
+    int32_t dy = cur.y - old.y;
+    int32_t drot = WrapRotation(cur.rotation - old.rotation);
+    bool stateChanged = cur.state != old.state;
+
+    if (dx == 0 && dy == 0 && drot == 0 && !stateChanged) {
+      unchanged++;
+      continue;
+    }
+
+    PutVarint(payload, unchanged);
+    unchanged = 0;
+    PutVarint(payload, ZigZag(dx));
+    PutVarint(payload, ZigZag(dy));
+    PutVarint(payload, (ZigZag(drot) << 1) | (stateChanged ? 1u : 0u));
+    if (stateChanged)
+      payload.push_back(cur.state);
+  }
+  if (unchanged > 0)
+    PutVarint(payload, unchanged);
+}
+
+void TrajectoryRecorder::flushChunk() {
+  if (ticksInChunk == 0)
+    return;
+
+  ChunkHeader header{CHUNK_MAGIC, chunkFirstTick, ticksInChunk, (uint32_t)payload.size()};
+  index.push_back(IndexEntry{chunkFirstTick, ticksInChunk, bytesWritten});
+
+  out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  out.write(reinterpret_cast<const char *>(payload.data()), (std::streamsize)payload.size());
+  bytesWritten += sizeof(header) + payload.size();
+
+  if (!out)
+    Logger::Error("TrajectoryRecorder: write to {} failed", path);
+
+  payload.clear();
+  ticksInChunk = 0;
+}
+
+void TrajectoryRecorder::finish() {
+  if (finished)
+    return;
+  finished = true;
+
+  flushChunk();
+
+  IndexFooter footer{};
+  std::memcpy(footer.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+  footer.indexOffset = bytesWritten;
+  footer.chunkCount = (uint32_t)index.size();
+  footer.totalTicks = tick;
+
+  out.write(reinterpret_cast<const char *>(index.data()), (std::streamsize)(index.size() * sizeof(IndexEntry)));
+  out.write(reinterpret_cast<const char *>(&footer), sizeof(footer));
+  bytesWritten += index.size() * sizeof(IndexEntry) + sizeof(footer);
+  out.close();
+
+  Logger::Info("TrajectoryRecorder: wrote {} ticks in {} chunks to {} ({} KB)", tick, index.size(), path,
+               bytesWritten / 1024);
+}
@@ -1,10 +1,43 @@
 #include "ui/DashboardOverlay.hpp"
 #include "config.hpp"
+#include "core/MemoryStats.hpp"
+#include "core/SystemScheduler.hpp"
 #include "events/InputEvents.hpp"
+#include "systems/LoadGovernor.hpp"
 #include "raymath.h"
+#include <algorithm>
+#include <array>
 #include <format>
+#include <span>
 #include <string>
 
+/// Forecast curve as a polyline in a framed box; occupancy 0-1 maps bottom to top.
+static void DrawForecastCurve(int x, int y, int width, int height, const std::vector<float> &curve) {
+  DrawRectangleLines(x, y, width, height, DARKGRAY);
+  if (curve.size() < 2)
+    return;
+  auto point = [&](size_t i) {
+    float px = (float)x + (float)width * (float)i / (float)(curve.size() - 1);
+    float py = (float)(y + height) - (float)height * std::clamp(curve[i], 0.0f, 1.0f);
+    return Vector2{px, py};
+  };
+  for (size_t i = 1; i < curve.size(); ++i)
+    DrawLineV(point(i - 1), point(i), SKYBLUE);
+}
+
+/// History buckets in a framed box: the min-max range as a band, the mean as a line; 0-1 maps bottom to top.
+static void DrawHistoryBand(int x, int y, int width, int height, std::span<const OccupancyHistory::Bucket> buckets) {
+  DrawRectangleLines(x, y, width, height, DARKGRAY);
+  if (buckets.size() < 2)
+    return;
+  auto px = [&](size_t i) { return (float)x + (float)width * (float)i / (float)(buckets.size() - 1); };
+  auto py = [&](float v) { return (float)(y + height) - (float)height * std::clamp(v, 0.0f, 1.0f); };
+  for (size_t i = 0; i < buckets.size(); ++i)
+    DrawLineV({px(i), py(buckets[i].min)}, {px(i), py(buckets[i].max)}, Fade(SKYBLUE, 0.3f));
+  for (size_t i = 1; i < buckets.size(); ++i)
+    DrawLineV({px(i - 1), py(buckets[i - 1].mean)}, {px(i), py(buckets[i].mean)}, SKYBLUE);
+}
+
 DashboardOverlay::DashboardOverlay(std::shared_ptr<EventBus> bus, EntityManager *em)
     : UIElement({0, 0}, {0, 0}, bus), entityManager(em) {
 
@@ -22,10 +55,41 @@ DashboardOverlay::DashboardOverlay(std::shared_ptr<EventBus> bus, EntityManager
   eventTokens.push_back(
       bus->subscribe<ToggleDashboardEvent>([this](const ToggleDashboardEvent &) { visible = !visible; }));
 
+  eventTokens.push_back(bus->subscribe<OccupancyForecastEvent>([this](const OccupancyForecastEvent &e) {
+    size_t capacity = forecast.capacity();
+    forecast = *e.forecast; // Reuses the vectors once they are large enough
+    if (forecast.capacity() != capacity)
+      MemoryStats::markTickEventful();
+    hasForecast = true;
+  }));
+
+  // A facility taken off the map: drop what points at it until the next forecast
+  eventTokens.push_back(bus->subscribe<MapEditedEvent>([this](const MapEditedEvent &e) {
+    if (!e.replaced && e.edit != MapEdit::Insert)
+      return;
+    hasForecast = false;
+    if (currentSelection.module && currentSelection.module == e.replaced)
+      currentSelection = EntitySelectedEvent{};
+  }));
+
+  eventTokens.push_back(bus->subscribe<OccupancyHistoryEvent>(
+      [this](const OccupancyHistoryEvent &e) { history = e.history; }));
+
+  eventTokens.push_back(bus->subscribe<LoadGovernorEvent>([this](const LoadGovernorEvent &e) {
+    governor = e;
+    hasGovernor = true;
+  }));
+
   // Subscribe to Toggle Key (I)
   eventTokens.push_back(bus->subscribe<KeyPressedEvent>([this](const KeyPressedEvent &e) {
     if (e.key == KEY_I) {
       eventBus->publish(ToggleDashboardEvent{});
+    } else if (e.key == KEY_T) {
+      tripPage = !tripPage;
+      if (currentSelection.type == SelectionType::GENERAL)
+        visible = true;
+    } else if (e.key == KEY_Y) {
+      historyLevel = (OccupancyHistory::Level)(((int)historyLevel + 1) % OccupancyHistory::LEVELS);
     }
   }));
 
@@ -41,6 +105,55 @@ void DashboardOverlay::update(double /*dt*/) {
   // No specific update logic needed for now
 }
 
+void DashboardOverlay::schedule(SystemScheduler &scheduler) {
+  scheduler.add({"dashboard", SystemScheduler::Stage::Bookkeeping, SystemScheduler::FACILITIES, SystemScheduler::HUD,
+                 Config::Scheduler::DASHBOARD_RATE, [this](double) { refreshOccupancy(); }});
+  refreshOccupancy();
+}
+
+void DashboardOverlay::refreshOccupancy() {
+  Occupancy o;
+  if (entityManager) {
+    auto &modules = entityManager->getModules();
+
+    for (const auto &m : modules) {
+      auto type = m->getType();
+      bool isCharging = (type == ModuleType::SMALL_CHARGING || type == ModuleType::LARGE_CHARGING);
+      bool isParking = (type == ModuleType::SMALL_PARKING || type == ModuleType::LARGE_PARKING);
+
+      if (!isCharging && !isParking)
+        continue; // Skip roads/etc
+
+      o.facilities++;
+
+      auto counts = m->getSpotCounts();
+      o.totalSpots += (counts.free + counts.reserved + counts.occupied);
+      o.occupiedSpots += counts.occupied;
+
+      if (isCharging) {
+        o.chargingStations++;
+        o.chargingSpots += (counts.free + counts.reserved + counts.occupied);
+        o.occupiedCharging += counts.occupied;
+      } else if (isParking) {
+        o.parkingLots++;
+        o.parkingSpots += (counts.free + counts.reserved + counts.occupied);
+        o.occupiedParking += counts.occupied;
+      }
+    }
+  }
+  occupancy = o;
+}
+
+const std::vector<float> *DashboardOverlay::forecastFor(const Module *module) const {
+  if (!hasForecast)
+    return nullptr;
+  for (size_t i = 0; i < forecast.facilities.size() && i < forecast.curves.size(); ++i) {
+    if (forecast.facilities[i] == module)
+      return forecast.curves[i].empty() ? nullptr : &forecast.curves[i];
+  }
+  return nullptr;
+}
+
 void DashboardOverlay::draw() {
   if (!visible)
     return;
@@ -57,14 +170,28 @@ void DashboardOverlay::draw() {
   int headerHeight = 30;
 
   // Rough estimation per type
-  if (currentSelection.type == SelectionType::GENERAL) {
+  if (currentSelection.type == SelectionType::GENERAL && tripPage) {
+    estimatedHeight = headerHeight + 25 + (TripTelemetry::METRICS * 25) + 10 + 25 + (3 * 25);
+  } else if (currentSelection.type == SelectionType::GENERAL) {
     estimatedHeight = headerHeight + 10 + 25 + (3 * 25) + 10 + 25 + 25 + (3 * 25); // ~350
+    if (hasForecast)
+      estimatedHeight += 25;
+    if (hasGovernor)
+      estimatedHeight += 25;
+    if (hasHistory(OccupancyHistory::MAP_ROW))
+      estimatedHeight += 25 + 50;
+    if constexpr (MemoryStats::Enabled)
+      estimatedHeight += 10 + 25 + (5 * 25);
   } else if (currentSelection.type == SelectionType::CAR) {
     estimatedHeight = headerHeight + (5 * 25); // ~155
     if (currentSelection.car && currentSelection.car->getType() == Car::CarType::ELECTRIC)
       estimatedHeight += 25;
   } else if (currentSelection.type == SelectionType::FACILITY) {
     estimatedHeight = headerHeight + (8 * 25); // ~230
+    if (forecastFor(currentSelection.module))
+      estimatedHeight += 25 + 50;
+    if (history && hasHistory(history->rowOf(currentSelection.module)))
+      estimatedHeight += 25 + 50;
   } else if (currentSelection.type == SelectionType::SPOT) {
     estimatedHeight = headerHeight + (3 * 25); // ~105
   }
@@ -92,7 +219,10 @@ void DashboardOverlay::draw() {
     break;
   case SelectionType::GENERAL:
   default:
-    drawGeneralInfo(contentX, contentY, contentWidth);
+    if (tripPage)
+      drawTripInfo(contentX, contentY, contentWidth);
+    else
+      drawGeneralInfo(contentX, contentY, contentWidth);
     break;
   }
 }
@@ -101,70 +231,95 @@ void DashboardOverlay::drawGeneralInfo(int x, int y, int width) {
   DrawText("GENERAL INFO", x, y, 20, GOLD);
   y += 30;
 
-  int totalFacilities = 0;
-  int totalSpots = 0;
-  int occupiedSpots = 0;
+  const Occupancy &o = occupancy;
 
-  int chargingStations = 0;
-  int parkingLots = 0;
+  auto drawStat = [&](const char *label, const std::string &val) {
+    DrawText(label, x, y, 20, WHITE);
+    DrawText(val.c_str(), x + width - MeasureText(val.c_str(), 20), y, 20, GREEN);
+    y += 25;
+  };
 
-  int chargingSpots = 0;
-  int occupiedCharging = 0;
+  drawStat("Facilities:", std::format("{}", o.facilities));
+  drawStat("Pk Lots:", std::format("{}", o.parkingLots));
+  drawStat("Chrg Stns:", std::format("{}", o.chargingStations));
 
-  int parkingSpots = 0;
-  int occupiedParking = 0;
+  y += 10;
+  DrawText("OCCUPANCY", x, y, 20, YELLOW);
+  y += 25;
 
-  if (entityManager) {
-    auto &modules = entityManager->getModules();
-    // totalFacilities = modules.size(); // Incorrect, includes roads
+  float overallOcc = o.totalSpots > 0 ? (float)o.occupiedSpots / o.totalSpots * 100.0f : 0.0f;
+  float parkingOcc = o.parkingSpots > 0 ? (float)o.occupiedParking / o.parkingSpots * 100.0f : 0.0f;
+  float chargingOcc = o.chargingSpots > 0 ? (float)o.occupiedCharging / o.chargingSpots * 100.0f : 0.0f;
 
-    for (const auto &m : modules) {
-      auto type = m->getType();
-      bool isCharging = (type == ModuleType::SMALL_CHARGING || type == ModuleType::LARGE_CHARGING);
-      bool isParking = (type == ModuleType::SMALL_PARKING || type == ModuleType::LARGE_PARKING);
+  drawStat("Overall:", std::format("{:.1f}%", overallOcc));
+  drawStat("Parking:", std::format("{:.1f}%", parkingOcc));
+  drawStat("Charging:", std::format("{:.1f}%", chargingOcc));
+  if (hasForecast && !forecast.overall.empty()) {
+    std::string label = std::format("In {:.0f} min:", Config::Forecast::HORIZON / 60.0);
+    drawStat(label.c_str(), std::format("{:.1f}%", forecast.overall.back() * 100.0f));
+  }
+  if (hasGovernor) {
+    std::string state = LoadGovernor::StageName(governor.stage);
+    if (governor.speedFactor < 1.0)
+      state += std::format(" x{:.2f}", governor.speedFactor);
+    drawStat("Governor:", std::format("{}, {:.0f}%", state, governor.load * 100.0));
+  }
+  drawHistory(x, y, width, OccupancyHistory::MAP_ROW);
 
-      if (!isCharging && !isParking)
-        continue; // Skip roads/etc
+  if constexpr (MemoryStats::Enabled) {
+    const auto &tick = MemoryStats::getLastTick();
+    const auto &frame = MemoryStats::getLastFrame();
 
-      totalFacilities++;
+    // Zone with the most allocations in the last tick
+    size_t worstZone = 0;
+    for (size_t i = 1; i < MemoryStats::ZoneCount; ++i) {
+      if (tick.zones[i].allocations > tick.zones[worstZone].allocations)
+        worstZone = i;
+    }
 
-      auto counts = m->getSpotCounts();
-      totalSpots += (counts.free + counts.reserved + counts.occupied);
-      occupiedSpots += counts.occupied;
+    y += 10;
+    DrawText("MEMORY", x, y, 20, YELLOW);
+    y += 25;
 
-      if (isCharging) {
-        chargingStations++;
-        chargingSpots += (counts.free + counts.reserved + counts.occupied);
-        occupiedCharging += counts.occupied;
-      } else if (isParking) {
-        parkingLots++;
-        parkingSpots += (counts.free + counts.reserved + counts.occupied);
-        occupiedParking += counts.occupied;
-      }
-    }
+    drawStat("Allocs/Tick:", std::format("{} ({} B)", tick.allocations, tick.bytes));
+    drawStat("Top Zone:", tick.allocations > 0 ? MemoryStats::ZoneName(static_cast<ProfileZone>(worstZone)) : "-");
+    drawStat("Allocs/Frame:", std::format("{}", frame.allocations));
+    drawStat("Live:", std::format("{:.1f} KB", (double)MemoryStats::getLiveBytes() / 1024.0));
+    drawStat("Peak:", std::format("{:.1f} KB", (double)MemoryStats::getPeakLiveBytes() / 1024.0));
   }
+}
+
+void DashboardOverlay::drawTripInfo(int x, int y, int width) {
+  DrawText("TRIP LATENCY", x, y, 20, GOLD);
+  y += 30;
+  if (!entityManager)
+    return;
+  const TripTelemetry &trips = entityManager->getTripTelemetry();
 
   auto drawStat = [&](const char *label, const std::string &val) {
     DrawText(label, x, y, 20, WHITE);
     DrawText(val.c_str(), x + width - MeasureText(val.c_str(), 20), y, 20, GREEN);
     y += 25;
   };
-
-  drawStat("Facilities:", std::format("{}", totalFacilities));
-  drawStat("Pk Lots:", std::format("{}", parkingLots));
-  drawStat("Chrg Stns:", std::format("{}", chargingStations));
+  // Seconds, one decimal while it fits
+  auto seconds = [](float s) { return s < 100.0f ? std::format("{:.1f}", s) : std::format("{:.0f}", s); };
+
+  drawStat("(s)", "p50 / p90 / p99");
+  static constexpr const char *labels[TripTelemetry::METRICS] = {"To Park:", "Search:", "Maneuver:", "Exit:",
+                                                                  "Pass-thru:"};
+  for (int m = 0; m < TripTelemetry::METRICS; ++m) {
+    const LatencyHistogram &h = trips.histogram((TripTelemetry::Metric)m);
+    drawStat(labels[m], h.count() == 0 ? "-"
+                                       : std::format("{} / {} / {}", seconds(h.percentile(50)),
+                                                     seconds(h.percentile(90)), seconds(h.percentile(99))));
+  }
 
   y += 10;
-  DrawText("OCCUPANCY", x, y, 20, YELLOW);
+  DrawText("TRIPS", x, y, 20, YELLOW);
   y += 25;
-
-  float overallOcc = totalSpots > 0 ? (float)occupiedSpots / totalSpots * 100.0f : 0.0f;
-  float parkingOcc = parkingSpots > 0 ? (float)occupiedParking / parkingSpots * 100.0f : 0.0f;
-  float chargingOcc = chargingSpots > 0 ? (float)occupiedCharging / chargingSpots * 100.0f : 0.0f;
-
-  drawStat("Overall:", std::format("{:.1f}%", overallOcc));
-  drawStat("Parking:", std::format("{:.1f}%", parkingOcc));
-  drawStat("Charging:", std::format("{:.1f}%", chargingOcc));
+  drawStat("Spawned:", std::format("{}", trips.getCount(TripMilestone::Spawn)));
+  drawStat("Parked:", std::format("{}", trips.getCount(TripMilestone::Parked)));
+  drawStat("Passed:", std::format("{}", trips.getCount(TripMilestone::PassThrough)));
 }
 
 void DashboardOverlay::drawCarInfo(int x, int y, int width) {
@@ -243,6 +398,8 @@ void DashboardOverlay::drawFacilityInfo(int x, int y, int width) {
     break;
   }
   drawStat("Type:", typeStr);
+  if (m->isClosed())
+    drawStat("Status:", "Closed");
 
   auto counts = m->getSpotCounts();
   int total = counts.free + counts.reserved + counts.occupied;
@@ -256,6 +413,43 @@ void DashboardOverlay::drawFacilityInfo(int x, int y, int width) {
   drawStat("Occ. Rate:", std::format("{:.1f}%", occ));
 
   drawStat("Price Mult:", std::format("{:.2f}x", m->getPriceMultiplier()));
+
+  if (const std::vector<float> *curve = forecastFor(m)) {
+    std::string label = std::format("In {:.0f} min:", Config::Forecast::HORIZON / 60.0);
+    drawStat(label.c_str(), std::format("{:.1f}%", curve->back() * 100.0f));
+    DrawForecastCurve(x, y, width, 40, *curve);
+    y += 50;
+  }
+  if (history)
+    drawHistory(x, y, width, history->rowOf(m));
+}
+
+bool DashboardOverlay::hasHistory(int row) const {
+  OccupancyHistory::Bucket newest[1];
+  return history && history->read(historyLevel, row, OccupancyHistory::Channel::Occupancy, newest) > 0;
+}
+
+void DashboardOverlay::drawHistory(int x, int &y, int width, int row) const {
+  if (!history)
+    return;
+  std::array<OccupancyHistory::Bucket, Config::History::SPARKLINE_BUCKETS> buckets;
+  size_t count = history->read(historyLevel, row, OccupancyHistory::Channel::Occupancy, buckets);
+  if (count == 0)
+    return;
+
+  float low = buckets[0].min;
+  float high = buckets[0].max;
+  for (size_t i = 1; i < count; ++i) {
+    low = std::min(low, buckets[i].min);
+    high = std::max(high, buckets[i].max);
+  }
+  std::string label = std::format("Past ({}):", OccupancyHistory::LevelName(historyLevel));
+  std::string range = std::format("{:.0f}-{:.0f}%", low * 100.0f, high * 100.0f);
+  DrawText(label.c_str(), x, y, 20, WHITE);
+  DrawText(range.c_str(), x + width - MeasureText(range.c_str(), 20), y, 20, GREEN);
+  y += 25;
+  DrawHistoryBand(x, y, width, 40, std::span(buckets.data(), count));
+  y += 50;
 }
 
 void DashboardOverlay::drawSpotInfo(int x, int y, int width) {
@@ -13,26 +13,33 @@
 
 GameHUD::GameHUD(std::shared_ptr<EventBus> bus, EntityManager *entityManager) : eventBus(bus) {
   // Setup UI Elements
-  uiManager.add(std::make_shared<DashboardOverlay>(eventBus, entityManager));
+  dashboard = std::make_shared<DashboardOverlay>(eventBus, entityManager);
+  uiManager.add(dashboard);
 
   auto spawnBtn = std::make_shared<UIButton>(Vector2{10, 10}, Vector2{150, 40}, "Spawn Car", eventBus);
   spawnBtn->setOnClick([this]() { eventBus->publish(SpawnCarRequestEvent{}); });
   uiManager.add(spawnBtn);
 
   auto speedBtn = std::make_shared<UIButton>(Vector2{10, 60}, Vector2{150, 40}, "Speed: 1.0x", eventBus);
-  speedBtn->setOnClick([this, speedBtn]() {
-    currentSpeed += 0.5;
-    if (currentSpeed > 5.0) {
-      currentSpeed = 1.0;
+  speedBtn->setOnClick([this]() {
+    double nextSpeed = currentSpeed + 0.5;
+    if (nextSpeed > 5.0) {
+      nextSpeed = 1.0;
     }
-    eventBus->publish(SimulationSpeedChangedEvent{currentSpeed});
-    // Update button text
-    char buffer[32];
-    snprintf(buffer, sizeof(buffer), "Speed: %.1fx", currentSpeed);
-    speedBtn->setText(buffer);
+    eventBus->publish(SimulationSpeedChangedEvent{nextSpeed});
   });
   uiManager.add(speedBtn);
 
+  // Follow speed changes from any source (button or control socket)
+  eventTokens.push_back(
+      eventBus->subscribe<SimulationSpeedChangedEvent>([this, speedBtn](const SimulationSpeedChangedEvent &e) {
+        currentSpeed = e.speedMultiplier;
+        // Update button text
+        char buffer[32];
+        snprintf(buffer, sizeof(buffer), "Speed: %.1fx", currentSpeed);
+        speedBtn->setText(buffer);
+      }));
+
   // Auto Spawn Button
   auto autoSpawnBtn = std::make_shared<UIButton>(Vector2{10, 110}, Vector2{150, 40}, "Auto: Off", eventBus);
   autoSpawnBtn->setOnClick([this]() { eventBus->publish(CycleAutoSpawnLevelEvent{}); });
@@ -45,6 +52,16 @@ GameHUD::GameHUD(std::shared_ptr<EventBus> bus, EntityManager *entityManager) :
         autoSpawnBtn->setText(text);
       }));
 
+  // Demand Profile Button
+  auto demandBtn = std::make_shared<UIButton>(Vector2{10, 160}, Vector2{150, 40}, "Demand: Fixed", eventBus);
+  demandBtn->setOnClick([this]() { eventBus->publish(CycleDemandProfileEvent{}); });
+  uiManager.add(demandBtn);
+
+  eventTokens.push_back(
+      eventBus->subscribe<DemandProfileChangedEvent>([demandBtn](const DemandProfileChangedEvent &e) {
+        demandBtn->setText(std::format("Demand: {}", e.name));
+      }));
+
   // Subscribe to Pause Events to toggle pause text visibility
   eventTokens.push_back(eventBus->subscribe<GamePausedEvent>([this](const GamePausedEvent &) { isPaused = true; }));
 
@@ -55,6 +72,8 @@ GameHUD::~GameHUD() { eventTokens.clear(); }
 
 void GameHUD::update(double dt) { uiManager.update(dt); }
 
+void GameHUD::schedule(SystemScheduler &scheduler) { dashboard->schedule(scheduler); }
+
 void GameHUD::draw() {
   uiManager.draw();
 